@@ -0,0 +1,36 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Bench.h                                            :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/16 11:06:10 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/16 11:32:40 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#pragma once
+
+#include <chrono>
+
+/**
+ * @file Bench.h
+ * @brief Helpers shared by the Bench/ executables (see `make bench`).
+ *
+ * Benchmarks run from the repository root, like the engine, so asset paths resolve.
+ */
+
+namespace Engine {
+	namespace Bench {
+
+		using Clock = std::chrono::steady_clock;
+
+		/// Milliseconds elapsed since start.
+		inline double ElapsedMs(Clock::time_point start) {
+			return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		}
+
+	} // namespace Bench
+} // namespace Engine
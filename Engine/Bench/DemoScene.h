@@ -0,0 +1,67 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   DemoScene.h                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/16 11:27:48 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/16 11:27:48 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+
+#pragma once
+
+#include "Renderer/Camera.h"
+#include "Renderer/Geometry/Mesh.h"
+#include "Renderer/Primitives/PrimitiveCache.h"
+#include "World/Actor.h"
+#include "World/Components/StaticMeshComponent.h"
+#include "World/World.h"
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <memory>
+#include <vector>
+
+/**
+ * @file DemoScene.h
+ * @brief Fixed scene for GPU benchmarks: the demo's primitives, sun and start camera (Application::Init).
+ */
+
+namespace Engine {
+	namespace Bench {
+
+		/// Spawns the demo primitives into world; meshes keeps them alive (components hold raw pointers).
+		inline void BuildDemoScene(World &world, std::vector<std::shared_ptr<Mesh>> &meshes) {
+			PrimitiveCache &primitives = PrimitiveCache::Get();
+			auto add = [&](std::shared_ptr<Mesh> mesh, const glm::vec3 &position, const glm::vec3 &rotation, const glm::vec3 &scale) {
+				Actor &actor = world.SpawnActor();
+				actor.GetRootComponent()->SetPosition(position);
+				actor.GetRootComponent()->SetRotation(rotation);
+				actor.GetRootComponent()->SetScale(scale);
+				actor.AddComponent<StaticMeshComponent>(mesh.get());
+				meshes.push_back(std::move(mesh));
+			};
+			add(primitives.GetPlane(), {0.0f, 0.0f, 0.0f}, glm::vec3(0.0f), {10.0f, 1.0f, 10.0f});
+			add(primitives.GetSphere(), {0.0f, 0.75f, 0.0f}, glm::vec3(0.0f), glm::vec3(0.75f));
+			add(primitives.GetCylinder(), {3.0f, 0.5f, -1.0f}, glm::vec3(0.0f), glm::vec3(1.0f));
+			add(primitives.GetCone(), {-1.5f, 0.5f, 2.5f}, glm::vec3(0.0f), glm::vec3(1.0f));
+			add(primitives.GetTorus(), {2.0f, 0.5f, 2.0f}, {0.0f, 45.0f, 0.0f}, glm::vec3(1.0f));
+			add(primitives.GetCube(), {0.5f, 0.5f, -3.0f}, glm::vec3(0.0f), glm::vec3(1.0f));
+			add(primitives.GetCube(), {-2.5f, 0.5f, 0.5f}, {0.0f, -30.0f, 0.0f}, glm::vec3(1.0f));
+		}
+
+		/// The demo's start camera for a render target of the given size.
+		inline Camera DemoCamera(int width, int height) {
+			return Camera({0.0f, 2.0f, 8.0f}, 45.0f, float(width) / float(height), 0.1f, 100.0f);
+		}
+
+		/// Direction the demo sun shines along (world space, normalized).
+		inline glm::vec3 DemoSunDirection() {
+			return glm::normalize(glm::quat(glm::radians(glm::vec3(-60.0f, -30.0f, 0.0f))) * glm::vec3(0.0f, 0.0f, -1.0f));
+		}
+
+	} // namespace Bench
+} // namespace Engine
@@ -0,0 +1,184 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   GBufferBench.cpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/16 11:27:48 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/16 11:27:48 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#include "Bench.h"
+#include "Core/Application.h"
+#include "DemoScene.h"
+#include "Renderer/GPUResources/Framebuffer.h"
+#include "Renderer/GPUResources/GPUQuery.h"
+#include "Renderer/GPUResources/UniformBuffer.h"
+#include "Renderer/Primitives/PrimitiveCache.h"
+#include "Renderer/Shaders/Shader.h"
+#include "Renderer/Textures/TextureCache.h"
+#include "Renderer/Textures/TextureResidency.h"
+#include "Renderer/Textures/TextureStreamer.h"
+#include "Tests/GLContext.h"
+#include "World/World.h"
+#include <glm/glm.hpp>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+// G-buffer size and GPU time of the compact layout (Application::CreateGBuffer) against the
+// previous one (3x RGBA16F + RGBA8, world position stored), on the demo scene at 1920x1080.
+// Each layout fills its G-buffer and runs a lighting pass reading it, 100 frames each; the
+// lighting shader (Shaders/Bench/gbuffer_lighting.frag) only differs in how it decodes the
+// G-buffer.
+//
+// Usage: GBufferBench
+
+using namespace Engine;
+
+namespace {
+	constexpr int Width	 = 1920;
+	constexpr int Height = 1080;
+	constexpr int Frames = 100;
+
+	struct Result {
+		unsigned int bytesPerPixel = 0; ///< Color attachments only
+		double fillMs			   = 0.0;
+		double lightingMs		   = 0.0;
+	};
+
+	std::unique_ptr<Framebuffer> CreateLegacyGBuffer() {
+		auto gBuffer = std::make_unique<Framebuffer>(Width, Height);
+		gBuffer->AddColorTexture(GL_RGBA16F, GL_RGBA, GL_FLOAT);	 // Position (xyz), Metallic (w)
+		gBuffer->AddColorTexture(GL_RGBA16F, GL_RGBA, GL_FLOAT);	 // Normal (xyz), Roughness (w)
+		gBuffer->AddColorTexture(GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE); // Albedo (rgb), AO (a)
+		gBuffer->AddColorTexture(GL_RGBA16F, GL_RGBA, GL_FLOAT);	 // Emissive/specular slot (never written)
+		gBuffer->AddDepthStencil();
+		gBuffer->Build();
+		return gBuffer;
+	}
+
+	Result Measure(World &world, Framebuffer &gBuffer, Shader &fillShader, Shader &lightingShader, Framebuffer &output,
+				   bool legacy, const glm::mat4 &viewProjection, const glm::vec3 &viewPos) {
+		Result result;
+		result.bytesPerPixel = gBuffer.GetBytesPerPixel(false);
+		GPUQuery fillTimer(GL_TIME_ELAPSED);
+		GPUQuery lightingTimer(GL_TIME_ELAPSED);
+
+		for (int frame = 0; frame <= Frames; ++frame) { // Frame 0 warms up and is not counted
+			fillTimer.Begin();
+			gBuffer.Bind();
+			glViewport(0, 0, Width, Height);
+			glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+			glEnable(GL_DEPTH_TEST);
+			glDepthMask(GL_TRUE);
+			fillShader.Bind();
+			for (const auto &actor : world.GetActors()) {
+				if (auto *meshComp = actor->GetComponent<StaticMeshComponent>())
+					meshComp->RenderGeometry(fillShader);
+			}
+			fillTimer.End();
+
+			output.Bind();
+			glDisable(GL_DEPTH_TEST);
+			lightingShader.Bind();
+			lightingShader.SetUniformInt("u_LegacyLayout", legacy ? 1 : 0);
+			if (legacy) {
+				glActiveTexture(GL_TEXTURE0);
+				glBindTexture(GL_TEXTURE_2D, gBuffer.GetColorAttachment(2));
+				glActiveTexture(GL_TEXTURE4);
+				glBindTexture(GL_TEXTURE_2D, gBuffer.GetColorAttachment(0));
+				glActiveTexture(GL_TEXTURE5);
+				glBindTexture(GL_TEXTURE_2D, gBuffer.GetColorAttachment(1));
+			} else {
+				for (unsigned int i = 0; i < 3; ++i) {
+					glActiveTexture(GL_TEXTURE0 + i);
+					glBindTexture(GL_TEXTURE_2D, gBuffer.GetColorAttachment(i));
+				}
+				glActiveTexture(GL_TEXTURE3);
+				glBindTexture(GL_TEXTURE_2D, gBuffer.GetDepthAttachment());
+			}
+			lightingShader.SetUniformInt("gAlbedoAO", 0);
+			lightingShader.SetUniformInt("gNormal", 1);
+			lightingShader.SetUniformInt("gMetallicRoughness", 2);
+			lightingShader.SetUniformInt("gDepth", 3);
+			lightingShader.SetUniformInt("gPositionMetallic", 4);
+			lightingShader.SetUniformInt("gNormalRoughness", 5);
+			lightingShader.SetUniformMat4("u_InvViewProjection", glm::inverse(viewProjection));
+			lightingShader.SetUniformVec3("u_ViewPos", viewPos);
+			lightingShader.SetUniformVec3("u_LightDir", -Bench::DemoSunDirection());
+			lightingTimer.Begin();
+			PrimitiveCache::Get().DrawFullscreenTriangle();
+			lightingTimer.End();
+			glFinish();
+
+			uint64_t fillNs = 0, lightingNs = 0;
+			fillTimer.GetResult(fillNs);
+			lightingTimer.GetResult(lightingNs);
+			if (frame > 0) {
+				result.fillMs += fillNs / 1e6 / Frames;
+				result.lightingMs += lightingNs / 1e6 / Frames;
+			}
+		}
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		return result;
+	}
+
+	void Print(const char *label, const Result &result) {
+		const double megabytes = double(result.bytesPerPixel + 4) * Width * Height / (1024.0 * 1024.0); // + D24S8
+		std::cout << "  " << label << ": " << result.bytesPerPixel << " bytes/pixel + depth (" << megabytes << " MB), fill "
+				  << result.fillMs << " ms, lighting " << result.lightingMs << " ms" << std::endl;
+	}
+} // namespace
+
+int main() {
+	GLFWwindow *window = Tests::CreateHiddenContext(Width, Height);
+	if (!window)
+		return 1;
+
+	int status = 0;
+	{
+		Shader compactFill("Shaders/Core/Deferred/gbuffer.vert", "Shaders/Core/Deferred/gbuffer.frag");
+		Shader legacyFill("Shaders/Core/Deferred/gbuffer.vert", "Shaders/Bench/gbuffer_legacy.frag");
+		Shader lighting("Shaders/Core/Deferred/deferred_lighting.vert", "Shaders/Bench/gbuffer_lighting.frag");
+
+		World world;
+		std::vector<std::shared_ptr<Mesh>> meshes;
+		Bench::BuildDemoScene(world, meshes);
+		const Camera camera = Bench::DemoCamera(Width, Height);
+		glm::mat4 proj		= camera.GetProjectionMatrix();
+		glm::mat4 view		= camera.GetViewMatrix();
+		UniformBuffer cameraBlock(2 * sizeof(glm::mat4), 0);
+		cameraBlock.SetData(0, sizeof(glm::mat4), &proj[0][0]);
+		cameraBlock.SetData(sizeof(glm::mat4), sizeof(glm::mat4), &view[0][0]);
+
+		std::unique_ptr<Framebuffer> compact = Application::CreateGBuffer(Width, Height);
+		std::unique_ptr<Framebuffer> legacy	 = CreateLegacyGBuffer();
+		Framebuffer output(Width, Height);
+		output.AddColorTexture(GL_RGBA16F, GL_RGBA, GL_FLOAT);
+		output.Build();
+
+		if (compactFill.IsValid() && legacyFill.IsValid() && lighting.IsValid()) {
+			std::cout << "[GBufferBench] " << Width << "x" << Height << ", demo scene, " << Frames << " frames" << std::endl;
+			const Result before = Measure(world, *legacy, legacyFill, lighting, output, true, proj * view, camera.GetPosition());
+			const Result after	= Measure(world, *compact, compactFill, lighting, output, false, proj * view, camera.GetPosition());
+			Print("previous", before);
+			Print("compact ", after);
+			std::cout << "  compact / previous: " << 100.0 * (after.bytesPerPixel + 4) / (before.bytesPerPixel + 4) << "% of the bytes, fill "
+					  << 100.0 * after.fillMs / before.fillMs << "%, lighting " << 100.0 * after.lightingMs / before.lightingMs << "%" << std::endl;
+		} else {
+			status = 1;
+		}
+	}
+
+	PrimitiveCache::Get().Clear();
+	TextureCache::Get().Clear();
+	TextureResidency::Get().Clear();
+	TextureStreamer::Get().Shutdown();
+	Tests::DestroyHiddenContext(window);
+	return status;
+}
@@ -0,0 +1,70 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ModelLoadingBench.cpp                              :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/16 11:18:20 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/16 11:18:20 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#include "Bench.h"
+#include "Core/MappedFile.h"
+#include "Renderer/Geometry/Model.h"
+#include "Renderer/Textures/TextureCache.h"
+#include "Renderer/Textures/TextureResidency.h"
+#include "Renderer/Textures/TextureStreamer.h"
+#include "Tests/GLContext.h"
+#include <iostream>
+#include <string>
+
+// Load time of a model through Assimp versus its cooked '.vmesh', cold (pages evicted from the
+// OS cache) and warm. The model is only cooked when its cooked file is missing, stale or was
+// cooked with other import flags.
+//
+// Usage: ModelLoadingBench [model = assets/models/crate.obj]
+
+using namespace Engine;
+
+namespace {
+	void Measure(const char *label, const std::string &path, bool useCooked) {
+		glFinish();
+		const Bench::Clock::time_point start = Bench::Clock::now();
+		const Model model(path, Model::DefaultImportFlags, useCooked);
+		glFinish();
+		std::cout << "  " << label << ": " << Bench::ElapsedMs(start) << " ms" << std::endl;
+	}
+
+	bool EnsureCooked(const std::string &path) {
+		ModelData cooked;
+		return Model::LoadCooked(path, Model::DefaultImportFlags, cooked) || Model::Cook(path);
+	}
+} // namespace
+
+int main(int argc, char **argv) {
+	const std::string path = argc > 1 ? argv[1] : "assets/models/crate.obj";
+
+	GLFWwindow *window = Tests::CreateHiddenContext();
+	if (!window)
+		return 1;
+
+	int result = 0;
+	if (EnsureCooked(path)) {
+		std::cout << "[ModelLoadingBench] " << path << std::endl;
+		Measure("assimp", path, false);
+		MappedFile::EvictFromCache(Model::GetCookedPath(path));
+		Measure("cold  ", path, true);
+		Measure("warm  ", path, true);
+	} else {
+		result = 1;
+	}
+
+	TextureCache::Get().Clear();
+	TextureResidency::Get().Clear();
+	TextureStreamer::Get().Shutdown();
+	Tests::DestroyHiddenContext(window);
+	return result;
+}
@@ -0,0 +1,83 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ResamplerBench.cpp                                 :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/16 10:41:27 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/16 10:41:27 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#include "Core/ThreadPool.h"
+#include "Renderer/Textures/Resampling/SeparableResampler.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// Timing table for the separable resampler: 4K->1K and 1K->4K RGBA8 per filter and
+// per instruction set (best of several runs, in ms). Levels the CPU lacks print "-".
+
+using namespace Engine::Renderer::Textures;
+
+namespace {
+	constexpr int kRuns = 5;
+
+	double BestTimeMs(const std::vector<uint8_t> &input, int inputSize, std::vector<uint8_t> &output, int outputSize,
+					  const FilterKernel &kernel, SimdLevel simd) {
+		double best = 1e30;
+		for (int run = 0; run < kRuns; ++run) {
+			const auto start = std::chrono::steady_clock::now();
+			SeparableResampler::Resample(ImageView(input.data(), inputSize, inputSize, 4),
+										 MutableImageView(output.data(), outputSize, outputSize, 4), kernel, simd);
+			best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+		}
+		return best;
+	}
+} // namespace
+
+int main() {
+	struct NamedKernel {
+		const char *name;
+		FilterKernel kernel;
+	};
+	const NamedKernel kernels[] = {
+		{"bilinear", {TriangleKernel, 1.0f, 0.0f}},
+		{"bicubic", {CubicKernel, 2.0f, 0.0f}},
+		{"lanczos3", {LanczosKernel, 3.0f, 3.0f}},
+	};
+	const SimdLevel levels[] = {SimdLevel::Scalar, SimdLevel::SSE41, SimdLevel::AVX2};
+	const SimdLevel supported = SeparableResampler::DetectSimdLevel();
+
+	std::mt19937 rng(7);
+	std::vector<uint8_t> large(4096ull * 4096 * 4), small(1024ull * 1024 * 4);
+	for (uint8_t &v : large)
+		v = static_cast<uint8_t>(rng());
+	for (uint8_t &v : small)
+		v = static_cast<uint8_t>(rng());
+	std::vector<uint8_t> largeOut(large.size()), smallOut(small.size());
+
+	std::printf("[ResamplerBench] RGBA8, %u worker thread(s), best of %d, ms\n",
+				Engine::ThreadPool::Get().GetThreadCount(), kRuns);
+	std::printf("  %-16s  %8s  %8s  %8s\n", "", "scalar", "sse4.1", "avx2");
+	for (int upscale = 0; upscale < 2; ++upscale) {
+		for (const NamedKernel &named : kernels) {
+			std::printf("  %s %-9s", upscale ? "1K->4K" : "4K->1K", named.name);
+			for (SimdLevel simd : levels) {
+				if (simd > supported) {
+					std::printf("  %8s", "-");
+					continue;
+				}
+				const double ms = upscale ? BestTimeMs(small, 1024, largeOut, 4096, named.kernel, simd)
+										  : BestTimeMs(large, 4096, smallOut, 1024, named.kernel, simd);
+				std::printf("  %8.1f", ms);
+			}
+			std::printf("\n");
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,198 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ShadowFilterBench.cpp                              :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/16 11:24:02 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/16 11:27:48 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#include "Bench.h"
+#include "DemoScene.h"
+#include "Renderer/GPUResources/Framebuffer.h"
+#include "Renderer/GPUResources/GPUQuery.h"
+#include "Renderer/GPUResources/UniformBuffer.h"
+#include "Renderer/Pipeline/ShadowMap.h"
+#include "Renderer/Primitives/PrimitiveCache.h"
+#include "Renderer/Shaders/Shader.h"
+#include "Renderer/Textures/TextureCache.h"
+#include "Renderer/Textures/TextureResidency.h"
+#include "Renderer/Textures/TextureStreamer.h"
+#include "Tests/GLContext.h"
+#include "World/World.h"
+#include <cmath>
+#include <glm/glm.hpp>
+#include <iostream>
+#include <vector>
+
+// GPU cost and quality of each directional shadow filter on a fixed scene and camera (the demo
+// scene's primitives and sun, seen from its start position). Only the shadow term is measured:
+// a fullscreen pass rebuilds positions from the camera depth and writes CalculateShadow() to an
+// R16F target, 100 times per mode. EVSM also reports its moments prefilter.
+//
+// Quality is the error against a dense PCSS reference (every texel of the blocker search and of
+// the penumbra kernel) over the pixels covered by geometry: mean absolute error and the share of
+// pixels off by more than 0.1.
+//
+// Usage: ShadowFilterBench
+
+using namespace Engine;
+
+namespace {
+	constexpr int Width		  = 1280;
+	constexpr int Height		  = 720;
+	constexpr int ShadowSize	  = 2048;
+	constexpr int Passes		  = 100;
+	constexpr int ShadowUnit	  = 0; // Units 0-2: shadow map (compare, raw depth, moments)
+	constexpr int SceneDepthUnit = 3;
+
+	std::vector<float> ReadRed(Framebuffer &target, GLenum format) {
+		std::vector<float> pixels(size_t(Width) * Height);
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, target.GetID());
+		glReadPixels(0, 0, Width, Height, format, GL_FLOAT, pixels.data());
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+		return pixels;
+	}
+} // namespace
+
+int main() {
+	GLFWwindow *window = Tests::CreateHiddenContext(Width, Height);
+	if (!window)
+		return 1;
+
+	int result = 0;
+	{
+		Shader depthShader("Shaders/Core/depth.vert", "Shaders/Core/depth.geom", "Shaders/Core/depth.frag");
+		Shader prepassShader("Shaders/Core/Forward/depth_prepass.vert", "Shaders/Core/depth.frag");
+		Shader termShader("Shaders/Bench/shadow_term.vert", "Shaders/Bench/shadow_term.frag");
+
+		World world;
+		std::vector<std::shared_ptr<Mesh>> meshes;
+		Bench::BuildDemoScene(world, meshes);
+
+		const Camera camera = Bench::DemoCamera(Width, Height);
+		glm::mat4 proj = camera.GetProjectionMatrix();
+		glm::mat4 view = camera.GetViewMatrix();
+		const glm::vec3 sunDirection = Bench::DemoSunDirection();
+		UniformBuffer cameraBlock(2 * sizeof(glm::mat4), 0);
+		cameraBlock.SetData(0, sizeof(glm::mat4), &proj[0][0]);
+		cameraBlock.SetData(sizeof(glm::mat4), sizeof(glm::mat4), &view[0][0]);
+		world.SelectLods(view, proj, Height);
+
+		ShadowMap shadowMap(ShadowSize, ShadowSize);
+		Framebuffer sceneDepth(Width, Height);
+		sceneDepth.AddDepthTexture();
+		sceneDepth.Build();
+		Framebuffer shadowTerm(Width, Height);
+		shadowTerm.AddColorTexture(GL_R16F, GL_RED, GL_FLOAT);
+		shadowTerm.Build();
+
+		if (depthShader.IsValid() && prepassShader.IsValid() && termShader.IsValid()) {
+			// Sun shadow map (both faces cast, as in the engine)
+			glEnable(GL_DEPTH_TEST);
+			glDepthMask(GL_TRUE);
+			shadowMap.ComputeLightSpaceMatrix(sunDirection);
+			shadowMap.BindForWriting();
+			depthShader.Bind();
+			depthShader.SetUniformMat4("lightSpaceMatrices[0]", shadowMap.GetLightSpaceMatrix());
+			depthShader.SetUniformInt("u_ViewCount", 1);
+			const ClusterCullView sunCull = ClusterCullView::FromViewProjection(shadowMap.GetLightSpaceMatrix(), glm::vec3(0.0f), false);
+			world.RenderDepth(depthShader, &sunCull);
+
+			// Camera depth
+			sceneDepth.Bind();
+			glViewport(0, 0, Width, Height);
+			glClear(GL_DEPTH_BUFFER_BIT);
+			prepassShader.Bind();
+			const ClusterCullView cameraCull = ClusterCullView::FromViewProjection(proj * view, camera.GetPosition(), true);
+			world.RenderDepthPrepass(prepassShader, &cameraCull);
+			const std::vector<float> depth = ReadRed(sceneDepth, GL_DEPTH_COMPONENT);
+
+			GPUQuery termTimer(GL_TIME_ELAPSED);
+			GPUQuery prefilterTimer(GL_TIME_ELAPSED);
+			auto drawShadowTerm = [&](ShadowFilterMode mode, bool reference, int passes) {
+				shadowMap.SetFilterMode(mode);
+				prefilterTimer.Begin();
+				shadowMap.PrepareForSampling(); // EVSM: depth -> moments + mip prefilter
+				prefilterTimer.End();
+
+				shadowTerm.Bind();
+				glViewport(0, 0, Width, Height);
+				glDisable(GL_DEPTH_TEST);
+				termShader.Bind();
+				shadowMap.SetupUniforms(termShader, ShadowUnit);
+				glActiveTexture(GL_TEXTURE0 + SceneDepthUnit);
+				glBindTexture(GL_TEXTURE_2D, sceneDepth.GetDepthAttachment());
+				termShader.SetUniformInt("u_SceneDepth", SceneDepthUnit);
+				termShader.SetUniformMat4("u_InvViewProjection", glm::inverse(proj * view));
+				termShader.SetUniformVec3("u_ViewPos", camera.GetPosition());
+				termShader.SetUniformVec3("u_LightDir", -sunDirection);
+				termShader.SetUniformInt("u_Reference", reference ? 1 : 0);
+
+				PrimitiveCache::Get().DrawFullscreenTriangle(); // Warm-up, not timed
+				termTimer.Begin();
+				for (int i = 0; i < passes; ++i)
+					PrimitiveCache::Get().DrawFullscreenTriangle();
+				termTimer.End();
+				shadowMap.ResetSamplers(ShadowUnit);
+				glFinish();
+				return ReadRed(shadowTerm, GL_RED);
+			};
+
+			uint64_t elapsedNs = 0;
+			const std::vector<float> reference = drawShadowTerm(ShadowFilterMode::PCSS, true, 0);
+			termTimer.GetResult(elapsedNs);
+			prefilterTimer.GetResult(elapsedNs);
+
+			// A scene without any shadowed pixel means the depth passes wrote nothing: every number would be meaningless
+			size_t shadowedPixels = 0;
+			for (size_t i = 0; i < reference.size(); ++i)
+				shadowedPixels += depth[i] < 1.0f && reference[i] < 0.5f ? 1 : 0;
+			if (shadowedPixels == 0) {
+				std::cerr << "[ShadowFilterBench] The reference has no shadowed pixel: shadow or camera depth pass is broken" << std::endl;
+				result = 1;
+			}
+
+			std::cout << "[ShadowFilterBench] " << Width << "x" << Height << ", " << ShadowSize << "x" << ShadowSize
+					  << " shadow map, light size " << shadowMap.GetLightSize() << ", " << Passes << " passes per mode" << std::endl;
+			for (int m = 0; result == 0 && m < static_cast<int>(ShadowFilterMode::Count); ++m) {
+				const ShadowFilterMode mode		= static_cast<ShadowFilterMode>(m);
+				const std::vector<float> shadow = drawShadowTerm(mode, false, Passes);
+
+				uint64_t termNs = 0, prefilterNs = 0;
+				termTimer.GetResult(termNs);
+				prefilterTimer.GetResult(prefilterNs);
+
+				double errorSum = 0.0;
+				size_t covered = 0, wrong = 0;
+				for (size_t i = 0; i < shadow.size(); ++i) {
+					if (depth[i] >= 1.0f)
+						continue;
+					const double error = std::abs(double(shadow[i]) - double(reference[i]));
+					errorSum += error;
+					wrong += error > 0.1 ? 1 : 0;
+					++covered;
+				}
+				std::cout << "  " << ToString(mode) << ": " << termNs / 1e6 / Passes << " ms/pass";
+				if (mode == ShadowFilterMode::EVSM)
+					std::cout << " (+ " << prefilterNs / 1e6 << " ms prefilter)";
+				std::cout << ", MAE " << (covered ? errorSum / covered : 0.0) << ", " << (covered ? 100.0 * wrong / covered : 0.0)
+						  << "% of pixels off by > 0.1" << std::endl;
+			}
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		} else {
+			result = 1;
+		}
+	}
+
+	PrimitiveCache::Get().Clear();
+	TextureCache::Get().Clear();
+	TextureResidency::Get().Clear();
+	TextureStreamer::Get().Shutdown();
+	Tests::DestroyHiddenContext(window);
+	return result;
+}
@@ -0,0 +1,63 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   TextureCompressionBench.cpp                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/16 11:13:05 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/16 11:32:40 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#include "Bench.h"
+#include "Core/FileUtils.h"
+#include "Renderer/Textures/Texture.h"
+#include "Renderer/Textures/TextureCache.h"
+#include "Renderer/Textures/TextureCooker.h"
+#include "Tests/GLContext.h"
+#include <iostream>
+#include <string>
+
+// Load + upload time and GPU size of an image through its source file and through its cooked
+// block-compressed sibling (cooked first if missing or older than the source).
+//
+// Usage: TextureCompressionBench [image = assets/textures/World_Diffuse.png]
+
+using namespace Engine;
+
+namespace {
+	void Measure(const std::string &path, bool useCooked) {
+		TextureLoadParams params;
+		params.useCooked = useCooked;
+		glFinish();
+		const Bench::Clock::time_point start = Bench::Clock::now();
+		const Texture texture(path, params);
+		glFinish();
+		const double ms = Bench::ElapsedMs(start);
+		std::cout << "  " << (texture.IsCompressed() ? "BCn" : "PNG") << ": " << ms << " ms, " << texture.GetResidentBytes() / (1024.0 * 1024.0)
+				  << " MiB resident" << std::endl;
+	}
+} // namespace
+
+int main(int argc, char **argv) {
+	const std::string path = argc > 1 ? argv[1] : "assets/textures/World_Diffuse.png";
+
+	GLFWwindow *window = Tests::CreateHiddenContext();
+	if (!window)
+		return 1;
+
+	int result = 0;
+	if (FileUtils::IsCookedUpToDate(path, Texture::GetCookedPath(path)) || TextureCooker::Cook(path)) {
+		std::cout << "[TextureCompressionBench] " << path << std::endl;
+		Measure(path, false);
+		Measure(path, true);
+	} else {
+		result = 1;
+	}
+
+	TextureCache::Get().Clear();
+	Tests::DestroyHiddenContext(window);
+	return result;
+}
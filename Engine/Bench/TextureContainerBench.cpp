@@ -0,0 +1,70 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   TextureContainerBench.cpp                          :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/16 11:15:44 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/16 11:32:40 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#include "Bench.h"
+#include "Core/FileUtils.h"
+#include "Core/MappedFile.h"
+#include "Renderer/Textures/Texture.h"
+#include "Renderer/Textures/TextureCache.h"
+#include "Renderer/Textures/TextureCooker.h"
+#include "Tests/GLContext.h"
+#include <iostream>
+#include <string>
+
+// Load time of an image decoded by stb versus its uncompressed '.vtex' container, cold (pages
+// evicted from the OS cache) and warm. The container holds the same texels, so only the decode
+// is skipped. It is cooked first if missing or older than the source.
+//
+// Usage: TextureContainerBench [image = assets/textures/World_Diffuse.png]
+
+using namespace Engine;
+
+namespace {
+	void Measure(const char *label, const std::string &file, bool useCooked) {
+		TextureLoadParams params;
+		params.useCooked	= useCooked;
+		params.cacheMipmaps = false;
+		glFinish();
+		const Bench::Clock::time_point start = Bench::Clock::now();
+		const Texture texture(file, params);
+		glFinish();
+		std::cout << "  " << label << ": " << Bench::ElapsedMs(start) << " ms" << std::endl;
+	}
+} // namespace
+
+int main(int argc, char **argv) {
+	const std::string path			= argc > 1 ? argv[1] : "assets/textures/World_Diffuse.png";
+	const std::string containerPath = Texture::GetContainerPath(path);
+
+	GLFWwindow *window = Tests::CreateHiddenContext();
+	if (!window)
+		return 1;
+
+	TextureCookSettings settings;
+	settings.container = true;
+	settings.compress  = false;
+	int result		   = 0;
+	if (FileUtils::IsCookedUpToDate(path, containerPath) || TextureCooker::Cook(path, settings)) {
+		std::cout << "[TextureContainerBench] " << path << " vs " << containerPath << std::endl;
+		Measure("stb ", path, false);
+		MappedFile::EvictFromCache(containerPath);
+		Measure("cold", containerPath, true);
+		Measure("warm", containerPath, true);
+	} else {
+		result = 1;
+	}
+
+	TextureCache::Get().Clear();
+	Tests::DestroyHiddenContext(window);
+	return result;
+}
@@ -0,0 +1,94 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   TextureStreamingBench.cpp                          :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/16 11:08:52 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/16 11:31:48 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#include "Bench.h"
+#include "Renderer/Textures/Texture.h"
+#include "Renderer/Textures/TextureCache.h"
+#include "Renderer/Textures/TextureResidency.h"
+#include "Renderer/Textures/TextureStreamer.h"
+#include "Tests/GLContext.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Streaming stress test: queue `count` loads of one image resized to `size` x `size` (full decode,
+// resample and CPU mip chain each, no cache or cooked file) and pump TextureStreamer::Update()
+// as a frame loop would until every texture is resident. A synchronous load of the same
+// texture is timed first for reference: that is how long the GL thread would block per texture.
+//
+// Each texture holds size * size * 5.3 bytes of GPU memory (RGBA8 with mips, about 5.3 MiB at
+// the default 1024) and nothing is evicted: the 200 default loads need about 1 GiB. Raise `size`
+// only with a smaller `count` (16 textures at 4096 already take 1.3 GiB).
+//
+// Usage: TextureStreamingBench [count = 200] [size = 1024] [image = assets/textures/World_Diffuse.png]
+
+using namespace Engine;
+
+int main(int argc, char **argv) {
+	const int count		   = argc > 1 ? std::max(1, std::atoi(argv[1])) : 200;
+	const int size		   = argc > 2 ? std::max(1, std::atoi(argv[2])) : 1024;
+	const std::string path = argc > 3 ? argv[3] : "assets/textures/World_Diffuse.png";
+
+	GLFWwindow *window = Tests::CreateHiddenContext();
+	if (!window)
+		return 1;
+
+	TextureLoadParams params(size, size, ResamplingAlgorithm::Bilinear, TextureColorSpace::sRGB);
+	params.cacheMipmaps = false;
+	params.useCooked	= false;
+
+	double syncMs = 0.0;
+	{
+		glFinish();
+		const Bench::Clock::time_point start = Bench::Clock::now();
+		const Texture texture(path, params);
+		glFinish();
+		syncMs = Bench::ElapsedMs(start);
+	}
+
+	std::vector<std::shared_ptr<Texture>> textures;
+	textures.reserve(count);
+	const Bench::Clock::time_point start = Bench::Clock::now();
+	for (int i = 0; i < count; ++i)
+		textures.push_back(TextureStreamer::Get().Load(path, params));
+	const double queueMs = Bench::ElapsedMs(start);
+
+	int frames			 = 0;
+	double worstUpdateMs = 0.0;
+	while (!TextureStreamer::Get().IsIdle()) {
+		const Bench::Clock::time_point frameStart = Bench::Clock::now();
+		TextureStreamer::Get().Update(2.0);
+		glFlush(); // What the buffer swap would do: lets the staging fences signal
+		worstUpdateMs = std::max(worstUpdateMs, Bench::ElapsedMs(frameStart));
+		++frames;
+	}
+	glFinish();
+	const double residentMs = Bench::ElapsedMs(start);
+
+	const TextureStreamer::Stats &stats = TextureStreamer::Get().GetStats();
+	std::cout << "[TextureStreamingBench] " << count << " x " << path << " at " << size << "x" << size << std::endl;
+	std::cout << "  synchronous: " << syncMs << " ms per texture, GL thread blocked" << std::endl;
+	std::cout << "  streamed:    queued in " << queueMs << " ms, all resident after " << residentMs << " ms (" << frames
+			  << " updates, worst " << worstUpdateMs << " ms), " << stats.completed << " loaded, " << stats.failed << " failed, "
+			  << stats.uploadBytes / (1024.0 * 1024.0) << " MiB uploaded" << std::endl;
+
+	textures.clear();
+	TextureCache::Get().Clear();
+	TextureResidency::Get().Clear();
+	TextureStreamer::Get().Shutdown();
+	Tests::DestroyHiddenContext(window);
+	return 0;
+}
@@ -0,0 +1,94 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   VertexFormatBench.cpp                              :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/16 11:21:37 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/16 11:31:04 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#include "Bench.h"
+#include "Renderer/GPUResources/GPUQuery.h"
+#include "Renderer/GPUResources/UniformBuffer.h"
+#include "Renderer/Geometry/Mesh.h"
+#include "Renderer/Primitives/Primitives.h"
+#include "Renderer/Shaders/Shader.h"
+#include "Tests/GLContext.h"
+#include <algorithm>
+#include <cstdlib>
+#include <glm/glm.hpp>
+#include <iostream>
+
+// Vertex-stage cost of a dense generated sphere uploaded with the full (56-byte) and the
+// compact (20-byte) vertex layout. Rasterization is discarded, so the GPU time is vertex
+// fetch and shading of 100 draws with the forward shader. "Fetched" counts every vertex
+// and index once per draw, the floor the vertex stage must read.
+//
+// Usage: VertexFormatBench [sectors = 1024] (stacks = sectors / 2)
+
+using namespace Engine;
+
+namespace {
+	constexpr int Draws = 100;
+
+	void Measure(const char *label, const MeshGeometry &geometry, VertexFormat format, Shader &shader) {
+		const Mesh mesh(geometry.vertices, geometry.indices, format);
+		const size_t vertexStride = format == VertexFormat::Compact ? sizeof(CompactVertex) : sizeof(Vertex);
+		const size_t vertexBytes  = geometry.vertices.size() * vertexStride;
+		// GetGPUBytes() also counts the two vec4 of compact bounds, the rest is the index buffer
+		const size_t indexBytes = mesh.GetGPUBytes() - vertexBytes - 2 * sizeof(glm::vec4);
+
+		shader.Bind();
+		shader.SetUniformMat4("u_Model", glm::mat4(1.0f));
+		GPUQuery timer(GL_TIME_ELAPSED);
+		glEnable(GL_RASTERIZER_DISCARD);
+		timer.Begin();
+		for (int i = 0; i < Draws; ++i)
+			mesh.Draw();
+		timer.End();
+		glDisable(GL_RASTERIZER_DISCARD);
+		glFinish();
+		uint64_t elapsedNs = 0;
+		timer.GetResult(elapsedNs);
+
+		const double fetchedMiB = double(vertexBytes + indexBytes) * Draws / (1024.0 * 1024.0);
+		std::cout << "  " << label << ": " << vertexStride << " B/vertex, " << (vertexBytes + indexBytes) / 1024.0 << " KiB on GPU, "
+				  << fetchedMiB << " MiB fetched over " << Draws << " draws in " << elapsedNs / 1e6 << " ms ("
+				  << fetchedMiB / 1024.0 / (elapsedNs / 1e9) << " GiB/s)" << std::endl;
+	}
+} // namespace
+
+int main(int argc, char **argv) {
+	const unsigned int sectors = argc > 1 ? static_cast<unsigned int>(std::max(3, std::atoi(argv[1]))) : 1024u;
+
+	GLFWwindow *window = Tests::CreateHiddenContext();
+	if (!window)
+		return 1;
+
+	int result = 0;
+	{
+		Shader shader("Shaders/Core/Forward/forward_shading.vert", "Shaders/Core/Forward/forward_shading.frag");
+		// Camera block (binding 0): projection then view
+		UniformBuffer cameraBlock(2 * sizeof(glm::mat4), 0);
+		const glm::mat4 identity(1.0f);
+		cameraBlock.SetData(0, sizeof(glm::mat4), &identity);
+		cameraBlock.SetData(sizeof(glm::mat4), sizeof(glm::mat4), &identity);
+
+		if (shader.IsValid()) {
+			const MeshGeometry sphere = Primitives::GenerateSphere(sectors, std::max(2u, sectors / 2));
+			std::cout << "[VertexFormatBench] sphere " << sectors << "x" << std::max(2u, sectors / 2) << ": " << sphere.vertices.size()
+					  << " vertices, " << sphere.indices.size() / 3 << " triangles" << std::endl;
+			Measure("full   ", sphere, VertexFormat::Full, shader);
+			Measure("compact", sphere, VertexFormat::Compact, shader);
+		} else {
+			result = 1;
+		}
+	}
+
+	Tests::DestroyHiddenContext(window);
+	return result;
+}
@@ -6,7 +6,7 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/04/26 11:19:09 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/04/29 10:44:26 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2025/05/16 11:27:48 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -17,12 +17,19 @@
 #include "Renderer/Camera.h"
 #include "Renderer/GPUResources/UniformBuffer.h"
 #include "Renderer/Geometry/Model.h"
+#include "Renderer/Geometry/ModelCache.h"
+#include "Renderer/Geometry/ModelStreamer.h"
+#include "Renderer/GPUResources/GPUQuery.h"
 #include "Renderer/Materials/DefaultMaterial.h" // Include DefaultMaterial header
 #include "Renderer/Materials/MaterialPBR.h"
 #include "Renderer/Pipeline/PostProcessor.h"
+#include "Renderer/Pipeline/ShadowAtlas.h"
 #include "Renderer/Pipeline/ShadowMap.h"
-#include "Renderer/Primitives/Primitives.h"
+#include "Renderer/Primitives/PrimitiveCache.h"
 #include "Renderer/Shaders/Shader.h"
+#include "Renderer/Textures/TextureCache.h"
+#include "Renderer/Textures/TextureResidency.h"
+#include "Renderer/Textures/TextureStreamer.h"
 #include "World/Actor.h"
 #include "World/Components/DirectionalLightComponent.h"
 #include "World/Components/LightComponent.h"
@@ -44,6 +51,7 @@
 
 // STL includes
 #include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <memory>
 #include <stdexcept>
@@ -61,8 +69,29 @@ namespace Engine {
 	World *s_World								   = nullptr;
 	std::unique_ptr<PostProcessor> s_PostProcessor = nullptr;
 	std::unique_ptr<Engine::ShadowMap> s_ShadowMap = nullptr;
+	std::unique_ptr<ShadowAtlas> s_ShadowAtlas	   = nullptr;
 	std::unique_ptr<Engine::Shader> s_DepthShader  = nullptr;
-	std::vector<std::unique_ptr<Mesh>> s_PrimitiveMeshes;
+	bool s_ShadowFilterKeyHeld					   = false;
+	std::unique_ptr<Shader> s_DepthPrepassShader   = nullptr; ///< Forward path depth-only prepass
+	std::unique_ptr<GPUQuery> s_OverdrawQuery	   = nullptr; ///< Fragments shaded by the opaque colour pass
+	bool s_DepthPrepassEnabled					   = true;
+	bool s_DepthPrepassKeyHeld					   = false;
+	int s_OverdrawFrames						   = 0;	  ///< Frames measured since the last report
+	double s_OverdrawSum						   = 0.0; ///< Accumulated shaded fragments per pixel
+	std::chrono::steady_clock::time_point s_StartupBegin;	  ///< Init() entry, for startup timings
+	bool s_StreamingReported					   = false;
+	double s_TextureUploadBudgetMs				   = 2.0; ///< Per-frame upload time for streamed textures
+	double s_ModelBuildBudgetMs					   = 1.0; ///< Per-frame GL buffer creation time for streamed models
+	size_t s_ModelStagingMB						   = 64;  ///< Converted geometry held per import batch / waiting for upload
+	bool s_ModelsReported						   = false;
+	bool s_CompactVertices						   = false; ///< Upload meshes with the 20-byte quantized layout
+	uint64_t s_TextureBudgetMB					   = 1024; ///< GPU memory allowed for streamed textures
+	int s_ResidencyFrames						   = 0;	   ///< Frames since the last residency report
+	float s_LodBias								   = 0.0f; ///< Model::SetLodBias (each +1 doubles the screen-space error allowed)
+	int s_LodFrames								   = 0;	   ///< Frames since the last level-of-detail report
+	size_t s_MeshletMinTriangles				   = 4096; ///< Meshes this dense are split into culled meshlets (0 = off)
+	bool s_ClusterBackfaceCulling				   = true; ///< Also reject back-facing meshlets (scene meshes are closed)
+	std::vector<std::shared_ptr<Mesh>> s_PrimitiveMeshes;
 	std::vector<std::unique_ptr<DynamicModule>> s_Plugins;
 	bool s_FirstMouse	  = true;
 	float s_LastX		  = 0.0f;
@@ -80,50 +109,6 @@ namespace Engine {
 	Shader *Application::s_WireframeShader		= nullptr;
 	RenderMode Application::s_CurrentRenderMode = RenderMode::Default;
 
-	// Helper to render a full screen quad (can be moved to PostProcessor or Renderer class)
-	static unsigned int quadVAO = 0;
-	static unsigned int quadVBO;
-	void renderQuad() {
-		if (quadVAO == 0) {
-			float quadVertices[] = {
-				// positions        // texture Coords
-				-1.0f,
-				1.0f,
-				0.0f,
-				0.0f,
-				1.0f,
-				-1.0f,
-				-1.0f,
-				0.0f,
-				0.0f,
-				0.0f,
-				1.0f,
-				1.0f,
-				0.0f,
-				1.0f,
-				1.0f,
-				1.0f,
-				-1.0f,
-				0.0f,
-				1.0f,
-				0.0f,
-			};
-			// setup plane VAO
-			glGenVertexArrays(1, &quadVAO);
-			glGenBuffers(1, &quadVBO);
-			glBindVertexArray(quadVAO);
-			glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
-			glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), &quadVertices, GL_STATIC_DRAW);
-			glEnableVertexAttribArray(0);
-			glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *)0);
-			glEnableVertexAttribArray(1);
-			glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *)(3 * sizeof(float)));
-		}
-		glBindVertexArray(quadVAO);
-		glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-		glBindVertexArray(0);
-	}
-
 	static void FramebufferSizeCallback([[maybe_unused]] GLFWwindow *window, int width, int height) {
 		glViewport(0, 0, width, height);
 		if (s_Camera)
@@ -179,7 +164,29 @@ namespace Engine {
 		Shutdown();
 	}
 
+	std::unique_ptr<Framebuffer> Application::CreateGBuffer(unsigned int width, unsigned int height) {
+		// Compact G-Buffer: world position is reconstructed from depth in the lighting pass
+		auto gBuffer = std::make_unique<Framebuffer>(width, height);
+		// Attachment 0: Albedo (rgb) + AO (a)
+		gBuffer->AddColorTexture(GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE);
+		// Attachment 1: Octahedral-encoded world normal
+		gBuffer->AddColorTexture(GL_RG16, GL_RG, GL_UNSIGNED_SHORT);
+		// Attachment 2: Metallic (r) + Roughness (g)
+		gBuffer->AddColorTexture(GL_RG8, GL_RG, GL_UNSIGNED_BYTE);
+		// Depth/Stencil Attachment (sampled by the lighting pass)
+		gBuffer->AddDepthTexture();
+		gBuffer->Build(); // Check for completeness
+		return gBuffer;
+	}
+
 	void Application::Init() {
+		s_StartupBegin = std::chrono::steady_clock::now();
+		Mesh::SetDefaultVertexFormat(s_CompactVertices ? VertexFormat::Compact : VertexFormat::Full);
+		Model::SetLodBias(s_LodBias);
+		Model::SetStagingBytes(s_ModelStagingMB * 1024 * 1024);
+		Mesh::SetMeshletMinTriangles(s_MeshletMinTriangles);
+		TextureResidency::Get().SetBudget(s_TextureBudgetMB * 1024 * 1024);
+
 		// Initialize the core plugins
 		// DynamicModule plugin("plugins/MyPlugin/libMyPlugin.so");
 		// plugin.load();
@@ -242,13 +249,14 @@ namespace Engine {
 		// s_PBRShader		  = new Shader("Shaders/Core/pbr.vert", "Shaders/Core/pbr.frag");
 		s_UnlitShader	  = new Shader("Shaders/Core/unlit.vert", "Shaders/Core/unlit.frag");
 		s_WireframeShader = new Shader("Shaders/Core/wireframe.vert", "Shaders/Core/wireframe.frag");
-		s_DepthShader	  = std::make_unique<Engine::Shader>("Shaders/Core/depth.vert", "Shaders/Core/depth.frag");
+		s_DepthShader	  = std::make_unique<Engine::Shader>("Shaders/Core/depth.vert", "Shaders/Core/depth.geom", "Shaders/Core/depth.frag");
+		s_DepthPrepassShader = std::make_unique<Engine::Shader>("Shaders/Core/Forward/depth_prepass.vert", "Shaders/Core/depth.frag");
 
 		// Load Deferred Shaders
 		s_GBufferShader			 = std::make_unique<Engine::Shader>("Shaders/Core/Deferred/gbuffer.vert", "Shaders/Core/Deferred/gbuffer.frag");
 		s_DeferredLightingShader = std::make_unique<Engine::Shader>("Shaders/Core/Deferred/deferred_lighting.vert", "Shaders/Core/Deferred/deferred_lighting.frag");
 
-		if (!s_PBRShader->IsValid() || !s_UnlitShader->IsValid() || !s_WireframeShader->IsValid()) {
+		if (!s_PBRShader->IsValid() || !s_UnlitShader->IsValid() || !s_WireframeShader->IsValid() || !s_DepthPrepassShader->IsValid()) {
 			std::cerr << "[ERROR] Failed to load forward shaders." << std::endl;
 			glfwTerminate();
 			exit(EXIT_FAILURE);
@@ -260,18 +268,13 @@ namespace Engine {
 			exit(EXIT_FAILURE);
 		}
 
-		s_GBufferFBO = std::make_unique<Framebuffer>(windowWidth, windowHeight);
-		// Attachment 0: Position (World Space) + Depth? (RGBA16F or RGBA32F)
-		s_GBufferFBO->AddColorTexture(GL_RGBA16F, GL_RGBA, GL_FLOAT);
-		// Attachment 1: Normal (World Space) + Metallic? (RGBA16F)
-		s_GBufferFBO->AddColorTexture(GL_RGBA16F, GL_RGBA, GL_FLOAT);
-		// Attachment 2: Albedo + Roughness? (RGBA8)
-		s_GBufferFBO->AddColorTexture(GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE);
-		// Attachment 3: AO + Emissive + Specular? (RGBA8 or RGBA16F) - Adjust as needed
-		s_GBufferFBO->AddColorTexture(GL_RGBA16F, GL_RGBA, GL_FLOAT);
-		// Depth/Stencil Attachment
-		s_GBufferFBO->AddDepthStencil();
-		s_GBufferFBO->Build(); // Check for completeness
+		s_GBufferFBO = CreateGBuffer(windowWidth, windowHeight);
+		{
+			const unsigned int bytesPerPixel = s_GBufferFBO->GetBytesPerPixel(false);
+			const double megabytes			 = double(s_GBufferFBO->GetBytesPerPixel()) * windowWidth * windowHeight / (1024.0 * 1024.0);
+			std::cout << "[GBuffer] " << bytesPerPixel << " bytes/pixel + depth, "
+					  << megabytes << " MB at " << windowWidth << "x" << windowHeight << std::endl;
+		}
 
 		s_UBO = new UniformBuffer(sizeof(glm::mat4) * 2, 0);
 
@@ -281,10 +284,16 @@ namespace Engine {
 		// Initialize ShadowMap
 		s_ShadowMap = std::make_unique<Engine::ShadowMap>(2048, 2048);
 
-		// Initialize Depth Shader
+		// Initialize Shadow Atlas (spot/point light shadows, 2 light updates per frame)
+		s_ShadowAtlas = std::make_unique<ShadowAtlas>(4096, 64, 1024);
+		s_ShadowAtlas->SetUpdateBudget(2);
+		s_OverdrawQuery = std::make_unique<GPUQuery>(GL_SAMPLES_PASSED);
+
+		// Initialize Depth Shader (instanced, layered: one draw writes every shadow view)
 		// Update paths to Core directory
 		s_DepthShader = std::make_unique<Engine::Shader>(
 			"Shaders/Core/depth.vert",
+			"Shaders/Core/depth.geom",
 			"Shaders/Core/depth.frag");
 
 		if (!s_DepthShader->IsValid()) {
@@ -296,13 +305,14 @@ namespace Engine {
 		// World & Actors
 		s_World = new World();
 
-		// Create and store primitive meshes first
-		s_PrimitiveMeshes.push_back(Primitives::CreateSphere());   // Index 0
-		s_PrimitiveMeshes.push_back(Primitives::CreatePlane());	   // Index 1
-		s_PrimitiveMeshes.push_back(Primitives::CreateCylinder()); // Index 2
-		s_PrimitiveMeshes.push_back(Primitives::CreateCone());	   // Index 3
-		s_PrimitiveMeshes.push_back(Primitives::CreateTorus());	   // Index 4
-		s_PrimitiveMeshes.push_back(Primitives::CreateCube());	   // Index 5 (Added primitive cube)
+		// Fetch primitive meshes first (generated once, shared through the cache)
+		PrimitiveCache &primitives = PrimitiveCache::Get();
+		s_PrimitiveMeshes.push_back(primitives.GetSphere());   // Index 0
+		s_PrimitiveMeshes.push_back(primitives.GetPlane());	   // Index 1
+		s_PrimitiveMeshes.push_back(primitives.GetCylinder()); // Index 2
+		s_PrimitiveMeshes.push_back(primitives.GetCone());	   // Index 3
+		s_PrimitiveMeshes.push_back(primitives.GetTorus());	   // Index 4
+		s_PrimitiveMeshes.push_back(primitives.GetCube());	   // Index 5 (Added primitive cube)
 
 		// --- PBR Materials ---
 		// Dirt Material for the ground plane - Load textures at native resolution
@@ -334,8 +344,10 @@ namespace Engine {
 		bricksMat->SetNormalMap("assets/textures/bricks/Bricks_Normal.png");
 		bricksMat->roughness = 0.5f; // Medium roughness
 		bricksMat->metallic	 = 0.0f; // Non-metallic
-		bricksMat->SetAOMap("assets/textures/bricks/Bricks_AmbientOcclusion.png");
-		bricksMat->SetHeightMap("assets/textures/bricks/Bricks_Height.png");
+		ChannelPackSources bricksPack; // AO + height in one texture (Bricks_ORM.dds)
+		bricksPack.ao	  = "assets/textures/bricks/Bricks_AmbientOcclusion.png";
+		bricksPack.height = "assets/textures/bricks/Bricks_Height.png";
+		bricksMat->SetPackedMaps(bricksPack);
 		bricksMat->SetSpecularMap("assets/textures/bricks/Bricks_Specular.png");
 
 		// --- Actor Setup ---
@@ -436,15 +448,46 @@ namespace Engine {
 		} else {
 			std::cerr << "[ERROR] Failed to load plugins/libHelloPlugin.so" << std::endl;
 		}
+
+		const double initMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - s_StartupBegin).count();
+		const ModelCache::Stats modelStats = ModelCache::Get().GetStats();
+		std::cout << "[Startup] Init finished in " << initMs << " ms (" << TextureStreamer::Get().GetStats().requested
+				  << " textures streaming, " << modelStats.misses << " models streaming for " << modelStats.hits + modelStats.misses << " requests)"
+				  << std::endl;
 	}
 
 	void Application::MainLoop() {
 		float lastFrame = 0.0f;
+		Mesh::ResetDrawStats(); // Frame statistics exclude startup draws
 		while (!glfwWindowShouldClose(s_Window)) {
 			float current = float(glfwGetTime());
 			float delta	  = current - lastFrame;
 			lastFrame	  = current;
 
+			// --- Texture Streaming ---
+			TextureStreamer::Get().Update(s_TextureUploadBudgetMs);
+			if (!s_StreamingReported && TextureStreamer::Get().IsIdle()) {
+				const TextureStreamer::Stats &stats = TextureStreamer::Get().GetStats();
+				const double residentMs				= std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - s_StartupBegin).count();
+				std::cout << "[Startup] All textures resident after " << residentMs << " ms (" << stats.completed << " loaded, "
+						  << stats.failed << " failed, " << stats.uploadBytes / (1024.0 * 1024.0) << " MiB uploaded)" << std::endl;
+				const TextureCache::Stats cacheStats = TextureCache::Get().GetStats();
+				std::cout << "[Startup] Texture cache: " << cacheStats.hits << " hits, " << cacheStats.misses << " misses, "
+						  << TextureCache::Get().GetLiveCount() << " live" << std::endl;
+				s_StreamingReported = true;
+			}
+
+			// --- Model Streaming ---
+			ModelStreamer::Get().Update(s_ModelBuildBudgetMs);
+			if (!s_ModelsReported && ModelStreamer::Get().IsIdle()) {
+				const ModelStreamer::Stats &stats = ModelStreamer::Get().GetStats();
+				const double readyMs			  = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - s_StartupBegin).count();
+				std::cout << "[Startup] All models ready after " << readyMs << " ms (" << stats.completed << " loaded, " << stats.failed
+						  << " failed, " << stats.subMeshesBuilt << " sub-meshes in " << stats.batchesBuilt << " batches, peak staging "
+						  << stats.peakStagedBytes / (1024 * 1024) << " MiB)" << std::endl;
+				s_ModelsReported = true;
+			}
+
 			// --- Input Processing ---
 			// Keyboard movement
 			bool forward  = glfwGetKey(s_Window, GLFW_KEY_W) == GLFW_PRESS;
@@ -475,12 +518,41 @@ namespace Engine {
 				glfwSetWindowShouldClose(s_Window, true);
 			}
 
+			// Shadow filter cycling (F5, edge-triggered); Bench/ShadowFilterBench measures each mode
+			bool shadowFilterKey = glfwGetKey(s_Window, GLFW_KEY_F5) == GLFW_PRESS;
+			if (shadowFilterKey && !s_ShadowFilterKeyHeld) {
+				int next = (static_cast<int>(s_ShadowMap->GetFilterMode()) + 1) % static_cast<int>(ShadowFilterMode::Count);
+				s_ShadowMap->SetFilterMode(static_cast<ShadowFilterMode>(next));
+				std::cout << "[Shadows] Filter: " << ToString(s_ShadowMap->GetFilterMode()) << std::endl;
+			}
+			s_ShadowFilterKeyHeld = shadowFilterKey;
+
+			// Depth prepass toggle (F6, edge-triggered); overdraw is reported for each state
+			bool depthPrepassKey = glfwGetKey(s_Window, GLFW_KEY_F6) == GLFW_PRESS;
+			if (depthPrepassKey && !s_DepthPrepassKeyHeld) {
+				s_DepthPrepassEnabled = !s_DepthPrepassEnabled;
+				s_OverdrawQuery->Discard(); // Frames still in flight were drawn in the previous state
+				s_OverdrawFrames = 0;
+				s_OverdrawSum	 = 0.0;
+				std::cout << "[Prepass] Depth prepass " << (s_DepthPrepassEnabled ? "ON" : "OFF") << std::endl;
+			}
+			s_DepthPrepassKeyHeld = depthPrepassKey;
+
 			// --- Camera & UBO Update ---
 			glm::mat4 proj = s_Camera->GetProjectionMatrix();
 			glm::mat4 view = s_Camera->GetViewMatrix();
 			s_UBO->SetData(0, sizeof(glm::mat4), &proj[0][0]);
 			s_UBO->SetData(sizeof(glm::mat4), sizeof(glm::mat4), &view[0][0]);
 
+			// --- Level of Detail (chosen once, so shadow, prepass and colour passes agree) ---
+			int lodViewportWidth, lodViewportHeight;
+			glfwGetFramebufferSize(s_Window, &lodViewportWidth, &lodViewportHeight);
+			s_World->SelectLods(view, proj, lodViewportHeight);
+
+			// --- Meshlet Culling (camera view for the prepass and colour pass; wireframe shows back faces) ---
+			const ClusterCullView cameraCull = ClusterCullView::FromViewProjection(
+				proj * view, s_Camera->GetPosition(), s_ClusterBackfaceCulling && s_CurrentRenderMode != RenderMode::Wireframe);
+
 			// --- Shadow Mapping Pass ---
 			// (Shadow mapping always uses the depth shader, unaffected by render mode)
 			// 1) Compute light space matrix based on the directional light
@@ -502,8 +574,14 @@ namespace Engine {
 			glViewport(0, 0, 2048, 2048); // Set viewport to shadow map size
 			glClear(GL_DEPTH_BUFFER_BIT);
 			s_DepthShader->Bind();
-			s_DepthShader->SetUniformMat4("lightSpaceMatrix", s_ShadowMap->GetLightSpaceMatrix());
-			s_World->RenderDepth(*s_DepthShader);
+			s_DepthShader->SetUniformMat4("lightSpaceMatrices[0]", s_ShadowMap->GetLightSpaceMatrix());
+			s_DepthShader->SetUniformInt("u_ViewCount", 1);
+			const ClusterCullView sunCull = ClusterCullView::FromViewProjection(s_ShadowMap->GetLightSpaceMatrix(), glm::vec3(0.0f), false); // Both faces cast
+			s_World->RenderDepth(*s_DepthShader, &sunCull);
+			s_ShadowMap->PrepareForSampling(); // EVSM: depth -> moments + mip prefilter
+
+			// 3) Refresh cached spot/point light tiles in the shadow atlas (bounded by the update budget)
+			s_ShadowAtlas->Update(*s_World, *s_Camera, *s_DepthShader);
 			glBindFramebuffer(GL_FRAMEBUFFER, 0); // Unbind shadow FBO
 
 			// Reset viewport to window size
@@ -511,6 +589,17 @@ namespace Engine {
 			glfwGetFramebufferSize(s_Window, &display_w, &display_h);
 			glViewport(0, 0, display_w, display_h);
 
+			// --- Texture Residency (evict / request mips from this frame's visible draws) ---
+			s_World->ReportTextureUsage(view, proj, display_h);
+			TextureResidency::Get().Update();
+			if (++s_ResidencyFrames == 240) {
+				const TextureResidency::Stats &stats = TextureResidency::Get().GetStats();
+				std::cout << "[Residency] " << stats.residentBytes / (1024.0 * 1024.0) << " / " << stats.budgetBytes / (1024.0 * 1024.0)
+						  << " MiB, " << stats.visible << "/" << stats.tracked << " textures visible, " << stats.misses << " misses, "
+						  << stats.evictions << " levels evicted, " << stats.streamIns << " stream-ins" << std::endl;
+				s_ResidencyFrames = 0;
+			}
+
 			// --- Main Rendering Pass ---
 			// Reset viewport and clear
 			glClearColor(0.05f, 0.05f, 0.08f, 1.0f);
@@ -529,19 +618,55 @@ namespace Engine {
 					glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 				}
 
+				s_World->Tick(delta);
+
+				// Depth prepass: only the cheap depth shader pays for overdraw (PBR mode only)
+				const bool useDepthPrepass = s_DepthPrepassEnabled && s_CurrentRenderMode == RenderMode::Default;
+				if (useDepthPrepass) {
+					glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+					s_DepthPrepassShader->Bind();
+					s_World->RenderDepthPrepass(*s_DepthPrepassShader, &cameraCull);
+					glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+				}
+
 				currentShader->Bind();
 
 				// Set common uniforms (ViewPos, ShadowMap for PBR)
 				if (s_CurrentRenderMode == RenderMode::Default && s_Camera) {
 					currentShader->SetUniformVec3("u_ViewPos", s_Camera->GetPosition());
-					s_ShadowMap->BindForReading(GL_TEXTURE4); // Assuming unit 4 for shadow map
-					currentShader->SetUniformInt("shadowMap", 4);
-					currentShader->SetUniformMat4("lightSpaceMatrix", s_ShadowMap->GetLightSpaceMatrix());
+					s_ShadowMap->SetupUniforms(*currentShader, 13);	  // Units 13-15, clear of material maps
+					s_ShadowAtlas->SetupUniforms(*currentShader, 12); // Unit 12, clear of material maps
 				}
 
 				// Tick and Render the world using the selected forward shader
-				s_World->Tick(delta);
-				s_World->Render(*currentShader, view, s_CurrentRenderMode); // World::Render handles lights/materials for forward
+				s_World->SetupLightUniforms(*currentShader, s_CurrentRenderMode);
+				if (useDepthPrepass) {
+					glDepthFunc(GL_EQUAL); // Only the visible surface passes
+					glDepthMask(GL_FALSE);
+				}
+				s_OverdrawQuery->Begin();
+				s_World->RenderOpaque(*currentShader, s_CurrentRenderMode, &cameraCull);
+				s_OverdrawQuery->End();
+				if (useDepthPrepass) {
+					glDepthFunc(GL_LESS);
+					glDepthMask(GL_TRUE);
+				}
+				s_World->RenderBillboards(*currentShader, view, s_CurrentRenderMode); // Not in the prepass (blended)
+				if (s_CurrentRenderMode == RenderMode::Default && s_Camera)
+					s_ShadowMap->ResetSamplers(13);
+
+				// Overdraw = fragments shaded by the opaque pass per screen pixel, reported every 240 frames
+				uint64_t shadedSamples = 0;
+				while (s_OverdrawQuery->GetResult(shadedSamples)) {
+					s_OverdrawSum += double(shadedSamples) / (double(display_w) * double(display_h));
+					if (++s_OverdrawFrames == 240) {
+						std::cout << "[Prepass] " << (useDepthPrepass ? "ON" : "OFF") << ": "
+								  << s_OverdrawSum / s_OverdrawFrames << " shaded fragments/pixel (avg over "
+								  << s_OverdrawFrames << " frames)" << std::endl;
+						s_OverdrawFrames = 0;
+						s_OverdrawSum	 = 0.0;
+					}
+				}
 
 				// Restore polygon mode if wireframe was used
 				if (s_CurrentRenderMode == RenderMode::Wireframe) {
@@ -582,19 +707,22 @@ namespace Engine {
 				s_DeferredLightingShader->Bind();
 				// Bind G-Buffer textures
 				glActiveTexture(GL_TEXTURE0);
-				glBindTexture(GL_TEXTURE_2D, s_GBufferFBO->GetColorAttachment(0)); // Position + Metallic
-				s_DeferredLightingShader->SetUniformInt("gPositionMetallic", 0);   // Corrected name
+				glBindTexture(GL_TEXTURE_2D, s_GBufferFBO->GetColorAttachment(0)); // Albedo + AO
+				s_DeferredLightingShader->SetUniformInt("gAlbedoAO", 0);
 				glActiveTexture(GL_TEXTURE1);
-				glBindTexture(GL_TEXTURE_2D, s_GBufferFBO->GetColorAttachment(1)); // Normal + Roughness
-				s_DeferredLightingShader->SetUniformInt("gNormalRoughness", 1);	   // Corrected name
+				glBindTexture(GL_TEXTURE_2D, s_GBufferFBO->GetColorAttachment(1)); // Octahedral normal
+				s_DeferredLightingShader->SetUniformInt("gNormal", 1);
 				glActiveTexture(GL_TEXTURE2);
-				glBindTexture(GL_TEXTURE_2D, s_GBufferFBO->GetColorAttachment(2)); // Albedo + AO
-				s_DeferredLightingShader->SetUniformInt("gAlbedoAO", 2);		   // Corrected name
+				glBindTexture(GL_TEXTURE_2D, s_GBufferFBO->GetColorAttachment(2)); // Metallic + Roughness
+				s_DeferredLightingShader->SetUniformInt("gMetallicRoughness", 2);
+				glActiveTexture(GL_TEXTURE3);
+				glBindTexture(GL_TEXTURE_2D, s_GBufferFBO->GetDepthAttachment()); // Depth -> world position
+				s_DeferredLightingShader->SetUniformInt("gDepth", 3);
+				s_DeferredLightingShader->SetUniformMat4("u_InvViewProjection", glm::inverse(proj * view));
 
-				// Bind Shadow Map
-				s_ShadowMap->BindForReading(GL_TEXTURE4); // Assuming unit 4
-				s_DeferredLightingShader->SetUniformInt("shadowMap", 4);
-				s_DeferredLightingShader->SetUniformMat4("lightSpaceMatrix", s_ShadowMap->GetLightSpaceMatrix());
+				// Bind Shadow Map (compare, raw depth and EVSM moments on units 13-15) and the point light atlas (unit 12)
+				s_ShadowMap->SetupUniforms(*s_DeferredLightingShader, 13);
+				s_ShadowAtlas->SetupUniforms(*s_DeferredLightingShader, 12);
 
 				// Set light uniforms (needs adaptation for deferred shader)
 				// Example: Pass light data via UBO or uniform arrays
@@ -606,41 +734,34 @@ namespace Engine {
 				// You'll likely iterate through lights similar to World::Render but set uniforms
 				// matching the structures (e.g., u_PointLights, u_DirLights) in deferred_lighting.frag.
 
-				// Example (needs full implementation):
-				int pointLightCount					= 0;
-				int dirLightCount					= 0;
-				const int MAX_POINT_LIGHTS_DEFERRED = 10; // Match shader define
-				const int MAX_DIR_LIGHTS_DEFERRED	= 1;  // Match shader define
+				// Same light order as the forward path, so point light i matches atlas slot i
+				const WorldLights lights = s_World->CollectLights();
+				int pointLightCount		 = 0;
+				int dirLightCount		 = 0;
 
-				for (const auto &actor : s_World->GetActors()) {
-					if (auto dirLight = actor->GetComponent<DirectionalLightComponent>()) {
-						if (dirLightCount < MAX_DIR_LIGHTS_DEFERRED) {
-							std::string baseName = "u_DirLights[" + std::to_string(dirLightCount) + "]";
-							s_DeferredLightingShader->SetUniformVec3(baseName + ".direction", dirLight->GetDirection());
-							s_DeferredLightingShader->SetUniformVec3(baseName + ".color", dirLight->GetColor());
-							// Add intensity if your shader struct uses it
-							dirLightCount++;
-						}
-					} else if (auto pointLight = actor->GetComponent<PointLightComponent>()) {
-						// Exclude SpotLights if they are handled separately or not supported yet
-						if (!dynamic_cast<SpotLightComponent *>(pointLight) && pointLightCount < MAX_POINT_LIGHTS_DEFERRED) {
-							std::string baseName = "u_PointLights[" + std::to_string(pointLightCount) + "]";
-							s_DeferredLightingShader->SetUniformVec3(baseName + ".position", pointLight->GetOwner()->GetRootComponent()->GetWorldPosition());
-							s_DeferredLightingShader->SetUniformVec3(baseName + ".color", pointLight->GetColor());
-							// Add intensity if your shader struct uses it
-							s_DeferredLightingShader->SetUniformFloat(baseName + ".constant", pointLight->GetConstant());
-							s_DeferredLightingShader->SetUniformFloat(baseName + ".linear", pointLight->GetLinear());
-							s_DeferredLightingShader->SetUniformFloat(baseName + ".quadratic", pointLight->GetQuadratic());
-							pointLightCount++;
-						}
-					}
-					// Add SpotLight handling if needed
+				if (lights.directional) {
+					s_DeferredLightingShader->SetUniformVec3("u_DirLights[0].direction", lights.directional->GetDirection());
+					s_DeferredLightingShader->SetUniformVec3("u_DirLights[0].color", lights.directional->GetColor());
+					// Add intensity if your shader struct uses it
+					dirLightCount++;
+				}
+				for (const PointLightComponent *pointLight : lights.points) {
+					std::string baseName = "u_PointLights[" + std::to_string(pointLightCount) + "]";
+					s_DeferredLightingShader->SetUniformVec3(baseName + ".position", pointLight->GetOwner()->GetRootComponent()->GetWorldPosition());
+					s_DeferredLightingShader->SetUniformVec3(baseName + ".color", pointLight->GetColor());
+					// Add intensity if your shader struct uses it
+					s_DeferredLightingShader->SetUniformFloat(baseName + ".constant", pointLight->GetConstant());
+					s_DeferredLightingShader->SetUniformFloat(baseName + ".linear", pointLight->GetLinear());
+					s_DeferredLightingShader->SetUniformFloat(baseName + ".quadratic", pointLight->GetQuadratic());
+					pointLightCount++;
 				}
+				// Spot lights are not lit by the deferred path yet
 				s_DeferredLightingShader->SetUniformInt("u_NumPointLights", pointLightCount);
 				s_DeferredLightingShader->SetUniformInt("u_NumDirLights", dirLightCount);
 				// --- End Light Uniform Setup ---
 
-				renderQuad(); // Draw fullscreen quad to apply lighting
+				PrimitiveCache::Get().DrawFullscreenTriangle(); // Apply lighting over the whole screen
+				s_ShadowMap->ResetSamplers(13);
 
 				// 3. Forward Pass (Transparency, Billboards, etc.)
 				// Copy depth information from G-Buffer to default framebuffer
@@ -674,6 +795,20 @@ namespace Engine {
 				// glDepthMask(GL_TRUE); // Restore depth writing if it was disabled
 			}
 
+			// Triangles submitted per frame (all passes) and draws per level of detail
+			if (++s_LodFrames == 240) {
+				const Mesh::DrawStats &stats = Mesh::GetDrawStats();
+				std::cout << "[LOD] " << stats.triangles / s_LodFrames << " triangles, " << stats.drawCalls / s_LodFrames << " draws per frame (bias "
+						  << Model::GetLodBias() << "), draws per level:";
+				for (uint64_t draws : stats.lodDrawCalls)
+					std::cout << " " << draws / s_LodFrames;
+				if (stats.meshletsTested > 0)
+					std::cout << ", meshlets culled: " << 100.0 * stats.meshletsCulled / stats.meshletsTested << "%";
+				std::cout << std::endl;
+				Mesh::ResetDrawStats();
+				s_LodFrames = 0;
+			}
+
 			// --- Post Processing (If enabled, would happen here or wrap the main rendering) ---
 			// s_PostProcessor->Render([&]() { /* Render logic goes here */ });
 
@@ -691,6 +826,9 @@ namespace Engine {
 
 		s_PostProcessor.reset(); // Release PostProcessor before other resources
 		s_ShadowMap.reset();	 // Release ShadowMap
+		s_ShadowAtlas.reset();	 // Release Shadow Atlas
+		s_OverdrawQuery.reset();
+		s_DepthPrepassShader.reset();
 		s_DepthShader.reset();	 // Release Depth Shader
 		delete s_World;
 		delete s_UBO;
@@ -705,6 +843,12 @@ namespace Engine {
 		s_DeferredLightingShader.reset();
 
 		s_PrimitiveMeshes.clear(); // Release primitive meshes
+		PrimitiveCache::Get().Clear();
+		ModelStreamer::Get().Shutdown();
+		ModelCache::Get().Clear();
+		TextureCache::Get().Clear();
+		TextureResidency::Get().Clear();
+		TextureStreamer::Get().Shutdown(); // Staging buffer and fences need the context
 		glfwDestroyWindow(s_Window);
 		glfwTerminate();
 	}
@@ -6,7 +6,7 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/04/26 11:18:59 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/04/29 00:53:20 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2025/05/16 11:27:48 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -41,6 +41,9 @@ namespace Engine {
 		// Starts the engine
 		void Run();
 
+		// Creates the deferred G-Buffer (compact layout read by deferred_lighting.frag)
+		static std::unique_ptr<Framebuffer> CreateGBuffer(unsigned int width, unsigned int height);
+
 	private:
 		void Init();
 		void MainLoop();
@@ -0,0 +1,63 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   FileUtils.cpp                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/16 11:32:10 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/16 11:32:10 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "Core/FileUtils.h"
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+
+namespace Engine {
+
+	bool FileUtils::IsCookedUpToDate(const std::string &source, const std::string &cooked) {
+		std::error_code error;
+		const auto cookedTime = std::filesystem::last_write_time(cooked, error);
+		if (error)
+			return false;
+		const auto sourceTime = std::filesystem::last_write_time(source, error);
+		return error || cookedTime >= sourceTime;
+	}
+
+	std::string FileUtils::CanonicalPath(const std::string &path) {
+		std::error_code error;
+		std::filesystem::path canonical = std::filesystem::weakly_canonical(path, error);
+		if (error)
+			canonical = std::filesystem::absolute(path, error).lexically_normal();
+		return canonical.string();
+	}
+
+	bool FileUtils::WriteAtomically(const std::string &path, const std::function<bool(std::ofstream &)> &write) {
+		const std::string tempPath = path + ".tmp";
+		{
+			std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+			if (!file) {
+				std::cerr << "[FileUtils] Cannot write: " << tempPath << std::endl;
+				return false;
+			}
+			if (!write(file) || !file.flush()) {
+				std::cerr << "[FileUtils] Failed writing: " << tempPath << std::endl;
+				file.close();
+				std::remove(tempPath.c_str());
+				return false;
+			}
+		}
+		// POSIX replaces the target atomically; Windows refuses an existing one, so drop it and retry
+		if (std::rename(tempPath.c_str(), path.c_str()) == 0)
+			return true;
+		std::remove(path.c_str());
+		if (std::rename(tempPath.c_str(), path.c_str()) == 0)
+			return true;
+		std::cerr << "[FileUtils] Cannot replace: " << path << std::endl;
+		std::remove(tempPath.c_str());
+		return false;
+	}
+
+} // namespace Engine
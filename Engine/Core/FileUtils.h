@@ -0,0 +1,56 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   FileUtils.h                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/16 11:32:10 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/16 11:32:10 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#pragma once
+
+/**
+ * @file FileUtils.h
+ * @brief File helpers shared by the loaders and cookers.
+ */
+
+#include <fstream>
+#include <functional>
+#include <string>
+
+namespace Engine {
+
+	/**
+	 * @class FileUtils
+	 * @brief Cooked-file freshness, cache keys and crash-safe writes.
+	 */
+	class FileUtils {
+	public:
+		/**
+		 * @brief Whether a cooked file exists and is at least as recent as its source (otherwise cook it again).
+		 *
+		 * A missing source keeps an existing cooked file usable.
+		 */
+		static bool IsCookedUpToDate(const std::string &source, const std::string &cooked);
+
+		/**
+		 * @brief Absolute, normalized form of a path, so different spellings of one file share a cache entry.
+		 */
+		static std::string CanonicalPath(const std::string &path);
+
+		/**
+		 * @brief Write a file through `path` + ".tmp", renamed over `path` once complete.
+		 *
+		 * A concurrent reader never sees a partial file, and a failed write leaves the
+		 * previous file in place.
+		 * @param write Fills the stream; returning false abandons the file.
+		 * @return false if the file cannot be written or renamed (the temporary file is removed).
+		 */
+		static bool WriteAtomically(const std::string &path, const std::function<bool(std::ofstream &)> &write);
+	};
+
+} // namespace Engine
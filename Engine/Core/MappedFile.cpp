@@ -0,0 +1,118 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   MappedFile.cpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/12 16:21:52 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/12 18:02:17 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#include "Core/MappedFile.h"
+#include <algorithm>
+#include <iostream>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Engine {
+
+#ifdef _WIN32
+	std::shared_ptr<MappedFile> MappedFile::Open(const std::string &path) {
+		HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return nullptr;
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+			CloseHandle(file);
+			return nullptr;
+		}
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		const void *data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+		if (!data) {
+			std::cerr << "[MappedFile] Cannot map: " << path << std::endl;
+			if (mapping)
+				CloseHandle(mapping);
+			CloseHandle(file);
+			return nullptr;
+		}
+
+		std::shared_ptr<MappedFile> mapped(new MappedFile());
+		mapped->m_Data	  = static_cast<const uint8_t *>(data);
+		mapped->m_Size	  = static_cast<size_t>(size.QuadPart);
+		mapped->m_File	  = file;
+		mapped->m_Mapping = mapping;
+		return mapped;
+	}
+
+	MappedFile::~MappedFile() {
+		if (m_Data)
+			UnmapViewOfFile(m_Data);
+		if (m_Mapping)
+			CloseHandle(static_cast<HANDLE>(m_Mapping));
+		if (m_File)
+			CloseHandle(static_cast<HANDLE>(m_File));
+	}
+
+	void MappedFile::Prefetch(size_t, size_t) const {
+		// The sequential-scan hint given at open time already drives read-ahead
+	}
+
+	void MappedFile::EvictFromCache(const std::string &) {
+		// No per-file equivalent of POSIX_FADV_DONTNEED
+	}
+#else
+	std::shared_ptr<MappedFile> MappedFile::Open(const std::string &path) {
+		const int fd = open(path.c_str(), O_RDONLY);
+		if (fd < 0)
+			return nullptr;
+		struct stat info;
+		if (fstat(fd, &info) != 0 || info.st_size == 0) {
+			close(fd);
+			return nullptr;
+		}
+		void *data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd); // The mapping keeps its own reference to the file
+		if (data == MAP_FAILED) {
+			std::cerr << "[MappedFile] Cannot map: " << path << std::endl;
+			return nullptr;
+		}
+
+		std::shared_ptr<MappedFile> mapped(new MappedFile());
+		mapped->m_Data = static_cast<const uint8_t *>(data);
+		mapped->m_Size = static_cast<size_t>(info.st_size);
+		return mapped;
+	}
+
+	MappedFile::~MappedFile() {
+		if (m_Data)
+			munmap(const_cast<uint8_t *>(m_Data), m_Size);
+	}
+
+	void MappedFile::Prefetch(size_t offset, size_t size) const {
+		// madvise needs a page-aligned start
+		const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+		const size_t begin	  = offset / pageSize * pageSize;
+		if (begin < m_Size)
+			madvise(const_cast<uint8_t *>(m_Data) + begin, std::min(m_Size - begin, size + (offset - begin)), MADV_WILLNEED);
+	}
+
+	void MappedFile::EvictFromCache(const std::string &path) {
+		const int fd = open(path.c_str(), O_RDONLY);
+		if (fd < 0)
+			return;
+		posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+		close(fd);
+	}
+#endif
+
+} // namespace Engine
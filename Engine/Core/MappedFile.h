@@ -0,0 +1,72 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   MappedFile.h                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/12 16:21:40 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/12 18:02:17 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#pragma once
+
+/**
+ * @file MappedFile.h
+ * @brief Read-only memory mapping of a whole file.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace Engine {
+
+	/**
+	 * @class MappedFile
+	 * @brief Maps a file read-only so its bytes can be used in place (no read() copy).
+	 *
+	 * Pages are loaded by the OS on first access and shared with its file cache, so a
+	 * warm load costs no I/O at all. The mapping lives as long as the object.
+	 */
+	class MappedFile {
+	public:
+		/**
+		 * @brief Map a file.
+		 * @return nullptr if the file cannot be opened or is empty.
+		 */
+		static std::shared_ptr<MappedFile> Open(const std::string &path);
+
+		~MappedFile();
+
+		MappedFile(const MappedFile &)			  = delete;
+		MappedFile &operator=(const MappedFile &) = delete;
+
+		const uint8_t *GetData() const { return m_Data; }
+		size_t GetSize() const { return m_Size; }
+
+		/**
+		 * @brief Ask the OS to read a range ahead (call from a worker before the bytes are used).
+		 */
+		void Prefetch(size_t offset, size_t size) const;
+
+		/**
+		 * @brief Drop a file's pages from the OS cache (best effort, for cold-load measurements).
+		 */
+		static void EvictFromCache(const std::string &path);
+
+	private:
+		MappedFile() = default;
+
+		const uint8_t *m_Data = nullptr; ///< First byte of the mapping.
+		size_t m_Size		  = 0;		 ///< File size in bytes.
+#ifdef _WIN32
+		void *m_File	= nullptr; ///< File handle.
+		void *m_Mapping = nullptr; ///< File mapping handle.
+#endif
+	};
+
+} // namespace Engine
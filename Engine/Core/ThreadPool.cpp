@@ -0,0 +1,109 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ThreadPool.cpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/05 09:47:18 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/05 11:20:33 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#include "Core/ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+
+namespace Engine {
+
+	ThreadPool::ThreadPool(unsigned int threadCount) {
+		if (threadCount == 0) {
+			unsigned int hardware = std::thread::hardware_concurrency();
+			threadCount			  = hardware > 1 ? hardware - 1 : 1;
+		}
+		m_Workers.reserve(threadCount);
+		for (unsigned int i = 0; i < threadCount; ++i) {
+			m_Workers.emplace_back(&ThreadPool::WorkerLoop, this);
+		}
+	}
+
+	ThreadPool::~ThreadPool() {
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Stop = true;
+		}
+		m_Condition.notify_all();
+		for (std::thread &worker : m_Workers) {
+			worker.join();
+		}
+	}
+
+	void ThreadPool::WorkerLoop() {
+		for (;;) {
+			std::function<void()> task;
+			{
+				std::unique_lock<std::mutex> lock(m_Mutex);
+				m_Condition.wait(lock, [this]() { return m_Stop || !m_Tasks.empty(); });
+				if (m_Stop && m_Tasks.empty())
+					return;
+				task = std::move(m_Tasks.front());
+				m_Tasks.pop();
+			}
+			task();
+		}
+	}
+
+	void ThreadPool::ParallelFor(int begin, int end, int grain, const std::function<void(int, int)> &body) {
+		if (end <= begin)
+			return;
+		grain = std::max(1, grain);
+
+		const int chunkCount = (end - begin + grain - 1) / grain;
+		if (chunkCount == 1) {
+			body(begin, end);
+			return;
+		}
+
+		// Shared so helpers that start after the caller returned still see valid state
+		struct State {
+			std::atomic<int> nextChunk{0};
+			std::atomic<int> doneChunks{0};
+			std::mutex mutex;
+			std::condition_variable finished;
+		};
+		auto state = std::make_shared<State>();
+
+		auto runChunks = [state, begin, end, grain, chunkCount, &body]() {
+			for (int chunk = state->nextChunk++; chunk < chunkCount; chunk = state->nextChunk++) {
+				const int chunkBegin = begin + chunk * grain;
+				body(chunkBegin, std::min(end, chunkBegin + grain));
+				if (++state->doneChunks == chunkCount) {
+					std::lock_guard<std::mutex> lock(state->mutex);
+					state->finished.notify_all();
+				}
+			}
+		};
+
+		// Helpers only touch `body` while chunks remain, i.e. before the caller returns
+		const int helpers = std::min<int>(chunkCount - 1, static_cast<int>(m_Workers.size()));
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			for (int i = 0; i < helpers; ++i) {
+				m_Tasks.emplace(runChunks);
+			}
+		}
+		m_Condition.notify_all();
+
+		runChunks();
+
+		std::unique_lock<std::mutex> lock(state->mutex);
+		state->finished.wait(lock, [&state, chunkCount]() { return state->doneChunks.load() == chunkCount; });
+	}
+
+	ThreadPool &ThreadPool::Get() {
+		static ThreadPool pool;
+		return pool;
+	}
+
+} // namespace Engine
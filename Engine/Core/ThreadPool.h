@@ -0,0 +1,105 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ThreadPool.h                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/05 09:47:12 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/05 11:20:33 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#pragma once
+
+/**
+ * @file ThreadPool.h
+ * @brief Fixed-size worker pool for CPU-side engine work (resampling, asset loading).
+ */
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Engine {
+
+	/**
+	 * @class ThreadPool
+	 * @brief Runs submitted tasks on a fixed set of worker threads.
+	 *
+	 * Usage:
+	 *   - Submit() queues a task and returns a future for its result.
+	 *   - ParallelFor() splits an index range into chunks; the calling thread takes part,
+	 *     so it is safe to call from inside a pool task.
+	 *   - Get() returns the engine-wide pool (hardware_concurrency - 1 workers).
+	 */
+	class ThreadPool {
+	public:
+		/**
+		 * @brief Start the workers.
+		 * @param threadCount Number of workers (0 = hardware_concurrency - 1, at least 1).
+		 */
+		explicit ThreadPool(unsigned int threadCount = 0);
+
+		/**
+		 * @brief Finish queued tasks and join the workers.
+		 */
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool &)			  = delete;
+		ThreadPool &operator=(const ThreadPool &) = delete;
+
+		/**
+		 * @brief Queue a task.
+		 * @param task Callable with no arguments.
+		 * @return Future holding the task's result (or exception).
+		 */
+		template <typename F>
+		auto Submit(F &&task) -> std::future<std::invoke_result_t<std::decay_t<F>>>;
+
+		/**
+		 * @brief Run body(chunkBegin, chunkEnd) over [begin, end) in chunks of `grain` indices.
+		 *
+		 * Blocks until every chunk is done. Chunks never overlap, so writes to disjoint
+		 * outputs need no synchronisation, and results do not depend on the thread count.
+		 */
+		void ParallelFor(int begin, int end, int grain, const std::function<void(int, int)> &body);
+
+		unsigned int GetThreadCount() const { return static_cast<unsigned int>(m_Workers.size()); }
+
+		/**
+		 * @brief Engine-wide pool, created on first use.
+		 */
+		static ThreadPool &Get();
+
+	private:
+		void WorkerLoop();
+
+		std::vector<std::thread> m_Workers;			///< Worker threads.
+		std::queue<std::function<void()>> m_Tasks; ///< Pending tasks.
+		std::mutex m_Mutex;							///< Protects m_Tasks and m_Stop.
+		std::condition_variable m_Condition;		///< Signals new tasks / shutdown.
+		bool m_Stop = false;						///< Set by the destructor.
+	};
+
+	template <typename F>
+	auto ThreadPool::Submit(F &&task) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+		using Result  = std::invoke_result_t<std::decay_t<F>>;
+		auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+		std::future<Result> future = packaged->get_future();
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Tasks.emplace([packaged]() { (*packaged)(); });
+		}
+		m_Condition.notify_one();
+		return future;
+	}
+
+} // namespace Engine
@@ -16,6 +16,31 @@
 
 namespace Engine {
 
+	/// Bytes per texel for the color formats used by the engine's render targets.
+	static unsigned int BytesPerTexel(unsigned int internalFormat) {
+		switch (internalFormat) {
+		case GL_R8: return 1;
+		case GL_RG8:
+		case GL_R16:
+		case GL_R16F: return 2;
+		case GL_RGBA:
+		case GL_RGBA8:
+		case GL_SRGB8_ALPHA8:
+		case GL_RG16:
+		case GL_RG16F:
+		case GL_R32F:
+		case GL_R11F_G11F_B10F:
+		case GL_RGB10_A2: return 4;
+		case GL_RGB16F: return 6;
+		case GL_RGBA16:
+		case GL_RGBA16F:
+		case GL_RG32F: return 8;
+		case GL_RGB32F: return 12;
+		case GL_RGBA32F: return 16;
+		default: return 4;
+		}
+	}
+
 	Framebuffer::Framebuffer(unsigned int w, unsigned int h)
 		: m_Width(w), m_Height(h) {
 		glGenFramebuffers(1, &m_FBO);
@@ -27,6 +52,8 @@ namespace Engine {
 			glDeleteTextures(1, &tex);
 		if (m_RBO)
 			glDeleteRenderbuffers(1, &m_RBO);
+		if (m_DepthTexture)
+			glDeleteTextures(1, &m_DepthTexture);
 	}
 
 	void Framebuffer::AddColorTexture(unsigned int internalFormat, unsigned int format, unsigned int type) {
@@ -38,6 +65,7 @@ namespace Engine {
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 		m_ColorAttachments.push_back(tex);
+		m_ColorBytesPerPixel += BytesPerTexel(internalFormat);
 	}
 
 	void Framebuffer::AddDepthStencil() {
@@ -47,6 +75,17 @@ namespace Engine {
 		glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, m_Width, m_Height);
 	}
 
+	void Framebuffer::AddDepthTexture() {
+		// Create a depth-stencil texture attachment that later passes can sample
+		glGenTextures(1, &m_DepthTexture);
+		glBindTexture(GL_TEXTURE_2D, m_DepthTexture);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH24_STENCIL8, m_Width, m_Height, 0, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, nullptr);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	}
+
 	void Framebuffer::Build() {
 		// Attach all color textures and optional depth-stencil to the FBO
 		glBindFramebuffer(GL_FRAMEBUFFER, m_FBO);
@@ -57,6 +96,8 @@ namespace Engine {
 
 		if (m_RBO) {
 			glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_RBO);
+		} else if (m_DepthTexture) {
+			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, m_DepthTexture, 0);
 		}
 
 		// Specify draw buffers for multiple render targets
@@ -84,4 +125,9 @@ namespace Engine {
 		return m_ColorAttachments.at(idx);
 	}
 
+	unsigned int Framebuffer::GetBytesPerPixel(bool includeDepth) const {
+		bool hasDepth = m_RBO != 0 || m_DepthTexture != 0;
+		return m_ColorBytesPerPixel + (includeDepth && hasDepth ? 4u : 0u); // D24S8
+	}
+
 } // namespace Engine
@@ -28,7 +28,7 @@ namespace Engine {
 	 * Usage:
 	 *   1. Create Framebuffer with width/height.
 	 *   2. AddColorTexture() for each color attachment needed.
-	 *   3. Optionally AddDepthStencil().
+	 *   3. Optionally AddDepthStencil(), or AddDepthTexture() when depth must be sampled.
 	 *   4. Call Build() to allocate and attach resources.
 	 *   5. Bind()/Unbind() for rendering.
 	 */
@@ -67,6 +67,12 @@ namespace Engine {
 		 */
 		void AddDepthStencil();
 
+		/**
+		 * @brief Add a sampleable depth+stencil texture attachment (GL_DEPTH24_STENCIL8).
+		 * Use instead of AddDepthStencil() when a later pass reads depth (e.g. position reconstruction).
+		 */
+		void AddDepthTexture();
+
 		/**
 		 * @brief Finalize and allocate all attachments. Must be called after adding attachments.
 		 * @throws std::runtime_error if framebuffer is incomplete.
@@ -91,6 +97,18 @@ namespace Engine {
 		 */
 		GLuint GetColorAttachment(unsigned int idx = 0) const;
 
+		/**
+		 * @brief Get OpenGL texture ID of the depth attachment.
+		 * @return Texture ID, or 0 if AddDepthTexture() was not called.
+		 */
+		GLuint GetDepthAttachment() const;
+
+		/**
+		 * @brief Memory footprint of one pixel across all attachments, in bytes.
+		 * @param includeDepth Whether the depth/stencil attachment is counted.
+		 */
+		unsigned int GetBytesPerPixel(bool includeDepth = true) const;
+
 		/**
 		 * @brief Get OpenGL FBO ID.
 		 * @return FBO handle, or 0 if not built.
@@ -111,12 +129,18 @@ namespace Engine {
 		GLuint m_FBO = 0;						///< OpenGL Framebuffer Object handle
 		unsigned int m_Width, m_Height;			///< Dimensions of attachments
 		std::vector<GLuint> m_ColorAttachments; ///< Texture IDs for color attachments
-		GLuint m_RBO   = 0;						///< Renderbuffer for depth/stencil
+		unsigned int m_ColorBytesPerPixel = 0;	///< Sum of color attachment texel sizes
+		GLuint m_RBO		  = 0;				///< Renderbuffer for depth/stencil
+		GLuint m_DepthTexture = 0;				///< Sampleable depth/stencil texture (alternative to m_RBO)
 		bool m_IsBuilt = false;					///< True if Build() succeeded
 	};
 
 	// --- Inline implementations ---
 
+	inline GLuint Framebuffer::GetDepthAttachment() const {
+		return m_DepthTexture;
+	}
+
 	inline GLuint Framebuffer::GetID() const {
 		return m_FBO;
 	}
@@ -0,0 +1,67 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   GPUQuery.cpp                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/04 14:12:41 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/16 10:58:20 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#include "Renderer/GPUResources/GPUQuery.h"
+
+namespace Engine {
+
+	GPUQuery::GPUQuery(GLenum target)
+		: m_Target(target) {
+		glGenQueries(QUERY_COUNT, m_Queries);
+	}
+
+	GPUQuery::~GPUQuery() {
+		glDeleteQueries(QUERY_COUNT, m_Queries);
+	}
+
+	void GPUQuery::Begin() {
+		if (m_Pending == QUERY_COUNT) {
+			// Ring full: drop the oldest result rather than reusing an active query
+			GLuint64 discarded = 0;
+			glGetQueryObjectui64v(m_Queries[m_Read], GL_QUERY_RESULT, &discarded);
+			m_Read = (m_Read + 1) % QUERY_COUNT;
+			--m_Pending;
+		}
+		glBeginQuery(m_Target, m_Queries[m_Write]);
+	}
+
+	void GPUQuery::End() {
+		glEndQuery(m_Target);
+		m_Write = (m_Write + 1) % QUERY_COUNT;
+		++m_Pending;
+	}
+
+	bool GPUQuery::GetResult(uint64_t &result) {
+		if (m_Pending == 0)
+			return false;
+
+		GLint available = 0;
+		glGetQueryObjectiv(m_Queries[m_Read], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available)
+			return false;
+
+		GLuint64 value = 0;
+		glGetQueryObjectui64v(m_Queries[m_Read], GL_QUERY_RESULT, &value);
+		result = static_cast<uint64_t>(value);
+		m_Read = (m_Read + 1) % QUERY_COUNT;
+		--m_Pending;
+		return true;
+	}
+
+	void GPUQuery::Discard() {
+		// A query whose result was never read can be begun again
+		m_Read	  = m_Write;
+		m_Pending = 0;
+	}
+
+} // namespace Engine
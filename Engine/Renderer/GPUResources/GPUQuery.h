@@ -0,0 +1,86 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   GPUQuery.h                                         :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/04 14:12:37 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/16 10:58:20 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#pragma once
+
+/**
+ * @file GPUQuery.h
+ * @brief Non-blocking OpenGL query object wrapper (timer, occlusion, primitives).
+ */
+
+#include <cstdint>
+#include <glad/glad.h>
+
+namespace Engine {
+
+	/**
+	 * @class GPUQuery
+	 * @brief Ring of OpenGL query objects read back without stalling the pipeline.
+	 *
+	 * Each Begin()/End() pair uses the next query of the ring; GetResult() returns the
+	 * oldest finished one, so results typically arrive a frame or two late.
+	 *
+	 * Usage:
+	 *   - Construct with a query target (GL_TIME_ELAPSED, GL_SAMPLES_PASSED, ...).
+	 *   - Wrap the GPU work with Begin()/End() once per frame.
+	 *   - Poll GetResult() every frame.
+	 */
+	class GPUQuery {
+	public:
+		/**
+		 * @brief Create the query ring.
+		 * @param target OpenGL query target.
+		 */
+		explicit GPUQuery(GLenum target);
+
+		/**
+		 * @brief Delete the query objects.
+		 */
+		~GPUQuery();
+
+		GPUQuery(const GPUQuery &)			  = delete;
+		GPUQuery &operator=(const GPUQuery &) = delete;
+
+		/**
+		 * @brief Start measuring. If every query of the ring is still in flight, the oldest is read back (blocking) and dropped.
+		 */
+		void Begin();
+
+		/**
+		 * @brief Stop measuring.
+		 */
+		void End();
+
+		/**
+		 * @brief Fetch the oldest available result without blocking.
+		 * @param result Query result (nanoseconds for GL_TIME_ELAPSED, samples for GL_SAMPLES_PASSED).
+		 * @return True if a result was available.
+		 */
+		bool GetResult(uint64_t &result);
+
+		/**
+		 * @brief Drop every query in flight without reading it (e.g. after the measured setup changed).
+		 */
+		void Discard();
+
+	private:
+		static constexpr int QUERY_COUNT = 4; ///< Frames a query may stay in flight.
+
+		GLuint m_Queries[QUERY_COUNT] = {}; ///< Query object handles.
+		GLenum m_Target				  = 0;	///< Query target.
+		int m_Write					  = 0;	///< Next query to begin.
+		int m_Read					  = 0;	///< Oldest query in flight.
+		int m_Pending				  = 0;	///< Number of queries in flight.
+	};
+
+} // namespace Engine
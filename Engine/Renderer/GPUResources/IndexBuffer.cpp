@@ -6,21 +6,42 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/04/26 11:54:47 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/04/29 00:52:08 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2025/05/16 11:33:55 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "IndexBuffer.h"
+#include <algorithm>
+#include <cstdint>
 #include <glad/glad.h>
+#include <vector>
 
 namespace Engine {
 
-	// Construct and upload index data to GPU
-	IndexBuffer::IndexBuffer(unsigned int *indices, unsigned int count)
-		: m_Count(count) {
+	// Construct and upload index data to GPU (16-bit when every index fits)
+	IndexBuffer::IndexBuffer(const unsigned int *indices, unsigned int count)
+		: m_Count(count), m_IndexType(GL_UNSIGNED_INT), m_IndexSize(sizeof(unsigned int)) {
 		glGenBuffers(1, &m_RendererID);
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(unsigned int), indices, GL_STATIC_DRAW);
+
+		const unsigned int maxIndex = count > 0 ? *std::max_element(indices, indices + count) : 0;
+		if (maxIndex <= 0xFFFFu) {
+			const std::vector<uint16_t> shortIndices(indices, indices + count);
+			m_IndexType = GL_UNSIGNED_SHORT;
+			m_IndexSize = sizeof(uint16_t);
+			glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(uint16_t), shortIndices.data(), GL_STATIC_DRAW);
+		} else {
+			glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(unsigned int), indices, GL_STATIC_DRAW);
+		}
+	}
+
+	// Upload indices as stored, without narrowing them
+	IndexBuffer::IndexBuffer(const void *indices, unsigned int count, unsigned int indexSize)
+		: m_Count(count), m_IndexType(indexSize == sizeof(uint16_t) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT),
+		  m_IndexSize(indexSize == sizeof(uint16_t) ? sizeof(uint16_t) : sizeof(unsigned int)) {
+		glGenBuffers(1, &m_RendererID);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * m_IndexSize, indices, GL_STATIC_DRAW);
 	}
 
 	// Free GPU buffer
@@ -6,7 +6,7 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/04/26 11:54:42 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/04/29 00:51:21 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2025/05/16 11:33:55 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -25,10 +25,22 @@ namespace Engine {
 	public:
 		/**
 		 * @brief Creates an index buffer and uploads index data to the GPU.
+		 *
+		 * Stored as 16-bit indices when every index fits (meshes under 65,536 vertices).
+		 *
 		 * @param indices Pointer to index data (array of unsigned ints).
 		 * @param count Number of indices in the array.
 		 */
-		IndexBuffer(unsigned int *indices, unsigned int count);
+		IndexBuffer(const unsigned int *indices, unsigned int count);
+
+		/**
+		 * @brief Creates an index buffer from indices already at their stored width (e.g. a cooked file).
+		 *
+		 * @param indices Pointer to index data.
+		 * @param count Number of indices in the array.
+		 * @param indexSize Bytes per index: 2 (uploaded as 16-bit) or 4.
+		 */
+		IndexBuffer(const void *indices, unsigned int count, unsigned int indexSize);
 
 		/**
 		 * @brief Destroys the index buffer and frees GPU resources.
@@ -51,9 +63,21 @@ namespace Engine {
 		 */
 		inline unsigned int GetCount() const { return m_Count; }
 
+		/**
+		 * @brief GL type of the stored indices (GL_UNSIGNED_SHORT or GL_UNSIGNED_INT).
+		 */
+		inline unsigned int GetIndexType() const { return m_IndexType; }
+
+		/**
+		 * @brief Bytes per stored index (2 or 4).
+		 */
+		inline unsigned int GetIndexSize() const { return m_IndexSize; }
+
 	private:
 		unsigned int m_RendererID; ///< OpenGL buffer object handle.
 		unsigned int m_Count;	   ///< Number of indices in the buffer.
+		unsigned int m_IndexType;  ///< GL_UNSIGNED_SHORT or GL_UNSIGNED_INT.
+		unsigned int m_IndexSize;  ///< Bytes per index.
 	};
 
 } // namespace Engine
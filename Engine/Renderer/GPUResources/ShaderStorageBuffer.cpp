@@ -0,0 +1,50 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ShaderStorageBuffer.cpp                            :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/03 10:21:14 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/03 11:02:51 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "ShaderStorageBuffer.h"
+#include <glad/glad.h>
+
+namespace Engine {
+
+	// Creates an SSBO of given capacity and binds it to a binding point
+	ShaderStorageBuffer::ShaderStorageBuffer(unsigned int size, unsigned int binding)
+		: m_Capacity(size), m_Binding(binding) {
+		glGenBuffers(1, &m_RendererID);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_RendererID);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, m_Capacity, nullptr, GL_DYNAMIC_DRAW);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, m_Binding, m_RendererID);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	}
+
+	ShaderStorageBuffer::~ShaderStorageBuffer() {
+		glDeleteBuffers(1, &m_RendererID);
+	}
+
+	// Upload data, reallocating (doubling) the storage when it does not fit
+	void ShaderStorageBuffer::SetData(unsigned int size, const void *data) {
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_RendererID);
+		if (size > m_Capacity) {
+			while (m_Capacity < size)
+				m_Capacity = m_Capacity ? m_Capacity * 2 : size;
+			glBufferData(GL_SHADER_STORAGE_BUFFER, m_Capacity, nullptr, GL_DYNAMIC_DRAW);
+		}
+		glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, size, data);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+		BindBase();
+	}
+
+	// Bind the buffer to its indexed binding point
+	void ShaderStorageBuffer::BindBase() const {
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, m_Binding, m_RendererID);
+	}
+
+} // namespace Engine
@@ -0,0 +1,69 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ShaderStorageBuffer.h                              :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/03 10:21:06 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/03 11:02:48 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma once
+
+/**
+ * @file ShaderStorageBuffer.h
+ * @brief OpenGL Shader Storage Buffer Object (SSBO) abstraction for variable-size GPU arrays.
+ *
+ * Used for per-instance data (e.g. instance transforms) indexed with gl_InstanceID.
+ */
+
+namespace Engine {
+
+	/**
+	 * @class ShaderStorageBuffer
+	 * @brief RAII wrapper for OpenGL Shader Storage Buffer Objects (SSBOs).
+	 *
+	 * Usage:
+	 *   - Construct with an initial capacity (bytes) and binding point.
+	 *   - Use SetData() to upload; the buffer grows when the data does not fit.
+	 */
+	class ShaderStorageBuffer {
+	public:
+		/**
+		 * @brief Create a Shader Storage Buffer Object.
+		 * @param size    Initial capacity of the buffer in bytes.
+		 * @param binding Binding point index (matches shader layout(binding = N)).
+		 */
+		ShaderStorageBuffer(unsigned int size, unsigned int binding);
+
+		/**
+		 * @brief Destroy the buffer and free GPU resources.
+		 */
+		~ShaderStorageBuffer();
+
+		ShaderStorageBuffer(const ShaderStorageBuffer &)			= delete;
+		ShaderStorageBuffer &operator=(const ShaderStorageBuffer &) = delete;
+
+		/**
+		 * @brief Upload data at the start of the buffer, growing it if needed.
+		 * @param size Number of bytes to upload.
+		 * @param data Pointer to source data.
+		 */
+		void SetData(unsigned int size, const void *data);
+
+		/**
+		 * @brief Re-attach this buffer to its binding point.
+		 */
+		void BindBase() const;
+
+		unsigned int GetCapacity() const { return m_Capacity; }
+
+	private:
+		unsigned int m_RendererID = 0; ///< OpenGL buffer object handle.
+		unsigned int m_Capacity	  = 0; ///< Allocated size in bytes.
+		unsigned int m_Binding	  = 0; ///< SSBO binding point.
+	};
+
+} // namespace Engine
@@ -6,7 +6,7 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/04/26 11:54:36 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/04/29 00:49:56 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2025/05/13 18:36:44 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -16,7 +16,7 @@
 namespace Engine {
 
 	// Create a vertex buffer and upload data to GPU
-	VertexBuffer::VertexBuffer(float *vertices, unsigned int size) {
+	VertexBuffer::VertexBuffer(const float *vertices, unsigned int size) {
 		glGenBuffers(1, &m_RendererID);
 		glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
 		glBufferData(GL_ARRAY_BUFFER, size, vertices, GL_STATIC_DRAW);
@@ -37,4 +37,10 @@ namespace Engine {
 		glBindBuffer(GL_ARRAY_BUFFER, 0);
 	}
 
+	// Update a range of the buffer
+	void VertexBuffer::SetData(const void *data, unsigned int size, unsigned int offset) const {
+		glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+		glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
+	}
+
 } // namespace Engine
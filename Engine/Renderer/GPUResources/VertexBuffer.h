@@ -6,7 +6,7 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/04/26 11:54:02 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/04/29 00:50:25 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2025/05/13 18:36:44 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -24,10 +24,10 @@ namespace Engine {
 	public:
 		/**
 		 * @brief Creates a vertex buffer and uploads data to the GPU.
-		 * @param vertices Pointer to vertex data (array of floats).
+		 * @param vertices Pointer to vertex data (array of floats), or nullptr to only allocate.
 		 * @param size Size of the data in bytes.
 		 */
-		VertexBuffer(float *vertices, unsigned int size);
+		VertexBuffer(const float *vertices, unsigned int size);
 
 		/**
 		 * @brief Destroys the vertex buffer and frees GPU resources.
@@ -44,6 +44,14 @@ namespace Engine {
 		 */
 		void Unbind() const;
 
+		/**
+		 * @brief Overwrites part of the buffer (binds it to GL_ARRAY_BUFFER).
+		 * @param data Source bytes.
+		 * @param size Number of bytes.
+		 * @param offset Byte offset in the buffer.
+		 */
+		void SetData(const void *data, unsigned int size, unsigned int offset = 0) const;
+
 	private:
 		unsigned int m_RendererID; ///< OpenGL buffer object handle.
 	};
@@ -6,41 +6,402 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/04/26 12:26:54 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/04/29 00:58:48 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2025/05/16 11:33:55 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "Mesh.h"
+#include "MeshletBuilder.h"
 #include "Renderer/GPUResources/IndexBuffer.h"
 #include "Renderer/GPUResources/VertexArray.h"
 #include "Renderer/GPUResources/VertexBuffer.h"
 #include "Renderer/Shaders/Shader.h"
+#include <algorithm>
+#include <cmath>
 #include <glad/glad.h>
+#include <glm/gtc/packing.hpp>
 #include <iostream> // For debugging
 
 namespace Engine {
 
-	Mesh::Mesh(const std::vector<Vertex> &vertices, const std::vector<unsigned int> &indices)
-		: m_Vertices(vertices), m_Indices(indices) {
-		// Debug print for mesh creation
-		// std::cout << "  Mesh::Mesh - Creating mesh with " << m_Vertices.size() << " vertices and " << m_Indices.size() << " indices." << std::endl;
-		if (m_Vertices.empty() || m_Indices.empty()) {
+	namespace {
+		VertexFormat s_DefaultVertexFormat = VertexFormat::Full;
+		Mesh::DrawStats s_DrawStats;
+		size_t s_MeshletMinTriangles = 0;
+
+		// Visible ranges of a culled draw (GL thread only)
+		std::vector<GLsizei> s_RangeCounts;
+		std::vector<const void *> s_RangeOffsets;
+		std::vector<GLint> s_RangeBaseVertices;
+
+		// Attribute locations of the compact layout and of the position decode (see Common/vertex.glsl)
+		constexpr GLuint OctNormalLocation		= 9;
+		constexpr GLuint OctTangentLocation		= 10;
+		constexpr GLuint PositionScaleLocation	= 11;
+		constexpr GLuint PositionOffsetLocation = 12;
+
+		// Keeps an attribute on its first element for every vertex and instance (a per-mesh constant)
+		constexpr GLuint ConstantAttributeDivisor = 0xFFFFFFFFu;
+
+		// Unit vector -> [-1, 1]^2 (inverse of OctDecode in packing.glsl)
+		glm::vec2 OctEncode(const glm::vec3 &n) {
+			const float sum = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+			if (sum <= 0.0f)
+				return glm::vec2(0.0f);
+			const glm::vec2 p(n.x / sum, n.y / sum);
+			if (n.z >= 0.0f)
+				return p;
+			return glm::vec2((1.0f - std::abs(p.y)) * (p.x >= 0.0f ? 1.0f : -1.0f), (1.0f - std::abs(p.x)) * (p.y >= 0.0f ? 1.0f : -1.0f));
+		}
+
+		int16_t PackSnorm16(float value) {
+			return static_cast<int16_t>(glm::packSnorm1x16(value));
+		}
+	} // namespace
+
+	/// VAO, vertex and index buffers of a mesh, held in a single allocation.
+	struct Mesh::GPUBuffers {
+		VertexArray vertexArray;
+		VertexBuffer vertexBuffer;
+		IndexBuffer indexBuffer;
+
+		// The VAO is bound before the index buffer is created so the element binding lands in it
+		GPUBuffers(unsigned int vertexBytes, const unsigned int *indices, unsigned int indexCount)
+			: vertexBuffer(nullptr, vertexBytes), indexBuffer((vertexArray.Bind(), indices), indexCount) {}
+		GPUBuffers(unsigned int vertexBytes, const void *indices, unsigned int indexCount, unsigned int indexSize)
+			: vertexBuffer(nullptr, vertexBytes), indexBuffer((vertexArray.Bind(), indices), indexCount, indexSize) {}
+	};
+
+	Mesh::Mesh(const std::vector<Vertex> &vertices, const std::vector<unsigned int> &indices, VertexFormat format, bool keepCpuCopy)
+		: m_Format(format) {
+		Create(vertices.data(), vertices.size(), indices.data(), indices.size());
+		if (keepCpuCopy) {
+			m_Vertices = vertices;
+			m_Indices  = indices;
+		}
+	}
+
+	Mesh::Mesh(std::vector<Vertex> &&vertices, std::vector<unsigned int> &&indices, VertexFormat format, bool keepCpuCopy)
+		: m_Format(format) {
+		Create(vertices.data(), vertices.size(), indices.data(), indices.size());
+		if (keepCpuCopy) {
+			m_Vertices = std::move(vertices);
+			m_Indices  = std::move(indices);
+		}
+	}
+
+	Mesh::Mesh(const Vertex *vertices, size_t vertexCount, const unsigned int *indices, size_t indexCount, const MeshMetrics &metrics,
+			   const std::vector<MeshLod> &lods, VertexFormat format, bool keepCpuCopy)
+		: m_Format(format), m_Metrics(metrics) {
+		if (vertexCount == 0 || indexCount == 0) {
 			std::cerr << "Warning: Creating Mesh with empty vertices or indices!" << std::endl;
 		}
-		SetupMesh();
+		if (keepCpuCopy) {
+			m_Vertices.assign(vertices, vertices + vertexCount);
+			m_Indices.assign(indices, indices + indexCount);
+		}
+		SetupMesh(vertices, vertexCount, indices, indexCount);
+		SetLods(lods);
+		BuildMeshlets(vertices, vertexCount, indices);
+	}
+
+	Mesh::Mesh(const PackedMeshView &geometry, const MeshMetrics &metrics, const std::vector<MeshLod> &lods, const std::vector<Meshlet> &meshlets)
+		: m_Format(geometry.format), m_Metrics(metrics) {
+		if (geometry.vertexCount == 0 || geometry.indexCount == 0) {
+			std::cerr << "Warning: Creating Mesh with empty vertices or indices!" << std::endl;
+		}
+		m_IndexCount = geometry.indexCount;
+		m_Buffers	 = UploadPacked(geometry);
+		const size_t vertexStride = m_Format == VertexFormat::Compact ? sizeof(CompactVertex) : sizeof(Vertex);
+		m_GPUBytes = geometry.vertexCount * vertexStride + 2 * sizeof(glm::vec4) + geometry.indexCount * m_Buffers->indexBuffer.GetIndexSize();
+		SetLods(lods);
+
+		// Same threshold as BuildMeshlets(); the clusters were built when the file was cooked
+		const MeshLod &full = m_Lods.front();
+		if (s_MeshletMinTriangles != 0 && full.indexCount / 3 >= s_MeshletMinTriangles)
+			m_Meshlets = meshlets;
 	}
 
 	Mesh::~Mesh() {
 		// std::cout << "  Mesh::~Mesh - Destroying mesh." << std::endl; // Optional: Check destruction
 	}
 
-	void Mesh::SetupMesh() {
+	Mesh::Mesh(Mesh &&) noexcept			= default;
+	Mesh &Mesh::operator=(Mesh &&) noexcept = default;
+
+	// Metrics, GPU buffers and meshlets of geometry given as arrays
+	void Mesh::Create(const Vertex *vertices, size_t vertexCount, const unsigned int *indices, size_t indexCount) {
+		// Debug print for mesh creation
+		// std::cout << "  Mesh::Mesh - Creating mesh with " << vertexCount << " vertices and " << indexCount << " indices." << std::endl;
+		if (vertexCount == 0 || indexCount == 0) {
+			std::cerr << "Warning: Creating Mesh with empty vertices or indices!" << std::endl;
+		}
+		m_Metrics = ComputeMetrics(vertices, vertexCount, indices, indexCount);
+		SetupMesh(vertices, vertexCount, indices, indexCount);
+		BuildMeshlets(vertices, vertexCount, indices);
+	}
+
+	void Mesh::SetDefaultVertexFormat(VertexFormat format) {
+		s_DefaultVertexFormat = format;
+	}
+
+	VertexFormat Mesh::GetDefaultVertexFormat() {
+		return s_DefaultVertexFormat;
+	}
+
+	void Mesh::SetMeshletMinTriangles(size_t triangles) {
+		s_MeshletMinTriangles = triangles;
+	}
+
+	size_t Mesh::GetMeshletMinTriangles() {
+		return s_MeshletMinTriangles;
+	}
+
+	const Mesh::DrawStats &Mesh::GetDrawStats() {
+		return s_DrawStats;
+	}
+
+	void Mesh::ResetDrawStats() {
+		s_DrawStats = DrawStats();
+	}
+
+	void Mesh::SetLods(const std::vector<MeshLod> &lods) {
+		m_Lods.clear();
+		for (const MeshLod &lod : lods) {
+			if (m_Lods.size() == MaxLods || uint64_t(lod.firstIndex) + lod.indexCount > m_IndexCount) {
+				std::cerr << "[Mesh] Ignoring level of detail " << m_Lods.size() << " (out of range)" << std::endl;
+				break;
+			}
+			m_Lods.push_back(lod);
+		}
+		if (m_Lods.empty())
+			m_Lods.push_back({0, static_cast<uint32_t>(m_IndexCount), 0.0f});
+	}
+
+	void Mesh::BuildMeshlets(const Vertex *vertices, size_t vertexCount, const unsigned int *indices) {
+		const MeshLod &full = m_Lods.front();
+		if (s_MeshletMinTriangles == 0 || full.indexCount / 3 < s_MeshletMinTriangles)
+			return;
+		m_Meshlets = MeshletBuilder::Build(vertices, vertexCount, indices, full.firstIndex, full.indexCount);
+	}
+
+	ClusterCullView ClusterCullView::FromViewProjection(const glm::mat4 &viewProjection, const glm::vec3 &viewPosition, bool cullBackfaces) {
+		ClusterCullView result;
+
+		// Gribb-Hartmann, as in TextureResidency::View::FromCamera()
+		auto row = [&viewProjection](int r) {
+			return glm::vec4(viewProjection[0][r], viewProjection[1][r], viewProjection[2][r], viewProjection[3][r]);
+		};
+		for (int axis = 0; axis < 3; ++axis) {
+			result.frustumPlanes[axis * 2]	   = row(3) + row(axis);
+			result.frustumPlanes[axis * 2 + 1] = row(3) - row(axis);
+		}
+		for (glm::vec4 &plane : result.frustumPlanes)
+			plane /= glm::length(glm::vec3(plane));
+
+		// Orthographic projections leave w = 1; the near plane normal is then the viewing direction
+		const glm::vec4 w	 = row(3);
+		result.orthographic	 = w.x == 0.0f && w.y == 0.0f && w.z == 0.0f;
+		result.viewDirection = glm::vec3(result.frustumPlanes[4]);
+		result.viewPosition	 = viewPosition;
+		result.cullBackfaces = cullBackfaces;
+		return result;
+	}
+
+	ClusterCullView ClusterCullView::ToObjectSpace(const glm::mat4 &model) const {
+		ClusterCullView result = *this;
+
+		// dot(plane, model * p) = dot(transpose(model) * plane, p): distances stay in world units
+		const glm::mat4 transposed = glm::transpose(model);
+		for (glm::vec4 &plane : result.frustumPlanes)
+			plane = transposed * plane;
+
+		const glm::vec3 scale(glm::length(glm::vec3(model[0])), glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2])));
+		const float maxScale = std::max({scale.x, scale.y, scale.z});
+		const float minScale = std::min({scale.x, scale.y, scale.z});
+		result.radiusScale	 = maxScale;
+		if (maxScale - minScale > 0.01f * maxScale)
+			result.cullBackfaces = false;
+
+		const glm::mat4 inverse = glm::inverse(model);
+		result.viewPosition		= glm::vec3(inverse * glm::vec4(viewPosition, 1.0f));
+		result.viewDirection	= glm::normalize(glm::vec3(inverse * glm::vec4(viewDirection, 0.0f)));
+		return result;
+	}
+
+	MeshMetrics Mesh::ComputeMetrics(const Vertex *vertices, size_t vertexCount, const unsigned int *indices, size_t indexCount) {
+		MeshMetrics metrics;
+		if (vertexCount == 0)
+			return metrics;
+
+		// Bounding sphere around the AABB center (cheap, slightly loose)
+		glm::vec3 minBounds = vertices[0].Position;
+		glm::vec3 maxBounds = vertices[0].Position;
+		for (size_t i = 0; i < vertexCount; ++i) {
+			minBounds = glm::min(minBounds, vertices[i].Position);
+			maxBounds = glm::max(maxBounds, vertices[i].Position);
+		}
+		metrics.boundsCenter = (minBounds + maxBounds) * 0.5f;
+		float radius2		 = 0.0f;
+		for (size_t i = 0; i < vertexCount; ++i) {
+			const glm::vec3 offset = vertices[i].Position - metrics.boundsCenter;
+			radius2				   = std::max(radius2, glm::dot(offset, offset));
+		}
+		metrics.boundsRadius = std::sqrt(radius2);
+
+		// Surface area over UV area gives the squared length mapped to one UV unit
+		double surfaceArea = 0.0;
+		double uvArea	   = 0.0;
+		for (size_t i = 0; i + 2 < indexCount; i += 3) {
+			const Vertex &a = vertices[indices[i]];
+			const Vertex &b = vertices[indices[i + 1]];
+			const Vertex &c = vertices[indices[i + 2]];
+			surfaceArea += 0.5 * glm::length(glm::cross(b.Position - a.Position, c.Position - a.Position));
+			const glm::vec2 uv1 = b.TexCoords - a.TexCoords;
+			const glm::vec2 uv2 = c.TexCoords - a.TexCoords;
+			uvArea += 0.5 * std::abs(uv1.x * uv2.y - uv1.y * uv2.x);
+		}
+		metrics.worldUnitsPerUV = uvArea > 1e-12 ? static_cast<float>(std::sqrt(surfaceArea / uvArea)) : 0.0f;
+		return metrics;
+	}
+
+	void Mesh::SetupMesh(const Vertex *vertices, size_t vertexCount, const unsigned int *indices, size_t indexCount) {
 		// std::cout << "    Mesh::SetupMesh - Setting up VAO/VBO/IBO..." << std::endl; // Debug print
-		m_VertexArray = std::make_shared<VertexArray>();
-		m_VertexArray->Bind();
+		m_IndexCount = indexCount;
+		m_Lods		 = {{0, static_cast<uint32_t>(indexCount), 0.0f}};
+		m_Buffers	 = UploadBuffers(vertices, vertexCount, indices, indexCount, m_Format);
+
+		const size_t vertexStride = m_Format == VertexFormat::Compact ? sizeof(CompactVertex) : sizeof(Vertex);
+		m_GPUBytes = vertexCount * vertexStride + 2 * sizeof(glm::vec4) + indexCount * m_Buffers->indexBuffer.GetIndexSize();
+		// std::cout << "    Mesh::SetupMesh - Setup complete." << std::endl; // Debug print
+	}
+
+	void Mesh::CompactVertices(const Vertex *vertices, size_t vertexCount, std::vector<CompactVertex> &compact, glm::vec4 (&positionDecode)[2]) {
+		compact.resize(vertexCount);
+		positionDecode[0] = glm::vec4(1.0f); // w = 1 selects the compact decode
+		positionDecode[1] = glm::vec4(0.0f);
+		if (vertexCount == 0)
+			return;
+
+		// Positions are quantized against the mesh's own bounds
+		glm::vec3 minBounds = vertices[0].Position;
+		glm::vec3 maxBounds = vertices[0].Position;
+		for (size_t i = 0; i < vertexCount; ++i) {
+			minBounds = glm::min(minBounds, vertices[i].Position);
+			maxBounds = glm::max(maxBounds, vertices[i].Position);
+		}
+		const glm::vec3 center	   = (minBounds + maxBounds) * 0.5f;
+		const glm::vec3 halfExtent = (maxBounds - minBounds) * 0.5f;
+
+		for (size_t i = 0; i < vertexCount; ++i) {
+			const Vertex &v	 = vertices[i];
+			CompactVertex &c = compact[i];
+			for (int axis = 0; axis < 3; ++axis)
+				c.Position[axis] = halfExtent[axis] > 0.0f ? PackSnorm16((v.Position[axis] - center[axis]) / halfExtent[axis]) : 0;
+			c.Position[3]	  = glm::dot(glm::cross(v.Normal, v.Tangent), v.Bitangent) < 0.0f ? -32767 : 32767;
+			const glm::vec2 n = OctEncode(v.Normal);
+			const glm::vec2 t = OctEncode(v.Tangent);
+			c.Normal[0]		  = PackSnorm16(n.x);
+			c.Normal[1]		  = PackSnorm16(n.y);
+			c.Tangent[0]	  = PackSnorm16(t.x);
+			c.Tangent[1]	  = PackSnorm16(t.y);
+			c.TexCoords[0]	  = glm::packHalf1x16(v.TexCoords.x);
+			c.TexCoords[1]	  = glm::packHalf1x16(v.TexCoords.y);
+		}
+		positionDecode[0] = glm::vec4(halfExtent, 1.0f);
+		positionDecode[1] = glm::vec4(center, 0.0f);
+	}
+
+	std::shared_ptr<Mesh::GPUBuffers> Mesh::UploadBuffers(const Vertex *vertices, size_t vertexCount, const unsigned int *indices, size_t indexCount,
+														  VertexFormat format) {
+		const size_t vertexStride = format == VertexFormat::Compact ? sizeof(CompactVertex) : sizeof(Vertex);
+		const size_t vertexBytes  = vertexCount * vertexStride;
+		auto buffers = std::make_shared<GPUBuffers>(static_cast<unsigned int>(vertexBytes + 2 * sizeof(glm::vec4)), indices, static_cast<unsigned int>(indexCount));
+
+		if (format == VertexFormat::Compact && vertexCount > 0) {
+			std::vector<CompactVertex> compact;
+			glm::vec4 decode[2];
+			CompactVertices(vertices, vertexCount, compact, decode);
+			SetupVertexBuffer(*buffers, compact.data(), vertexBytes, format, decode);
+		} else {
+			// Position decode: identity for the full layout
+			const glm::vec4 decode[2] = {glm::vec4(1.0f, 1.0f, 1.0f, 0.0f), glm::vec4(0.0f)};
+			SetupVertexBuffer(*buffers, vertices, vertexBytes, VertexFormat::Full, decode);
+		}
+		return buffers;
+	}
+
+	std::shared_ptr<Mesh::GPUBuffers> Mesh::UploadPacked(const PackedMeshView &geometry) {
+		const size_t vertexStride = geometry.format == VertexFormat::Compact ? sizeof(CompactVertex) : sizeof(Vertex);
+		const size_t vertexBytes  = geometry.vertexCount * vertexStride;
+		auto buffers = std::make_shared<GPUBuffers>(static_cast<unsigned int>(vertexBytes + 2 * sizeof(glm::vec4)), geometry.indices,
+													static_cast<unsigned int>(geometry.indexCount), geometry.indexSize);
+		SetupVertexBuffer(*buffers, geometry.vertices, vertexBytes, geometry.format, geometry.positionDecode);
+		return buffers;
+	}
+
+	// Vertices, then the position decode (scale, offset) as a per-buffer constant attribute
+	void Mesh::SetupVertexBuffer(GPUBuffers &buffers, const void *vertices, size_t vertexBytes, VertexFormat format,
+								 const glm::vec4 (&positionDecode)[2]) {
+		const VertexBuffer &vertexBuffer = buffers.vertexBuffer;
+		vertexBuffer.SetData(vertices, static_cast<unsigned int>(vertexBytes));
+		if (format == VertexFormat::Compact)
+			SetupCompactAttributes();
+		else
+			SetupFullAttributes();
 
-		m_VertexBuffer = std::make_shared<VertexBuffer>((float *)m_Vertices.data(), m_Vertices.size() * sizeof(Vertex));
+		// Position scale/offset (locations 11, 12): one element shared by every vertex
+		vertexBuffer.SetData(positionDecode, 2 * sizeof(glm::vec4), static_cast<unsigned int>(vertexBytes));
+		glEnableVertexAttribArray(PositionScaleLocation);
+		glVertexAttribPointer(PositionScaleLocation, 4, GL_FLOAT, GL_FALSE, 0, (void *)vertexBytes);
+		glVertexAttribDivisor(PositionScaleLocation, ConstantAttributeDivisor);
+		glEnableVertexAttribArray(PositionOffsetLocation);
+		glVertexAttribPointer(PositionOffsetLocation, 4, GL_FLOAT, GL_FALSE, 0, (void *)(vertexBytes + sizeof(glm::vec4)));
+		glVertexAttribDivisor(PositionOffsetLocation, ConstantAttributeDivisor);
 
+		buffers.vertexArray.Unbind();
+	}
+
+	std::vector<std::unique_ptr<Mesh>> Mesh::CreateShared(const std::vector<MeshGeometry> &geometries) {
+		// Concatenated; indices stay relative to their own mesh (drawn with a base vertex)
+		size_t vertexCount = 0, indexCount = 0;
+		for (const MeshGeometry &geometry : geometries) {
+			vertexCount += geometry.vertices.size();
+			indexCount += geometry.indices.size();
+		}
+		std::vector<Vertex> vertices;
+		std::vector<unsigned int> indices;
+		vertices.reserve(vertexCount);
+		indices.reserve(indexCount);
+		for (const MeshGeometry &geometry : geometries) {
+			vertices.insert(vertices.end(), geometry.vertices.begin(), geometry.vertices.end());
+			indices.insert(indices.end(), geometry.indices.begin(), geometry.indices.end());
+		}
+		std::vector<std::unique_ptr<Mesh>> meshes;
+		if (vertices.empty() || indices.empty())
+			return meshes;
+		const std::shared_ptr<GPUBuffers> buffers = UploadBuffers(vertices.data(), vertices.size(), indices.data(), indices.size(), VertexFormat::Full);
+
+		meshes.reserve(geometries.size());
+		size_t baseVertex = 0, firstIndex = 0;
+		for (const MeshGeometry &geometry : geometries) {
+			std::unique_ptr<Mesh> mesh(new Mesh());
+			mesh->m_Format	   = VertexFormat::Full;
+			mesh->m_Buffers	   = buffers;
+			mesh->m_BaseVertex = static_cast<int>(baseVertex);
+			mesh->m_IndexCount = geometry.indices.size();
+			mesh->m_Lods	   = {{static_cast<uint32_t>(firstIndex), static_cast<uint32_t>(geometry.indices.size()), 0.0f}};
+			mesh->m_GPUBytes   = geometry.vertices.size() * sizeof(Vertex) + geometry.indices.size() * buffers->indexBuffer.GetIndexSize();
+			mesh->m_Metrics	   = ComputeMetrics(geometry.vertices.data(), geometry.vertices.size(), geometry.indices.data(), geometry.indices.size());
+			mesh->BuildMeshlets(geometry.vertices.data(), geometry.vertices.size(), indices.data());
+			baseVertex += geometry.vertices.size();
+			firstIndex += geometry.indices.size();
+			meshes.push_back(std::move(mesh));
+		}
+		return meshes;
+	}
+
+	void Mesh::SetupFullAttributes() {
 		// Position attribute (location 0)
 		glEnableVertexAttribArray(0);
 		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, Position));
@@ -60,22 +421,107 @@ namespace Engine {
 		// Bitangent attribute (location 4)
 		glEnableVertexAttribArray(4);
 		glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, Bitangent));
+	}
+
+	void Mesh::SetupCompactAttributes() {
+		// Quantized position + bitangent sign (location 0, normalized to [-1, 1])
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 4, GL_SHORT, GL_TRUE, sizeof(CompactVertex), (void *)offsetof(CompactVertex, Position));
 
-		m_IndexBuffer = std::make_shared<IndexBuffer>(m_Indices.data(), m_Indices.size());
+		// Half-float texture coordinates (location 2, same as the full layout)
+		glEnableVertexAttribArray(2);
+		glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(CompactVertex), (void *)offsetof(CompactVertex, TexCoords));
 
-		m_VertexArray->Unbind();
-		// std::cout << "    Mesh::SetupMesh - Setup complete." << std::endl; // Debug print
+		// Octahedral normal and tangent (locations 9, 10)
+		glEnableVertexAttribArray(OctNormalLocation);
+		glVertexAttribPointer(OctNormalLocation, 2, GL_SHORT, GL_TRUE, sizeof(CompactVertex), (void *)offsetof(CompactVertex, Normal));
+		glEnableVertexAttribArray(OctTangentLocation);
+		glVertexAttribPointer(OctTangentLocation, 2, GL_SHORT, GL_TRUE, sizeof(CompactVertex), (void *)offsetof(CompactVertex, Tangent));
 	}
 
-	void Mesh::Draw() const {
-		if (m_Indices.empty()) {
+	void Mesh::Draw(int lod, const ClusterCullView *cull) const {
+		const MeshLod &level = GetLod(lod);
+		if (level.indexCount == 0) {
 			// std::cerr << "Warning: Mesh::Draw called with 0 indices." << std::endl; // Debug print
 			return;
 		}
-		// std::cout << "    Mesh::Draw - Binding VAO and drawing " << m_Indices.size() << " indices." << std::endl; // Debug print
-		m_VertexArray->Bind();
-		glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(m_Indices.size()), GL_UNSIGNED_INT, nullptr);
-		m_VertexArray->Unbind();
+		if (cull && &level == m_Lods.data() && !m_Meshlets.empty()) {
+			DrawMeshlets(1, cull);
+			return;
+		}
+		s_DrawStats.drawCalls++;
+		s_DrawStats.triangles += level.indexCount / 3;
+		s_DrawStats.lodDrawCalls[&level - m_Lods.data()]++;
+		m_Buffers->vertexArray.Bind();
+		glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(level.indexCount), m_Buffers->indexBuffer.GetIndexType(),
+								 (void *)(size_t(level.firstIndex) * m_Buffers->indexBuffer.GetIndexSize()), m_BaseVertex);
+		m_Buffers->vertexArray.Unbind();
+	}
+
+	void Mesh::DrawInstanced(unsigned int instanceCount, int lod, const ClusterCullView *cull) const {
+		const MeshLod &level = GetLod(lod);
+		if (level.indexCount == 0 || instanceCount == 0)
+			return;
+		if (cull && &level == m_Lods.data() && !m_Meshlets.empty()) {
+			DrawMeshlets(instanceCount, cull);
+			return;
+		}
+		s_DrawStats.drawCalls++;
+		s_DrawStats.triangles += uint64_t(level.indexCount / 3) * instanceCount;
+		s_DrawStats.lodDrawCalls[&level - m_Lods.data()]++;
+		m_Buffers->vertexArray.Bind();
+		glDrawElementsInstancedBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(level.indexCount), m_Buffers->indexBuffer.GetIndexType(),
+										  (void *)(size_t(level.firstIndex) * m_Buffers->indexBuffer.GetIndexSize()), static_cast<GLsizei>(instanceCount),
+										  m_BaseVertex);
+		m_Buffers->vertexArray.Unbind();
+	}
+
+	/**
+	 * @brief Draws the meshlets of level 0 that at least one instance can see.
+	 *
+	 * Meshlets are contiguous in the index buffer, so runs of visible ones merge into a single
+	 * range and a fully visible mesh costs one range, like an unculled draw.
+	 */
+	void Mesh::DrawMeshlets(unsigned int instanceCount, const ClusterCullView *cull) const {
+		s_RangeCounts.clear();
+		s_RangeOffsets.clear();
+		uint32_t rangeEnd		  = 0;
+		uint64_t visibleTriangles = 0;
+		for (const Meshlet &meshlet : m_Meshlets) {
+			bool visible = false;
+			for (unsigned int i = 0; i < instanceCount && !visible; ++i)
+				visible = MeshletBuilder::IsVisible(meshlet, cull[i]);
+			if (!visible) {
+				s_DrawStats.meshletsCulled++;
+				continue;
+			}
+			if (!s_RangeCounts.empty() && rangeEnd == meshlet.firstIndex) {
+				s_RangeCounts.back() += static_cast<GLsizei>(meshlet.indexCount);
+			} else {
+				s_RangeCounts.push_back(static_cast<GLsizei>(meshlet.indexCount));
+				s_RangeOffsets.push_back((const void *)(size_t(meshlet.firstIndex) * m_Buffers->indexBuffer.GetIndexSize()));
+			}
+			rangeEnd = meshlet.firstIndex + meshlet.indexCount;
+			visibleTriangles += meshlet.indexCount / 3;
+		}
+		s_DrawStats.meshletsTested += m_Meshlets.size();
+		if (s_RangeCounts.empty())
+			return;
+
+		s_DrawStats.drawCalls++;
+		s_DrawStats.triangles += visibleTriangles * instanceCount;
+		s_DrawStats.lodDrawCalls[0]++;
+		m_Buffers->vertexArray.Bind();
+		if (instanceCount == 1) {
+			s_RangeBaseVertices.assign(s_RangeCounts.size(), m_BaseVertex);
+			glMultiDrawElementsBaseVertex(GL_TRIANGLES, s_RangeCounts.data(), m_Buffers->indexBuffer.GetIndexType(), s_RangeOffsets.data(),
+										  static_cast<GLsizei>(s_RangeCounts.size()), s_RangeBaseVertices.data());
+		} else {
+			for (size_t i = 0; i < s_RangeCounts.size(); ++i)
+				glDrawElementsInstancedBaseVertex(GL_TRIANGLES, s_RangeCounts[i], m_Buffers->indexBuffer.GetIndexType(), s_RangeOffsets[i],
+												  static_cast<GLsizei>(instanceCount), m_BaseVertex);
+		}
+		m_Buffers->vertexArray.Unbind();
 	}
 
 } // namespace Engine
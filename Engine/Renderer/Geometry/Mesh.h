@@ -6,21 +6,21 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/04/26 12:26:49 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/04/26 22:47:58 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2025/05/16 11:33:55 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <glm/glm.hpp>
 #include <memory>
 #include <vector>
 
 namespace Engine {
 
-	class VertexArray;
-	class VertexBuffer;
-	class IndexBuffer;
 	class Shader;
 
 	struct Vertex {
@@ -31,28 +31,276 @@ namespace Engine {
 		glm::vec3 Bitangent;
 	};
 
+	/**
+	 * @brief Vertex layout of a mesh on the GPU (decoded by Shaders/Core/Common/vertex.glsl).
+	 */
+	enum class VertexFormat {
+		Full,	///< Vertex as is: 56 bytes of floats.
+		Compact ///< CompactVertex: 20 bytes.
+	};
+
+	/**
+	 * @brief Quantized vertex uploaded for VertexFormat::Compact.
+	 *
+	 * The bitangent is rebuilt in the shader as sign * cross(normal, tangent).
+	 */
+	struct CompactVertex {
+		int16_t Position[4];   ///< snorm16 in the mesh bounds (center +- half extent); w = bitangent sign.
+		int16_t Normal[2];	   ///< Octahedral snorm16.
+		int16_t Tangent[2];	   ///< Octahedral snorm16.
+		uint16_t TexCoords[2]; ///< Half floats.
+	};
+	static_assert(sizeof(CompactVertex) == 20, "CompactVertex must stay tightly packed");
+
+	/**
+	 * @brief Object-space bounds and texel density of a mesh (computed once, or read from a cooked file).
+	 */
+	struct MeshMetrics {
+		glm::vec3 boundsCenter = glm::vec3(0.0f); ///< Bounding sphere center.
+		float boundsRadius	   = 0.0f;			  ///< Bounding sphere radius.
+		float worldUnitsPerUV  = 0.0f;			  ///< See Mesh::GetWorldUnitsPerUV().
+	};
+
+	/**
+	 * @brief Vertices and indices of one mesh on the CPU (e.g. a generated primitive).
+	 */
+	struct MeshGeometry {
+		std::vector<Vertex> vertices;
+		std::vector<unsigned int> indices;
+	};
+
+	/**
+	 * @brief Geometry of one mesh already in its GPU layout (e.g. inside a cooked .vmesh file).
+	 */
+	struct PackedMeshView {
+		VertexFormat format	 = VertexFormat::Full; ///< Layout of `vertices`.
+		const void *vertices = nullptr;			   ///< vertexCount Vertex or CompactVertex structs.
+		size_t vertexCount	 = 0;				   ///< Vertices of the mesh.
+		const void *indices	 = nullptr;			   ///< indexCount indices of indexSize bytes.
+		size_t indexCount	 = 0;				   ///< Indices of all levels.
+		uint32_t indexSize	 = 4;				   ///< Bytes per index (2 or 4).
+		glm::vec4 positionDecode[2] = {glm::vec4(1.0f, 1.0f, 1.0f, 0.0f), glm::vec4(0.0f)}; ///< Scale and offset, see Mesh::CompactVertices().
+	};
+
+	/**
+	 * @brief One level of detail: a range of the mesh's index buffer over the shared vertices.
+	 */
+	struct MeshLod {
+		uint32_t firstIndex = 0;	///< First index of the level in the mesh's index buffer.
+		uint32_t indexCount = 0;	///< Indices of the level.
+		float error			= 0.0f; ///< Object-space distance the level may deviate from level 0.
+	};
+
+	/**
+	 * @brief A cluster of consecutive triangles (see MeshletBuilder) with the data needed to cull it.
+	 */
+	struct Meshlet {
+		uint32_t firstIndex = 0;				///< First index of the cluster in the mesh's index buffer.
+		uint32_t indexCount = 0;				///< Indices of the cluster.
+		glm::vec3 center	= glm::vec3(0.0f);	///< Object-space bounding sphere center.
+		float radius		= 0.0f;				///< Object-space bounding sphere radius.
+		glm::vec3 coneAxis	= glm::vec3(0.0f);	///< Average triangle normal.
+		float coneCutoff	= 1.0f;				///< Sine of the normal cone half-angle (1 = never back-facing).
+	};
+
+	/**
+	 * @brief What a pass can see, for rejecting meshlets before rasterisation.
+	 *
+	 * Built in world space from the pass matrix, then moved to each object's space with
+	 * ToObjectSpace() so meshlet bounds are tested without transforming them.
+	 */
+	struct ClusterCullView {
+		glm::vec4 frustumPlanes[6];	 ///< Planes pointing inwards; dot() gives world-space distances.
+		glm::vec3 viewPosition;		 ///< Eye position (perspective views).
+		glm::vec3 viewDirection;	 ///< Viewing direction (orthographic views).
+		float radiusScale	= 1.0f;	 ///< World units per object unit (largest axis scale).
+		bool orthographic	= false; ///< Test cones against viewDirection instead of viewPosition.
+		bool cullBackfaces	= false; ///< Reject clusters whose triangles all face away (closed meshes only).
+
+		/**
+		 * @brief Build from a pass's view-projection matrix (perspective or orthographic).
+		 * @param viewPosition Eye position, used by perspective views.
+		 * @param cullBackfaces Also reject back-facing clusters; only valid when back faces are never visible.
+		 */
+		static ClusterCullView FromViewProjection(const glm::mat4 &viewProjection, const glm::vec3 &viewPosition, bool cullBackfaces);
+
+		/**
+		 * @brief The same view in the space of an object drawn with `model`.
+		 *        Non-uniform scale disables back-face rejection (normal cones do not survive it).
+		 */
+		ClusterCullView ToObjectSpace(const glm::mat4 &model) const;
+	};
+
 	class Mesh {
 	public:
-		Mesh(const std::vector<Vertex> &vertices, const std::vector<unsigned int> &indices);
+		static constexpr int MaxLods = 4; ///< Levels of detail per mesh, including the full-detail one.
+
+		/**
+		 * @brief Draw calls and triangles submitted through Draw() / DrawInstanced() since the last reset.
+		 */
+		struct DrawStats {
+			uint64_t drawCalls			  = 0;
+			uint64_t triangles			  = 0;	///< Instances included.
+			uint64_t lodDrawCalls[MaxLods] = {}; ///< Draw calls per level of detail.
+			uint64_t meshletsTested		  = 0;	///< Meshlets tested by culled draws.
+			uint64_t meshletsCulled		  = 0;	///< Meshlets rejected (outside the view or back-facing).
+		};
+
+		/**
+		 * @brief Upload geometry from CPU arrays.
+		 * @param keepCpuCopy Keep the arrays for GetVertices() / GetIndices() (otherwise they are empty).
+		 */
+		Mesh(const std::vector<Vertex> &vertices, const std::vector<unsigned int> &indices, VertexFormat format = GetDefaultVertexFormat(),
+			 bool keepCpuCopy = false);
+
+		/**
+		 * @brief Upload geometry from arrays the caller gives up (kept without a copy when keepCpuCopy is set).
+		 */
+		Mesh(std::vector<Vertex> &&vertices, std::vector<unsigned int> &&indices, VertexFormat format = GetDefaultVertexFormat(),
+			 bool keepCpuCopy = false);
+
+		/**
+		 * @brief Upload geometry straight from caller memory (e.g. a mapped file or a staging batch).
+		 * @param lods Levels of detail, finest first (at most MaxLods); empty = the whole index buffer is level 0.
+		 * @param keepCpuCopy Copy the arrays for GetVertices() / GetIndices() (otherwise they are empty).
+		 */
+		Mesh(const Vertex *vertices, size_t vertexCount, const unsigned int *indices, size_t indexCount, const MeshMetrics &metrics,
+			 const std::vector<MeshLod> &lods = {}, VertexFormat format = GetDefaultVertexFormat(), bool keepCpuCopy = false);
+
+		/**
+		 * @brief Upload geometry already in GPU layout as is (no CPU copy is kept).
+		 * @param meshlets Clusters of level 0, kept when the mesh reaches the meshlet threshold.
+		 */
+		Mesh(const PackedMeshView &geometry, const MeshMetrics &metrics, const std::vector<MeshLod> &lods, const std::vector<Meshlet> &meshlets);
 		~Mesh();
 
-		// Draw no longer needs the shader reference, assumes it's bound externally
-		void Draw() const;
+		// Owns GL objects: movable (a moved-from mesh must not be drawn), not copyable
+		Mesh(const Mesh &)			  = delete;
+		Mesh &operator=(const Mesh &) = delete;
+		Mesh(Mesh &&) noexcept;
+		Mesh &operator=(Mesh &&) noexcept;
+
+		/**
+		 * @brief Upload several meshes into one vertex buffer, index buffer and VAO (full layout).
+		 *
+		 * Each mesh draws its own index range with a base vertex, so drawing them one after
+		 * another never switches buffers. The compact layout is not used: its position decode is
+		 * a per-buffer constant.
+		 */
+		static std::vector<std::unique_ptr<Mesh>> CreateShared(const std::vector<MeshGeometry> &geometries);
+
+		/**
+		 * @brief Whether both meshes draw from the same GL buffers (see CreateShared()).
+		 */
+		bool SharesBuffersWith(const Mesh &other) const { return m_Buffers == other.m_Buffers; }
+
+		/**
+		 * @brief Layout used by meshes created without an explicit format (GL thread).
+		 */
+		static void SetDefaultVertexFormat(VertexFormat format);
+		static VertexFormat GetDefaultVertexFormat();
+
+		/**
+		 * @brief Meshes created with at least this many level-0 triangles are split into meshlets (0 = never).
+		 */
+		static void SetMeshletMinTriangles(size_t triangles);
+		static size_t GetMeshletMinTriangles();
+
+		/**
+		 * @brief Bounds and UV density of a triangle list.
+		 */
+		static MeshMetrics ComputeMetrics(const Vertex *vertices, size_t vertexCount, const unsigned int *indices, size_t indexCount);
+
+		/**
+		 * @brief Convert vertices to the compact layout, positions quantized against their own bounds.
+		 * @param[out] positionDecode Scale (w = 1 selects the compact decode) and offset restoring the positions.
+		 */
+		static void CompactVertices(const Vertex *vertices, size_t vertexCount, std::vector<CompactVertex> &compact, glm::vec4 (&positionDecode)[2]);
+
+		/**
+		 * @brief Draws one level of detail (clamped to the levels of the mesh); the shader is bound externally.
+		 * @param cull Object-space view: level 0 then only draws the meshlets it can see (nullptr = all).
+		 */
+		void Draw(int lod = 0, const ClusterCullView *cull = nullptr) const;
+
+		/**
+		 * @brief Draws `instanceCount` instances of the mesh in a single call.
+		 * @param instanceCount Number of instances (gl_InstanceID = 0 .. instanceCount - 1).
+		 * @param lod Level of detail (clamped).
+		 * @param cull One object-space view per instance; a meshlet is drawn if any instance sees it (nullptr = all).
+		 */
+		void DrawInstanced(unsigned int instanceCount, int lod = 0, const ClusterCullView *cull = nullptr) const;
 
-		// Getters for vertices and indices
+		int GetLodCount() const { return static_cast<int>(m_Lods.size()); }
+		const MeshLod &GetLod(int lod) const { return m_Lods[std::min(std::max(lod, 0), GetLodCount() - 1)]; }
+
+		/**
+		 * @brief Clusters of level 0 (empty below the meshlet threshold).
+		 */
+		const std::vector<Meshlet> &GetMeshlets() const { return m_Meshlets; }
+
+		static const DrawStats &GetDrawStats();
+		static void ResetDrawStats();
+
+		// CPU copies of the geometry (empty unless the mesh was created with keepCpuCopy)
 		const std::vector<Vertex> &GetVertices() const { return m_Vertices; }
 		const std::vector<unsigned int> &GetIndices() const { return m_Indices; }
 
+		/**
+		 * @brief Object-space bounding sphere center.
+		 */
+		const glm::vec3 &GetBoundsCenter() const { return m_Metrics.boundsCenter; }
+
+		/**
+		 * @brief Object-space bounding sphere radius.
+		 */
+		float GetBoundsRadius() const { return m_Metrics.boundsRadius; }
+
+		/**
+		 * @brief Average object-space length covered by one UV unit (0 if the mesh has no UVs).
+		 *
+		 * sqrt(surface area / UV area); used to estimate the texel density on screen.
+		 */
+		float GetWorldUnitsPerUV() const { return m_Metrics.worldUnitsPerUV; }
+
+		VertexFormat GetVertexFormat() const { return m_Format; }
+
+		/**
+		 * @brief GPU bytes of the vertex and index buffers (this mesh's part of them when shared).
+		 */
+		size_t GetGPUBytes() const { return m_GPUBytes; }
+
 	private:
-		std::shared_ptr<VertexArray> m_VertexArray;
-		std::shared_ptr<VertexBuffer> m_VertexBuffer;
-		std::shared_ptr<IndexBuffer> m_IndexBuffer;
+		struct GPUBuffers;
+		std::shared_ptr<GPUBuffers> m_Buffers; ///< VAO, vertex and index buffers (one allocation, shared by CreateShared() meshes)
+		int m_BaseVertex = 0;				   ///< First vertex of the mesh in m_Buffers.
 
-		void SetupMesh();
+		/// Filled by CreateShared().
+		Mesh() = default;
+
+		void Create(const Vertex *vertices, size_t vertexCount, const unsigned int *indices, size_t indexCount);
+		void SetupMesh(const Vertex *vertices, size_t vertexCount, const unsigned int *indices, size_t indexCount);
+		static std::shared_ptr<GPUBuffers> UploadBuffers(const Vertex *vertices, size_t vertexCount, const unsigned int *indices, size_t indexCount,
+														 VertexFormat format);
+		static std::shared_ptr<GPUBuffers> UploadPacked(const PackedMeshView &geometry);
+		static void SetupVertexBuffer(GPUBuffers &buffers, const void *vertices, size_t vertexBytes, VertexFormat format,
+									  const glm::vec4 (&positionDecode)[2]);
+		void SetLods(const std::vector<MeshLod> &lods);
+		void BuildMeshlets(const Vertex *vertices, size_t vertexCount, const unsigned int *indices);
+		void DrawMeshlets(unsigned int instanceCount, const ClusterCullView *cull) const;
+		static void SetupFullAttributes();
+		static void SetupCompactAttributes();
 
 	private:
-		std::vector<Vertex> m_Vertices;
-		std::vector<unsigned int> m_Indices;
+		std::vector<Vertex> m_Vertices;			   ///< CPU copy (keepCpuCopy only).
+		std::vector<unsigned int> m_Indices;	   ///< CPU copy (keepCpuCopy only).
+		size_t m_IndexCount = 0;				   ///< Indices on the GPU (m_Indices may be empty).
+		size_t m_GPUBytes	= 0;				   ///< Vertex + index buffer sizes.
+		VertexFormat m_Format = VertexFormat::Full; ///< Layout of the vertex buffer.
+		std::vector<MeshLod> m_Lods;				///< Levels of detail (at least one).
+		std::vector<Meshlet> m_Meshlets;			///< Clusters covering level 0, in index order.
+
+		MeshMetrics m_Metrics;
 	};
 
 } // namespace Engine
\ No newline at end of file
@@ -0,0 +1,331 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   MeshFile.cpp                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/13 09:26:03 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/16 11:33:55 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#include "Renderer/Geometry/MeshFile.h"
+#include "Core/FileUtils.h"
+#include "Core/MappedFile.h"
+#include "Renderer/Geometry/MeshletBuilder.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace Engine {
+
+	namespace {
+		constexpr char MeshMagic[4]	   = {'V', 'M', 'S', 'H'};
+		constexpr uint32_t MeshVersion = 3;
+		constexpr uint32_t NoString	   = 0xFFFFFFFFu;
+
+		struct MeshHeader {
+			char magic[4];
+			uint32_t version;
+			uint32_t importFlags;
+			uint32_t vertexStride; ///< Size of the stored vertex; guards against layout changes.
+			uint32_t subMeshCount;
+			uint32_t materialCount;
+			uint32_t stringBytes;
+			uint32_t lodCount;	   ///< Entries of the level-of-detail table (all sub-meshes).
+			uint32_t vertexFormat; ///< VertexFormat of the vertex array.
+			uint32_t indexSize;	   ///< Bytes per index (2 or 4).
+			uint32_t meshletCount; ///< Entries of the meshlet table (all sub-meshes).
+			uint32_t reserved;
+			uint64_t vertexCount;
+			uint64_t indexCount;
+			uint64_t vertexOffset; ///< Multiple of Alignment.
+			uint64_t indexOffset;  ///< Multiple of Alignment.
+		};
+
+		struct MeshSubMesh {
+			uint32_t firstVertex;
+			uint32_t vertexCount;
+			uint32_t firstIndex;
+			uint32_t indexCount;
+			int32_t material;
+			float boundsCenter[3];
+			float boundsRadius;
+			float worldUnitsPerUV;
+			uint32_t lodCount;		 ///< Levels of the sub-mesh in the level-of-detail table (0 = one level).
+			uint32_t meshletCount;	 ///< Clusters of the sub-mesh in the meshlet table.
+			float positionScale[3];	 ///< Decode of compact positions (1 for the full layout).
+			float positionOffset[3]; ///< Decode of compact positions (0 for the full layout).
+		};
+
+		struct MeshLodEntry {
+			uint32_t firstIndex; ///< Relative to the sub-mesh's firstIndex.
+			uint32_t indexCount;
+			float error;
+		};
+
+		struct MeshMeshlet {
+			uint32_t firstIndex; ///< Relative to the sub-mesh's firstIndex.
+			uint32_t indexCount;
+			float center[3];
+			float radius;
+			float coneAxis[3];
+			float coneCutoff;
+		};
+
+		struct MeshMaterial {
+			float albedoColor[3];
+			float metallic;
+			float roughness;
+			float ao;
+			uint32_t textures[3]; ///< Offsets into the string blob (albedo, normal, AO), or NoString.
+		};
+
+		static_assert(sizeof(MeshHeader) == 80, "Mesh header layout");
+		static_assert(sizeof(MeshSubMesh) == 72, "Mesh sub-mesh layout");
+		static_assert(sizeof(MeshLodEntry) == 12, "Mesh level-of-detail layout");
+		static_assert(sizeof(MeshMeshlet) == 40, "Mesh meshlet layout");
+		static_assert(sizeof(MeshMaterial) == 36, "Mesh material layout");
+
+		uint64_t AlignUp(uint64_t value) {
+			return (value + MeshFile::Alignment - 1) / MeshFile::Alignment * MeshFile::Alignment;
+		}
+
+		size_t VertexStride(VertexFormat format) {
+			return format == VertexFormat::Compact ? sizeof(CompactVertex) : sizeof(Vertex);
+		}
+	} // namespace
+
+	bool MeshFile::IsMeshFile(const std::string &path) {
+		return path.size() > 6 && path.compare(path.size() - 6, 6, ".vmesh") == 0;
+	}
+
+	bool MeshFile::Load(const std::string &path, unsigned int importFlags, VertexFormat format, ModelData &data) {
+		std::shared_ptr<MappedFile> file = MappedFile::Open(path);
+		if (!file || file->GetSize() < sizeof(MeshHeader))
+			return false;
+
+		MeshHeader header;
+		std::memcpy(&header, file->GetData(), sizeof(header));
+		if (std::memcmp(header.magic, MeshMagic, sizeof(MeshMagic)) == 0 && header.version != MeshVersion)
+			return false; // Cooked by an older engine: the caller re-imports
+		const uint64_t tablesEnd = sizeof(MeshHeader) + uint64_t(header.subMeshCount) * sizeof(MeshSubMesh) + uint64_t(header.lodCount) * sizeof(MeshLodEntry) +
+								   uint64_t(header.meshletCount) * sizeof(MeshMeshlet) + uint64_t(header.materialCount) * sizeof(MeshMaterial) +
+								   header.stringBytes;
+		const bool knownFormat = header.vertexFormat <= static_cast<uint32_t>(VertexFormat::Compact);
+		const size_t stride	   = knownFormat ? VertexStride(static_cast<VertexFormat>(header.vertexFormat)) : 0;
+		if (std::memcmp(header.magic, MeshMagic, sizeof(MeshMagic)) != 0 || !knownFormat || header.vertexStride != stride ||
+			(header.indexSize != 2 && header.indexSize != 4) || tablesEnd > file->GetSize() || header.vertexOffset % Alignment != 0 ||
+			header.indexOffset % Alignment != 0 || header.vertexOffset > file->GetSize() ||
+			header.vertexCount > (file->GetSize() - header.vertexOffset) / stride || header.indexOffset > file->GetSize() ||
+			header.indexCount > (file->GetSize() - header.indexOffset) / header.indexSize) {
+			std::cerr << "[MeshFile] Invalid file: " << path << std::endl;
+			return false;
+		}
+		if (header.importFlags != importFlags || header.vertexFormat != static_cast<uint32_t>(format))
+			return false; // Cooked with other post-processing or vertex layout: the caller re-imports
+
+		const uint8_t *cursor	= file->GetData() + sizeof(MeshHeader);
+		const uint8_t *lods		= cursor + header.subMeshCount * sizeof(MeshSubMesh);
+		const uint8_t *meshlets = lods + header.lodCount * sizeof(MeshLodEntry);
+		uint32_t lodsLeft		= header.lodCount;
+		uint32_t meshletsLeft	= header.meshletCount;
+		ModelData loaded;
+		loaded.subMeshes.resize(header.subMeshCount);
+		for (SubMeshRange &range : loaded.subMeshes) {
+			MeshSubMesh entry;
+			std::memcpy(&entry, cursor, sizeof(entry));
+			cursor += sizeof(entry);
+			if (uint64_t(entry.firstVertex) + entry.vertexCount > header.vertexCount || uint64_t(entry.firstIndex) + entry.indexCount > header.indexCount ||
+				entry.material >= static_cast<int32_t>(header.materialCount) || entry.lodCount > lodsLeft || entry.lodCount > uint32_t(Mesh::MaxLods) ||
+				entry.meshletCount > meshletsLeft) {
+				std::cerr << "[MeshFile] Sub-mesh out of range: " << path << std::endl;
+				return false;
+			}
+			range.firstVertex			  = entry.firstVertex;
+			range.vertexCount			  = entry.vertexCount;
+			range.firstIndex			  = entry.firstIndex;
+			range.indexCount			  = entry.indexCount;
+			range.material				  = entry.material;
+			range.metrics.boundsCenter	  = glm::vec3(entry.boundsCenter[0], entry.boundsCenter[1], entry.boundsCenter[2]);
+			range.metrics.boundsRadius	  = entry.boundsRadius;
+			range.metrics.worldUnitsPerUV = entry.worldUnitsPerUV;
+			range.positionDecode[0]		  = glm::vec4(entry.positionScale[0], entry.positionScale[1], entry.positionScale[2],
+													  format == VertexFormat::Compact ? 1.0f : 0.0f);
+			range.positionDecode[1]		  = glm::vec4(entry.positionOffset[0], entry.positionOffset[1], entry.positionOffset[2], 0.0f);
+
+			range.lods.resize(entry.lodCount);
+			for (MeshLod &lod : range.lods) {
+				MeshLodEntry lodEntry;
+				std::memcpy(&lodEntry, lods, sizeof(lodEntry));
+				lods += sizeof(lodEntry);
+				if (uint64_t(lodEntry.firstIndex) + lodEntry.indexCount > entry.indexCount) {
+					std::cerr << "[MeshFile] Level of detail out of range: " << path << std::endl;
+					return false;
+				}
+				lod = {lodEntry.firstIndex, lodEntry.indexCount, lodEntry.error};
+			}
+			lodsLeft -= entry.lodCount;
+
+			range.meshlets.resize(entry.meshletCount);
+			for (Meshlet &meshlet : range.meshlets) {
+				MeshMeshlet meshletEntry;
+				std::memcpy(&meshletEntry, meshlets, sizeof(meshletEntry));
+				meshlets += sizeof(meshletEntry);
+				if (uint64_t(meshletEntry.firstIndex) + meshletEntry.indexCount > entry.indexCount) {
+					std::cerr << "[MeshFile] Meshlet out of range: " << path << std::endl;
+					return false;
+				}
+				meshlet.firstIndex = meshletEntry.firstIndex;
+				meshlet.indexCount = meshletEntry.indexCount;
+				meshlet.center	   = glm::vec3(meshletEntry.center[0], meshletEntry.center[1], meshletEntry.center[2]);
+				meshlet.radius	   = meshletEntry.radius;
+				meshlet.coneAxis   = glm::vec3(meshletEntry.coneAxis[0], meshletEntry.coneAxis[1], meshletEntry.coneAxis[2]);
+				meshlet.coneCutoff = meshletEntry.coneCutoff;
+			}
+			meshletsLeft -= entry.meshletCount;
+		}
+		cursor += header.lodCount * sizeof(MeshLodEntry) + header.meshletCount * sizeof(MeshMeshlet);
+
+		const char *strings = reinterpret_cast<const char *>(cursor + header.materialCount * sizeof(MeshMaterial));
+		const auto readString = [&](uint32_t offset) {
+			if (offset == NoString || offset >= header.stringBytes)
+				return std::string();
+			return std::string(strings + offset, strnlen(strings + offset, header.stringBytes - offset));
+		};
+		loaded.materials.resize(header.materialCount);
+		for (MaterialDesc &material : loaded.materials) {
+			MeshMaterial entry;
+			std::memcpy(&entry, cursor, sizeof(entry));
+			cursor += sizeof(entry);
+			material.albedoColor   = glm::vec3(entry.albedoColor[0], entry.albedoColor[1], entry.albedoColor[2]);
+			material.metallic	   = entry.metallic;
+			material.roughness	   = entry.roughness;
+			material.ao			   = entry.ao;
+			material.albedoTexture = readString(entry.textures[0]);
+			material.normalTexture = readString(entry.textures[1]);
+			material.aoTexture	   = readString(entry.textures[2]);
+		}
+
+		// Geometry stays in the mapping; start paging it in before the upload reads it
+		file->Prefetch(header.vertexOffset, file->GetSize() - header.vertexOffset);
+		loaded.packedFormat		 = format;
+		loaded.packedVertices	 = file->GetData() + header.vertexOffset;
+		loaded.packedIndices	 = file->GetData() + header.indexOffset;
+		loaded.packedIndexSize	 = header.indexSize;
+		loaded.packedVertexCount = static_cast<size_t>(header.vertexCount);
+		loaded.packedIndexCount	 = static_cast<size_t>(header.indexCount);
+		loaded.backing			 = file;
+		data					 = std::move(loaded);
+		return true;
+	}
+
+	bool MeshFile::Save(const std::string &path, const ModelData &data, unsigned int importFlags, VertexFormat format) {
+		if (data.IsPacked())
+			return false; // Already cooked: nothing to convert from
+
+		std::string strings;
+		const auto addString = [&strings](const std::string &value) {
+			if (value.empty())
+				return NoString;
+			const uint32_t offset = static_cast<uint32_t>(strings.size());
+			strings.append(value).push_back('\0');
+			return offset;
+		};
+
+		// Vertices in upload layout, each sub-mesh quantized against its own bounds
+		const size_t stride = VertexStride(format);
+		std::vector<uint8_t> vertices(data.GetVertexCount() * stride);
+		std::vector<CompactVertex> compact;
+		glm::vec4 decode[2] = {glm::vec4(1.0f, 1.0f, 1.0f, 0.0f), glm::vec4(0.0f)};
+
+		// 16-bit indices when every sub-mesh fits (indices are relative to the sub-mesh's first vertex)
+		uint32_t indexSize = 2;
+		for (const SubMeshRange &range : data.subMeshes) {
+			if (range.vertexCount > 0x10000u)
+				indexSize = 4;
+		}
+
+		std::vector<MeshSubMesh> subMeshes;
+		std::vector<MeshLodEntry> lods;
+		std::vector<MeshMeshlet> meshlets;
+		subMeshes.reserve(data.subMeshes.size());
+		for (const SubMeshRange &range : data.subMeshes) {
+			const Vertex *rangeVertices	 = data.GetVertices() + range.firstVertex;
+			const uint32_t *rangeIndices = data.GetIndices() + range.firstIndex;
+			if (format == VertexFormat::Compact) {
+				Mesh::CompactVertices(rangeVertices, range.vertexCount, compact, decode);
+				std::memcpy(vertices.data() + range.firstVertex * stride, compact.data(), compact.size() * stride);
+			} else {
+				std::memcpy(vertices.data() + range.firstVertex * stride, rangeVertices, range.vertexCount * stride);
+			}
+
+			// Clusters of level 0 for every sub-mesh: the threshold is applied when the file is loaded
+			const MeshLod full = range.lods.empty() ? MeshLod{0, range.indexCount, 0.0f} : range.lods.front();
+			const std::vector<Meshlet> rangeMeshlets = MeshletBuilder::Build(rangeVertices, range.vertexCount, rangeIndices, full.firstIndex, full.indexCount);
+
+			const glm::vec3 &center = range.metrics.boundsCenter;
+			subMeshes.push_back({range.firstVertex, range.vertexCount, range.firstIndex, range.indexCount, range.material, {center.x, center.y, center.z},
+								 range.metrics.boundsRadius, range.metrics.worldUnitsPerUV, static_cast<uint32_t>(range.lods.size()),
+								 static_cast<uint32_t>(rangeMeshlets.size()), {decode[0].x, decode[0].y, decode[0].z}, {decode[1].x, decode[1].y, decode[1].z}});
+			for (const MeshLod &lod : range.lods)
+				lods.push_back({lod.firstIndex, lod.indexCount, lod.error});
+			for (const Meshlet &meshlet : rangeMeshlets) {
+				meshlets.push_back({meshlet.firstIndex, meshlet.indexCount, {meshlet.center.x, meshlet.center.y, meshlet.center.z}, meshlet.radius,
+									{meshlet.coneAxis.x, meshlet.coneAxis.y, meshlet.coneAxis.z}, meshlet.coneCutoff});
+			}
+		}
+		std::vector<uint16_t> shortIndices;
+		if (indexSize == 2)
+			shortIndices.assign(data.GetIndices(), data.GetIndices() + data.GetIndexCount());
+
+		std::vector<MeshMaterial> materials;
+		materials.reserve(data.materials.size());
+		for (const MaterialDesc &material : data.materials) {
+			materials.push_back({{material.albedoColor.x, material.albedoColor.y, material.albedoColor.z},
+								 material.metallic,
+								 material.roughness,
+								 material.ao,
+								 {addString(material.albedoTexture), addString(material.normalTexture), addString(material.aoTexture)}});
+		}
+
+		MeshHeader header{};
+		std::memcpy(header.magic, MeshMagic, sizeof(MeshMagic));
+		header.version		 = MeshVersion;
+		header.importFlags	 = importFlags;
+		header.vertexStride	 = static_cast<uint32_t>(stride);
+		header.subMeshCount	 = static_cast<uint32_t>(subMeshes.size());
+		header.materialCount = static_cast<uint32_t>(materials.size());
+		header.stringBytes	 = static_cast<uint32_t>(strings.size());
+		header.lodCount		 = static_cast<uint32_t>(lods.size());
+		header.vertexFormat	 = static_cast<uint32_t>(format);
+		header.indexSize	 = indexSize;
+		header.meshletCount	 = static_cast<uint32_t>(meshlets.size());
+		header.vertexCount	 = data.GetVertexCount();
+		header.indexCount	 = data.GetIndexCount();
+		const uint64_t tablesEnd = sizeof(MeshHeader) + subMeshes.size() * sizeof(MeshSubMesh) + lods.size() * sizeof(MeshLodEntry) +
+								   meshlets.size() * sizeof(MeshMeshlet) + materials.size() * sizeof(MeshMaterial) + strings.size();
+		header.vertexOffset		 = AlignUp(tablesEnd);
+		header.indexOffset		 = AlignUp(header.vertexOffset + vertices.size());
+
+		const void *indices = indexSize == 2 ? static_cast<const void *>(shortIndices.data()) : static_cast<const void *>(data.GetIndices());
+		return FileUtils::WriteAtomically(path, [&](std::ofstream &file) {
+			const std::vector<char> padding(Alignment, 0);
+			file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+			file.write(reinterpret_cast<const char *>(subMeshes.data()), static_cast<std::streamsize>(subMeshes.size() * sizeof(MeshSubMesh)));
+			file.write(reinterpret_cast<const char *>(lods.data()), static_cast<std::streamsize>(lods.size() * sizeof(MeshLodEntry)));
+			file.write(reinterpret_cast<const char *>(meshlets.data()), static_cast<std::streamsize>(meshlets.size() * sizeof(MeshMeshlet)));
+			file.write(reinterpret_cast<const char *>(materials.data()), static_cast<std::streamsize>(materials.size() * sizeof(MeshMaterial)));
+			file.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+			file.write(padding.data(), static_cast<std::streamsize>(header.vertexOffset - tablesEnd));
+			file.write(reinterpret_cast<const char *>(vertices.data()), static_cast<std::streamsize>(vertices.size()));
+			file.write(padding.data(), static_cast<std::streamsize>(header.indexOffset - header.vertexOffset - vertices.size()));
+			file.write(static_cast<const char *>(indices), static_cast<std::streamsize>(header.indexCount * indexSize));
+			return true;
+		});
+	}
+
+} // namespace Engine
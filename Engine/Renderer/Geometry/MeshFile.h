@@ -0,0 +1,61 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   MeshFile.h                                         :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/13 09:25:51 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/16 11:33:55 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#pragma once
+
+#include "Renderer/Geometry/ModelData.h"
+#include <string>
+
+/**
+ * @file MeshFile.h
+ * @brief Engine-native cooked models (.vmesh), loaded by memory mapping instead of Assimp.
+ */
+
+namespace Engine {
+
+	/**
+	 * @class MeshFile
+	 * @brief Reads and writes .vmesh files.
+	 *
+	 * Layout: a fixed header, the sub-mesh table (ranges, material, bounds, position decode), the
+	 * level-of-detail and meshlet tables (index ranges of each sub-mesh, in sub-mesh order), the
+	 * material table, a string blob with texture names, then the vertex and index arrays in the
+	 * layout Mesh uploads, each starting on a 4 KiB boundary: Vertex or CompactVertex structs
+	 * (each sub-mesh quantized against its own bounds), and 16-bit indices unless a sub-mesh has
+	 * more than 65,536 vertices. Loading maps the file and points ModelData at the arrays, so
+	 * Mesh uploads straight from the mapping with no conversion.
+	 */
+	class MeshFile {
+	public:
+		static constexpr uint32_t Alignment = 4096; ///< Alignment of the vertex and index arrays.
+
+		/**
+		 * @brief Whether the path has the cooked mesh extension (.vmesh).
+		 */
+		static bool IsMeshFile(const std::string &path);
+
+		/**
+		 * @brief Map a cooked model (thread-safe, no GL calls).
+		 * @param importFlags Assimp flags the caller expects; a file cooked with others is rejected.
+		 * @param format Vertex layout the caller uploads; a file cooked in the other one is rejected.
+		 * @return false if the file is missing, malformed or was cooked with other flags or layout.
+		 */
+		static bool Load(const std::string &path, unsigned int importFlags, VertexFormat format, ModelData &data);
+
+		/**
+		 * @brief Write an imported model in `format` (temporary file, then rename).
+		 */
+		static bool Save(const std::string &path, const ModelData &data, unsigned int importFlags, VertexFormat format);
+	};
+
+} // namespace Engine
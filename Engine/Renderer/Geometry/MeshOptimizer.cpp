@@ -0,0 +1,407 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   MeshOptimizer.cpp                                  :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/14 09:52:13 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/16 11:35:12 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#include "Renderer/Geometry/MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <type_traits>
+
+namespace Engine {
+
+	namespace {
+		// Forsyth's scoring constants (cache of 32 entries, as in the original paper)
+		constexpr int ForsythCacheSize	   = 32;
+		constexpr float CacheDecayPower	   = 1.5f;
+		constexpr float LastTriangleScore  = 0.75f;
+		constexpr float ValenceBoostScale  = 2.0f;
+		constexpr float ValenceBoostPower  = 0.5f;
+		constexpr size_t NoTriangle		   = std::numeric_limits<size_t>::max();
+
+		// Favors vertices just used (cache) and vertices with few triangles left (valence boost)
+		float ForsythScore(int cachePosition, unsigned int remaining) {
+			if (remaining == 0)
+				return -1.0f;
+			float score = 0.0f;
+			if (cachePosition >= 0) {
+				if (cachePosition < 3)
+					score = LastTriangleScore;
+				else
+					score = std::pow(1.0f - float(cachePosition - 3) / float(ForsythCacheSize - 3), CacheDecayPower);
+			}
+			return score + ValenceBoostScale * std::pow(float(remaining), -ValenceBoostPower);
+		}
+
+		/// One block holding every temporary array of a pass, so a pass costs a single allocation.
+		class Scratch {
+		public:
+			// Bytes to reserve for `count` values of T, alignment padding included
+			template <typename T>
+			static constexpr size_t Bytes(size_t count) { return count * sizeof(T) + alignof(T); }
+
+			explicit Scratch(size_t bytes)
+				: m_Block(new unsigned char[bytes]) {}
+
+			// Next `count` values of T, all set to `value`; the caller sized the block with Bytes<T>()
+			template <typename T>
+			T *Take(size_t count, const T &value) {
+				static_assert(std::is_trivially_destructible<T>::value, "Scratch never runs destructors");
+				m_Used	= (m_Used + alignof(T) - 1) / alignof(T) * alignof(T);
+				T *data = reinterpret_cast<T *>(m_Block.get() + m_Used);
+				m_Used += count * sizeof(T);
+				std::uninitialized_fill_n(data, count, value);
+				return data;
+			}
+
+			// Hand the whole block out again (the next pass does not need the previous arrays)
+			void Reset() { m_Used = 0; }
+
+		private:
+			std::unique_ptr<unsigned char[]> m_Block;
+			size_t m_Used = 0;
+		};
+
+		/// FIFO post-transform cache simulated with insertion timestamps.
+		struct FifoCache {
+			size_t *insertedAt;
+			size_t time = MeshOptimizer::CacheSize + 1;
+
+			FifoCache(Scratch &scratch, size_t vertexCount)
+				: insertedAt(scratch.Take<size_t>(vertexCount, 0)) {}
+
+			static constexpr size_t Bytes(size_t vertexCount) { return Scratch::Bytes<size_t>(vertexCount); }
+
+			// True if the vertex had to be transformed
+			bool Access(unsigned int vertex) {
+				if (time - insertedAt[vertex] <= MeshOptimizer::CacheSize)
+					return false;
+				insertedAt[vertex] = time++;
+				return true;
+			}
+
+			void Flush() { time += MeshOptimizer::CacheSize + 1; }
+		};
+
+		size_t StatsBytes(size_t vertexCount) {
+			return Scratch::Bytes<bool>(vertexCount) + FifoCache::Bytes(vertexCount);
+		}
+
+		size_t VertexCacheBytes(size_t vertexCount, size_t triangleCount) {
+			return Scratch::Bytes<unsigned int>(vertexCount + 1)	  // offsets
+				   + Scratch::Bytes<unsigned int>(triangleCount * 3) // adjacency
+				   + Scratch::Bytes<unsigned int>(vertexCount)		  // remaining
+				   + Scratch::Bytes<int>(vertexCount)				  // cachePosition
+				   + Scratch::Bytes<float>(vertexCount)			  // vertexScore
+				   + Scratch::Bytes<float>(triangleCount)			  // triangleScore
+				   + Scratch::Bytes<bool>(triangleCount)			  // emitted
+				   + Scratch::Bytes<unsigned int>(triangleCount * 3); // output
+		}
+
+		size_t OverdrawBytes(size_t vertexCount, size_t triangleCount) {
+			return Scratch::Bytes<size_t>(triangleCount + 1) * 2	  // hardClusters, clusters
+				   + FifoCache::Bytes(vertexCount)				  // one cache, reused
+				   + Scratch::Bytes<glm::vec3>(triangleCount) * 2	  // centroids, normals
+				   + Scratch::Bytes<float>(triangleCount) * 2		  // areas, sortKeys
+				   + Scratch::Bytes<size_t>(triangleCount)			  // order
+				   + Scratch::Bytes<unsigned int>(triangleCount * 3); // output
+		}
+
+		size_t VertexFetchBytes(size_t vertexCount) {
+			return Scratch::Bytes<unsigned int>(vertexCount) + Scratch::Bytes<Vertex>(vertexCount);
+		}
+
+		size_t SimulateCache(Scratch &scratch, const unsigned int *indices, size_t indexCount, size_t vertexCount) {
+			scratch.Reset();
+			FifoCache cache(scratch, vertexCount);
+			size_t misses = 0;
+			for (size_t i = 0; i < indexCount; ++i)
+				misses += cache.Access(indices[i]) ? 1 : 0;
+			return misses;
+		}
+
+		void VertexCachePass(Scratch &scratch, unsigned int *indices, size_t indexCount, size_t vertexCount) {
+			const size_t triangleCount = indexCount / 3;
+			if (triangleCount < 2)
+				return;
+			scratch.Reset();
+
+			// Triangles of each vertex; the first `remaining[v]` entries are not emitted yet
+			unsigned int *offsets = scratch.Take<unsigned int>(vertexCount + 1, 0);
+			for (size_t i = 0; i < triangleCount * 3; ++i)
+				++offsets[indices[i] + 1];
+			for (size_t v = 0; v < vertexCount; ++v)
+				offsets[v + 1] += offsets[v];
+			unsigned int *adjacency = scratch.Take<unsigned int>(triangleCount * 3, 0);
+			unsigned int *remaining = scratch.Take<unsigned int>(vertexCount, 0);
+			for (size_t t = 0; t < triangleCount; ++t) {
+				for (int k = 0; k < 3; ++k) {
+					const unsigned int v				   = indices[t * 3 + k];
+					adjacency[offsets[v] + remaining[v]++] = static_cast<unsigned int>(t);
+				}
+			}
+
+			int *cachePosition = scratch.Take<int>(vertexCount, -1);
+			float *vertexScore = scratch.Take<float>(vertexCount, 0.0f);
+			for (size_t v = 0; v < vertexCount; ++v)
+				vertexScore[v] = ForsythScore(-1, remaining[v]);
+			float *triangleScore = scratch.Take<float>(triangleCount, 0.0f);
+			for (size_t t = 0; t < triangleCount; ++t)
+				triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+
+			bool *emitted		 = scratch.Take<bool>(triangleCount, false);
+			unsigned int *output = scratch.Take<unsigned int>(triangleCount * 3, 0);
+			unsigned int cache[ForsythCacheSize + 3];
+			unsigned int newCache[ForsythCacheSize + 3];
+			size_t cacheSize = 0;
+
+			size_t best	  = static_cast<size_t>(std::max_element(triangleScore, triangleScore + triangleCount) - triangleScore);
+			size_t cursor = 0;
+			for (size_t n = 0; n < triangleCount; ++n) {
+				// Nothing left around the cache: continue with the next triangle in input order
+				if (best == NoTriangle) {
+					while (emitted[cursor])
+						++cursor;
+					best = cursor;
+				}
+
+				const unsigned int *triangle = indices + best * 3;
+				std::copy(triangle, triangle + 3, output + n * 3);
+				emitted[best] = true;
+
+				// Drop the triangle from its vertices' lists and put them at the front of the cache
+				size_t newCacheSize = 0;
+				for (int k = 0; k < 3; ++k) {
+					const unsigned int v = triangle[k];
+					unsigned int *begin	 = adjacency + offsets[v];
+					unsigned int *end	 = begin + remaining[v];
+					unsigned int *it	 = std::find(begin, end, static_cast<unsigned int>(best));
+					if (it != end) {
+						std::swap(*it, *(end - 1));
+						--remaining[v];
+					}
+					if (std::find(newCache, newCache + newCacheSize, v) == newCache + newCacheSize)
+						newCache[newCacheSize++] = v;
+				}
+				const size_t fresh = newCacheSize;
+				for (size_t i = 0; i < cacheSize; ++i) {
+					if (std::find(newCache, newCache + fresh, cache[i]) == newCache + fresh)
+						newCache[newCacheSize++] = cache[i];
+				}
+
+				// Rescore everything that moved in or out of the cache
+				for (size_t i = 0; i < newCacheSize; ++i) {
+					const unsigned int v = newCache[i];
+					cachePosition[v]	 = i < ForsythCacheSize ? static_cast<int>(i) : -1;
+					const float score	 = ForsythScore(cachePosition[v], remaining[v]);
+					const float delta	 = score - vertexScore[v];
+					vertexScore[v]		 = score;
+					for (unsigned int j = 0; j < remaining[v]; ++j)
+						triangleScore[adjacency[offsets[v] + j]] += delta;
+				}
+
+				// Best candidate among the triangles of cached vertices
+				best			= NoTriangle;
+				float bestScore = -1.0f;
+				cacheSize		= std::min<size_t>(newCacheSize, ForsythCacheSize);
+				for (size_t i = 0; i < cacheSize; ++i) {
+					const unsigned int v = newCache[i];
+					for (unsigned int j = 0; j < remaining[v]; ++j) {
+						const unsigned int t = adjacency[offsets[v] + j];
+						if (triangleScore[t] > bestScore) {
+							bestScore = triangleScore[t];
+							best	  = t;
+						}
+					}
+				}
+				std::copy(newCache, newCache + cacheSize, cache);
+			}
+
+			std::copy(output, output + triangleCount * 3, indices);
+		}
+
+		void OverdrawPass(Scratch &scratch, unsigned int *indices, size_t indexCount, const Vertex *vertices, size_t vertexCount, float threshold) {
+			const size_t triangleCount = indexCount / 3;
+			if (triangleCount < 2)
+				return;
+			scratch.Reset();
+
+			// 1. Hard boundaries: triangles that miss all three vertices start over with a cold cache
+			// Both boundary lists are sized for the worst case (one cluster per triangle)
+			size_t *hardClusters	 = scratch.Take<size_t>(triangleCount + 1, 0);
+			size_t hardClusterCount = 0;
+			FifoCache cache(scratch, vertexCount);
+			for (size_t t = 0; t < triangleCount; ++t) {
+				int misses = 0;
+				for (int k = 0; k < 3; ++k)
+					misses += cache.Access(indices[t * 3 + k]) ? 1 : 0;
+				if (t == 0 || misses == 3)
+					hardClusters[hardClusterCount++] = t;
+			}
+			hardClusters[hardClusterCount++] = triangleCount;
+
+			// 2. Soft boundaries: split a cluster once its running miss ratio is within `threshold` of its total
+			size_t *clusters	 = scratch.Take<size_t>(triangleCount + 1, 0);
+			size_t boundaryCount = 0;
+			for (size_t c = 0; c + 1 < hardClusterCount; ++c) {
+				const size_t begin = hardClusters[c];
+				const size_t end   = hardClusters[c + 1];
+				cache.Flush();
+				size_t clusterMisses = 0;
+				for (size_t i = begin * 3; i < end * 3; ++i)
+					clusterMisses += cache.Access(indices[i]) ? 1 : 0;
+				const float target = threshold * float(clusterMisses) / float(end - begin);
+
+				cache.Flush();
+				clusters[boundaryCount++] = begin;
+				size_t start			  = begin;
+				size_t misses			  = 0;
+				for (size_t t = begin; t < end; ++t) {
+					for (int k = 0; k < 3; ++k)
+						misses += cache.Access(indices[t * 3 + k]) ? 1 : 0;
+					if (t + 1 < end && float(misses) / float(t + 1 - start) <= target) {
+						clusters[boundaryCount++] = t + 1;
+						start					  = t + 1;
+						misses					  = 0;
+						cache.Flush();
+					}
+				}
+			}
+			clusters[boundaryCount++] = triangleCount;
+
+			// 3. Draw the clusters that face away from the mesh center first (they occlude the rest)
+			const size_t clusterCount = boundaryCount - 1;
+			glm::vec3 *centroids	  = scratch.Take<glm::vec3>(clusterCount, glm::vec3(0.0f));
+			glm::vec3 *normals		  = scratch.Take<glm::vec3>(clusterCount, glm::vec3(0.0f));
+			float *areas			  = scratch.Take<float>(clusterCount, 0.0f);
+			glm::vec3 meshCentroid(0.0f);
+			float meshArea = 0.0f;
+			for (size_t c = 0; c < clusterCount; ++c) {
+				for (size_t t = clusters[c]; t < clusters[c + 1]; ++t) {
+					const glm::vec3 &p0	   = vertices[indices[t * 3]].Position;
+					const glm::vec3 &p1	   = vertices[indices[t * 3 + 1]].Position;
+					const glm::vec3 &p2	   = vertices[indices[t * 3 + 2]].Position;
+					const glm::vec3 normal = glm::cross(p1 - p0, p2 - p0); // Length = 2 * area
+					const float area	   = glm::length(normal) * 0.5f;
+					centroids[c] += (p0 + p1 + p2) * (area / 3.0f);
+					normals[c] += normal;
+					areas[c] += area;
+				}
+				meshCentroid += centroids[c];
+				meshArea += areas[c];
+			}
+			if (meshArea <= 0.0f)
+				return;
+			meshCentroid /= meshArea;
+
+			float *sortKeys = scratch.Take<float>(clusterCount, 0.0f);
+			size_t *order	= scratch.Take<size_t>(clusterCount, 0);
+			for (size_t c = 0; c < clusterCount; ++c) {
+				order[c] = c;
+				if (areas[c] > 0.0f && glm::dot(normals[c], normals[c]) > 0.0f)
+					sortKeys[c] = glm::dot(centroids[c] / areas[c] - meshCentroid, glm::normalize(normals[c]));
+			}
+			// Ties keep their cache order; std::stable_sort would allocate its merge buffer
+			std::sort(order, order + clusterCount, [&](size_t a, size_t b) {
+				return sortKeys[a] > sortKeys[b] || (sortKeys[a] == sortKeys[b] && a < b);
+			});
+
+			unsigned int *output = scratch.Take<unsigned int>(triangleCount * 3, 0);
+			unsigned int *cursor = output;
+			for (size_t i = 0; i < clusterCount; ++i)
+				cursor = std::copy(indices + clusters[order[i]] * 3, indices + clusters[order[i] + 1] * 3, cursor);
+			std::copy(output, output + triangleCount * 3, indices);
+		}
+
+		void VertexFetchPass(Scratch &scratch, Vertex *vertices, size_t vertexCount, unsigned int *indices, size_t indexCount) {
+			constexpr unsigned int Unused = std::numeric_limits<unsigned int>::max();
+			scratch.Reset();
+			unsigned int *remap = scratch.Take<unsigned int>(vertexCount, Unused);
+			unsigned int next	= 0;
+			for (size_t i = 0; i < indexCount; ++i) {
+				unsigned int &target = remap[indices[i]];
+				if (target == Unused)
+					target = next++;
+				indices[i] = target;
+			}
+			for (size_t v = 0; v < vertexCount; ++v) {
+				if (remap[v] == Unused)
+					remap[v] = next++;
+			}
+
+			Vertex *reordered = scratch.Take<Vertex>(vertexCount, Vertex{});
+			for (size_t v = 0; v < vertexCount; ++v)
+				reordered[remap[v]] = vertices[v];
+			std::copy(reordered, reordered + vertexCount, vertices);
+		}
+	} // namespace
+
+	MeshOptimizer::Stats &MeshOptimizer::Stats::operator+=(const Stats &other) {
+		triangles += other.triangles;
+		vertices += other.vertices;
+		missesBefore += other.missesBefore;
+		missesAfter += other.missesAfter;
+		return *this;
+	}
+
+	size_t MeshOptimizer::CountCacheMisses(const unsigned int *indices, size_t indexCount, size_t vertexCount) {
+		Scratch scratch(FifoCache::Bytes(vertexCount));
+		return SimulateCache(scratch, indices, indexCount, vertexCount);
+	}
+
+	MeshOptimizer::Stats MeshOptimizer::Optimize(Vertex *vertices, size_t vertexCount, unsigned int *indices, size_t indexCount, float threshold) {
+		indexCount -= indexCount % 3;
+		const size_t triangleCount = indexCount / 3;
+
+		// Every pass reuses the same block, sized for the largest one
+		Scratch scratch(std::max({StatsBytes(vertexCount), VertexCacheBytes(vertexCount, triangleCount),
+								  OverdrawBytes(vertexCount, triangleCount), VertexFetchBytes(vertexCount)}));
+
+		Stats stats;
+		stats.triangles	 = triangleCount;
+		bool *referenced = scratch.Take<bool>(vertexCount, false);
+		for (size_t i = 0; i < indexCount; ++i) {
+			stats.vertices += referenced[indices[i]] ? 0 : 1;
+			referenced[indices[i]] = true;
+		}
+		stats.missesBefore = SimulateCache(scratch, indices, indexCount, vertexCount);
+
+		VertexCachePass(scratch, indices, indexCount, vertexCount);
+		OverdrawPass(scratch, indices, indexCount, vertices, vertexCount, threshold);
+		VertexFetchPass(scratch, vertices, vertexCount, indices, indexCount);
+
+		stats.missesAfter = SimulateCache(scratch, indices, indexCount, vertexCount);
+		return stats;
+	}
+
+	MeshOptimizer::Stats MeshOptimizer::Optimize(std::vector<Vertex> &vertices, std::vector<unsigned int> &indices, float threshold) {
+		return Optimize(vertices.data(), vertices.size(), indices.data(), indices.size(), threshold);
+	}
+
+	void MeshOptimizer::OptimizeVertexCache(unsigned int *indices, size_t indexCount, size_t vertexCount) {
+		Scratch scratch(VertexCacheBytes(vertexCount, indexCount / 3));
+		VertexCachePass(scratch, indices, indexCount, vertexCount);
+	}
+
+	void MeshOptimizer::OptimizeOverdraw(unsigned int *indices, size_t indexCount, const Vertex *vertices, size_t vertexCount, float threshold) {
+		Scratch scratch(OverdrawBytes(vertexCount, indexCount / 3));
+		OverdrawPass(scratch, indices, indexCount, vertices, vertexCount, threshold);
+	}
+
+	void MeshOptimizer::OptimizeVertexFetch(Vertex *vertices, size_t vertexCount, unsigned int *indices, size_t indexCount) {
+		Scratch scratch(VertexFetchBytes(vertexCount));
+		VertexFetchPass(scratch, vertices, vertexCount, indices, indexCount);
+	}
+
+} // namespace Engine
@@ -0,0 +1,96 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   MeshOptimizer.h                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/14 09:52:13 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/16 11:35:12 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+
+#pragma once
+
+#include "Renderer/Geometry/Mesh.h"
+#include <cstddef>
+#include <vector>
+
+/**
+ * @file MeshOptimizer.h
+ * @brief Import-time triangle and vertex reordering for the GPU vertex cache, overdraw and vertex fetch.
+ */
+
+namespace Engine {
+
+	/**
+	 * @class MeshOptimizer
+	 * @brief Reorders an indexed triangle list in place; the rendered surface is unchanged.
+	 *
+	 * Optimize() runs, in order:
+	 *   1. OptimizeVertexCache(): Forsyth's linear-speed ordering, so consecutive triangles
+	 *      reuse recently transformed vertices.
+	 *   2. OptimizeOverdraw(): splits that order into clusters and draws outward-facing
+	 *      clusters first, keeping the cache miss ratio within `threshold` of step 1.
+	 *   3. OptimizeVertexFetch(): stores vertices in first-use order so fetches are sequential.
+	 *
+	 * Efficiency is measured with a FIFO post-transform cache of CacheSize entries:
+	 * ACMR (transformed vertices per triangle, 0.5 at best) and ATVR (transformed vertices per
+	 * referenced vertex, 1.0 at best).
+	 *
+	 * Every call makes a single heap allocation for its temporary arrays (Optimize() shares it between passes).
+	 */
+	class MeshOptimizer {
+	public:
+		static constexpr unsigned int CacheSize = 16; ///< Simulated post-transform cache entries.
+
+		/**
+		 * @brief Cache efficiency before and after optimisation (sums over meshes with +=).
+		 */
+		struct Stats {
+			size_t triangles	= 0; ///< Triangles processed.
+			size_t vertices		= 0; ///< Distinct vertices referenced.
+			size_t missesBefore = 0; ///< Simulated vertex transforms before.
+			size_t missesAfter	= 0; ///< Simulated vertex transforms after.
+
+			float GetACMRBefore() const { return triangles ? float(missesBefore) / float(triangles) : 0.0f; }
+			float GetACMRAfter() const { return triangles ? float(missesAfter) / float(triangles) : 0.0f; }
+			float GetATVRBefore() const { return vertices ? float(missesBefore) / float(vertices) : 0.0f; }
+			float GetATVRAfter() const { return vertices ? float(missesAfter) / float(vertices) : 0.0f; }
+
+			Stats &operator+=(const Stats &other);
+		};
+
+		/**
+		 * @brief Run the three passes on a triangle list.
+		 * @param vertices Vertex array (reordered in place).
+		 * @param indices Triangle list into `vertices` (rewritten in place).
+		 * @param threshold Cache miss ratio allowed for overdraw ordering, relative to the cache-optimal order.
+		 */
+		static Stats Optimize(Vertex *vertices, size_t vertexCount, unsigned int *indices, size_t indexCount, float threshold = 1.05f);
+		static Stats Optimize(std::vector<Vertex> &vertices, std::vector<unsigned int> &indices, float threshold = 1.05f);
+
+		/**
+		 * @brief Reorder triangles for vertex reuse (Forsyth).
+		 */
+		static void OptimizeVertexCache(unsigned int *indices, size_t indexCount, size_t vertexCount);
+
+		/**
+		 * @brief Reorder clusters of a cache-optimised list to reduce overdraw (Sander et al. 2007).
+		 */
+		static void OptimizeOverdraw(unsigned int *indices, size_t indexCount, const Vertex *vertices, size_t vertexCount, float threshold);
+
+		/**
+		 * @brief Reorder vertices by first use and remap the indices (unreferenced vertices move to the end).
+		 */
+		static void OptimizeVertexFetch(Vertex *vertices, size_t vertexCount, unsigned int *indices, size_t indexCount);
+
+		/**
+		 * @brief Simulated vertex transforms of a triangle list with a FIFO cache of CacheSize entries.
+		 */
+		static size_t CountCacheMisses(const unsigned int *indices, size_t indexCount, size_t vertexCount);
+	};
+
+} // namespace Engine
@@ -0,0 +1,285 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   MeshSimplifier.cpp                                 :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/14 14:08:31 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/14 14:08:31 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#include "Renderer/Geometry/MeshSimplifier.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <unordered_map>
+
+namespace Engine {
+
+	namespace {
+		// Sum of squared distances to a set of planes, as a symmetric 4x4 matrix weighted by triangle area
+		struct Quadric {
+			double a00 = 0.0, a01 = 0.0, a02 = 0.0, a03 = 0.0;
+			double a11 = 0.0, a12 = 0.0, a13 = 0.0;
+			double a22 = 0.0, a23 = 0.0;
+			double a33	  = 0.0;
+			double weight = 0.0;
+
+			void AddPlane(const glm::vec3 &n, float d, double w) {
+				a00 += w * n.x * n.x;
+				a01 += w * n.x * n.y;
+				a02 += w * n.x * n.z;
+				a03 += w * n.x * d;
+				a11 += w * n.y * n.y;
+				a12 += w * n.y * n.z;
+				a13 += w * n.y * d;
+				a22 += w * n.z * n.z;
+				a23 += w * n.z * d;
+				a33 += w * d * d;
+				weight += w;
+			}
+
+			Quadric &operator+=(const Quadric &other) {
+				a00 += other.a00, a01 += other.a01, a02 += other.a02, a03 += other.a03;
+				a11 += other.a11, a12 += other.a12, a13 += other.a13;
+				a22 += other.a22, a23 += other.a23;
+				a33 += other.a33;
+				weight += other.weight;
+				return *this;
+			}
+
+			// Area-weighted mean squared distance of p to the planes
+			double Evaluate(const glm::vec3 &p) const {
+				if (weight <= 0.0)
+					return 0.0;
+				const double x = p.x, y = p.y, z = p.z;
+				const double sum = a00 * x * x + a11 * y * y + a22 * z * z + 2.0 * (a01 * x * y + a02 * x * z + a12 * y * z) +
+								   2.0 * (a03 * x + a13 * y + a23 * z) + a33;
+				return std::max(sum, 0.0) / weight;
+			}
+		};
+
+		// Position, normal and UV bits of a vertex (attributes zeroed to compare positions only)
+		struct VertexKey {
+			float values[8];
+
+			bool operator==(const VertexKey &other) const { return std::memcmp(values, other.values, sizeof(values)) == 0; }
+		};
+
+		struct VertexKeyHash {
+			size_t operator()(const VertexKey &key) const {
+				uint32_t bits[8];
+				std::memcpy(bits, key.values, sizeof(bits));
+				size_t hash = 2166136261u;
+				for (uint32_t word : bits)
+					hash = (hash ^ word) * 16777619u;
+				return hash;
+			}
+		};
+
+		VertexKey MakeKey(const Vertex &vertex, bool withAttributes) {
+			VertexKey key{};
+			key.values[0] = vertex.Position.x;
+			key.values[1] = vertex.Position.y;
+			key.values[2] = vertex.Position.z;
+			if (withAttributes) {
+				key.values[3] = vertex.Normal.x;
+				key.values[4] = vertex.Normal.y;
+				key.values[5] = vertex.Normal.z;
+				key.values[6] = vertex.TexCoords.x;
+				key.values[7] = vertex.TexCoords.y;
+			}
+			return key;
+		}
+
+		// Moving `from` onto `to`
+		struct Collapse {
+			unsigned int from;
+			unsigned int to;
+			double cost;
+		};
+
+		// True if moving `from` onto `to` turns a surviving triangle around `from` over (or nearly so)
+		bool FlipsTriangle(const Vertex *vertices, const unsigned int *indices, const unsigned int *triangles, size_t triangleCount, unsigned int from,
+						   unsigned int to) {
+			for (size_t i = 0; i < triangleCount; ++i) {
+				const unsigned int *corners = indices + triangles[i] * 3;
+				if (corners[0] == to || corners[1] == to || corners[2] == to)
+					continue; // Collapses away
+
+				const glm::vec3 &a	 = vertices[corners[0]].Position;
+				const glm::vec3 &b	 = vertices[corners[1]].Position;
+				const glm::vec3 &c	 = vertices[corners[2]].Position;
+				const glm::vec3 &p	 = vertices[to].Position;
+				const glm::vec3 na	 = corners[0] == from ? p : a;
+				const glm::vec3 nb	 = corners[1] == from ? p : b;
+				const glm::vec3 nc	 = corners[2] == from ? p : c;
+				const glm::vec3 before = glm::cross(b - a, c - a);
+				const glm::vec3 after  = glm::cross(nb - na, nc - na);
+				if (glm::dot(before, after) <= 0.25f * glm::length(before) * glm::length(after))
+					return true;
+			}
+			return false;
+		}
+	} // namespace
+
+	std::vector<unsigned int> MeshSimplifier::Simplify(const Vertex *vertices, size_t vertexCount, const unsigned int *indices, size_t indexCount,
+													   size_t targetIndexCount, float maxError, float *outError) {
+		std::vector<unsigned int> result(indices, indices + indexCount);
+		if (outError)
+			*outError = 0.0f;
+		if (indexCount <= targetIndexCount || vertexCount == 0)
+			return result;
+
+		// Merge identical vertices (unindexed imports duplicate every corner) and group them by position
+		std::vector<unsigned int> canonical(vertexCount);
+		std::vector<unsigned int> position(vertexCount);
+		{
+			std::unordered_map<VertexKey, unsigned int, VertexKeyHash> vertexIds;
+			std::unordered_map<VertexKey, unsigned int, VertexKeyHash> positionIds;
+			vertexIds.reserve(vertexCount);
+			positionIds.reserve(vertexCount);
+			for (unsigned int v = 0; v < vertexCount; ++v) {
+				canonical[v] = vertexIds.emplace(MakeKey(vertices[v], true), v).first->second;
+				position[v]	 = positionIds.emplace(MakeKey(vertices[v], false), v).first->second;
+			}
+		}
+		for (unsigned int &index : result)
+			index = canonical[index];
+
+		// Seams: a position shared by distinct vertices. Borders: an edge not shared by exactly two triangles.
+		// Both are indexed by the first vertex of a position.
+		std::vector<uint8_t> seam(vertexCount, 0);
+		std::vector<uint8_t> locked(vertexCount, 0);
+		for (unsigned int v = 0; v < vertexCount; ++v) {
+			if (canonical[v] == v && position[v] != v)
+				seam[position[v]] = locked[position[v]] = 1;
+		}
+		std::unordered_map<uint64_t, uint32_t> edgeUses;
+		edgeUses.reserve(result.size());
+		for (size_t i = 0; i < result.size(); i += 3) {
+			for (int e = 0; e < 3; ++e) {
+				const uint64_t a = position[result[i + e]];
+				const uint64_t b = position[result[i + (e + 1) % 3]];
+				++edgeUses[std::min(a, b) << 32 | std::max(a, b)];
+			}
+		}
+		for (const auto &[edge, uses] : edgeUses) {
+			if (uses != 2)
+				locked[edge >> 32] = locked[edge & 0xFFFFFFFFu] = 1;
+		}
+
+		// Plane quadrics of the triangles around each position
+		std::vector<Quadric> quadrics(vertexCount);
+		for (size_t i = 0; i < result.size(); i += 3) {
+			const glm::vec3 &a = vertices[result[i]].Position;
+			const glm::vec3 &b = vertices[result[i + 1]].Position;
+			const glm::vec3 &c = vertices[result[i + 2]].Position;
+			glm::vec3 normal   = glm::cross(b - a, c - a);
+			const float length = glm::length(normal);
+			if (length <= 0.0f)
+				continue;
+			normal /= length;
+			for (int corner = 0; corner < 3; ++corner)
+				quadrics[position[result[i + corner]]].AddPlane(normal, -glm::dot(normal, a), 0.5 * length);
+		}
+
+		// Passes of independent collapses, cheapest first; a vertex moves at most once per pass
+		const double maxCost		 = double(maxError) * double(maxError);
+		const size_t targetTriangles = targetIndexCount / 3;
+		double worstCost			 = 0.0;
+		std::vector<Collapse> collapses;
+		std::vector<unsigned int> remap(vertexCount);
+		std::vector<uint8_t> touched(vertexCount);
+		std::vector<unsigned int> triangleOffsets(vertexCount + 1);
+		std::vector<unsigned int> triangleList;
+		while (result.size() > targetIndexCount) {
+			const size_t triangleCount = result.size() / 3;
+
+			// Each interior edge has one half-edge per direction, so both collapses are considered.
+			// Only vertices that are not locked move, and only onto vertices that are not on a seam
+			// (the target's attributes then match on every triangle around the moved vertex).
+			collapses.clear();
+			for (size_t i = 0; i < result.size(); i += 3) {
+				for (int e = 0; e < 3; ++e) {
+					const unsigned int from = result[i + e];
+					const unsigned int to	= result[i + (e + 1) % 3];
+					if (locked[position[from]] || seam[position[to]])
+						continue;
+					Quadric quadric = quadrics[from];
+					quadric += quadrics[to];
+					collapses.push_back({from, to, quadric.Evaluate(vertices[to].Position)});
+				}
+			}
+			if (collapses.empty())
+				break;
+			std::sort(collapses.begin(), collapses.end(), [](const Collapse &a, const Collapse &b) { return a.cost < b.cost; });
+
+			// Triangles around each vertex
+			std::fill(triangleOffsets.begin(), triangleOffsets.end(), 0u);
+			for (unsigned int index : result)
+				++triangleOffsets[index + 1];
+			std::partial_sum(triangleOffsets.begin(), triangleOffsets.end(), triangleOffsets.begin());
+			triangleList.resize(result.size());
+			{
+				std::vector<unsigned int> cursor(triangleOffsets.begin(), triangleOffsets.end() - 1);
+				for (size_t i = 0; i < result.size(); ++i)
+					triangleList[cursor[result[i]]++] = static_cast<unsigned int>(i / 3);
+			}
+
+			std::iota(remap.begin(), remap.end(), 0u);
+			std::fill(touched.begin(), touched.end(), uint8_t(0));
+			size_t trianglesLeft = triangleCount;
+			size_t applied		 = 0;
+			for (const Collapse &collapse : collapses) {
+				if (collapse.cost > maxCost || trianglesLeft <= targetTriangles)
+					break;
+				if (touched[collapse.from] || touched[collapse.to])
+					continue;
+				const unsigned int *around = triangleList.data() + triangleOffsets[collapse.from];
+				const size_t aroundCount   = triangleOffsets[collapse.from + 1] - triangleOffsets[collapse.from];
+				if (FlipsTriangle(vertices, result.data(), around, aroundCount, collapse.from, collapse.to))
+					continue;
+
+				// Freeze every triangle that changes so the flip tests of this pass stay valid
+				for (size_t i = 0; i < aroundCount; ++i) {
+					const unsigned int *corners = result.data() + around[i] * 3;
+					touched[corners[0]] = touched[corners[1]] = touched[corners[2]] = 1;
+					if (corners[0] == collapse.to || corners[1] == collapse.to || corners[2] == collapse.to)
+						--trianglesLeft;
+				}
+				remap[collapse.from] = collapse.to;
+				quadrics[collapse.to] += quadrics[collapse.from];
+				worstCost = std::max(worstCost, collapse.cost);
+				++applied;
+			}
+			if (applied == 0)
+				break;
+
+			// Apply the pass and drop the triangles that collapsed
+			size_t write = 0;
+			for (size_t i = 0; i < result.size(); i += 3) {
+				const unsigned int a = remap[result[i]];
+				const unsigned int b = remap[result[i + 1]];
+				const unsigned int c = remap[result[i + 2]];
+				if (a == b || b == c || a == c)
+					continue;
+				result[write++] = a;
+				result[write++] = b;
+				result[write++] = c;
+			}
+			result.resize(write);
+		}
+
+		if (outError)
+			*outError = static_cast<float>(std::sqrt(worstCost));
+		return result;
+	}
+
+} // namespace Engine
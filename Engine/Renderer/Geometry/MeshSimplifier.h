@@ -0,0 +1,52 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   MeshSimplifier.h                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/14 14:08:31 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/14 14:08:31 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+
+#pragma once
+
+#include "Renderer/Geometry/Mesh.h"
+#include <cstddef>
+#include <vector>
+
+/**
+ * @file MeshSimplifier.h
+ * @brief Import-time triangle reduction for level-of-detail chains.
+ */
+
+namespace Engine {
+
+	/**
+	 * @class MeshSimplifier
+	 * @brief Quadric error metric edge collapse (Garland & Heckbert 1997) over an indexed triangle list.
+	 *
+	 * Only indices change: each collapse moves one vertex onto a neighbour that already exists,
+	 * so every level of detail can share the vertex buffer of the full-detail mesh.
+	 * Vertices with identical position, normal and UV are merged first; vertices on a border
+	 * or on an attribute seam (same position, different normal or UV) never move.
+	 */
+	class MeshSimplifier {
+	public:
+		/**
+		 * @brief Collapse edges, cheapest first, until the target is reached or the next collapse costs too much.
+		 * @param vertices Vertex array (unchanged).
+		 * @param indices Triangle list into `vertices`.
+		 * @param targetIndexCount Stop once the result has at most this many indices.
+		 * @param maxError Largest distance (object units) a collapsed vertex may move off the original surface.
+		 * @param outError Receives the largest error actually introduced (may be nullptr).
+		 * @return Simplified triangle list into `vertices`.
+		 */
+		static std::vector<unsigned int> Simplify(const Vertex *vertices, size_t vertexCount, const unsigned int *indices, size_t indexCount,
+												  size_t targetIndexCount, float maxError, float *outError = nullptr);
+	};
+
+} // namespace Engine
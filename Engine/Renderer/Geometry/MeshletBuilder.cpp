@@ -0,0 +1,132 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   MeshletBuilder.cpp                                 :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/14 18:04:55 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/16 10:46:02 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#include "Renderer/Geometry/MeshletBuilder.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Engine {
+
+	namespace {
+		// Cones wider than this (cos of the half-angle) reject too rarely to be worth testing
+		constexpr float MinConeSpread = 0.1f;
+
+		// Bounds of a finished meshlet: sphere around the AABB center, cone around the mean normal.
+		// `normals` is scratch shared by every meshlet of a Build() call.
+		void ComputeBounds(Meshlet &meshlet, const Vertex *vertices, const unsigned int *indices, std::vector<glm::vec3> &normals) {
+			const unsigned int *first = indices + meshlet.firstIndex;
+			glm::vec3 minBounds		  = vertices[first[0]].Position;
+			glm::vec3 maxBounds		  = minBounds;
+			for (uint32_t i = 0; i < meshlet.indexCount; ++i) {
+				minBounds = glm::min(minBounds, vertices[first[i]].Position);
+				maxBounds = glm::max(maxBounds, vertices[first[i]].Position);
+			}
+			meshlet.center = (minBounds + maxBounds) * 0.5f;
+			float radius2  = 0.0f;
+			for (uint32_t i = 0; i < meshlet.indexCount; ++i) {
+				const glm::vec3 offset = vertices[first[i]].Position - meshlet.center;
+				radius2				   = std::max(radius2, glm::dot(offset, offset));
+			}
+			meshlet.radius = std::sqrt(radius2);
+
+			normals.clear();
+			glm::vec3 axis(0.0f);
+			for (uint32_t i = 0; i + 2 < meshlet.indexCount; i += 3) {
+				const glm::vec3 &a	 = vertices[first[i]].Position;
+				const glm::vec3 &b	 = vertices[first[i + 1]].Position;
+				const glm::vec3 &c	 = vertices[first[i + 2]].Position;
+				const glm::vec3 normal = glm::cross(b - a, c - a);
+				const float length	   = glm::length(normal);
+				if (length <= 0.0f)
+					continue;
+				normals.push_back(normal / length);
+				axis += normals.back();
+			}
+			const float axisLength = glm::length(axis);
+			if (normals.empty() || axisLength <= 0.0f)
+				return; // No usable cone: never rejected as back-facing
+			meshlet.coneAxis = axis / axisLength;
+
+			float minDot = 1.0f;
+			for (const glm::vec3 &normal : normals)
+				minDot = std::min(minDot, glm::dot(normal, meshlet.coneAxis));
+			// Stored as the sine of the half-angle: see IsVisible()
+			meshlet.coneCutoff = minDot <= MinConeSpread ? 1.0f : std::sqrt(1.0f - minDot * minDot);
+		}
+	} // namespace
+
+	std::vector<Meshlet> MeshletBuilder::Build(const Vertex *vertices, size_t vertexCount, const unsigned int *indices, size_t firstIndex, size_t indexCount) {
+		std::vector<Meshlet> meshlets;
+		if (indexCount < 3)
+			return meshlets;
+
+		// A finished meshlet holds at least MaxVertices / 3 triangles (each adds at most 3 vertices),
+		// so this bound never reallocates; the result is copied out at its exact size
+		meshlets.reserve(indexCount / 3 / (MaxVertices / 3) + 1);
+		std::vector<glm::vec3> normals;
+		normals.reserve(MaxTriangles);
+
+		// owner[v] = 1 + index of the last meshlet that used vertex v
+		std::vector<uint32_t> owner(vertexCount, 0);
+		Meshlet current;
+		current.firstIndex = static_cast<uint32_t>(firstIndex);
+		size_t vertexUsed  = 0;
+		const auto finish  = [&]() {
+			ComputeBounds(current, vertices, indices, normals);
+			meshlets.push_back(current);
+			current			   = Meshlet();
+			current.firstIndex = meshlets.back().firstIndex + meshlets.back().indexCount;
+			vertexUsed		   = 0;
+		};
+
+		for (size_t i = firstIndex; i + 2 < firstIndex + indexCount; i += 3) {
+			// Vertices the triangle would add to the current meshlet
+			const uint32_t id	 = static_cast<uint32_t>(meshlets.size()) + 1;
+			const unsigned int a = indices[i], b = indices[i + 1], c = indices[i + 2];
+			const size_t added	 = size_t(owner[a] != id) + size_t(owner[b] != id && b != a) + size_t(owner[c] != id && c != a && c != b);
+			if (current.indexCount > 0 && (vertexUsed + added > MaxVertices || current.indexCount / 3 == MaxTriangles))
+				finish();
+
+			const uint32_t owned = static_cast<uint32_t>(meshlets.size()) + 1;
+			for (unsigned int vertex : {a, b, c}) {
+				if (owner[vertex] != owned) {
+					owner[vertex] = owned;
+					++vertexUsed;
+				}
+			}
+			current.indexCount += 3;
+		}
+		if (current.indexCount > 0)
+			finish();
+		return std::vector<Meshlet>(meshlets.begin(), meshlets.end());
+	}
+
+	bool MeshletBuilder::IsVisible(const Meshlet &meshlet, const ClusterCullView &view) {
+		const float radius = meshlet.radius * view.radiusScale;
+		for (const glm::vec4 &plane : view.frustumPlanes) {
+			if (glm::dot(glm::vec3(plane), meshlet.center) + plane.w < -radius)
+				return false;
+		}
+		if (!view.cullBackfaces || meshlet.coneCutoff >= 1.0f)
+			return true;
+
+		// Every normal is within the cone's half-angle of the axis, so the cluster faces away when
+		// all view rays into its sphere make at most (90 degrees - half-angle) with the axis
+		if (view.orthographic)
+			return glm::dot(view.viewDirection, meshlet.coneAxis) < meshlet.coneCutoff;
+		const glm::vec3 toCenter = meshlet.center - view.viewPosition;
+		return glm::dot(toCenter, meshlet.coneAxis) < meshlet.coneCutoff * glm::length(toCenter) + meshlet.radius;
+	}
+
+} // namespace Engine
@@ -0,0 +1,56 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   MeshletBuilder.h                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/14 18:04:55 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/14 18:04:55 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+
+#pragma once
+
+#include "Renderer/Geometry/Mesh.h"
+#include <cstddef>
+#include <vector>
+
+/**
+ * @file MeshletBuilder.h
+ * @brief Splits triangle lists into small clusters that can be culled before rasterisation.
+ */
+
+namespace Engine {
+
+	/**
+	 * @class MeshletBuilder
+	 * @brief Groups consecutive triangles into meshlets and tests them against a ClusterCullView.
+	 *
+	 * Triangles are taken in index order, so an index buffer already ordered for the vertex cache
+	 * (MeshOptimizer) gives compact clusters, and each meshlet is a contiguous index range that
+	 * can be drawn on its own. Each meshlet keeps a bounding sphere for frustum tests and a normal
+	 * cone for back-face tests.
+	 */
+	class MeshletBuilder {
+	public:
+		static constexpr size_t MaxVertices	 = 64;	///< Distinct vertices per meshlet.
+		static constexpr size_t MaxTriangles = 124; ///< Triangles per meshlet.
+
+		/**
+		 * @brief Partition indices [firstIndex, firstIndex + indexCount) into meshlets.
+		 * @param vertices Vertex array the indices refer to.
+		 * @param indices Whole index buffer; meshlet ranges are offsets into it.
+		 */
+		static std::vector<Meshlet> Build(const Vertex *vertices, size_t vertexCount, const unsigned int *indices, size_t firstIndex, size_t indexCount);
+
+		/**
+		 * @brief False if the meshlet is outside the view, or entirely back-facing when the view culls back faces.
+		 * @param view View in the meshlet's object space (ClusterCullView::ToObjectSpace()).
+		 */
+		static bool IsVisible(const Meshlet &meshlet, const ClusterCullView &view);
+	};
+
+} // namespace Engine
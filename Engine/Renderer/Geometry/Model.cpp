@@ -6,32 +6,212 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/04/27 00:49:21 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/04/29 10:50:28 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2025/05/16 11:33:55 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "Model.h"
+#include "Core/FileUtils.h"
+#include "Core/ThreadPool.h"
 #include "Mesh.h"
+#include "MeshFile.h"
+#include "MeshSimplifier.h"
 #include "Renderer/Materials/DefaultMaterial.h"
 #include "Renderer/Materials/MaterialPBR.h"
 #include "Renderer/Shaders/Shader.h"
 #include "Renderer/Textures/Texture.h"
+#include "Renderer/Textures/TextureCache.h"
 
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <map>
 
 namespace Engine {
 
+	namespace {
+		constexpr size_t MinLodTriangles = 64;	  ///< Sub-meshes below this keep a single level.
+		constexpr float LodMaxError		 = 0.05f; ///< Largest simplification error, relative to the bounding radius.
+		constexpr float LodMinReduction	 = 0.8f;  ///< A level must drop at least 20% of the previous level's triangles.
+
+		float s_LodBias		  = 0.0f;
+		size_t s_StagingBytes = size_t(64) << 20;
+
+		// First texture of a type, ignoring embedded ('*N') and empty names
+		std::string GetTextureFile(aiMaterial *mat, aiTextureType type) {
+			if (mat->GetTextureCount(type) == 0)
+				return {};
+			aiString str;
+			mat->GetTexture(type, 0, &str);
+			std::string textureFile = str.C_Str();
+			if (textureFile.empty() || textureFile[0] == '*')
+				return {};
+			return textureFile;
+		}
+
+		// Color, PBR factors and texture names of an Assimp material
+		MaterialDesc ReadMaterial(aiMaterial *aiMat) {
+			MaterialDesc desc;
+			desc.albedoTexture = GetTextureFile(aiMat, aiTextureType_DIFFUSE);
+			desc.normalTexture = GetTextureFile(aiMat, aiTextureType_NORMALS);
+			desc.aoTexture	   = GetTextureFile(aiMat, aiTextureType_AMBIENT_OCCLUSION);
+
+			aiColor4D color;
+			if (aiGetMaterialColor(aiMat, AI_MATKEY_COLOR_DIFFUSE, &color) == AI_SUCCESS) {
+				desc.albedoColor = {color.r, color.g, color.b};
+			}
+			float factor = 0.0f;
+			if (aiGetMaterialFloat(aiMat, AI_MATKEY_METALLIC_FACTOR, &factor) == AI_SUCCESS) {
+				desc.metallic = factor;
+			} else if (aiGetMaterialFloat(aiMat, "$mat.metallicFactor", 0, 0, &factor) == AI_SUCCESS) {
+				desc.metallic = factor;
+			}
+			if (aiGetMaterialFloat(aiMat, AI_MATKEY_ROUGHNESS_FACTOR, &factor) == AI_SUCCESS) {
+				desc.roughness = factor;
+			} else if (aiGetMaterialFloat(aiMat, "$mat.roughnessFactor", 0, 0, &factor) == AI_SUCCESS) {
+				desc.roughness = factor;
+			}
+			return desc;
+		}
+
+		// Triangles of a mesh (faces that are not triangles are skipped)
+		uint32_t CountTriangleIndices(const aiMesh *mesh) {
+			uint32_t count = 0;
+			for (unsigned int i = 0; i < mesh->mNumFaces; ++i)
+				count += mesh->mFaces[i].mNumIndices == 3 ? 3 : 0;
+			return count;
+		}
+
+		// Collects the meshes of a node hierarchy in draw order and reserves their ranges
+		void CollectMeshes(aiNode *node, const aiScene *scene, ModelData &data, std::vector<const aiMesh *> &meshes) {
+			for (unsigned int i = 0; i < node->mNumMeshes; ++i) {
+				const aiMesh *mesh = scene->mMeshes[node->mMeshes[i]];
+				SubMeshRange range;
+				range.firstVertex = data.subMeshes.empty() ? 0 : data.subMeshes.back().firstVertex + data.subMeshes.back().vertexCount;
+				range.firstIndex  = data.subMeshes.empty() ? 0 : data.subMeshes.back().firstIndex + data.subMeshes.back().indexCount;
+				range.vertexCount = mesh->mNumVertices;
+				range.indexCount  = CountTriangleIndices(mesh);
+				range.material	  = mesh->mMaterialIndex < scene->mNumMaterials ? static_cast<int32_t>(mesh->mMaterialIndex) : -1;
+				data.subMeshes.push_back(range);
+				meshes.push_back(mesh);
+			}
+			for (unsigned int i = 0; i < node->mNumChildren; ++i)
+				CollectMeshes(node->mChildren[i], scene, data, meshes);
+		}
+
+		// Staging bytes of a sub-mesh once converted (simplified levels add at most as many indices again)
+		size_t EstimateStagingBytes(const SubMeshRange &range) {
+			return size_t(range.vertexCount) * sizeof(Vertex) + size_t(range.indexCount) * 2 * sizeof(uint32_t);
+		}
+
+		// Simplified levels of an optimised sub-mesh, appended after its full-detail indices (halving the triangles each time)
+		void BuildLods(const Vertex *vertices, SubMeshRange &range, const uint32_t *indices, std::vector<uint32_t> &lodIndices) {
+			if (range.indexCount < MinLodTriangles * 3)
+				return;
+			range.lods.push_back({0, range.indexCount, 0.0f});
+			const float maxError = range.metrics.boundsRadius * LodMaxError;
+			while (range.lods.size() < size_t(Mesh::MaxLods)) {
+				const MeshLod &previous = range.lods.back();
+				float error				= 0.0f;
+				std::vector<unsigned int> lod =
+					MeshSimplifier::Simplify(vertices, range.vertexCount, indices, range.indexCount, previous.indexCount / 6 * 3, maxError, &error);
+				if (lod.empty() || lod.size() > previous.indexCount * LodMinReduction)
+					break;
+				MeshOptimizer::OptimizeVertexCache(lod.data(), lod.size(), range.vertexCount);
+				range.lods.push_back({range.indexCount + static_cast<uint32_t>(lodIndices.size()), static_cast<uint32_t>(lod.size()), std::max(error, previous.error)});
+				lodIndices.insert(lodIndices.end(), lod.begin(), lod.end());
+			}
+			if (range.lods.size() == 1)
+				range.lods.clear();
+		}
+
+		// Smallest sphere around two spheres
+		void MergeBounds(glm::vec3 &center, float &radius, const glm::vec3 &otherCenter, float otherRadius) {
+			const float distance = glm::length(otherCenter - center);
+			if (distance + otherRadius <= radius)
+				return;
+			if (distance + radius <= otherRadius) {
+				center = otherCenter;
+				radius = otherRadius;
+				return;
+			}
+			const float merged = (distance + radius + otherRadius) * 0.5f;
+			center += (otherCenter - center) * ((merged - radius) / distance);
+			radius = merged;
+		}
+
+		// Converts an Assimp mesh into its reserved range of the model's vertex/index arrays
+		void ProcessMesh(const aiMesh *mesh, SubMeshRange &range, ModelData &data, MeshOptimizer::Stats &stats, std::vector<uint32_t> &lodIndices) {
+			Vertex *verts = data.vertexStorage.data() + range.firstVertex;
+			for (unsigned int i = 0; i < mesh->mNumVertices; ++i) {
+				Vertex &v	= verts[i];
+				v.Position	= {mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z};
+				v.Normal	= mesh->HasNormals() ? glm::vec3(mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z) : glm::vec3(0.0f, 1.0f, 0.0f);
+				v.TexCoords = mesh->HasTextureCoords(0) ? glm::vec2(mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y) : glm::vec2(0.0f);
+				v.Tangent	= mesh->HasTangentsAndBitangents() ? glm::vec3(mesh->mTangents[i].x, mesh->mTangents[i].y, mesh->mTangents[i].z) : glm::vec3(1.0f, 0.0f, 0.0f);
+				v.Bitangent = mesh->HasTangentsAndBitangents() ? glm::vec3(mesh->mBitangents[i].x, mesh->mBitangents[i].y, mesh->mBitangents[i].z) : glm::vec3(0.0f, 0.0f, 1.0f);
+			}
+
+			uint32_t *indices = data.indexStorage.data() + range.firstIndex;
+			for (unsigned int i = 0; i < mesh->mNumFaces; ++i) {
+				const aiFace &face = mesh->mFaces[i];
+				if (face.mNumIndices == 3) {
+					for (unsigned int j = 0; j < face.mNumIndices; ++j)
+						*indices++ = face.mIndices[j];
+				}
+			}
+
+			// Cache, overdraw and fetch order are baked into the imported (and cooked) data
+			stats		  = MeshOptimizer::Optimize(verts, range.vertexCount, data.indexStorage.data() + range.firstIndex, range.indexCount);
+			range.metrics = Mesh::ComputeMetrics(verts, range.vertexCount, data.indexStorage.data() + range.firstIndex, range.indexCount);
+			BuildLods(verts, range, data.indexStorage.data() + range.firstIndex, lodIndices);
+		}
+
+		// Converts a batch of sub-meshes in parallel into their laid-out ranges, then appends each one's coarser levels
+		void ConvertBatch(const aiMesh *const *meshes, ModelData &batch, MeshOptimizer::Stats &stats, size_t (&lodTriangles)[Mesh::MaxLods]) {
+			if (!batch.subMeshes.empty()) {
+				const SubMeshRange &last = batch.subMeshes.back();
+				batch.vertexStorage.resize(last.firstVertex + last.vertexCount);
+				batch.indexStorage.resize(last.firstIndex + last.indexCount);
+			}
+			std::vector<MeshOptimizer::Stats> meshStats(batch.subMeshes.size());
+			std::vector<std::vector<uint32_t>> lodIndices(batch.subMeshes.size());
+			ThreadPool::Get().ParallelFor(0, static_cast<int>(batch.subMeshes.size()), 1, [&](int begin, int end) {
+				for (int i = begin; i < end; ++i)
+					ProcessMesh(meshes[i], batch.subMeshes[i], batch, meshStats[i], lodIndices[i]);
+			});
+
+			std::vector<uint32_t> indices;
+			indices.reserve(batch.indexStorage.size());
+			for (size_t i = 0; i < batch.subMeshes.size(); ++i) {
+				SubMeshRange &range	  = batch.subMeshes[i];
+				const uint32_t *first = batch.indexStorage.data() + range.firstIndex;
+				range.firstIndex	  = static_cast<uint32_t>(indices.size());
+				indices.insert(indices.end(), first, first + range.indexCount);
+				indices.insert(indices.end(), lodIndices[i].begin(), lodIndices[i].end());
+				for (int lod = 0; lod < Mesh::MaxLods; ++lod)
+					lodTriangles[lod] += range.lods.empty() ? range.indexCount / 3 : range.lods[std::min<size_t>(lod, range.lods.size() - 1)].indexCount / 3;
+				range.indexCount += static_cast<uint32_t>(lodIndices[i].size());
+				stats += meshStats[i];
+			}
+			batch.indexStorage = std::move(indices);
+		}
+	} // namespace
+
 	/**
 	 * @brief Construct a Model by loading from file.
 	 * @param path Path to the model file.
 	 */
-	Model::Model(const std::string &path) {
-		LoadModel(path);
+	Model::Model(const std::string &path, unsigned int importFlags, bool useCooked, bool keepCpuCopy)
+		: m_KeepCpuCopy(keepCpuCopy) {
+		LoadModel(path, importFlags, useCooked);
 	}
 
 	Model::~Model() = default;
@@ -40,7 +220,7 @@ namespace Engine {
 	 * @brief Draws all sub-meshes with their materials using the given shader.
 	 * @param shader Shader to use for rendering.
 	 */
-	void Model::Draw(Shader &shader) const {
+	void Model::Draw(Shader &shader, int lod, const ClusterCullView *cull) const {
 		// Get the default material once outside the loop if needed
 		static std::shared_ptr<MaterialPBR> defaultMaterial = GetDefaultMaterial();
 
@@ -161,163 +341,328 @@ namespace Engine {
 			shader.SetUniformFloat("u_Subsurface", material->subsurface);
 			shader.SetUniformVec3("u_SubsurfaceColor", material->subsurfaceColor);
 
+			// Packed AO/Roughness/Metallic/Height (Unit 11)
+			if (material->hasPackedMap && material->packedMap) {
+				material->packedMap->Bind(11);
+				shader.SetUniformInt("u_PackedMap", 11);
+				shader.SetUniformInt("u_PackedChannels", material->packedChannels);
+			} else {
+				shader.SetUniformInt("u_PackedChannels", 0);
+			}
+
 			// Sheen (No specific map in shader, only factors)
 			shader.SetUniformVec3("u_SheenColor", material->sheenColor);
 			shader.SetUniformFloat("u_SheenRoughness", material->sheenRoughness);
 
 			// Draw mesh geometry
-			sub.mesh->Draw();
+			sub.mesh->Draw(lod, cull);
 
 			// Optional: Unbind textures after drawing each submesh?
 			// Generally not necessary if the next submesh rebinds or if state is reset elsewhere.
 		}
 	}
 
+	void Model::ReportTextureUsage(const glm::mat4 &modelMatrix, const TextureResidency::View &view) const {
+		for (const auto &sub : m_SubMeshes) {
+			if (!sub.material)
+				continue;
+			const float pixelsPerUV = TextureResidency::ComputePixelsPerUV(*sub.mesh, modelMatrix, view);
+			if (pixelsPerUV > 0.0f)
+				TextureResidency::Get().ReportMaterial(*sub.material, pixelsPerUV);
+		}
+	}
+
+	size_t Model::GetGPUBytes() const {
+		size_t bytes = 0;
+		for (const auto &sub : m_SubMeshes)
+			bytes += sub.mesh->GetGPUBytes();
+		return bytes;
+	}
+
 	/**
 	 * @brief Draws only geometry (no material uniforms).
 	 * @param shader Shader to use for rendering.
 	 */
-	void Model::DrawGeometry([[maybe_unused]] Shader &shader) const {
+	void Model::DrawGeometry([[maybe_unused]] Shader &shader, int lod, const ClusterCullView *cull) const {
 		for (const auto &sub : m_SubMeshes) {
-			sub.mesh->Draw();
+			sub.mesh->Draw(lod, cull);
 		}
 	}
 
 	/**
-	 * @brief Loads the model from file using Assimp.
-	 * @param path Path to the model file.
+	 * @brief Draws only geometry for several instances at once.
+	 * @param instanceCount Number of instances to draw.
 	 */
-	void Model::LoadModel(const std::string &path) {
-		Assimp::Importer importer;
-		const aiScene *scene = importer.ReadFile(path,
-												 aiProcess_Triangulate |
-													 aiProcess_FlipUVs |
-													 aiProcess_CalcTangentSpace |
-													 aiProcess_GenSmoothNormals);
-
-		if (!scene || !scene->mRootNode || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE) {
-			std::cerr << "Assimp load error: " << importer.GetErrorString() << "\n";
-			return;
-		}
-		// Extract directory for texture loading
-		m_Directory = path.substr(0, path.find_last_of('/'));
-		if (m_Directory == path) {
-			m_Directory = ".";
+	void Model::DrawGeometryInstanced(unsigned int instanceCount, int lod, const ClusterCullView *cull) const {
+		for (const auto &sub : m_SubMeshes) {
+			sub.mesh->DrawInstanced(instanceCount, lod, cull);
 		}
-		ProcessNode(scene->mRootNode, scene);
 	}
 
 	/**
-	 * @brief Recursively process Assimp nodes and meshes.
-	 * @param node Current node.
-	 * @param scene Assimp scene.
+	 * @brief Picks the coarsest level whose error stays under LodErrorPixels (scaled by the bias) on screen.
+	 *
+	 * Going coarser needs the error to drop LodHysteresis below the threshold, so a model
+	 * near a switching distance does not alternate between two levels every frame.
 	 */
-	void Model::ProcessNode(aiNode *node, const aiScene *scene) {
-		for (unsigned int i = 0; i < node->mNumMeshes; ++i) {
-			aiMesh *mesh = scene->mMeshes[node->mMeshes[i]];
-			m_SubMeshes.push_back(ProcessMesh(mesh, scene));
+	int Model::SelectLod(const glm::mat4 &modelMatrix, const TextureResidency::View &view, int currentLod) const {
+		const int lodCount = GetLodCount();
+		if (lodCount <= 1)
+			return 0;
+
+		const glm::vec3 center = glm::vec3(modelMatrix * glm::vec4(m_BoundsCenter, 1.0f));
+		const float scale = std::max({glm::length(glm::vec3(modelMatrix[0])), glm::length(glm::vec3(modelMatrix[1])), glm::length(glm::vec3(modelMatrix[2]))});
+		const float radius = m_BoundsRadius * scale;
+		for (const glm::vec4 &plane : view.frustumPlanes) {
+			if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+				return std::min(std::max(currentLod, 0), lodCount - 1); // Not visible: keep the level until it is
 		}
-		for (unsigned int i = 0; i < node->mNumChildren; ++i)
-			ProcessNode(node->mChildren[i], scene);
+
+		// Screen pixels covered by one object-space unit at the closest point of the bounds
+		const float distance	  = std::max(glm::length(center - view.cameraPosition) - radius, 0.01f);
+		const float pixelsPerUnit = scale * view.pixelsPerUnitAtDistance / distance;
+		const float threshold	  = LodErrorPixels * std::exp2(s_LodBias);
+
+		int lod = std::min(std::max(currentLod, 0), lodCount - 1);
+		while (lod + 1 < lodCount && m_LodErrors[lod + 1] * pixelsPerUnit < threshold * (1.0f - LodHysteresis))
+			++lod;
+		while (lod > 0 && m_LodErrors[lod] * pixelsPerUnit > threshold)
+			--lod;
+		return lod;
+	}
+
+	void Model::SetLodBias(float bias) {
+		s_LodBias = bias;
+	}
+
+	float Model::GetLodBias() {
+		return s_LodBias;
+	}
+
+	void Model::SetStagingBytes(size_t bytes) {
+		s_StagingBytes = bytes;
+	}
+
+	size_t Model::GetStagingBytes() {
+		return s_StagingBytes;
 	}
 
 	/**
-	 * @brief Converts an Assimp mesh to engine Mesh and loads its material.
-	 * @param mesh Assimp mesh.
-	 * @param scene Assimp scene.
-	 * @return SubMesh containing geometry and material.
+	 * @brief Loads the model from its cooked file, or from the source file using Assimp.
+	 * @param path Path to the model file.
+	 * @param importFlags Assimp post-processing steps.
+	 * @param useCooked Try the cooked '.vmesh' sibling first.
 	 */
-	Model::SubMesh Model::ProcessMesh(aiMesh *mesh, const aiScene *scene) {
-		std::vector<Vertex> verts;
-		std::vector<unsigned int> indices;
-		std::shared_ptr<MaterialPBR> material = nullptr;
-
-		verts.reserve(mesh->mNumVertices);
-		for (unsigned int i = 0; i < mesh->mNumVertices; ++i) {
-			Vertex v;
-			v.Position	= {mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z};
-			v.Normal	= mesh->HasNormals() ? glm::vec3(mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z) : glm::vec3(0.0f, 1.0f, 0.0f);
-			v.TexCoords = mesh->HasTextureCoords(0) ? glm::vec2(mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y) : glm::vec2(0.0f);
-			v.Tangent	= mesh->HasTangentsAndBitangents() ? glm::vec3(mesh->mTangents[i].x, mesh->mTangents[i].y, mesh->mTangents[i].z) : glm::vec3(1.0f, 0.0f, 0.0f);
-			v.Bitangent = mesh->HasTangentsAndBitangents() ? glm::vec3(mesh->mBitangents[i].x, mesh->mBitangents[i].y, mesh->mBitangents[i].z) : glm::vec3(0.0f, 0.0f, 1.0f);
-			verts.push_back(v);
+	void Model::LoadModel(const std::string &path, unsigned int importFlags, bool useCooked) {
+		m_Directory = GetDirectory(path);
+		ModelData data;
+		// Cooked geometry is in upload layout: a CPU copy needs the source
+		if (useCooked && !m_KeepCpuCopy && LoadCooked(path, importFlags, data)) {
+			Build(data);
+		} else {
+			// Each batch is on the GPU before the next one is converted
+			ImportStreamed(path, importFlags, s_StagingBytes, [this](ModelData &batch, bool) {
+				Build(batch);
+				return true;
+			});
 		}
+		FinishLoading();
+	}
 
-		indices.reserve(mesh->mNumFaces * 3);
-		for (unsigned int i = 0; i < mesh->mNumFaces; ++i) {
-			aiFace face = mesh->mFaces[i];
-			if (face.mNumIndices == 3) {
-				for (unsigned int j = 0; j < face.mNumIndices; ++j)
-					indices.push_back(face.mIndices[j]);
-			}
+	void Model::FinishLoading() {
+		m_LoadMaterials.clear();
+		m_LoadMaterials.shrink_to_fit();
+		m_Ready = true;
+	}
+
+	std::string Model::GetDirectory(const std::string &path) {
+		// Extract directory for texture loading
+		std::string directory = path.substr(0, path.find_last_of('/'));
+		if (directory == path) {
+			directory = ".";
 		}
+		return directory;
+	}
 
-		// Load material if present
-		if (mesh->mMaterialIndex < scene->mNumMaterials) {
-			aiMaterial *aiMat = scene->mMaterials[mesh->mMaterialIndex];
-			material		  = std::make_shared<MaterialPBR>();
+	bool Model::LoadData(const std::string &path, unsigned int importFlags, bool useCooked, ModelData &data) {
+		if (useCooked && LoadCooked(path, importFlags, data))
+			return true;
+		return Import(path, importFlags, data);
+	}
 
-			// Load textures
-			material->albedoMap = LoadMaterialTexture(aiMat, aiTextureType_DIFFUSE);
-			material->normalMap = LoadMaterialTexture(aiMat, aiTextureType_NORMALS);
-			material->aoMap		= LoadMaterialTexture(aiMat, aiTextureType_AMBIENT_OCCLUSION);
+	bool Model::LoadCooked(const std::string &path, unsigned int importFlags, ModelData &data) {
+		const std::string cookedPath = GetCookedPath(path);
+		return FileUtils::IsCookedUpToDate(path, cookedPath) && MeshFile::Load(cookedPath, importFlags, Mesh::GetDefaultVertexFormat(), data);
+	}
 
-			// Set flags
-			material->hasAlbedoMap = (material->albedoMap != nullptr);
-			material->hasNormalMap = (material->normalMap != nullptr);
-			material->hasAOMap	   = (material->aoMap != nullptr);
+	bool Model::Import(const std::string &path, unsigned int importFlags, ModelData &data, ImportStats *stats) {
+		// A single batch holding every sub-mesh
+		return ImportStreamed(
+			path, importFlags, SIZE_MAX,
+			[&data](ModelData &batch, bool) {
+				data = std::move(batch);
+				return true;
+			},
+			stats);
+	}
 
-			// Load color and PBR factors
-			aiColor4D color;
-			if (aiGetMaterialColor(aiMat, AI_MATKEY_COLOR_DIFFUSE, &color) == AI_SUCCESS) {
-				material->albedoColor = {color.r, color.g, color.b};
+	bool Model::ImportStreamed(const std::string &path, unsigned int importFlags, size_t stagingBytes, const BatchCallback &consume,
+							   ImportStats *stats) {
+		Assimp::Importer importer;
+		const aiScene *scene = importer.ReadFile(path, importFlags);
+
+		if (!scene || !scene->mRootNode || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE) {
+			std::cerr << "Assimp load error: " << importer.GetErrorString() << "\n";
+			return false;
+		}
+
+		// Lay out every sub-mesh first (sizes only), then convert them batch by batch
+		ModelData layout;
+		layout.materials.reserve(scene->mNumMaterials);
+		for (unsigned int i = 0; i < scene->mNumMaterials; ++i)
+			layout.materials.push_back(ReadMaterial(scene->mMaterials[i]));
+		std::vector<const aiMesh *> meshes;
+		CollectMeshes(scene->mRootNode, scene, layout, meshes);
+
+		ImportStats importStats;
+		size_t begin = 0;
+		do {
+			// As many consecutive sub-meshes as fit the staging size, at least one
+			size_t end = begin, bytes = 0;
+			while (end < meshes.size()) {
+				const size_t meshBytes = EstimateStagingBytes(layout.subMeshes[end]);
+				if (end > begin && bytes + meshBytes > stagingBytes)
+					break;
+				bytes += meshBytes;
+				++end;
 			}
-			float factor = 0.0f;
-			if (aiGetMaterialFloat(aiMat, AI_MATKEY_METALLIC_FACTOR, &factor) == AI_SUCCESS) {
-				material->metallic = factor;
-			} else if (aiGetMaterialFloat(aiMat, "$mat.metallicFactor", 0, 0, &factor) == AI_SUCCESS) {
-				material->metallic = factor;
-			} else {
-				material->metallic = 0.1f;
+
+			// Ranges are rebased onto the batch's own storage
+			ModelData batch;
+			batch.materials = layout.materials;
+			batch.subMeshes.assign(layout.subMeshes.begin() + begin, layout.subMeshes.begin() + end);
+			for (SubMeshRange &range : batch.subMeshes) {
+				range.firstVertex -= layout.subMeshes[begin].firstVertex;
+				range.firstIndex -= layout.subMeshes[begin].firstIndex;
 			}
-			if (aiGetMaterialFloat(aiMat, AI_MATKEY_ROUGHNESS_FACTOR, &factor) == AI_SUCCESS) {
-				material->roughness = factor;
-			} else if (aiGetMaterialFloat(aiMat, "$mat.roughnessFactor", 0, 0, &factor) == AI_SUCCESS) {
-				material->roughness = factor;
+			ConvertBatch(meshes.data() + begin, batch, importStats.optimizer, importStats.lodTriangles);
+			importStats.largestBatchBytes = std::max(importStats.largestBatchBytes, batch.GetOwnedBytes());
+			++importStats.batches;
+
+			begin = end;
+			if (!consume(batch, begin == meshes.size()))
+				return false;
+		} while (begin < meshes.size());
+
+		if (stats)
+			*stats = importStats;
+		return true;
+	}
+
+	std::string Model::GetCookedPath(const std::string &path) {
+		return std::filesystem::path(path).replace_extension(".vmesh").string();
+	}
+
+	bool Model::Cook(const std::string &path, unsigned int importFlags) {
+		const auto start = std::chrono::steady_clock::now();
+		ModelData data;
+		ImportStats stats;
+		if (!Import(path, importFlags, data, &stats))
+			return false;
+		const std::string output = GetCookedPath(path);
+		if (!MeshFile::Save(output, data, importFlags, Mesh::GetDefaultVertexFormat())) {
+			std::cerr << "[Model] Failed to cook: " << path << std::endl;
+			return false;
+		}
+		const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		std::cout << "[Model] " << path << " -> " << output << " (" << data.subMeshes.size() << " sub-meshes, " << data.GetVertexCount() << " vertices, "
+				  << ms << " ms)" << std::endl;
+
+		const MeshOptimizer::Stats &optimizer = stats.optimizer;
+		std::cout << "[MeshOptimizer] " << path << ": ACMR " << optimizer.GetACMRBefore() << " -> " << optimizer.GetACMRAfter() << ", ATVR "
+				  << optimizer.GetATVRBefore() << " -> " << optimizer.GetATVRAfter() << " (" << optimizer.triangles << " triangles)" << std::endl;
+		std::cout << "[MeshSimplifier] " << path << ": triangles per level";
+		for (size_t triangles : stats.lodTriangles)
+			std::cout << " " << triangles;
+		std::cout << std::endl;
+		return true;
+	}
+
+	/**
+	 * @brief Creates one Mesh per sub-mesh range and one MaterialPBR per referenced material.
+	 * @param data Imported or memory-mapped model data.
+	 */
+	void Model::Build(const ModelData &data) {
+		BuildSubMeshes(data, 0, data.subMeshes.size());
+	}
+
+	/**
+	 * @brief Creates the meshes of sub-meshes [begin, end), sharing materials across calls.
+	 * @param data Imported or memory-mapped model data (or one staging batch of it).
+	 */
+	void Model::BuildSubMeshes(const ModelData &data, size_t begin, size_t end) {
+		if (m_LoadMaterials.size() < data.materials.size())
+			m_LoadMaterials.resize(data.materials.size());
+		for (size_t i = begin; i < end; ++i) {
+			const SubMeshRange &range = data.subMeshes[i];
+			std::shared_ptr<MaterialPBR> material = nullptr;
+			if (range.material >= 0) {
+				std::shared_ptr<MaterialPBR> &shared = m_LoadMaterials[range.material];
+				if (!shared) {
+					const MaterialDesc &desc = data.materials[range.material];
+					shared					 = std::make_shared<MaterialPBR>();
+
+					// Load textures
+					shared->albedoMap = LoadMaterialTexture(desc.albedoTexture, aiTextureType_DIFFUSE);
+					shared->normalMap = LoadMaterialTexture(desc.normalTexture, aiTextureType_NORMALS);
+					shared->aoMap	  = LoadMaterialTexture(desc.aoTexture, aiTextureType_AMBIENT_OCCLUSION);
+
+					// Set flags
+					shared->hasAlbedoMap = (shared->albedoMap != nullptr);
+					shared->hasNormalMap = (shared->normalMap != nullptr);
+					shared->hasAOMap	 = (shared->aoMap != nullptr);
+
+					shared->albedoColor = desc.albedoColor;
+					shared->metallic	= desc.metallic;
+					shared->roughness	= desc.roughness;
+					shared->ao			= desc.ao;
+				}
+				material = shared;
+			}
+
+			// Uploaded straight from the mapped file (already in upload layout) or the staging batch
+			auto meshPtr = data.IsPacked() ? std::make_unique<Mesh>(data.GetPackedMesh(range), range.metrics, range.lods, range.meshlets)
+										   : std::make_unique<Mesh>(data.GetVertices() + range.firstVertex, range.vertexCount,
+																	data.GetIndices() + range.firstIndex, range.indexCount, range.metrics, range.lods,
+																	Mesh::GetDefaultVertexFormat(), m_KeepCpuCopy);
+
+			// Model-wide bounds and level errors (a sub-mesh with fewer levels keeps drawing its coarsest one)
+			if (m_SubMeshes.empty()) {
+				m_BoundsCenter = range.metrics.boundsCenter;
+				m_BoundsRadius = range.metrics.boundsRadius;
 			} else {
-				material->roughness = 0.8f;
+				MergeBounds(m_BoundsCenter, m_BoundsRadius, range.metrics.boundsCenter, range.metrics.boundsRadius);
 			}
-			material->ao = 1.0f;
-		}
+			if (meshPtr->GetLodCount() > GetLodCount())
+				m_LodErrors.resize(meshPtr->GetLodCount(), m_LodErrors.empty() ? 0.0f : m_LodErrors.back());
+			for (int lod = 0; lod < GetLodCount(); ++lod)
+				m_LodErrors[lod] = std::max(m_LodErrors[lod], meshPtr->GetLod(lod).error);
 
-		auto meshPtr = std::make_unique<Mesh>(verts, indices);
-		return {std::move(meshPtr), material};
+			m_SubMeshes.push_back({std::move(meshPtr), material});
+		}
 	}
 
 	/**
-	 * @brief Loads a texture from a material, using cache if possible.
-	 * @param mat Assimp material.
+	 * @brief Loads a material texture, using cache if possible.
+	 * @param textureFile File name from the material (relative to the model directory).
 	 * @param type Texture type.
 	 * @return Shared pointer to loaded Texture, or nullptr.
 	 */
-	std::shared_ptr<Texture> Model::LoadMaterialTexture(aiMaterial *mat, aiTextureType type) {
-		if (mat->GetTextureCount(type) > 0) {
-			aiString str;
-			mat->GetTexture(type, 0, &str);
-			std::string textureFile = str.C_Str();
-
-			// Ignore embedded or invalid texture names
-			if (textureFile.empty() || textureFile[0] == '*') {
-				return nullptr;
-			}
+	std::shared_ptr<Texture> Model::LoadMaterialTexture(const std::string &textureFile, aiTextureType type) {
+		if (!textureFile.empty()) {
 
 			std::string texturePath = m_Directory + "/" + textureFile;
 
-			// Use cached texture if already loaded
-			if (m_LoadedTextures.count(texturePath)) {
-				return m_LoadedTextures[texturePath];
-			}
-
 			// Check file existence
 			std::ifstream f(texturePath.c_str());
 			if (!f.good()) {
@@ -331,10 +676,17 @@ namespace Engine {
 			}
 			f.close();
 
-			// Load and cache texture
-			auto texture = std::make_shared<Texture>(texturePath);
-			if (texture->GetID() != 0) {
-				m_LoadedTextures[texturePath] = texture;
+			// Stream through the engine-wide cache (only color maps are sRGB-encoded)
+			TextureLoadParams params;
+			const bool isColorMap = type == aiTextureType_DIFFUSE || type == aiTextureType_BASE_COLOR || type == aiTextureType_EMISSIVE;
+			params.colorSpace	  = isColorMap ? TextureColorSpace::sRGB : TextureColorSpace::Linear;
+			uint32_t placeholder  = isColorMap ? 0x808080FF : 0xFFFFFFFF;
+			if (type == aiTextureType_NORMALS) {
+				params.mipSettings.content = Renderer::Textures::MipContent::NormalMap;
+				placeholder				   = 0x8080FFFF;
+			}
+			auto texture = TextureCache::Get().Stream(texturePath, params, placeholder);
+			if (texture && texture->GetID() != 0) {
 				std::cout << "Loaded texture: " << texturePath << std::endl;
 				return texture;
 			} else {
@@ -6,15 +6,19 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/04/26 14:15:35 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/04/27 00:49:56 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2025/05/16 11:33:55 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #pragma once
 
+#include "Renderer/Geometry/MeshOptimizer.h"
+#include "Renderer/Geometry/ModelData.h"
+#include "Renderer/Textures/TextureResidency.h"
+#include <assimp/postprocess.h>
 #include <assimp/scene.h>
+#include <functional>
 #include <glm/glm.hpp>
-#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -32,11 +36,46 @@ namespace Engine {
 	 */
 	class Model {
 	public:
+		static constexpr float LodErrorPixels = 1.0f;  ///< Simplification error allowed on screen at bias 0, in pixels.
+		static constexpr float LodHysteresis  = 0.25f; ///< Margin below the threshold needed to switch to a coarser level.
+
+		/// Assimp post-processing used when no flags are given.
+		static constexpr unsigned int DefaultImportFlags = aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_CalcTangentSpace | aiProcess_GenSmoothNormals;
+
+		/**
+		 * @brief Receives the sub-meshes of ImportStreamed() batch by batch.
+		 * @param batch Converted sub-meshes; ranges index the batch's own storage, materials are the whole model's.
+		 * @param last No batch follows.
+		 * @return false to stop the import.
+		 */
+		using BatchCallback = std::function<bool(ModelData &batch, bool last)>;
+
+		/**
+		 * @brief What an import did to the geometry, for reporting (see Cook()).
+		 */
+		struct ImportStats {
+			MeshOptimizer::Stats optimizer;			 ///< Vertex cache efficiency before and after optimisation.
+			size_t lodTriangles[Mesh::MaxLods] = {}; ///< Triangles of each level of detail, over every sub-mesh.
+			size_t batches					   = 0;	 ///< Staging batches converted.
+			size_t largestBatchBytes		   = 0;	 ///< Geometry bytes of the largest batch.
+		};
+
 		/**
 		 * @brief Loads a model from file (supports formats via Assimp).
+		 *        Prefer ModelCache::Load(), which imports each file once.
+		 *
+		 * An up-to-date cooked sibling ('<name>.vmesh', see Cook()) cooked with the same flags
+		 * is memory-mapped and uploaded as stored, without running Assimp. Otherwise the source is
+		 * imported in batches of at most GetStagingBytes() of geometry, each uploaded before the
+		 * next is converted.
+		 *
 		 * @param path Path to the model file.
+		 * @param importFlags Assimp aiPostProcessSteps flags.
+		 * @param useCooked Load the cooked file when it is up to date.
+		 * @param keepCpuCopy Keep the vertices and indices of each sub-mesh in its Mesh (tools, CPU picking);
+		 *                    imports the source, as cooked geometry is stored in upload layout.
 		 */
-		Model(const std::string &path);
+		Model(const std::string &path, unsigned int importFlags = DefaultImportFlags, bool useCooked = true, bool keepCpuCopy = false);
 
 		/**
 		 * @brief Destructor. Cleans up loaded resources.
@@ -46,17 +85,134 @@ namespace Engine {
 		/**
 		 * @brief Draws all sub-meshes with their materials using the given shader.
 		 * @param shader Shader to use for rendering.
+		 * @param lod Level of detail (see SelectLod()).
+		 * @param cull Object-space view for meshlet culling (nullptr = draw every meshlet).
 		 */
-		void Draw(Shader &shader) const;
+		void Draw(Shader &shader, int lod = 0, const ClusterCullView *cull = nullptr) const;
 
 		/**
 		 * @brief Draws only geometry (no material handling).
 		 *        Useful for depth or shadow passes.
 		 * @param shader Shader to use for rendering.
+		 * @param lod Level of detail.
+		 * @param cull Object-space view for meshlet culling (nullptr = draw every meshlet).
+		 */
+		void DrawGeometry(Shader &shader, int lod = 0, const ClusterCullView *cull = nullptr) const;
+
+		/**
+		 * @brief Draws only geometry, `instanceCount` times per sub-mesh.
+		 *        Per-instance data (transforms) is provided by the bound shader.
+		 * @param instanceCount Number of instances to draw.
+		 * @param lod Level of detail.
+		 * @param cull One object-space view per instance (nullptr = draw every meshlet).
 		 */
-		void DrawGeometry(Shader &shader) const;
+		void DrawGeometryInstanced(unsigned int instanceCount, int lod = 0, const ClusterCullView *cull = nullptr) const;
+
+		/**
+		 * @brief Level of detail to draw, from the projected size of each level's simplification error.
+		 * @param modelMatrix World transform of the model.
+		 * @param view Camera of the frame.
+		 * @param currentLod Level drawn so far (kept while the model is outside the view).
+		 */
+		int SelectLod(const glm::mat4 &modelMatrix, const TextureResidency::View &view, int currentLod) const;
+
+		/**
+		 * @brief Levels of detail of the most detailed sub-mesh (1 without simplified levels).
+		 */
+		int GetLodCount() const { return static_cast<int>(m_LodErrors.size()); }
+
+		/**
+		 * @brief Global bias on the screen-space error threshold: each +1 doubles it (coarser levels sooner).
+		 */
+		static void SetLodBias(float bias);
+		static float GetLodBias();
+
+		/**
+		 * @brief Report the screen-space UV density of each visible sub-mesh to TextureResidency.
+		 * @param modelMatrix World transform of the model.
+		 * @param view Camera of the frame.
+		 */
+		void ReportTextureUsage(const glm::mat4 &modelMatrix, const TextureResidency::View &view) const;
+
+		/**
+		 * @brief True if the import produced at least one sub-mesh.
+		 */
+		bool IsValid() const { return !m_SubMeshes.empty(); }
+
+		/**
+		 * @brief False while a ModelStreamer load is in progress (the model draws nothing until then).
+		 */
+		bool IsReady() const { return m_Ready; }
+
+		/**
+		 * @brief Object-space bounding sphere of all sub-meshes (zero radius until ready).
+		 */
+		const glm::vec3 &GetBoundsCenter() const { return m_BoundsCenter; }
+		float GetBoundsRadius() const { return m_BoundsRadius; }
+
+		/**
+		 * @brief GPU bytes of all sub-mesh vertex and index buffers.
+		 */
+		size_t GetGPUBytes() const;
+
+		/**
+		 * @brief CPU part of a load: the cooked file when allowed and up to date, else Import() (thread-safe).
+		 */
+		static bool LoadData(const std::string &path, unsigned int importFlags, bool useCooked, ModelData &data);
+
+		/**
+		 * @brief Map the cooked file if it is up to date and was cooked with the same flags and
+		 *        Mesh::GetDefaultVertexFormat() (thread-safe).
+		 */
+		static bool LoadCooked(const std::string &path, unsigned int importFlags, ModelData &data);
+
+		/**
+		 * @brief Run Assimp and convert the scene to engine layout (thread-safe, no GL calls).
+		 * @param stats Filled with what the import did (optional).
+		 * @return false if Assimp cannot read the file.
+		 */
+		static bool Import(const std::string &path, unsigned int importFlags, ModelData &data, ImportStats *stats = nullptr);
+
+		/**
+		 * @brief Import() in batches: sub-meshes are converted and handed over a batch at a time.
+		 *
+		 * A batch holds as many consecutive sub-meshes as fit in stagingBytes (at least one, so a
+		 * larger sub-mesh gets a batch of its own). Only one batch of converted geometry exists at
+		 * a time; the callback uploads or moves it before the next one is converted.
+		 *
+		 * @param stagingBytes Vertex and index bytes per batch (estimated before conversion).
+		 * @param consume Called once per batch, in draw order.
+		 * @param stats Filled with what the import did (optional; nothing is logged).
+		 * @return false if Assimp cannot read the file or the callback stopped the import.
+		 */
+		static bool ImportStreamed(const std::string &path, unsigned int importFlags, size_t stagingBytes, const BatchCallback &consume,
+								   ImportStats *stats = nullptr);
+
+		/**
+		 * @brief Geometry converted per batch when a model is loaded from source (default 64 MiB).
+		 *        Also bounds the imported geometry ModelStreamer holds while waiting for upload.
+		 */
+		static void SetStagingBytes(size_t bytes);
+		static size_t GetStagingBytes();
+
+		/**
+		 * @brief Where Cook() writes the engine-native version of a model ('<name>.vmesh').
+		 */
+		static std::string GetCookedPath(const std::string &path);
+
+		/**
+		 * @brief Import a model and write GetCookedPath() (no GL calls).
+		 *        Prints the optimiser, level-of-detail and batch statistics of the import.
+		 */
+		static bool Cook(const std::string &path, unsigned int importFlags = DefaultImportFlags);
 
 	private:
+		friend class ModelStreamer;
+
+		/// Empty model filled later by ModelStreamer.
+		explicit Model(bool keepCpuCopy)
+			: m_KeepCpuCopy(keepCpuCopy) {}
+
 		/**
 		 * @brief Represents a sub-mesh and its material.
 		 */
@@ -65,21 +221,32 @@ namespace Engine {
 			std::shared_ptr<MaterialPBR> material; ///< Material (may be nullptr)
 		};
 
-		std::vector<SubMesh> m_SubMeshes;								  ///< All sub-meshes in the model
-		std::string m_Directory;										  ///< Directory of the model file
-		std::map<std::string, std::shared_ptr<Texture>> m_LoadedTextures; ///< Texture cache
+		std::vector<SubMesh> m_SubMeshes; ///< All sub-meshes in the model
+		std::string m_Directory;		  ///< Directory of the model file
+		bool m_Ready = false;			  ///< Loading finished (successfully or not)
+		std::vector<float> m_LodErrors;	  ///< Largest sub-mesh error of each level (object units)
+		glm::vec3 m_BoundsCenter{0.0f};	  ///< Bounding sphere of all sub-meshes
+		float m_BoundsRadius = 0.0f;
+		bool m_KeepCpuCopy	 = false;		  ///< Meshes keep their vertices and indices
+		std::vector<std::shared_ptr<MaterialPBR>> m_LoadMaterials; ///< Materials created so far, per ModelData slot (dropped when ready)
+
+		/// Loads the model from its cooked file or through Assimp.
+		void LoadModel(const std::string &path, unsigned int importFlags, bool useCooked);
+
+		/// Directory that material texture names are relative to.
+		static std::string GetDirectory(const std::string &path);
 
-		/// Loads the model from file.
-		void LoadModel(const std::string &path);
+		/// Creates the meshes and materials of imported or cooked data.
+		void Build(const ModelData &data);
 
-		/// Recursively processes Assimp nodes.
-		void ProcessNode(aiNode *node, const aiScene *scene);
+		/// Creates the meshes of sub-meshes [begin, end) (materials are shared across calls and batches).
+		void BuildSubMeshes(const ModelData &data, size_t begin, size_t end);
 
-		/// Processes an Assimp mesh and returns a SubMesh.
-		SubMesh ProcessMesh(aiMesh *mesh, const aiScene *scene);
+		/// Drops the per-load material slots and marks the model ready.
+		void FinishLoading();
 
-		/// Loads a texture from a material, using cache if possible.
-		std::shared_ptr<Texture> LoadMaterialTexture(aiMaterial *mat, aiTextureType type);
+		/// Loads a material texture by file name, through the texture cache.
+		std::shared_ptr<Texture> LoadMaterialTexture(const std::string &textureFile, aiTextureType type);
 	};
 
 }
@@ -0,0 +1,103 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ModelCache.cpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/12 19:31:12 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/16 11:32:40 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#include "Renderer/Geometry/ModelCache.h"
+#include "Core/FileUtils.h"
+#include "Renderer/Geometry/ModelStreamer.h"
+
+#include <iostream>
+
+namespace Engine {
+
+	ModelCache &ModelCache::Get() {
+		static ModelCache cache;
+		return cache;
+	}
+
+	ModelCache::Key ModelCache::MakeKey(const std::string &path, unsigned int importFlags) {
+		return Key(FileUtils::CanonicalPath(path), importFlags);
+	}
+
+	std::shared_ptr<Model> ModelCache::Load(const std::string &path, unsigned int importFlags) {
+		const Key key = MakeKey(path, importFlags);
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			// Another request is importing this model: share its result
+			m_Imported.wait(lock, [&] { return m_Importing.count(key) == 0; });
+			auto it = m_Entries.find(key);
+			if (it != m_Entries.end()) {
+				if (std::shared_ptr<Model> model = it->second.lock()) {
+					++m_Stats.hits;
+					lock.unlock();
+					// Requested through Stream() earlier: finish it now
+					if (!model->IsReady())
+						ModelStreamer::Get().Flush();
+					return model->IsValid() ? model : nullptr;
+				}
+			}
+			++m_Stats.misses;
+			m_Importing.insert(key);
+		}
+
+		// Imported without the lock so requests for other models are not serialised behind it
+		auto model = std::make_shared<Model>(path, importFlags);
+		if (!model->IsValid()) {
+			std::cerr << "[ModelCache] Failed to import: " << path << std::endl;
+			model.reset();
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			if (model)
+				m_Entries[key] = model;
+			m_Importing.erase(key);
+		}
+		m_Imported.notify_all();
+		return model;
+	}
+
+	std::shared_ptr<Model> ModelCache::Stream(const std::string &path, unsigned int importFlags) {
+		const Key key = MakeKey(path, importFlags);
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		m_Imported.wait(lock, [&] { return m_Importing.count(key) == 0; });
+		auto it = m_Entries.find(key);
+		if (it != m_Entries.end()) {
+			if (std::shared_ptr<Model> model = it->second.lock()) {
+				++m_Stats.hits;
+				return model;
+			}
+		}
+		++m_Stats.misses;
+		std::shared_ptr<Model> model = ModelStreamer::Get().Load(path, importFlags);
+		m_Entries[key]				 = model;
+		return model;
+	}
+
+	size_t ModelCache::GetLiveCount() {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		for (auto it = m_Entries.begin(); it != m_Entries.end();)
+			it = it->second.expired() ? m_Entries.erase(it) : std::next(it);
+		return m_Entries.size();
+	}
+
+	ModelCache::Stats ModelCache::GetStats() const {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_Stats;
+	}
+
+	void ModelCache::Clear() {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Entries.clear();
+	}
+
+} // namespace Engine
@@ -0,0 +1,98 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ModelCache.h                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/12 19:31:05 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/13 15:21:08 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#pragma once
+
+#include "Renderer/Geometry/Model.h"
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <utility>
+
+/**
+ * @file ModelCache.h
+ * @brief Engine-wide Model registry keyed by canonical path and import flags.
+ */
+
+namespace Engine {
+
+	/**
+	 * @class ModelCache
+	 * @brief Hands out shared Model handles so each file is imported and uploaded once.
+	 *
+	 * Entries are weak: a model is freed with its last component, and the next request imports
+	 * it again. Concurrent requests for a model being imported wait for that import instead of
+	 * starting their own. Importing creates GL buffers, so Load() and Stream() need a current GL
+	 * context.
+	 */
+	class ModelCache {
+	public:
+		/**
+		 * @brief Counters for profiling.
+		 */
+		struct Stats {
+			uint64_t hits	= 0; ///< Requests served by a live (or in-flight) model.
+			uint64_t misses = 0; ///< Requests that imported a model.
+		};
+
+		/**
+		 * @brief Engine-wide cache.
+		 */
+		static ModelCache &Get();
+
+		ModelCache(const ModelCache &)			  = delete;
+		ModelCache &operator=(const ModelCache &) = delete;
+
+		/**
+		 * @brief Shared model for this file and flags, importing it on first request.
+		 * @return nullptr if the import fails (failures are not cached).
+		 */
+		std::shared_ptr<Model> Load(const std::string &path, unsigned int importFlags = Model::DefaultImportFlags);
+
+		/**
+		 * @brief Shared model for this file and flags, loaded through ModelStreamer on first request.
+		 * @return Model that draws nothing until IsReady() (failed loads stay empty).
+		 */
+		std::shared_ptr<Model> Stream(const std::string &path, unsigned int importFlags = Model::DefaultImportFlags);
+
+		/**
+		 * @brief Number of cached models still alive (drops expired entries).
+		 */
+		size_t GetLiveCount();
+
+		Stats GetStats() const;
+
+		/**
+		 * @brief Forget every entry (models stay alive while referenced).
+		 */
+		void Clear();
+
+	private:
+		ModelCache() = default;
+
+		using Key = std::pair<std::string, unsigned int>; ///< Canonical path, import flags.
+
+		static Key MakeKey(const std::string &path, unsigned int importFlags);
+
+		mutable std::mutex m_Mutex;
+		std::condition_variable m_Imported; ///< Signalled when an in-flight import ends.
+		std::map<Key, std::weak_ptr<Model>> m_Entries;
+		std::set<Key> m_Importing; ///< Keys being imported right now.
+		Stats m_Stats;
+	};
+
+} // namespace Engine
@@ -0,0 +1,111 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ModelData.h                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/13 09:12:40 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/16 11:33:55 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#pragma once
+
+#include "Renderer/Geometry/Mesh.h"
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @file ModelData.h
+ * @brief CPU-side description of a model: geometry, sub-mesh ranges and materials.
+ */
+
+namespace Engine {
+
+	/**
+	 * @brief Material parameters of a model (texture names are resolved against the model's directory).
+	 */
+	struct MaterialDesc {
+		glm::vec3 albedoColor{1.0f, 1.0f, 1.0f}; ///< Diffuse color factor.
+		float metallic	= 0.1f;					 ///< Metallic factor.
+		float roughness = 0.8f;					 ///< Roughness factor.
+		float ao		= 1.0f;					 ///< Ambient occlusion factor.
+		std::string albedoTexture;				 ///< Diffuse map file name (empty = none).
+		std::string normalTexture;				 ///< Normal map file name (empty = none).
+		std::string aoTexture;					 ///< AO map file name (empty = none).
+	};
+
+	/**
+	 * @brief One drawable part of a model: a vertex range, an index range and a material.
+	 *
+	 * The index range holds every level of detail back to back, finest first.
+	 */
+	struct SubMeshRange {
+		uint32_t firstVertex = 0; ///< First vertex in ModelData's vertex array.
+		uint32_t vertexCount = 0; ///< Vertices of the sub-mesh.
+		uint32_t firstIndex	 = 0; ///< First index in ModelData's index array.
+		uint32_t indexCount	 = 0; ///< Indices of all levels (relative to firstVertex).
+		int32_t material	 = -1; ///< Index into ModelData::materials (-1 = default material).
+		MeshMetrics metrics;	   ///< Bounds and UV density.
+		std::vector<MeshLod> lods; ///< Levels of detail, relative to firstIndex (empty = one level).
+
+		// Cooked models only (see ModelData::IsPacked())
+		glm::vec4 positionDecode[2] = {glm::vec4(1.0f, 1.0f, 1.0f, 0.0f), glm::vec4(0.0f)}; ///< Scale and offset of the packed positions.
+		std::vector<Meshlet> meshlets; ///< Clusters of level 0, built when cooking.
+	};
+
+	/**
+	 * @brief Everything needed to build a Model's GPU resources, with no GL calls.
+	 *
+	 * Produced by the Assimp importer (Vertex structs and 32-bit indices owned here) or by a
+	 * cooked .vmesh file (arrays in upload layout inside the mapped file, kept alive by `backing`).
+	 */
+	struct ModelData {
+		std::vector<SubMeshRange> subMeshes; ///< Parts in draw order.
+		std::vector<MaterialDesc> materials; ///< Materials referenced by the parts.
+
+		std::vector<Vertex> vertexStorage;				  ///< Owned vertices (imported models).
+		std::vector<uint32_t> indexStorage;				  ///< Owned indices (imported models).
+		VertexFormat packedFormat = VertexFormat::Full; ///< Layout of packedVertices.
+		const void *packedVertices = nullptr;			  ///< Vertices inside `backing` (cooked models).
+		const void *packedIndices  = nullptr;			  ///< Indices inside `backing` (cooked models).
+		uint32_t packedIndexSize   = 4;				  ///< Bytes per packed index (2 or 4).
+		size_t packedVertexCount   = 0;				  ///< Size of packedVertices.
+		size_t packedIndexCount	   = 0;				  ///< Size of packedIndices.
+		std::shared_ptr<const void> backing;			  ///< Owner of the packed arrays.
+
+		/// Whether the geometry is in upload layout (cooked) rather than Vertex structs (imported).
+		bool IsPacked() const { return packedVertices != nullptr; }
+
+		/// Geometry of one part in upload layout (packed data only).
+		PackedMeshView GetPackedMesh(const SubMeshRange &range) const {
+			const size_t vertexStride = packedFormat == VertexFormat::Compact ? sizeof(CompactVertex) : sizeof(Vertex);
+			PackedMeshView view;
+			view.format			   = packedFormat;
+			view.vertices		   = static_cast<const uint8_t *>(packedVertices) + range.firstVertex * vertexStride;
+			view.vertexCount	   = range.vertexCount;
+			view.indices		   = static_cast<const uint8_t *>(packedIndices) + size_t(range.firstIndex) * packedIndexSize;
+			view.indexCount		   = range.indexCount;
+			view.indexSize		   = packedIndexSize;
+			view.positionDecode[0] = range.positionDecode[0];
+			view.positionDecode[1] = range.positionDecode[1];
+			return view;
+		}
+
+		// Imported data only
+		const Vertex *GetVertices() const { return vertexStorage.data(); }
+		const uint32_t *GetIndices() const { return indexStorage.data(); }
+
+		size_t GetVertexCount() const { return IsPacked() ? packedVertexCount : vertexStorage.size(); }
+		size_t GetIndexCount() const { return IsPacked() ? packedIndexCount : indexStorage.size(); }
+
+		/// Bytes of the owned storage (mapped arrays are not counted).
+		size_t GetOwnedBytes() const { return vertexStorage.size() * sizeof(Vertex) + indexStorage.size() * sizeof(uint32_t); }
+	};
+
+} // namespace Engine
@@ -0,0 +1,206 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ModelStreamer.cpp                                  :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/13 15:21:08 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/16 11:33:55 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#include "Renderer/Geometry/ModelStreamer.h"
+#include "Core/ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+namespace Engine {
+
+	ModelStreamer &ModelStreamer::Get() {
+		static ModelStreamer streamer;
+		return streamer;
+	}
+
+	ModelStreamer::ModelStreamer()
+		: m_Completed(std::make_shared<CompletionQueue>()) {
+		// Each import already spreads its sub-meshes over the pool
+		m_MaxInFlight = std::max(1, static_cast<int>(ThreadPool::Get().GetThreadCount()) / 2);
+	}
+
+	std::shared_ptr<Model> ModelStreamer::Load(const std::string &path, unsigned int importFlags, bool useCooked, bool keepCpuCopy) {
+		std::shared_ptr<Model> model(new Model(keepCpuCopy));
+		model->m_Directory = Model::GetDirectory(path);
+
+		Request request;
+		request.model		= model;
+		request.path		= path;
+		request.importFlags = importFlags;
+		request.useCooked	= useCooked && !keepCpuCopy; // Cooked geometry is in upload layout
+		m_Pending.push_back(std::move(request));
+		++m_Stats.requested;
+		return model;
+	}
+
+	void ModelStreamer::Update(double budgetMs) {
+		using Clock		 = std::chrono::steady_clock;
+		const auto start = Clock::now();
+
+		// Collect finished batches (an import is done with its last one)
+		{
+			std::lock_guard<std::mutex> lock(m_Completed->mutex);
+			for (Imported &imported : m_Completed->items) {
+				if (imported.last)
+					--m_InFlight;
+				m_Ready.push_back(std::move(imported));
+			}
+			m_Completed->items.clear();
+			m_Stats.peakStagedBytes = std::max(m_Stats.peakStagedBytes, m_Completed->stagedBytes);
+		}
+
+		// Dispatch new imports (requests whose model was already dropped are skipped)
+		while (!m_Pending.empty() && m_InFlight < m_MaxInFlight) {
+			Request request = std::move(m_Pending.front());
+			m_Pending.pop_front();
+			if (request.model.expired())
+				continue;
+			++m_InFlight;
+			ThreadPool::Get().Submit([queue = m_Completed, request = std::move(request), stagingBytes = Model::GetStagingBytes()]() {
+				// Queue a batch once the staged geometry leaves room for it (or nothing else is staged)
+				const auto push = [&queue, stagingBytes](Imported &&imported) {
+					std::unique_lock<std::mutex> lock(queue->mutex);
+					queue->released.wait(lock, [&] {
+						return queue->closed || queue->stagedBytes == 0 || queue->stagedBytes + imported.stagedBytes <= stagingBytes;
+					});
+					if (queue->closed)
+						return false;
+					queue->stagedBytes += imported.stagedBytes;
+					queue->items.push_back(std::move(imported));
+					return true;
+				};
+
+				Imported imported;
+				imported.model = request.model;
+				imported.path  = request.path;
+				if (request.model.expired()) {
+					push(std::move(imported));
+					return;
+				}
+				if (request.useCooked && Model::LoadCooked(request.path, request.importFlags, imported.data)) {
+					imported.loaded		 = true;
+					imported.stagedBytes = imported.data.GetOwnedBytes();
+					push(std::move(imported));
+					return;
+				}
+
+				// Stops early if the model is dropped or the streamer shut down
+				const bool loaded = Model::ImportStreamed(request.path, request.importFlags, stagingBytes, [&](ModelData &data, bool last) {
+					Imported batch;
+					batch.model		  = request.model;
+					batch.path		  = request.path;
+					batch.loaded	  = true;
+					batch.last		  = last;
+					batch.stagedBytes = data.GetOwnedBytes();
+					batch.data		  = std::move(data);
+					return !request.model.expired() && push(std::move(batch));
+				});
+				if (!loaded)
+					push(std::move(imported));
+			});
+		}
+
+		// Create GL buffers until the budget is spent (always make progress)
+		do {
+			if (!BuildStep())
+				break;
+		} while (std::chrono::duration<double, std::milli>(Clock::now() - start).count() < budgetMs);
+	}
+
+	bool ModelStreamer::BuildStep() {
+		// Next model: skip dropped ones, finish failed ones empty
+		while (!m_Current) {
+			if (m_Ready.empty())
+				return false;
+			Imported imported = std::move(m_Ready.front());
+			m_Ready.pop_front();
+			std::shared_ptr<Model> model = imported.model.lock();
+			if (!model) {
+				ReleaseStaging(imported.stagedBytes);
+				continue;
+			}
+			if (!imported.loaded) {
+				std::cerr << "[ModelStreamer] Failed to load: " << imported.path << std::endl;
+				model->FinishLoading();
+				++m_Stats.failed;
+				continue;
+			}
+			m_Current			= std::make_unique<Building>();
+			m_Current->imported = std::move(imported);
+		}
+
+		std::shared_ptr<Model> model = m_Current->imported.model.lock();
+		if (!model) {
+			ReleaseStaging(m_Current->imported.stagedBytes);
+			m_Current.reset();
+			return true;
+		}
+
+		const ModelData &data = m_Current->imported.data;
+		if (m_Current->nextSubMesh < data.subMeshes.size()) {
+			model->BuildSubMeshes(data, m_Current->nextSubMesh, m_Current->nextSubMesh + 1);
+			++m_Current->nextSubMesh;
+			++m_Stats.subMeshesBuilt;
+		}
+		if (m_Current->nextSubMesh == data.subMeshes.size()) {
+			ReleaseStaging(m_Current->imported.stagedBytes);
+			++m_Stats.batchesBuilt;
+			if (m_Current->imported.last) {
+				model->FinishLoading();
+				++m_Stats.completed;
+			}
+			m_Current.reset();
+		}
+		return true;
+	}
+
+	void ModelStreamer::ReleaseStaging(size_t bytes) {
+		if (bytes == 0)
+			return;
+		{
+			std::lock_guard<std::mutex> lock(m_Completed->mutex);
+			m_Completed->stagedBytes -= bytes;
+		}
+		m_Completed->released.notify_all();
+	}
+
+	void ModelStreamer::Flush() {
+		while (!IsIdle()) {
+			Update(1e9);
+			if (!IsIdle())
+				std::this_thread::sleep_for(std::chrono::milliseconds(1)); // Waiting on workers
+		}
+	}
+
+	bool ModelStreamer::IsIdle() const {
+		return m_Pending.empty() && m_InFlight == 0 && m_Ready.empty() && !m_Current;
+	}
+
+	void ModelStreamer::Shutdown() {
+		// Running imports keep the old queue alive; closing it wakes workers waiting for staging room and stops them
+		{
+			std::lock_guard<std::mutex> lock(m_Completed->mutex);
+			m_Completed->closed = true;
+		}
+		m_Completed->released.notify_all();
+		m_Pending.clear();
+		m_Ready.clear();
+		m_Current.reset();
+		m_Completed = std::make_shared<CompletionQueue>();
+		m_InFlight	= 0;
+	}
+
+} // namespace Engine
@@ -0,0 +1,161 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ModelStreamer.h                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/13 15:21:08 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/16 11:33:55 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+
+#pragma once
+
+#include "Renderer/Geometry/Model.h"
+#include "Renderer/Geometry/ModelData.h"
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @file ModelStreamer.h
+ * @brief Asynchronous model loading: import on the ThreadPool, create GL buffers under a per-frame budget.
+ */
+
+namespace Engine {
+
+	/**
+	 * @class ModelStreamer
+	 * @brief Loads models in the background; they draw nothing until their meshes exist.
+	 *
+	 * Usage:
+	 *   - Load() returns immediately with an empty Model whose address never changes.
+	 *   - Worker threads map the cooked file, or run Assimp and convert sub-meshes in parallel,
+	 *     batch by batch (Model::ImportStreamed).
+	 *   - Update(), called once per frame on the GL thread, creates the vertex/index buffers and
+	 *     materials of finished batches, sub-mesh by sub-mesh, until the frame's time budget is
+	 *     spent. The model turns ready once its last batch is built.
+	 *
+	 * At most GetMaxInFlight() imports are outstanding. Converted geometry waiting for upload is
+	 * capped at Model::GetStagingBytes() for all of them together: a worker waits before queuing
+	 * a batch that would exceed it, and each batch is freed once its meshes exist (mapped cooked
+	 * files are not counted).
+	 */
+	class ModelStreamer {
+	public:
+		/**
+		 * @brief Counters for profiling and loading screens.
+		 */
+		struct Stats {
+			int requested		   = 0; ///< Load() calls.
+			int completed		   = 0; ///< Models fully built.
+			int failed			   = 0; ///< Models that could not be imported (left empty).
+			int subMeshesBuilt	   = 0; ///< Meshes created by Update().
+			int batchesBuilt	   = 0; ///< Imported batches (or cooked files) fully built.
+			size_t peakStagedBytes = 0; ///< Most converted geometry queued at once.
+		};
+
+		/**
+		 * @brief Engine-wide streamer.
+		 */
+		static ModelStreamer &Get();
+
+		ModelStreamer(const ModelStreamer &)			= delete;
+		ModelStreamer &operator=(const ModelStreamer &) = delete;
+
+		/**
+		 * @brief Queue a model load (GL thread). Prefer ModelCache::Stream(), which shares models.
+		 *
+		 * @param path Model file.
+		 * @param importFlags Assimp aiPostProcessSteps flags.
+		 * @param useCooked Load the cooked '.vmesh' file when it is up to date.
+		 * @param keepCpuCopy Keep each sub-mesh's vertices and indices in its Mesh (imports the source instead of the cooked file).
+		 * @return Model usable right away; IsReady() turns true once it is built.
+		 */
+		std::shared_ptr<Model> Load(const std::string &path, unsigned int importFlags = Model::DefaultImportFlags, bool useCooked = true,
+									bool keepCpuCopy = false);
+
+		/**
+		 * @brief Dispatch imports and build finished ones (GL thread, once per frame).
+		 * @param budgetMs Build time allowed this frame, in milliseconds (at least one sub-mesh is built).
+		 */
+		void Update(double budgetMs = 1.0);
+
+		/**
+		 * @brief Block until every queued model is built (loading screens, benchmarks).
+		 */
+		void Flush();
+
+		/**
+		 * @brief Whether nothing is queued, importing or building.
+		 */
+		bool IsIdle() const;
+
+		/**
+		 * @brief Drop queued work (call before the GL context is destroyed).
+		 *
+		 * Imports still running stop at their next batch and are discarded.
+		 */
+		void Shutdown();
+
+		void SetMaxInFlight(int count) { m_MaxInFlight = count > 0 ? count : 1; }
+		int GetMaxInFlight() const { return m_MaxInFlight; }
+		const Stats &GetStats() const { return m_Stats; }
+
+	private:
+		ModelStreamer();
+
+		struct Request {
+			std::weak_ptr<Model> model; ///< Dropped models are skipped.
+			std::string path;
+			unsigned int importFlags = Model::DefaultImportFlags;
+			bool useCooked			 = true;
+		};
+
+		/// One batch of a model (a whole cooked file is a single batch).
+		struct Imported {
+			std::weak_ptr<Model> model;
+			std::string path;
+			ModelData data;
+			bool loaded		   = false; ///< The cooked file or the source could be read.
+			bool last		   = true;	///< Last batch of the model (it turns ready once built).
+			size_t stagedBytes = 0;		///< Converted geometry counted against the staging budget.
+		};
+
+		/// Shared with worker tasks so they can finish after Shutdown().
+		struct CompletionQueue {
+			std::mutex mutex;
+			std::condition_variable released; ///< Staged bytes went down, or the queue was closed.
+			std::deque<Imported> items;
+			size_t stagedBytes = 0;	   ///< Bytes of batches queued or being built.
+			bool closed		   = false; ///< Shutdown(): workers stop importing.
+		};
+
+		/// Batch whose sub-meshes are being created.
+		struct Building {
+			Imported imported;
+			size_t nextSubMesh = 0;
+		};
+
+		bool BuildStep();
+
+		/// Return a built batch's bytes to the staging budget.
+		void ReleaseStaging(size_t bytes);
+
+		std::deque<Request> m_Pending;				  ///< Not yet dispatched to the pool.
+		std::shared_ptr<CompletionQueue> m_Completed; ///< Imported by workers, waiting to be built.
+		std::deque<Imported> m_Ready;				  ///< Collected on the GL thread.
+		std::unique_ptr<Building> m_Current;		  ///< Model being built.
+		int m_InFlight	  = 0;						  ///< Dispatched, not yet collected.
+		int m_MaxInFlight = 1;						  ///< Import concurrency limit.
+
+		Stats m_Stats;
+	};
+
+} // namespace Engine
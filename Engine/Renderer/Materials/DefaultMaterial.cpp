@@ -54,6 +54,8 @@ namespace Engine {
 			defaultMaterial->hasClearcoatMap  = false;
 			defaultMaterial->hasAnisotropyMap = false;
 			defaultMaterial->hasSubsurfaceMap = false;
+			defaultMaterial->hasPackedMap	  = false;
+			defaultMaterial->packedChannels	  = 0;
 
 			// --- Other Properties ---
 			defaultMaterial->doubleSided = false; // Default to back-face culling
@@ -6,13 +6,15 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/04/26 20:38:38 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/04/28 17:46:48 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2025/05/16 11:35:48 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #pragma once
 
 #include "Renderer/Textures/Texture.h" // For Texture and ResamplingAlgorithm
+#include "Renderer/Textures/TextureCache.h"
+#include "Renderer/Textures/TextureCooker.h"
 #include <glm/glm.hpp>
 #include <iostream>
 #include <memory>
@@ -28,6 +30,8 @@ namespace Engine {
 	 *   - Albedo (diffuse), normal, roughness, metallic, specular, and ambient occlusion (AO) maps.
 	 *   - Scalar fallback values for each property if a texture map is not provided.
 	 *   - Boolean flags indicating the presence of each map.
+	 *   - An optional channel-packed map (AO/Roughness/Metallic/Height) replacing up to four
+	 *     single-channel maps with one texture unit and one fetch.
 	 *
 	 * Texture maps are loaded via the provided setters, which handle error checking and flag updates.
 	 */
@@ -45,6 +49,7 @@ namespace Engine {
 		std::shared_ptr<Texture> clearcoatMap;	///< Clearcoat intensity/roughness map (can pack values)
 		std::shared_ptr<Texture> anisotropyMap; ///< Anisotropy direction/strength map
 		std::shared_ptr<Texture> subsurfaceMap; ///< Subsurface scattering thickness/color map
+		std::shared_ptr<Texture> packedMap;		///< R = AO, G = Roughness, B = Metallic, A = Height (see SetPackedMaps)
 
 		// --- Scalar Factors (used if corresponding map is missing) ---
 		glm::vec3 albedoColor{1.0f, 1.0f, 1.0f};		 ///< Default albedo color (white)
@@ -77,6 +82,8 @@ namespace Engine {
 		bool hasClearcoatMap  = false; ///< True if clearcoatMap is valid
 		bool hasAnisotropyMap = false; ///< True if anisotropyMap is valid
 		bool hasSubsurfaceMap = false; ///< True if subsurfaceMap is valid
+		bool hasPackedMap	  = false; ///< True if packedMap is valid
+		int packedChannels	  = 0;	   ///< ChannelPackSources::Channel bits read from packedMap
 
 		// --- Other Properties ---
 		bool doubleSided = false; ///< Render both front and back faces?
@@ -84,17 +91,21 @@ namespace Engine {
 		/**
 		 * @brief Helper to load a texture map and update its presence flag.
 		 *
+		 * The map is streamed asynchronously: a 1x1 placeholder of the given color is bound
+		 * until TextureStreamer has decoded and uploaded the image. Files already requested with
+		 * the same options are shared through TextureCache instead of being loaded again.
+		 *
 		 * @param[out] texturePtr   Reference to the shared_ptr<Texture> to assign.
 		 * @param[out] hasMapFlag   Reference to the boolean flag indicating map presence.
 		 * @param[in]  mapType      Human-readable map type (for logging).
 		 * @param[in]  path         Filesystem path to the texture.
-		 * @param[in]  targetWidth  Desired width (0 = original).
-		 * @param[in]  targetHeight Desired height (0 = original).
-		 * @param[in]  algorithm    Resampling algorithm for resizing.
+		 * @param[in]  params       Target size, resampling, color space (sRGB for color maps,
+		 *                          Linear for data maps) and mip generation options.
+		 * @param[in]  placeholder  Neutral value shown while loading, packed as 0xRRGGBBAA.
 		 */
-		void LoadTextureMap(std::shared_ptr<Texture> &texturePtr, bool &hasMapFlag, const std::string &mapType, const std::string &path, int targetWidth, int targetHeight, ResamplingAlgorithm algorithm) {
+		void LoadTextureMap(std::shared_ptr<Texture> &texturePtr, bool &hasMapFlag, const std::string &mapType, const std::string &path, const TextureLoadParams &params, uint32_t placeholder) {
 			try {
-				texturePtr = std::make_shared<Texture>(path, targetWidth, targetHeight, algorithm);
+				texturePtr = TextureCache::Get().Stream(path, params, placeholder); // Shared with every material using this file
 				hasMapFlag = (texturePtr && texturePtr->GetID() != 0);
 				if (!hasMapFlag) {
 					std::cerr << "[MaterialPBR] Warning: Loaded " << mapType << " map from '" << path
@@ -119,84 +130,113 @@ namespace Engine {
 		 * @brief Assign an albedo (diffuse) texture map.
 		 */
 		void SetAlbedoMap(const std::string &path, int targetWidth = 0, int targetHeight = 0, ResamplingAlgorithm algorithm = ResamplingAlgorithm::Bilinear) {
-			LoadTextureMap(albedoMap, hasAlbedoMap, "Albedo", path, targetWidth, targetHeight, algorithm);
+			LoadTextureMap(albedoMap, hasAlbedoMap, "Albedo", path, TextureLoadParams(targetWidth, targetHeight, algorithm, TextureColorSpace::sRGB), 0x808080FF);
 		}
 
 		/**
 		 * @brief Assign a normal map.
 		 */
 		void SetNormalMap(const std::string &path, int targetWidth = 0, int targetHeight = 0, ResamplingAlgorithm algorithm = ResamplingAlgorithm::Bilinear) {
-			LoadTextureMap(normalMap, hasNormalMap, "Normal", path, targetWidth, targetHeight, algorithm);
+			TextureLoadParams params(targetWidth, targetHeight, algorithm, TextureColorSpace::Linear);
+			params.mipSettings.content = Renderer::Textures::MipContent::NormalMap; // Keep unit-length normals in every mip
+			LoadTextureMap(normalMap, hasNormalMap, "Normal", path, params, 0x8080FFFF);
 		}
 
 		/**
 		 * @brief Assign an ambient occlusion (AO) map.
 		 */
 		void SetAOMap(const std::string &path, int targetWidth = 0, int targetHeight = 0, ResamplingAlgorithm algorithm = ResamplingAlgorithm::Bilinear) {
-			LoadTextureMap(aoMap, hasAOMap, "AO", path, targetWidth, targetHeight, algorithm);
+			LoadTextureMap(aoMap, hasAOMap, "AO", path, TextureLoadParams(targetWidth, targetHeight, algorithm, TextureColorSpace::Linear), 0xFFFFFFFF);
 		}
 
 		/**
 		 * @brief Assign a roughness map.
 		 */
 		void SetRoughnessMap(const std::string &path, int targetWidth = 0, int targetHeight = 0, ResamplingAlgorithm algorithm = ResamplingAlgorithm::Bilinear) {
-			LoadTextureMap(roughnessMap, hasRoughnessMap, "Roughness", path, targetWidth, targetHeight, algorithm);
+			LoadTextureMap(roughnessMap, hasRoughnessMap, "Roughness", path, TextureLoadParams(targetWidth, targetHeight, algorithm, TextureColorSpace::Linear), 0xFFFFFFFF);
 		}
 
 		/**
 		 * @brief Assign a metallic map.
 		 */
 		void SetMetallicMap(const std::string &path, int targetWidth = 0, int targetHeight = 0, ResamplingAlgorithm algorithm = ResamplingAlgorithm::Bilinear) {
-			LoadTextureMap(metallicMap, hasMetallicMap, "Metallic", path, targetWidth, targetHeight, algorithm);
+			LoadTextureMap(metallicMap, hasMetallicMap, "Metallic", path, TextureLoadParams(targetWidth, targetHeight, algorithm, TextureColorSpace::Linear), 0x000000FF);
 		}
 
 		/**
 		 * @brief Assign a specular map.
 		 */
 		void SetSpecularMap(const std::string &path, int targetWidth = 0, int targetHeight = 0, ResamplingAlgorithm algorithm = ResamplingAlgorithm::Bilinear) {
-			LoadTextureMap(specularMap, hasSpecularMap, "Specular", path, targetWidth, targetHeight, algorithm);
+			LoadTextureMap(specularMap, hasSpecularMap, "Specular", path, TextureLoadParams(targetWidth, targetHeight, algorithm, TextureColorSpace::Linear), 0x808080FF);
 		}
 
 		/**
 		 * @brief Assign an emissive map.
 		 */
 		void SetEmissiveMap(const std::string &path, int targetWidth = 0, int targetHeight = 0, ResamplingAlgorithm algorithm = ResamplingAlgorithm::Bilinear) {
-			LoadTextureMap(emissiveMap, hasEmissiveMap, "Emissive", path, targetWidth, targetHeight, algorithm);
+			LoadTextureMap(emissiveMap, hasEmissiveMap, "Emissive", path, TextureLoadParams(targetWidth, targetHeight, algorithm, TextureColorSpace::sRGB), 0x000000FF);
 		}
 
 		/**
 		 * @brief Assign an opacity (alpha) map.
 		 */
 		void SetOpacityMap(const std::string &path, int targetWidth = 0, int targetHeight = 0, ResamplingAlgorithm algorithm = ResamplingAlgorithm::Bilinear) {
-			LoadTextureMap(opacityMap, hasOpacityMap, "Opacity", path, targetWidth, targetHeight, algorithm);
+			LoadTextureMap(opacityMap, hasOpacityMap, "Opacity", path, TextureLoadParams(targetWidth, targetHeight, algorithm, TextureColorSpace::Linear), 0xFFFFFFFF);
 		}
 
 		/**
 		 * @brief Assign a height (parallax) map.
 		 */
 		void SetHeightMap(const std::string &path, int targetWidth = 0, int targetHeight = 0, ResamplingAlgorithm algorithm = ResamplingAlgorithm::Bilinear) {
-			LoadTextureMap(heightMap, hasHeightMap, "Height", path, targetWidth, targetHeight, algorithm);
+			LoadTextureMap(heightMap, hasHeightMap, "Height", path, TextureLoadParams(targetWidth, targetHeight, algorithm, TextureColorSpace::Linear), 0x808080FF);
 		}
 
 		/**
 		 * @brief Assign a clearcoat map.
 		 */
 		void SetClearcoatMap(const std::string &path, int targetWidth = 0, int targetHeight = 0, ResamplingAlgorithm algorithm = ResamplingAlgorithm::Bilinear) {
-			LoadTextureMap(clearcoatMap, hasClearcoatMap, "Clearcoat", path, targetWidth, targetHeight, algorithm);
+			LoadTextureMap(clearcoatMap, hasClearcoatMap, "Clearcoat", path, TextureLoadParams(targetWidth, targetHeight, algorithm, TextureColorSpace::Linear), 0x000000FF);
 		}
 
 		/**
 		 * @brief Assign an anisotropy map.
 		 */
 		void SetAnisotropyMap(const std::string &path, int targetWidth = 0, int targetHeight = 0, ResamplingAlgorithm algorithm = ResamplingAlgorithm::Bilinear) {
-			LoadTextureMap(anisotropyMap, hasAnisotropyMap, "Anisotropy", path, targetWidth, targetHeight, algorithm);
+			LoadTextureMap(anisotropyMap, hasAnisotropyMap, "Anisotropy", path, TextureLoadParams(targetWidth, targetHeight, algorithm, TextureColorSpace::Linear), 0x8080FFFF);
+		}
+
+		/**
+		 * @brief Assign AO, roughness, metallic and height through one channel-packed texture.
+		 *
+		 * Uses the pack next to the sources ('<prefix>_ORM.dds'), cooking it first when it is
+		 * missing or older than a source. If packing fails, the maps are loaded separately.
+		 * Channels without a source keep using the scalar factors.
+		 */
+		void SetPackedMaps(const ChannelPackSources &sources, int targetWidth = 0, int targetHeight = 0, ResamplingAlgorithm algorithm = ResamplingAlgorithm::Bilinear) {
+			const std::string packedPath = sources.GetPackedPath();
+			if (!packedPath.empty() && (TextureCooker::IsPackUpToDate(sources, packedPath) || TextureCooker::PackChannels(sources, packedPath))) {
+				LoadTextureMap(packedMap, hasPackedMap, "Packed", packedPath, TextureLoadParams(targetWidth, targetHeight, algorithm, TextureColorSpace::Linear), 0xFFFF0080);
+				packedChannels = hasPackedMap ? sources.GetChannelMask() : 0;
+				if (hasPackedMap)
+					return;
+			}
+
+			std::cerr << "[MaterialPBR] Warning: Packing failed, loading the maps separately." << std::endl;
+			if (!sources.ao.empty())
+				SetAOMap(sources.ao, targetWidth, targetHeight, algorithm);
+			if (!sources.roughness.empty())
+				SetRoughnessMap(sources.roughness, targetWidth, targetHeight, algorithm);
+			if (!sources.metallic.empty())
+				SetMetallicMap(sources.metallic, targetWidth, targetHeight, algorithm);
+			if (!sources.height.empty())
+				SetHeightMap(sources.height, targetWidth, targetHeight, algorithm);
 		}
 
 		/**
 		 * @brief Assign a subsurface scattering (SSS) map.
 		 */
 		void SetSubsurfaceMap(const std::string &path, int targetWidth = 0, int targetHeight = 0, ResamplingAlgorithm algorithm = ResamplingAlgorithm::Bilinear) {
-			LoadTextureMap(subsurfaceMap, hasSubsurfaceMap, "Subsurface", path, targetWidth, targetHeight, algorithm);
+			LoadTextureMap(subsurfaceMap, hasSubsurfaceMap, "Subsurface", path, TextureLoadParams(targetWidth, targetHeight, algorithm, TextureColorSpace::sRGB), 0x000000FF);
 		}
 	};
 
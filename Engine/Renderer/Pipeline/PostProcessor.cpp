@@ -6,12 +6,13 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/04/27 00:01:23 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/04/29 01:05:49 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2025/05/15 15:38:52 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "Renderer/Pipeline/PostProcessor.h"
 #include "Renderer/GPUResources/Framebuffer.h"
+#include "Renderer/Primitives/PrimitiveCache.h"
 #include "Renderer/Shaders/Shader.h"
 #include <functional>
 #include <glad/glad.h>
@@ -46,14 +47,9 @@ namespace Engine {
 		m_FinalShader = std::make_unique<Shader>(
 			"Shaders/PostProcess/final.vert",
 			"Shaders/PostProcess/final.frag");
-
-		initRenderData();
 	}
 
-	PostProcessor::~PostProcessor() {
-		glDeleteVertexArrays(1, &m_QuadVAO);
-		glDeleteBuffers(1, &m_QuadVBO);
-	}
+	PostProcessor::~PostProcessor() = default;
 
 	void PostProcessor::Render(std::function<void()> sceneRender) {
 		glEnable(GL_DEPTH_TEST);
@@ -83,7 +79,7 @@ namespace Engine {
 			glBindTexture(GL_TEXTURE_2D, first_iteration ? m_HDRFBO->GetColorAttachment(1) : m_PingPongFBO[!horizontal]->GetColorAttachment(0));
 			m_GaussianBlurShader->SetUniformInt("image", 0);
 
-			renderQuad();
+			PrimitiveCache::Get().DrawFullscreenTriangle();
 
 			m_PingPongFBO[horizontal]->Unbind();
 			horizontal = !horizontal;
@@ -105,7 +101,7 @@ namespace Engine {
 		m_FinalShader->SetUniformInt("bloomBlur", 1);
 		m_FinalShader->SetUniformFloat("exposure", 1.0f);
 
-		renderQuad();
+		PrimitiveCache::Get().DrawFullscreenTriangle();
 
 		// Unbind textures for cleanliness
 		glActiveTexture(GL_TEXTURE0);
@@ -114,51 +110,4 @@ namespace Engine {
 		glBindTexture(GL_TEXTURE_2D, 0);
 	}
 
-	void PostProcessor::initRenderData() {
-		// Fullscreen quad: 2D positions and UVs
-		float quadVertices[] = {
-			// pos    // uv
-			-1,
-			-1,
-			0,
-			0,
-			1,
-			-1,
-			1,
-			0,
-			-1,
-			1,
-			0,
-			1,
-			-1,
-			1,
-			0,
-			1,
-			1,
-			-1,
-			1,
-			0,
-			1,
-			1,
-			1,
-			1,
-		};
-		glGenVertexArrays(1, &m_QuadVAO);
-		glGenBuffers(1, &m_QuadVBO);
-		glBindVertexArray(m_QuadVAO);
-		glBindBuffer(GL_ARRAY_BUFFER, m_QuadVBO);
-		glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
-		glEnableVertexAttribArray(0);
-		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void *)0);
-		glEnableVertexAttribArray(1);
-		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void *)(2 * sizeof(float)));
-		glBindVertexArray(0);
-	}
-
-	void PostProcessor::renderQuad() {
-		glBindVertexArray(m_QuadVAO);
-		glDrawArrays(GL_TRIANGLES, 0, 6);
-		glBindVertexArray(0);
-	}
-
 } // namespace Engine
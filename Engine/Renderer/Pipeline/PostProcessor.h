@@ -6,7 +6,7 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/04/27 00:01:18 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/04/29 01:06:31 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2025/05/15 15:38:52 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -44,12 +44,8 @@ namespace Engine {
 		std::unique_ptr<Shader> m_GaussianBlurShader;
 		std::unique_ptr<Shader> m_FinalShader;
 
-		// Fullscreen quad geometry
-		unsigned int m_QuadVAO = 0, m_QuadVBO = 0;
+		// Fullscreen passes draw PrimitiveCache::DrawFullscreenTriangle()
 		bool m_First = true;
-
-		void initRenderData(); // Sets up quad VAO/VBO
-		void renderQuad();	   // Draws fullscreen quad
 	};
 
 } // namespace Engine
@@ -0,0 +1,497 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ShadowAtlas.cpp                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/02 14:12:52 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/16 11:29:03 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "Renderer/Pipeline/ShadowAtlas.h"
+#include "Renderer/Camera.h"
+#include "Renderer/Shaders/Shader.h"
+#include "World/Actor.h"
+#include "World/Components/PointLightComponent.h"
+#include "World/Components/SceneComponent.h"
+#include "World/Components/SpotLightComponent.h"
+#include "World/Components/StaticMeshComponent.h"
+#include "World/World.h"
+#include <algorithm>
+#include <cmath>
+#include <glm/gtc/matrix_transform.hpp>
+#include <iostream>
+#include <string>
+
+namespace Engine {
+
+	namespace {
+
+		constexpr float kShadowNearPlane = 0.1f;
+		constexpr float kSpotFovMargin	 = 5.0f; // Degrees added to the outer cone so PCF taps stay inside the frustum
+
+		/// Largest power of two <= value (value >= 1).
+		unsigned int FloorPowerOfTwo(unsigned int value) {
+			unsigned int p = 1;
+			while ((p << 1) <= value)
+				p <<= 1;
+			return p;
+		}
+
+		/// Fraction of the half-screen height covered by a sphere of the given radius.
+		float ComputeScreenCoverage(const Camera &camera, const glm::vec3 &center, float radius) {
+			glm::vec3 viewPos = glm::vec3(camera.GetViewMatrix() * glm::vec4(center, 1.0f));
+			float distance	  = glm::length(viewPos);
+			if (distance <= radius)
+				return 1.0f; // Camera is inside the light volume
+			if (viewPos.z > radius)
+				return 0.0f; // Light volume entirely behind the camera
+			// projection[1][1] = cot(fov / 2)
+			return std::min(radius * camera.GetProjectionMatrix()[1][1] / distance, 1.0f);
+		}
+
+		glm::mat4 ComputeFaceViewMatrix(const glm::vec3 &position, int face) {
+			static const glm::vec3 kDirections[6] = {
+				{1.0f, 0.0f, 0.0f}, {-1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, -1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, -1.0f}};
+			static const glm::vec3 kUps[6] = {
+				{0.0f, -1.0f, 0.0f}, {0.0f, -1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, -1.0f}, {0.0f, -1.0f, 0.0f}, {0.0f, -1.0f, 0.0f}};
+			return glm::lookAt(position, position + kDirections[face], kUps[face]);
+		}
+
+		bool NearlyEqual(const glm::vec3 &a, const glm::vec3 &b) {
+			glm::vec3 d = glm::abs(a - b);
+			return d.x < 1e-4f && d.y < 1e-4f && d.z < 1e-4f;
+		}
+
+	} // namespace
+
+	ShadowAtlas::ShadowAtlas(unsigned int size, unsigned int minTileSize, unsigned int maxTileSize)
+		: m_Size(FloorPowerOfTwo(size)),
+		  m_MinTileSize(FloorPowerOfTwo(minTileSize)),
+		  m_MaxTileSize(std::min(FloorPowerOfTwo(maxTileSize), FloorPowerOfTwo(size))) {
+		// Depth texture covering the whole atlas
+		glGenTextures(1, &m_DepthTexture);
+		glBindTexture(GL_TEXTURE_2D, m_DepthTexture);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, m_Size, m_Size, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+		// Sampled through a sampler2DShadow: linear filtering gives bilinear PCF per tap
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+		// Depth-only framebuffer
+		glGenFramebuffers(1, &m_FBO);
+		glBindFramebuffer(GL_FRAMEBUFFER, m_FBO);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, m_DepthTexture, 0);
+		glDrawBuffer(GL_NONE);
+		glReadBuffer(GL_NONE);
+		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+			std::cerr << "[ShadowAtlas] Framebuffer is not complete!" << std::endl;
+		}
+		glClear(GL_DEPTH_BUFFER_BIT);
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+		// Root node covers the whole atlas
+		CreateNode(0, 0, m_Size, -1);
+	}
+
+	ShadowAtlas::~ShadowAtlas() {
+		glDeleteFramebuffers(1, &m_FBO);
+		glDeleteTextures(1, &m_DepthTexture);
+	}
+
+	// --- Quadtree allocator ---
+
+	int ShadowAtlas::CreateNode(unsigned int x, unsigned int y, unsigned int size, int parent) {
+		Node node;
+		node.x		= x;
+		node.y		= y;
+		node.size	= size;
+		node.parent = parent;
+		if (!m_FreeNodeSlots.empty()) {
+			int index = m_FreeNodeSlots.back();
+			m_FreeNodeSlots.pop_back();
+			m_Nodes[index] = node;
+			return index;
+		}
+		m_Nodes.push_back(node);
+		return static_cast<int>(m_Nodes.size()) - 1;
+	}
+
+	int ShadowAtlas::AllocateTile(unsigned int size) {
+		return AllocateTile(0, size);
+	}
+
+	int ShadowAtlas::AllocateTile(int nodeIndex, unsigned int size) {
+		if (m_Nodes[nodeIndex].size < size)
+			return -1;
+
+		if (m_Nodes[nodeIndex].children[0] < 0) {
+			// Leaf: take it if it fits exactly, otherwise split it
+			if (m_Nodes[nodeIndex].allocated)
+				return -1;
+			if (m_Nodes[nodeIndex].size == size) {
+				m_Nodes[nodeIndex].allocated = true;
+				return nodeIndex;
+			}
+			unsigned int half = m_Nodes[nodeIndex].size / 2;
+			unsigned int x	  = m_Nodes[nodeIndex].x;
+			unsigned int y	  = m_Nodes[nodeIndex].y;
+			// CreateNode may grow m_Nodes, so never hold a reference across these calls
+			int c0 = CreateNode(x, y, half, nodeIndex);
+			int c1 = CreateNode(x + half, y, half, nodeIndex);
+			int c2 = CreateNode(x, y + half, half, nodeIndex);
+			int c3 = CreateNode(x + half, y + half, half, nodeIndex);
+			m_Nodes[nodeIndex].children[0] = c0;
+			m_Nodes[nodeIndex].children[1] = c1;
+			m_Nodes[nodeIndex].children[2] = c2;
+			m_Nodes[nodeIndex].children[3] = c3;
+		}
+
+		for (int i = 0; i < 4; ++i) {
+			int result = AllocateTile(m_Nodes[nodeIndex].children[i], size);
+			if (result >= 0)
+				return result;
+		}
+		return -1;
+	}
+
+	void ShadowAtlas::FreeTile(int nodeIndex) {
+		if (nodeIndex < 0)
+			return;
+		m_Nodes[nodeIndex].allocated = false;
+		m_SpaceFreed				 = true;
+
+		// Merge parents whose four children are all free leaves
+		int parent = m_Nodes[nodeIndex].parent;
+		while (parent >= 0) {
+			bool mergeable = true;
+			for (int child : m_Nodes[parent].children) {
+				if (m_Nodes[child].allocated || m_Nodes[child].children[0] >= 0) {
+					mergeable = false;
+					break;
+				}
+			}
+			if (!mergeable)
+				break;
+			for (int &child : m_Nodes[parent].children) {
+				m_FreeNodeSlots.push_back(child);
+				child = -1;
+			}
+			parent = m_Nodes[parent].parent;
+		}
+	}
+
+	void ShadowAtlas::ReleaseLight(LightShadow &shadow) {
+		for (int i = 0; i < shadow.tileCount; ++i) {
+			FreeTile(shadow.tiles[i]);
+			shadow.tiles[i] = -1;
+		}
+		shadow.tileCount	 = 0;
+		shadow.tileSize		 = 0;
+		shadow.requestedSize = 0;
+		shadow.valid		 = false;
+		shadow.dirty		 = true;
+	}
+
+	bool ShadowAtlas::AllocateLight(LightShadow &shadow, int tileCount, unsigned int tileSize) {
+		// Fall back to smaller tiles while the atlas is crowded
+		for (unsigned int size = tileSize; size >= m_MinTileSize; size /= 2) {
+			int allocated = 0;
+			for (; allocated < tileCount; ++allocated) {
+				shadow.tiles[allocated] = AllocateTile(size);
+				if (shadow.tiles[allocated] < 0)
+					break;
+			}
+			if (allocated == tileCount) {
+				shadow.tileCount	 = tileCount;
+				shadow.tileSize		 = size;
+				shadow.requestedSize = tileSize;
+				shadow.valid		 = false;
+				shadow.dirty		 = true;
+				return true;
+			}
+			for (int i = 0; i < allocated; ++i) {
+				FreeTile(shadow.tiles[i]);
+				shadow.tiles[i] = -1;
+			}
+		}
+		return false;
+	}
+
+	glm::vec4 ShadowAtlas::GetTileRect(int nodeIndex) const {
+		const Node &node = m_Nodes[nodeIndex];
+		float inv		 = 1.0f / float(m_Size);
+		return glm::vec4(float(node.x) * inv, float(node.y) * inv, float(node.size) * inv, float(node.size) * inv);
+	}
+
+	// --- Caster tracking ---
+
+	void ShadowAtlas::TrackCasters(World &world) {
+		m_MovedCasters.clear();
+
+		for (const auto &actor : world.GetActors()) {
+			const StaticMeshComponent *meshComp = actor->GetComponent<StaticMeshComponent>();
+			if (!meshComp)
+				continue;
+
+			// World-space bounding sphere (zero radius while a model is still streaming)
+			glm::mat4 transform = actor->GetRootComponent()->GetWorldTransform();
+			glm::vec3 localCenter(0.0f);
+			float localRadius = 0.0f;
+			meshComp->GetLocalBounds(localCenter, localRadius);
+			const float scale	   = std::max({glm::length(glm::vec3(transform[0])), glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2]))});
+			const glm::vec3 center = glm::vec3(transform * glm::vec4(localCenter, 1.0f));
+			const float radius	   = localRadius * scale;
+
+			auto it = m_Casters.find(meshComp);
+			if (it == m_Casters.end()) {
+				m_MovedCasters.push_back({center, radius});
+				m_Casters[meshComp] = {transform, center, radius, m_Frame};
+				continue;
+			}
+			// A streamed model finishing its load changes the bounds without moving
+			if (it->second.transform != transform || it->second.radius != radius) {
+				m_MovedCasters.push_back({it->second.center, it->second.radius});
+				m_MovedCasters.push_back({center, radius});
+				it->second.transform = transform;
+				it->second.center	 = center;
+				it->second.radius	 = radius;
+			}
+			it->second.lastSeenFrame = m_Frame;
+		}
+
+		// Removed casters invalidate the lights around their last bounds
+		for (auto it = m_Casters.begin(); it != m_Casters.end();) {
+			if (it->second.lastSeenFrame != m_Frame) {
+				m_MovedCasters.push_back({it->second.center, it->second.radius});
+				it = m_Casters.erase(it);
+			} else {
+				++it;
+			}
+		}
+	}
+
+	bool ShadowAtlas::CasterMovedNear(const glm::vec3 &position, float range) const {
+		for (const MovedCaster &caster : m_MovedCasters) {
+			if (glm::length(caster.position - position) <= range + caster.radius)
+				return true;
+		}
+		return false;
+	}
+
+	ShadowAtlas::LightShadow *ShadowAtlas::FindShadow(const LightComponent *light) {
+		auto it = m_Lights.find(light);
+		return it != m_Lights.end() ? &it->second : nullptr;
+	}
+
+	const ShadowAtlas::LightShadow *ShadowAtlas::FindShadow(const LightComponent *light) const {
+		auto it = m_Lights.find(light);
+		return it != m_Lights.end() ? &it->second : nullptr;
+	}
+
+	// --- Per-frame update ---
+
+	void ShadowAtlas::Update(World &world, const Camera &camera, Shader &depthShader) {
+		++m_Frame;
+		m_Stats = Stats();
+		TrackCasters(world);
+
+		struct Request {
+			const LightComponent *light;
+			int tileCount;
+			unsigned int tileSize;
+		};
+		std::vector<Request> requests;
+
+		// 1) Refresh light state and work out the tile size each light wants
+		WorldLights lights = world.CollectLights();
+		m_SpotSlots.assign(lights.spots.size(), nullptr);
+		m_PointSlots.assign(lights.points.size(), nullptr);
+
+		auto processLight = [&](const PointLightComponent *light, const glm::vec3 &direction, float fov, int tileCount) {
+			glm::vec3 position = light->GetOwner()->GetRootComponent()->GetWorldPosition();
+			float range		   = std::max(light->GetAttenuationRadius(), kShadowNearPlane * 2.0f);
+
+			LightShadow &shadow	 = m_Lights[light];
+			shadow.lastSeenFrame = m_Frame;
+			if (!NearlyEqual(shadow.position, position) || !NearlyEqual(shadow.direction, direction) || shadow.range != range || shadow.fov != fov || CasterMovedNear(position, range)) {
+				shadow.dirty = true;
+			}
+			shadow.position	 = position;
+			shadow.direction = direction;
+			shadow.range	 = range;
+			shadow.fov		 = fov;
+
+			float importance = std::max(light->GetShadowImportance(), 0.0f);
+			float coverage	 = ComputeScreenCoverage(camera, position, range);
+			shadow.priority	 = coverage * importance;
+
+			// Point lights spread their budget over six faces
+			float ideal = float(m_MaxTileSize) * shadow.priority * (tileCount > 1 ? 0.5f : 1.0f);
+			ideal		= std::clamp(ideal, float(m_MinTileSize), float(m_MaxTileSize));
+
+			// Hysteresis: keep the current request unless the ideal drifts well outside it. The request,
+			// not the granted size, is compared: a crowded atlas may have granted a smaller fallback tile.
+			unsigned int tileSize = FloorPowerOfTwo(static_cast<unsigned int>(ideal));
+			if (shadow.tileCount == tileCount && shadow.requestedSize != 0 && ideal >= shadow.requestedSize * 0.75f && ideal < shadow.requestedSize * 2.5f) {
+				tileSize = shadow.requestedSize;
+			}
+			requests.push_back({light, tileCount, tileSize});
+		};
+
+		for (size_t i = 0; i < lights.spots.size(); ++i) {
+			const SpotLightComponent *spot = lights.spots[i];
+			if (!spot->CastsShadows())
+				continue;
+			processLight(spot, spot->GetDirection(), std::min(spot->GetOuterCutOff() * 2.0f + kSpotFovMargin, 170.0f), 1);
+			m_SpotSlots[i] = spot;
+		}
+		for (size_t i = 0; i < lights.points.size(); ++i) {
+			const PointLightComponent *point = lights.points[i];
+			if (!point->CastsShadows())
+				continue;
+			processLight(point, glm::vec3(0.0f), 90.0f, MAX_TILES_PER_LIGHT);
+			m_PointSlots[i] = point;
+		}
+
+		// 2) Drop lights that disappeared, and free tiles whose size changes
+		for (auto it = m_Lights.begin(); it != m_Lights.end();) {
+			if (it->second.lastSeenFrame != m_Frame) {
+				ReleaseLight(it->second);
+				it = m_Lights.erase(it);
+			} else {
+				++it;
+			}
+		}
+		for (const Request &request : requests) {
+			LightShadow &shadow = m_Lights[request.light];
+			if (shadow.tileCount != 0 && (shadow.tileCount != request.tileCount || shadow.requestedSize != request.tileSize))
+				ReleaseLight(shadow);
+		}
+		// Lights on fallback tiles only retry their requested size once space has been freed
+		if (m_SpaceFreed) {
+			for (const Request &request : requests) {
+				LightShadow &shadow = m_Lights[request.light];
+				if (shadow.tileCount != 0 && shadow.tileSize < shadow.requestedSize)
+					ReleaseLight(shadow);
+			}
+		}
+
+		// 3) Allocate missing tiles, largest and most important first
+		std::sort(requests.begin(), requests.end(), [&](const Request &a, const Request &b) {
+			if (a.tileSize != b.tileSize)
+				return a.tileSize > b.tileSize;
+			return m_Lights[a.light].priority > m_Lights[b.light].priority;
+		});
+		for (const Request &request : requests) {
+			LightShadow &shadow = m_Lights[request.light];
+			if (shadow.tileCount == 0 && !AllocateLight(shadow, request.tileCount, request.tileSize)) {
+				++m_Stats.failedAllocs;
+				continue;
+			}
+			++m_Stats.shadowedLights;
+			m_Stats.usedTexels += uint64_t(shadow.tileCount) * shadow.tileSize * shadow.tileSize;
+		}
+		m_SpaceFreed = false; // The releases above were consumed by this allocation pass
+
+		// 4) Re-render dirty lights within the budget; lights without any content go first
+		std::vector<LightShadow *> dirty;
+		for (auto &entry : m_Lights) {
+			if (entry.second.dirty && entry.second.tileCount > 0)
+				dirty.push_back(&entry.second);
+		}
+		std::sort(dirty.begin(), dirty.end(), [](const LightShadow *a, const LightShadow *b) {
+			if (a->valid != b->valid)
+				return !a->valid;
+			return a->priority > b->priority;
+		});
+
+		int updates = std::min(static_cast<int>(dirty.size()), m_UpdateBudget);
+		if (updates > 0) {
+			glBindFramebuffer(GL_FRAMEBUFFER, m_FBO);
+			glEnable(GL_SCISSOR_TEST);
+			depthShader.Bind();
+			for (int i = 0; i < updates; ++i) {
+				RenderLight(*dirty[i], world, depthShader);
+			}
+			glDisable(GL_SCISSOR_TEST);
+		}
+		m_Stats.updatedLights = updates;
+		m_Stats.pendingLights = static_cast<int>(dirty.size()) - updates;
+	}
+
+	void ShadowAtlas::RenderLight(LightShadow &shadow, World &world, Shader &depthShader) {
+		if (shadow.tileCount == 1) {
+			// Spot light: one perspective frustum around the outer cone
+			const glm::vec3 up = std::abs(shadow.direction.y) > 0.99f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+			glm::mat4 proj = glm::perspective(glm::radians(shadow.fov), 1.0f, kShadowNearPlane, shadow.range);
+			glm::mat4 view = glm::lookAt(shadow.position, shadow.position + shadow.direction, up);
+			shadow.matrices[0] = proj * view;
+		} else {
+			// Point light: six 90 degree cube faces
+			glm::mat4 proj = glm::perspective(glm::radians(shadow.fov), 1.0f, kShadowNearPlane, shadow.range);
+			for (int face = 0; face < shadow.tileCount; ++face) {
+				shadow.matrices[face] = proj * ComputeFaceViewMatrix(shadow.position, face);
+			}
+		}
+
+		// Clear every tile (glClear only honours the scissor box of viewport 0)
+		for (int i = 0; i < shadow.tileCount; ++i) {
+			const Node &node = m_Nodes[shadow.tiles[i]];
+			glScissorIndexed(0, node.x, node.y, node.size, node.size);
+			glClear(GL_DEPTH_BUFFER_BIT);
+		}
+
+		// One viewport per tile; the layered depth shader writes all of them in a single pass
+		for (int i = 0; i < shadow.tileCount; ++i) {
+			const Node &node = m_Nodes[shadow.tiles[i]];
+			glViewportIndexedf(i, float(node.x), float(node.y), float(node.size), float(node.size));
+			glScissorIndexed(i, node.x, node.y, node.size, node.size);
+			depthShader.SetUniformMat4("lightSpaceMatrices[" + std::to_string(i) + "]", shadow.matrices[i]);
+		}
+		depthShader.SetUniformInt("u_ViewCount", shadow.tileCount);
+		world.RenderDepth(depthShader);
+		m_Stats.renderedTiles += shadow.tileCount;
+
+		shadow.dirty = false;
+		shadow.valid = true;
+	}
+
+	// --- Shading ---
+
+	void ShadowAtlas::SetupUniforms(Shader &shader, int textureUnit) const {
+		glActiveTexture(GL_TEXTURE0 + textureUnit);
+		glBindTexture(GL_TEXTURE_2D, m_DepthTexture);
+		shader.SetUniformInt("u_ShadowAtlas", textureUnit);
+
+		for (int i = 0; i < World::MAX_SPOT_LIGHTS; ++i) {
+			std::string index		  = "[" + std::to_string(i) + "]";
+			const LightShadow *shadow = i < (int)m_SpotSlots.size() ? FindShadow(m_SpotSlots[i]) : nullptr;
+			if (shadow && shadow->valid) {
+				shader.SetUniformMat4("u_SpotShadowMatrices" + index, shadow->matrices[0]);
+				shader.SetUniformVec4("u_SpotShadowRects" + index, GetTileRect(shadow->tiles[0]));
+			} else {
+				shader.SetUniformVec4("u_SpotShadowRects" + index, glm::vec4(0.0f));
+			}
+		}
+
+		for (int i = 0; i < World::MAX_POINT_LIGHTS; ++i) {
+			const LightShadow *shadow = i < (int)m_PointSlots.size() ? FindShadow(m_PointSlots[i]) : nullptr;
+			for (int face = 0; face < MAX_TILES_PER_LIGHT; ++face) {
+				std::string index = "[" + std::to_string(i * MAX_TILES_PER_LIGHT + face) + "]";
+				if (shadow && shadow->valid) {
+					shader.SetUniformMat4("u_PointShadowMatrices" + index, shadow->matrices[face]);
+					shader.SetUniformVec4("u_PointShadowRects" + index, GetTileRect(shadow->tiles[face]));
+				} else {
+					shader.SetUniformVec4("u_PointShadowRects" + index, glm::vec4(0.0f));
+				}
+			}
+		}
+	}
+
+} // namespace Engine
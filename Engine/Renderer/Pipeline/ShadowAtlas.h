@@ -0,0 +1,183 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ShadowAtlas.h                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/02 14:12:41 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/16 11:29:03 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+// ShadowAtlas.h
+#pragma once
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Engine {
+
+	class Camera;
+	class LightComponent;
+	class Shader;
+	class StaticMeshComponent;
+	class World;
+
+	/**
+	 * @class ShadowAtlas
+	 * @brief Single depth texture shared by every shadowed point and spot light.
+	 *
+	 * The atlas is partitioned by a quadtree: each node is a square tile that can be split into
+	 * four children of half its size. Spot lights receive one tile, point lights receive six
+	 * (one per cube face). Tile resolution is picked from the light's projected screen size and
+	 * its shadow importance.
+	 *
+	 * Tiles are cached between frames: a light's tiles are only re-rendered when the light moves,
+	 * its tile resolution changes, or a shadow caster inside its range moves. At most
+	 * `updateBudget` lights are re-rendered per frame; the rest keep their previous contents
+	 * until their turn comes.
+	 *
+	 * Typical usage (once per frame, before the main pass):
+	 *  - Update() to allocate tiles and re-render the dirty ones.
+	 *  - SetupUniforms() on the lighting shader after World::Render() light setup.
+	 */
+	class ShadowAtlas {
+	public:
+		static constexpr int MAX_TILES_PER_LIGHT = 6; ///< Cube faces for point lights.
+
+		/**
+		 * @brief Creates the atlas depth texture and framebuffer.
+		 * @param size        Width/height of the atlas texture (power of two).
+		 * @param minTileSize Smallest tile the quadtree hands out.
+		 * @param maxTileSize Largest tile a single light face can receive.
+		 */
+		ShadowAtlas(unsigned int size = 4096, unsigned int minTileSize = 64, unsigned int maxTileSize = 1024);
+
+		/**
+		 * @brief Destructor. Cleans up OpenGL resources.
+		 */
+		~ShadowAtlas();
+
+		ShadowAtlas(const ShadowAtlas &)			= delete;
+		ShadowAtlas &operator=(const ShadowAtlas &) = delete;
+
+		/**
+		 * @brief Allocates tiles for the world's lights and re-renders dirty tiles within the budget.
+		 * @param world       World providing lights and shadow casters.
+		 * @param camera      Camera used to estimate each light's projected screen size.
+		 * @param depthShader Layered depth shader (expects "lightSpaceMatrices[]" and "u_ViewCount").
+		 *
+		 * Leaves the atlas framebuffer bound; callers restore their own framebuffer and viewport.
+		 */
+		void Update(World &world, const Camera &camera, Shader &depthShader);
+
+		/**
+		 * @brief Binds the atlas and uploads per-light shadow matrices and tile rectangles.
+		 * @param shader      Lighting shader (forward_shading, or deferred_lighting which reads the point light tiles).
+		 * @param textureUnit Texture unit index used for the atlas sampler.
+		 *
+		 * Slots follow World::CollectLights() order. Lights without a valid tile get an empty
+		 * rectangle, which the shader treats as unshadowed.
+		 */
+		void SetupUniforms(Shader &shader, int textureUnit) const;
+
+		/**
+		 * @brief Sets how many lights may be re-rendered per frame.
+		 * @param budget Maximum light updates per frame (at least 1).
+		 */
+		void SetUpdateBudget(int budget) { m_UpdateBudget = budget > 0 ? budget : 1; }
+		int GetUpdateBudget() const { return m_UpdateBudget; }
+
+		/**
+		 * @brief Per-frame counters, reset at the start of each Update().
+		 */
+		struct Stats {
+			int shadowedLights	= 0; ///< Lights holding tiles this frame.
+			int updatedLights	= 0; ///< Lights re-rendered this frame.
+			int pendingLights	= 0; ///< Dirty lights deferred by the budget.
+			int renderedTiles	= 0; ///< Tiles rendered this frame.
+			int failedAllocs	= 0; ///< Lights that found no free tile.
+			uint64_t usedTexels = 0; ///< Texels covered by allocated tiles.
+		};
+		const Stats &GetStats() const { return m_Stats; }
+
+		unsigned int GetDepthTexture() const { return m_DepthTexture; }
+		unsigned int GetSize() const { return m_Size; }
+
+	private:
+		/// Quadtree node. Leaves are either free or allocated; inner nodes have four children.
+		struct Node {
+			unsigned int x, y, size;
+			int children[4] = {-1, -1, -1, -1};
+			int parent		= -1;
+			bool allocated	= false;
+		};
+
+		/// Cached shadow state of one light.
+		struct LightShadow {
+			int tiles[MAX_TILES_PER_LIGHT] = {-1, -1, -1, -1, -1, -1};
+			int tileCount				   = 0;
+			unsigned int tileSize		   = 0;
+			unsigned int requestedSize	   = 0; ///< Size last asked for; tileSize is smaller when the atlas was crowded.
+			glm::mat4 matrices[MAX_TILES_PER_LIGHT];
+			glm::vec3 position	   = glm::vec3(0.0f);
+			glm::vec3 direction	   = glm::vec3(0.0f);
+			float range			   = 0.0f;
+			float fov			   = 90.0f; ///< Vertical field of view in degrees.
+			float priority		   = 0.0f;
+			bool dirty			   = true;
+			bool valid			   = false; ///< Tiles hold rendered depth for the current allocation.
+			uint64_t lastSeenFrame = 0;
+		};
+
+		int CreateNode(unsigned int x, unsigned int y, unsigned int size, int parent);
+		int AllocateTile(unsigned int size);
+		int AllocateTile(int nodeIndex, unsigned int size);
+		void FreeTile(int nodeIndex);
+		void ReleaseLight(LightShadow &shadow);
+		bool AllocateLight(LightShadow &shadow, int tileCount, unsigned int tileSize);
+
+		void TrackCasters(World &world);
+		bool CasterMovedNear(const glm::vec3 &position, float range) const;
+		void RenderLight(LightShadow &shadow, World &world, Shader &depthShader);
+		glm::vec4 GetTileRect(int nodeIndex) const;
+
+		LightShadow *FindShadow(const LightComponent *light);
+		const LightShadow *FindShadow(const LightComponent *light) const;
+
+		unsigned int m_FBO			= 0;
+		unsigned int m_DepthTexture = 0;
+		unsigned int m_Size;
+		unsigned int m_MinTileSize;
+		unsigned int m_MaxTileSize;
+		int m_UpdateBudget = 2;
+		uint64_t m_Frame   = 0;
+		bool m_SpaceFreed  = false; ///< Tiles were freed since the last allocation pass (lights on fallback tiles may grow).
+
+		std::vector<Node> m_Nodes;		 ///< Quadtree storage; node 0 covers the whole atlas.
+		std::vector<int> m_FreeNodeSlots; ///< Recycled indices in m_Nodes.
+		std::unordered_map<const LightComponent *, LightShadow> m_Lights;
+
+		/// Last seen world transform and bounds per caster, used to detect moving casters.
+		struct CasterState {
+			glm::mat4 transform;
+			glm::vec3 center; ///< World-space bounding sphere center.
+			float radius;	  ///< World-space bounding sphere radius (mesh bounds x largest axis scale).
+			uint64_t lastSeenFrame;
+		};
+		std::unordered_map<const StaticMeshComponent *, CasterState> m_Casters;
+		struct MovedCaster {
+			glm::vec3 position;
+			float radius;
+		};
+		std::vector<MovedCaster> m_MovedCasters; ///< Old and new positions of casters that moved this frame.
+
+		std::vector<const LightComponent *> m_SpotSlots;  ///< Light per spot uniform slot.
+		std::vector<const LightComponent *> m_PointSlots; ///< Light per point uniform slot.
+		Stats m_Stats;
+	};
+
+} // namespace Engine
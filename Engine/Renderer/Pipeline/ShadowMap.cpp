@@ -6,15 +6,30 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/04/27 01:14:42 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/04/29 01:06:02 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2025/05/16 10:21:48 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "Renderer/Pipeline/ShadowMap.h"
+#include "Renderer/Primitives/PrimitiveCache.h"
+#include "Renderer/Shaders/Shader.h"
+#include <algorithm>
+#include <cmath>
 #include <glm/gtc/matrix_transform.hpp>
+#include <iostream>
 
 namespace Engine {
 
+	const char *ToString(ShadowFilterMode mode) {
+		switch (mode) {
+		case ShadowFilterMode::HardwarePCF: return "Hardware PCF";
+		case ShadowFilterMode::PoissonPCF: return "Poisson PCF";
+		case ShadowFilterMode::PCSS: return "PCSS";
+		case ShadowFilterMode::EVSM: return "EVSM";
+		default: return "Unknown";
+		}
+	}
+
 	ShadowMap::ShadowMap(unsigned int w, unsigned int h)
 		: SHADOW_WIDTH(w), SHADOW_HEIGHT(h) {
 		// Create framebuffer for shadow mapping
@@ -23,25 +38,62 @@ namespace Engine {
 		// Create depth texture for storing shadow map
 		glGenTextures(1, &depthMap);
 		glBindTexture(GL_TEXTURE_2D, depthMap);
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, SHADOW_WIDTH, SHADOW_HEIGHT, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, SHADOW_WIDTH, SHADOW_HEIGHT, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+		// Linear filtering + comparison mode: each sampler2DShadow tap returns a bilinear 2x2 PCF result
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
 		float borderColor[] = {1.0f, 1.0f, 1.0f, 1.0f};
 		glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
 
+		// Sampler object for raw depth reads (overrides the texture's comparison mode)
+		glGenSamplers(1, &rawDepthSampler);
+		glSamplerParameteri(rawDepthSampler, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glSamplerParameteri(rawDepthSampler, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glSamplerParameteri(rawDepthSampler, GL_TEXTURE_COMPARE_MODE, GL_NONE);
+		glSamplerParameteri(rawDepthSampler, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+		glSamplerParameteri(rawDepthSampler, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+		glSamplerParameterfv(rawDepthSampler, GL_TEXTURE_BORDER_COLOR, borderColor);
+
 		// Attach depth texture to framebuffer (no color buffer)
 		glBindFramebuffer(GL_FRAMEBUFFER, depthMapFBO);
 		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depthMap, 0);
 		glDrawBuffer(GL_NONE);
 		glReadBuffer(GL_NONE);
+
+		// EVSM moments target: RGBA32F with a full mip chain used as a prefiltered shadow map
+		const int mipLevels = 1 + static_cast<int>(std::floor(std::log2(float(std::max(SHADOW_WIDTH, SHADOW_HEIGHT)))));
+		glGenTextures(1, &momentsMap);
+		glBindTexture(GL_TEXTURE_2D, momentsMap);
+		glTexStorage2D(GL_TEXTURE_2D, mipLevels, GL_RGBA32F, SHADOW_WIDTH, SHADOW_HEIGHT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+		glGenFramebuffers(1, &momentsFBO);
+		glBindFramebuffer(GL_FRAMEBUFFER, momentsFBO);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, momentsMap, 0);
+		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+			std::cerr << "[ShadowMap] EVSM moments framebuffer is not complete!" << std::endl;
+		}
 		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+		momentsShader = std::make_unique<Shader>("Shaders/Core/evsm_moments.vert", "Shaders/Core/evsm_moments.frag");
+		if (!momentsShader->IsValid()) {
+			std::cerr << "[ShadowMap] Failed to load EVSM moments shader." << std::endl;
+		}
 	}
 
 	ShadowMap::~ShadowMap() {
 		glDeleteFramebuffers(1, &depthMapFBO);
 		glDeleteTextures(1, &depthMap);
+		glDeleteSamplers(1, &rawDepthSampler);
+		glDeleteFramebuffers(1, &momentsFBO);
+		glDeleteTextures(1, &momentsMap);
 	}
 
 	void ShadowMap::BindForWriting() {
@@ -57,6 +109,55 @@ namespace Engine {
 		glBindTexture(GL_TEXTURE_2D, depthMap);
 	}
 
+	void ShadowMap::PrepareForSampling() {
+		if (filterMode != ShadowFilterMode::EVSM || !momentsShader->IsValid())
+			return;
+
+		// Depth -> exponential moments (fullscreen triangle)
+		glBindFramebuffer(GL_FRAMEBUFFER, momentsFBO);
+		glViewport(0, 0, SHADOW_WIDTH, SHADOW_HEIGHT);
+		glDisable(GL_DEPTH_TEST);
+		momentsShader->Bind();
+		glActiveTexture(GL_TEXTURE0);
+		glBindTexture(GL_TEXTURE_2D, depthMap);
+		glBindSampler(0, rawDepthSampler);
+		momentsShader->SetUniformInt("u_DepthMap", 0);
+		PrimitiveCache::Get().DrawFullscreenTriangle();
+		glBindSampler(0, 0);
+		glEnable(GL_DEPTH_TEST);
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+		// Mip chain = box-prefiltered moments, sampled trilinearly in the lighting pass
+		glBindTexture(GL_TEXTURE_2D, momentsMap);
+		glGenerateMipmap(GL_TEXTURE_2D);
+	}
+
+	void ShadowMap::SetupUniforms(Shader &shader, int firstTextureUnit) const {
+		// Comparison sampler (sampler2DShadow)
+		glActiveTexture(GL_TEXTURE0 + firstTextureUnit);
+		glBindTexture(GL_TEXTURE_2D, depthMap);
+		shader.SetUniformInt("shadowMap", firstTextureUnit);
+
+		// Same depth texture, raw reads through the sampler object
+		glActiveTexture(GL_TEXTURE0 + firstTextureUnit + 1);
+		glBindTexture(GL_TEXTURE_2D, depthMap);
+		glBindSampler(firstTextureUnit + 1, rawDepthSampler);
+		shader.SetUniformInt("u_ShadowDepthMap", firstTextureUnit + 1);
+
+		// EVSM moments
+		glActiveTexture(GL_TEXTURE0 + firstTextureUnit + 2);
+		glBindTexture(GL_TEXTURE_2D, momentsMap);
+		shader.SetUniformInt("u_ShadowMoments", firstTextureUnit + 2);
+
+		shader.SetUniformInt("u_ShadowFilterMode", static_cast<int>(filterMode));
+		shader.SetUniformFloat("u_ShadowLightSize", lightSize);
+		shader.SetUniformMat4("lightSpaceMatrix", lightSpaceMatrix);
+	}
+
+	void ShadowMap::ResetSamplers(int firstTextureUnit) const {
+		glBindSampler(firstTextureUnit + 1, 0);
+	}
+
 	void ShadowMap::ComputeLightSpaceMatrix(const glm::vec3 &lightDir) {
 		// Build orthographic projection and view matrix for directional light
 		const float near_plane = 1.0f, far_plane = 25.0f;
@@ -6,7 +6,7 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/04/27 01:14:33 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/04/27 11:12:27 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2025/05/16 10:21:48 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -14,9 +14,28 @@
 #pragma once
 #include <glad/glad.h>
 #include <glm/glm.hpp>
+#include <memory>
 
 namespace Engine {
 
+	class Shader;
+
+	/**
+	 * @brief Filtering applied when sampling the directional shadow map (matches SHADOW_FILTER_* in shadow.glsl).
+	 */
+	enum class ShadowFilterMode {
+		HardwarePCF = 0, ///< sampler2DShadow, four bilinear comparison taps (3x3 tent).
+		PoissonPCF	= 1, ///< 16 Poisson-disk comparison taps rotated per pixel.
+		PCSS		= 2, ///< Blocker search + variable-size Poisson PCF (contact hardening).
+		EVSM		= 3, ///< Exponential variance shadow map with mipmapped (prefiltered) moments.
+		Count
+	};
+
+	/**
+	 * @brief Returns a human-readable name for a shadow filter mode.
+	 */
+	const char *ToString(ShadowFilterMode mode);
+
 	/**
 	 * @class ShadowMap
 	 * @brief Encapsulates OpenGL resources and logic for shadow mapping with directional lights.
@@ -26,9 +45,15 @@ namespace Engine {
 	 * methods to bind the FBO for writing (rendering the shadow map), bind the depth texture for
 	 * reading (sampling during scene rendering), and compute the light space transformation matrix.
 	 *
+	 * The depth texture is created with GL_LINEAR filtering and GL_COMPARE_REF_TO_TEXTURE, so
+	 * shaders sample it through a sampler2DShadow and get hardware 2x2 PCF per tap. Raw depth
+	 * (needed by the PCSS blocker search) is read through a separate sampler object, and the
+	 * EVSM mode converts depth into a mipmapped moments texture after the depth pass.
+	 *
 	 * Typical usage:
 	 *  - Call BindForWriting() before rendering the scene from the light's point of view.
-	 *  - Use GetDepthMapTexture() to bind the shadow map as a sampler in your shaders.
+	 *  - Call PrepareForSampling() once the depth pass is done.
+	 *  - Call SetupUniforms() on the lighting shader.
 	 *  - Use ComputeLightSpaceMatrix() to update the light's projection-view matrix.
 	 */
 	class ShadowMap {
@@ -60,6 +85,44 @@ namespace Engine {
 		 */
 		void BindForReading(GLenum textureUnit);
 
+		/**
+		 * @brief Finishes the shadow pass for the current filter mode.
+		 *
+		 * For EVSM, converts depth into exponential moments and builds their mip chain
+		 * (prefiltering). Other modes sample the depth texture directly and do nothing here.
+		 */
+		void PrepareForSampling();
+
+		/**
+		 * @brief Binds all shadow textures and sets the filtering uniforms of shadow.glsl.
+		 * @param shader           Lighting shader (forward or deferred).
+		 * @param firstTextureUnit First of three consecutive texture units (compare, raw depth, moments).
+		 */
+		void SetupUniforms(Shader &shader, int firstTextureUnit) const;
+
+		/**
+		 * @brief Unbinds the raw depth sampler object set by SetupUniforms() (call after the lighting draw).
+		 * @param firstTextureUnit Same unit as passed to SetupUniforms().
+		 *
+		 * Sampler objects override texture state, so leaving it bound would make any texture
+		 * later bound on that unit sample without filtering or comparison.
+		 */
+		void ResetSamplers(int firstTextureUnit) const;
+
+		/**
+		 * @brief Selects how the shadow map is filtered when sampled.
+		 * @param mode Filter mode.
+		 */
+		void SetFilterMode(ShadowFilterMode mode) { filterMode = mode; }
+		ShadowFilterMode GetFilterMode() const { return filterMode; }
+
+		/**
+		 * @brief Sets the light source size used by PCSS (fraction of the shadow map width).
+		 * @param size Light size in shadow map UV units.
+		 */
+		void SetLightSize(float size) { lightSize = size; }
+		float GetLightSize() const { return lightSize; }
+
 		/**
 		 * @brief Computes the light space transformation matrix for a directional light.
 		 * @param lightDir The direction vector of the light (world space, normalized).
@@ -83,9 +146,15 @@ namespace Engine {
 	private:
 		unsigned int depthMapFBO;		  ///< OpenGL framebuffer object for shadow map rendering.
 		unsigned int depthMap;			  ///< OpenGL texture ID for the depth map.
+		unsigned int rawDepthSampler;	  ///< Sampler object reading depthMap without comparison (PCSS, EVSM).
+		unsigned int momentsFBO;		  ///< Framebuffer for the EVSM moments pass.
+		unsigned int momentsMap;		  ///< RGBA32F exponential moments with a full mip chain.
+		std::unique_ptr<Shader> momentsShader; ///< Depth -> EVSM moments conversion shader.
 		const unsigned int SHADOW_WIDTH;  ///< Width of the shadow map texture.
 		const unsigned int SHADOW_HEIGHT; ///< Height of the shadow map texture.
 		glm::mat4 lightSpaceMatrix;		  ///< Light's projection-view matrix for shadow mapping.
+		ShadowFilterMode filterMode = ShadowFilterMode::HardwarePCF; ///< Active filtering mode.
+		float lightSize				= 0.01f;							 ///< PCSS light size (shadow map UV units).
 	};
 
 } // namespace Engine
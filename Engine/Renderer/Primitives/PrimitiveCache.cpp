@@ -0,0 +1,112 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   PrimitiveCache                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/15 15:24:09 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/15 15:24:09 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "Renderer/Primitives/PrimitiveCache.h"
+#include "Renderer/Primitives/Primitives.h"
+#include <glad/glad.h>
+#include <utility>
+
+namespace Engine {
+
+	PrimitiveCache &PrimitiveCache::Get() {
+		static PrimitiveCache s_Instance;
+		return s_Instance;
+	}
+
+	template <typename Generate>
+	std::shared_ptr<Mesh> PrimitiveCache::Find(const Key &key, Generate generate) {
+		auto it = m_Entries.find(key);
+		if (it != m_Entries.end()) {
+			++m_Stats.hits;
+			return it->second;
+		}
+
+		++m_Stats.misses;
+		std::shared_ptr<Mesh> mesh(generate());
+		m_Entries.emplace(key, mesh);
+		return mesh;
+	}
+
+	void PrimitiveCache::CreateBuiltIns() {
+		m_BuiltInsCreated = true;
+
+		std::vector<MeshGeometry> geometries;
+		geometries.push_back(Primitives::GenerateQuad());
+		geometries.push_back(Primitives::GenerateCube());
+		geometries.push_back(Primitives::GenerateSphere());
+		std::vector<std::unique_ptr<Mesh>> meshes = Mesh::CreateShared(geometries);
+		if (meshes.size() != 3) return;
+
+		// The shared buffer is always in the Full layout (see Mesh::CreateShared())
+		m_Entries[Key(Shape::Quad, 0.0f, 0.0f, 0, 0, VertexFormat::Full)]	= std::move(meshes[0]);
+		m_Entries[Key(Shape::Cube, 0.0f, 0.0f, 0, 0, VertexFormat::Full)]	= std::move(meshes[1]);
+		m_Entries[Key(Shape::Sphere, 0.0f, 0.0f, 36, 18, VertexFormat::Full)] = std::move(meshes[2]);
+		m_Stats.misses += 3;
+	}
+
+	std::shared_ptr<Mesh> PrimitiveCache::GetQuad() {
+		if (!m_BuiltInsCreated) CreateBuiltIns();
+		return Find(Key(Shape::Quad, 0.0f, 0.0f, 0, 0, VertexFormat::Full), [] { return Primitives::CreateQuad(); });
+	}
+
+	std::shared_ptr<Mesh> PrimitiveCache::GetCube() {
+		if (!m_BuiltInsCreated) CreateBuiltIns();
+		return Find(Key(Shape::Cube, 0.0f, 0.0f, 0, 0, VertexFormat::Full), [] { return Primitives::CreateCube(); });
+	}
+
+	std::shared_ptr<Mesh> PrimitiveCache::GetPlane(unsigned int subdivisions) {
+		return Find(Key(Shape::Plane, 0.0f, 0.0f, subdivisions, 0, Mesh::GetDefaultVertexFormat()),
+					[=] { return Primitives::CreatePlane(subdivisions); });
+	}
+
+	std::shared_ptr<Mesh> PrimitiveCache::GetSphere(unsigned int sectorCount, unsigned int stackCount) {
+		VertexFormat format = Mesh::GetDefaultVertexFormat();
+		if (sectorCount == 36 && stackCount == 18) {
+			if (!m_BuiltInsCreated) CreateBuiltIns();
+			format = VertexFormat::Full;
+		}
+		return Find(Key(Shape::Sphere, 0.0f, 0.0f, sectorCount, stackCount, format),
+					[=] { return Primitives::CreateSphere(sectorCount, stackCount); });
+	}
+
+	std::shared_ptr<Mesh> PrimitiveCache::GetCylinder(float height, float radius, unsigned int sectorCount) {
+		return Find(Key(Shape::Cylinder, height, radius, sectorCount, 0, Mesh::GetDefaultVertexFormat()),
+					[=] { return Primitives::CreateCylinder(height, radius, sectorCount); });
+	}
+
+	std::shared_ptr<Mesh> PrimitiveCache::GetCone(float height, float radius, unsigned int sectorCount) {
+		return Find(Key(Shape::Cone, height, radius, sectorCount, 0, Mesh::GetDefaultVertexFormat()),
+					[=] { return Primitives::CreateCone(height, radius, sectorCount); });
+	}
+
+	std::shared_ptr<Mesh> PrimitiveCache::GetTorus(float mainRadius, float tubeRadius, unsigned int mainSegments, unsigned int tubeSegments) {
+		return Find(Key(Shape::Torus, mainRadius, tubeRadius, mainSegments, tubeSegments, Mesh::GetDefaultVertexFormat()),
+					[=] { return Primitives::CreateTorus(mainRadius, tubeRadius, mainSegments, tubeSegments); });
+	}
+
+	void PrimitiveCache::DrawFullscreenTriangle() {
+		if (m_EmptyVAO == 0) glGenVertexArrays(1, &m_EmptyVAO);
+		glBindVertexArray(m_EmptyVAO);
+		glDrawArrays(GL_TRIANGLES, 0, 3);
+		glBindVertexArray(0);
+	}
+
+	void PrimitiveCache::Clear() {
+		if (m_EmptyVAO) {
+			glDeleteVertexArrays(1, &m_EmptyVAO);
+			m_EmptyVAO = 0;
+		}
+		m_Entries.clear();
+		m_BuiltInsCreated = false;
+	}
+
+} // namespace Engine
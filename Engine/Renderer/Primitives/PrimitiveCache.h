@@ -0,0 +1,101 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   PrimitiveCache.h                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/15 15:20:44 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/15 15:20:44 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#pragma once
+
+#include "Renderer/Geometry/Mesh.h"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <tuple>
+
+/**
+ * @file PrimitiveCache.h
+ * @brief Engine-wide registry of generated primitive meshes, keyed by shape and parameters.
+ */
+
+namespace Engine {
+
+	/**
+	 * @class PrimitiveCache
+	 * @brief Generates each primitive once per parameter set and hands out shared meshes.
+	 *
+	 * The default quad, cube and sphere are packed into one vertex/index buffer
+	 * (Mesh::CreateShared()), so drawing them one after another never switches buffers.
+	 * Other shapes and parameter sets get their own buffers in the default vertex format.
+	 * Entries are kept until Clear(): primitives are small and requested again and again.
+	 *
+	 * Also draws the fullscreen triangle used by screen-space passes. GL thread only.
+	 */
+	class PrimitiveCache {
+	public:
+		/**
+		 * @brief Counters for profiling.
+		 */
+		struct Stats {
+			uint64_t hits	= 0; ///< Requests served by an existing mesh.
+			uint64_t misses = 0; ///< Meshes generated.
+		};
+
+		/**
+		 * @brief Engine-wide cache.
+		 */
+		static PrimitiveCache &Get();
+
+		PrimitiveCache(const PrimitiveCache &)			  = delete;
+		PrimitiveCache &operator=(const PrimitiveCache &) = delete;
+
+		// Same shapes and defaults as Primitives::CreateX()
+		std::shared_ptr<Mesh> GetQuad();
+		std::shared_ptr<Mesh> GetCube();
+		std::shared_ptr<Mesh> GetPlane(unsigned int subdivisions = 1);
+		std::shared_ptr<Mesh> GetSphere(unsigned int sectorCount = 36, unsigned int stackCount = 18);
+		std::shared_ptr<Mesh> GetCylinder(float height = 1.0f, float radius = 0.5f, unsigned int sectorCount = 36);
+		std::shared_ptr<Mesh> GetCone(float height = 1.0f, float radius = 0.5f, unsigned int sectorCount = 36);
+		std::shared_ptr<Mesh> GetTorus(float mainRadius = 1.0f, float tubeRadius = 0.2f, unsigned int mainSegments = 36, unsigned int tubeSegments = 18);
+
+		/**
+		 * @brief Draw one triangle covering the viewport (the vertex shader builds it from gl_VertexID).
+		 *        Outputs span [-1, 3] in clip space and [0, 2] in UV, so the visible part is [0, 1].
+		 */
+		void DrawFullscreenTriangle();
+
+		const Stats &GetStats() const { return m_Stats; }
+
+		/**
+		 * @brief Drop every entry and the fullscreen VAO (call before the GL context is destroyed).
+		 *        Meshes stay alive while referenced elsewhere.
+		 */
+		void Clear();
+
+	private:
+		PrimitiveCache() = default;
+
+		enum class Shape { Quad, Cube, Plane, Sphere, Cylinder, Cone, Torus };
+
+		/// Shape, float parameters, integer parameters, vertex format.
+		using Key = std::tuple<Shape, float, float, unsigned int, unsigned int, VertexFormat>;
+
+		template <typename Generate>
+		std::shared_ptr<Mesh> Find(const Key &key, Generate generate);
+
+		/// Packs the default quad, cube and sphere into one shared buffer.
+		void CreateBuiltIns();
+
+		std::map<Key, std::shared_ptr<Mesh>> m_Entries;
+		bool m_BuiltInsCreated = false;
+		unsigned int m_EmptyVAO = 0; ///< Attribute-less VAO for DrawFullscreenTriangle() (core profile needs one bound).
+		Stats m_Stats;
+	};
+
+} // namespace Engine
@@ -6,14 +6,16 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/04/28 10:30:04 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/04/29 00:57:26 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2025/05/15 15:38:52 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "Renderer/Geometry/Mesh.h"
+#include "Renderer/Geometry/MeshOptimizer.h"
 #include "Renderer/Primitives/Primitives.h"
 #include <cmath>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #ifndef M_PI
@@ -22,11 +24,14 @@
 
 namespace Engine {
 
-	std::unique_ptr<Mesh> Primitives::CreateCone(float height, float radius, unsigned int sectorCount) {
+	MeshGeometry Primitives::GenerateCone(float height, float radius, unsigned int sectorCount) {
 		std::vector<Vertex> vertices;
 		std::vector<unsigned int> indices;
 		const float halfHeight = height * 0.5f;
 
+		vertices.reserve(2 + (sectorCount + 1) * 2);
+		indices.reserve(sectorCount * 6);
+
 		// Apex vertex (top point)
 		const glm::vec3 apexPos(0.0f, halfHeight, 0.0f);
 		vertices.push_back({apexPos,
@@ -48,11 +53,11 @@ namespace Engine {
 		const unsigned int baseVertexStart = 2;
 
 		// Generate base ring and side ring vertices
+		const std::vector<glm::vec2> ring = AngleTable(sectorCount, 2.0f * float(M_PI));
 		for (unsigned int i = 0; i <= sectorCount; ++i) {
-			const float theta = (float)i / sectorCount * 2.0f * M_PI;
-			const float x	  = radius * std::cos(theta);
-			const float z	  = radius * std::sin(theta);
-			const float u	  = (float)i / sectorCount;
+			const float x = radius * ring[i].x;
+			const float z = radius * ring[i].y;
+			const float u = (float)i / sectorCount;
 
 			// Base ring vertex
 			glm::vec3 basePos(x, -halfHeight, z);
@@ -88,7 +93,13 @@ namespace Engine {
 			indices.push_back(next);
 		}
 
-		return std::make_unique<Mesh>(vertices, indices);
+		MeshOptimizer::Optimize(vertices, indices);
+		return {std::move(vertices), std::move(indices)};
+	}
+
+	std::unique_ptr<Mesh> Primitives::CreateCone(float height, float radius, unsigned int sectorCount) {
+		MeshGeometry geometry = GenerateCone(height, radius, sectorCount);
+		return std::make_unique<Mesh>(std::move(geometry.vertices), std::move(geometry.indices));
 	}
 
 } // namespace Engine
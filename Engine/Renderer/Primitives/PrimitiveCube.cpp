@@ -6,20 +6,22 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/04/28 10:30:00 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/04/29 00:57:26 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2025/05/15 15:38:52 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "Renderer/Geometry/Mesh.h"
+#include "Renderer/Geometry/MeshOptimizer.h"
 #include "Renderer/Primitives/Primitives.h"
 #include <memory>
+#include <utility>
 #include <vector>
 
 namespace Engine {
 
 	// Generates a unit cube centered at the origin with per-face normals, tangents, and UVs.
 	// Each face uses unique vertices for correct shading and texturing.
-	std::unique_ptr<Mesh> Primitives::CreateCube() {
+	MeshGeometry Primitives::GenerateCube() {
 		std::vector<Vertex> vertices = {
 			// Back face (-Z)
 			{{-0.5f, -0.5f, -0.5f}, {0.0f, 0.0f, -1.0f}, {0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, -1.0f, 0.0f}},
@@ -103,7 +105,13 @@ namespace Engine {
 			23,
 			20};
 
-		return std::make_unique<Mesh>(vertices, indices);
+		MeshOptimizer::Optimize(vertices, indices);
+		return {std::move(vertices), std::move(indices)};
+	}
+
+	std::unique_ptr<Mesh> Primitives::CreateCube() {
+		MeshGeometry geometry = GenerateCube();
+		return std::make_unique<Mesh>(std::move(geometry.vertices), std::move(geometry.indices));
 	}
 
 } // namespace Engine
@@ -6,14 +6,16 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/04/28 10:30:03 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/04/29 00:57:26 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2025/05/15 15:38:52 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "Renderer/Geometry/Mesh.h"
+#include "Renderer/Geometry/MeshOptimizer.h"
 #include "Renderer/Primitives/Primitives.h"
 #include <cmath>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #ifndef M_PI
@@ -26,11 +28,14 @@ namespace Engine {
 	// - height: total height of the cylinder
 	// - radius: radius of the cylinder
 	// - sectorCount: number of segments around the circumference (minimum 3)
-	std::unique_ptr<Mesh> Primitives::CreateCylinder(float height, float radius, unsigned int sectorCount) {
+	MeshGeometry Primitives::GenerateCylinder(float height, float radius, unsigned int sectorCount) {
 		std::vector<Vertex> vertices;
 		std::vector<unsigned int> indices;
 		const float halfHeight = height * 0.5f;
 
+		vertices.reserve(2 + (sectorCount + 1) * 4);
+		indices.reserve(sectorCount * 12);
+
 		// Add center vertices for top and bottom caps
 		vertices.push_back({
 			{0.0f, halfHeight, 0.0f}, // Position (top center)
@@ -51,10 +56,10 @@ namespace Engine {
 		const unsigned int ringStartIdx	   = 2;
 
 		// Generate ring vertices for caps and sides
+		const std::vector<glm::vec2> ring = AngleTable(sectorCount, 2.0f * float(M_PI));
 		for (unsigned int i = 0; i <= sectorCount; ++i) {
-			const float theta		= (float)i / sectorCount * 2.0f * M_PI;
-			const float x			= radius * std::cos(theta);
-			const float z			= radius * std::sin(theta);
+			const float x			= radius * ring[i].x;
+			const float z			= radius * ring[i].y;
 			const float u			= (float)i / sectorCount;
 			const glm::vec3 tangent = glm::normalize(glm::vec3(-z, 0.0f, x));
 
@@ -109,7 +114,13 @@ namespace Engine {
 			indices.push_back(curr + 3);
 		}
 
-		return std::make_unique<Mesh>(vertices, indices);
+		MeshOptimizer::Optimize(vertices, indices);
+		return {std::move(vertices), std::move(indices)};
+	}
+
+	std::unique_ptr<Mesh> Primitives::CreateCylinder(float height, float radius, unsigned int sectorCount) {
+		MeshGeometry geometry = GenerateCylinder(height, radius, sectorCount);
+		return std::make_unique<Mesh>(std::move(geometry.vertices), std::move(geometry.indices));
 	}
 
 } // namespace Engine
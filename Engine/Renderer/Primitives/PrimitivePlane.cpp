@@ -6,21 +6,23 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/04/28 10:30:01 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/04/29 00:57:26 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2025/05/15 15:38:52 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "Renderer/Geometry/Mesh.h"
+#include "Renderer/Geometry/MeshOptimizer.h"
 #include "Renderer/Primitives/Primitives.h"
 #include <algorithm>
 #include <memory>
+#include <utility>
 #include <vector>
 
 namespace Engine {
 
 	// Generates a subdivided plane mesh centered at the origin, lying on the XZ plane.
 	// - subdivisions: number of quads per axis (minimum 1)
-	std::unique_ptr<Mesh> Primitives::CreatePlane(unsigned int subdivisions) {
+	MeshGeometry Primitives::GeneratePlane(unsigned int subdivisions) {
 		const unsigned int div		  = std::max(1u, subdivisions);
 		const unsigned int vertCount  = (div + 1) * (div + 1);
 		const unsigned int indexCount = div * div * 6;
@@ -61,7 +63,13 @@ namespace Engine {
 			}
 		}
 
-		return std::make_unique<Mesh>(vertices, indices);
+		MeshOptimizer::Optimize(vertices, indices);
+		return {std::move(vertices), std::move(indices)};
+	}
+
+	std::unique_ptr<Mesh> Primitives::CreatePlane(unsigned int subdivisions) {
+		MeshGeometry geometry = GeneratePlane(subdivisions);
+		return std::make_unique<Mesh>(std::move(geometry.vertices), std::move(geometry.indices));
 	}
 
 } // namespace Engine
@@ -6,20 +6,21 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/04/28 10:45:00 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/04/29 00:57:26 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2025/05/15 15:38:52 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "Renderer/Geometry/Mesh.h"
 #include "Renderer/Primitives/Primitives.h"
 #include <memory>
+#include <utility>
 #include <vector>
 
 namespace Engine {
 
 	// Generates a unit quad centered at the origin, lying on the XY plane, facing +Z.
 	// Vertex order: bottom-left, bottom-right, top-right, top-left.
-	std::unique_ptr<Mesh> Primitives::CreateQuad() {
+	MeshGeometry Primitives::GenerateQuad() {
 		std::vector<Vertex> vertices = {
 			// Position                Normal              TexCoord    Tangent             Bitangent
 			{{-0.5f, -0.5f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}}, // Bottom Left
@@ -32,7 +33,12 @@ namespace Engine {
 		std::vector<unsigned int> indices = {
 			0, 1, 2, 2, 3, 0};
 
-		return std::make_unique<Mesh>(vertices, indices);
+		return {std::move(vertices), std::move(indices)};
+	}
+
+	std::unique_ptr<Mesh> Primitives::CreateQuad() {
+		MeshGeometry geometry = GenerateQuad();
+		return std::make_unique<Mesh>(std::move(geometry.vertices), std::move(geometry.indices));
 	}
 
 } // namespace Engine
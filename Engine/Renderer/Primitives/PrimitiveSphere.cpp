@@ -6,14 +6,16 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/04/28 10:30:02 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/04/29 00:57:26 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2025/05/15 15:38:52 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "Renderer/Geometry/Mesh.h"
+#include "Renderer/Geometry/MeshOptimizer.h"
 #include "Renderer/Primitives/Primitives.h"
 #include <cmath>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #ifndef M_PI
@@ -22,7 +24,7 @@
 
 namespace Engine {
 
-	std::unique_ptr<Mesh> Primitives::CreateSphere(unsigned int sectorCount, unsigned int stackCount) {
+	MeshGeometry Primitives::GenerateSphere(unsigned int sectorCount, unsigned int stackCount) {
 		std::vector<Vertex> vertices;
 		std::vector<unsigned int> indices;
 		const float radius = 0.5f;
@@ -30,23 +32,23 @@ namespace Engine {
 		vertices.reserve((stackCount + 1) * (sectorCount + 1));
 		indices.reserve(stackCount * sectorCount * 6);
 
-		// Generate vertices
+		// Generate vertices (latitude 0..pi from the north pole, longitude 0..2pi)
+		const std::vector<glm::vec2> stacks	 = AngleTable(stackCount, float(M_PI));
+		const std::vector<glm::vec2> sectors = AngleTable(sectorCount, 2.0f * float(M_PI));
 		for (unsigned int stack = 0; stack <= stackCount; ++stack) {
-			float stackTheta = M_PI_2 - (float(stack) / stackCount) * M_PI; // +pi/2 to -pi/2
-			float xy		 = radius * cosf(stackTheta);
-			float y			 = radius * sinf(stackTheta);
+			float xy = radius * stacks[stack].y;
+			float y	 = radius * stacks[stack].x;
 
 			for (unsigned int sector = 0; sector <= sectorCount; ++sector) {
-				float sectorPhi = (float(sector) / sectorCount) * 2.0f * M_PI; // 0 to 2pi
-				float x			= xy * cosf(sectorPhi);
-				float z			= xy * sinf(sectorPhi);
+				float x = xy * sectors[sector].x;
+				float z = xy * sectors[sector].y;
 
 				glm::vec3 pos(x, y, z);
 				glm::vec3 normal = glm::normalize(pos);
 				glm::vec2 uv(float(sector) / sectorCount, float(stack) / stackCount);
 
 				// Tangent points along increasing phi (longitude)
-				glm::vec3 tangent(-sinf(sectorPhi), 0.0f, cosf(sectorPhi));
+				glm::vec3 tangent(-sectors[sector].y, 0.0f, sectors[sector].x);
 				// Bitangent points along increasing theta (latitude)
 				glm::vec3 bitangent = glm::cross(normal, tangent);
 
@@ -81,7 +83,13 @@ namespace Engine {
 			}
 		}
 
-		return std::make_unique<Mesh>(vertices, indices);
+		MeshOptimizer::Optimize(vertices, indices);
+		return {std::move(vertices), std::move(indices)};
+	}
+
+	std::unique_ptr<Mesh> Primitives::CreateSphere(unsigned int sectorCount, unsigned int stackCount) {
+		MeshGeometry geometry = GenerateSphere(sectorCount, stackCount);
+		return std::make_unique<Mesh>(std::move(geometry.vertices), std::move(geometry.indices));
 	}
 
 } // namespace Engine
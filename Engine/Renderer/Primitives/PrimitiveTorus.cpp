@@ -6,14 +6,16 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/04/28 10:30:05 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/04/29 00:57:26 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2025/05/15 15:38:52 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "Renderer/Geometry/Mesh.h"
+#include "Renderer/Geometry/MeshOptimizer.h"
 #include "Renderer/Primitives/Primitives.h"
 #include <cmath>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #ifndef M_PI
@@ -27,25 +29,25 @@ namespace Engine {
 	// tubeRadius: radius of the tube
 	// mainSegments: number of segments around the main ring
 	// tubeSegments: number of segments around the tube
-	std::unique_ptr<Mesh> Primitives::CreateTorus(float mainRadius, float tubeRadius, unsigned int mainSegments, unsigned int tubeSegments) {
+	MeshGeometry Primitives::GenerateTorus(float mainRadius, float tubeRadius, unsigned int mainSegments, unsigned int tubeSegments) {
 		std::vector<Vertex> vertices;
 		std::vector<unsigned int> indices;
 
 		vertices.reserve((mainSegments + 1) * (tubeSegments + 1));
 		indices.reserve(mainSegments * tubeSegments * 6);
 
+		const std::vector<glm::vec2> rings = AngleTable(mainSegments, 2.0f * float(M_PI));
+		const std::vector<glm::vec2> tubes = AngleTable(tubeSegments, 2.0f * float(M_PI));
 		for (unsigned int i = 0; i <= mainSegments; ++i) {
-			float theta	   = float(i) / mainSegments * 2.0f * M_PI;
-			float cosTheta = cosf(theta);
-			float sinTheta = sinf(theta);
+			float cosTheta = rings[i].x;
+			float sinTheta = rings[i].y;
 
 			// Center of tube circle for this main segment
 			glm::vec3 circleCenter = {cosTheta * mainRadius, 0.0f, sinTheta * mainRadius};
 
 			for (unsigned int j = 0; j <= tubeSegments; ++j) {
-				float phi	 = float(j) / tubeSegments * 2.0f * M_PI;
-				float cosPhi = cosf(phi);
-				float sinPhi = sinf(phi);
+				float cosPhi = tubes[j].x;
+				float sinPhi = tubes[j].y;
 
 				// Position of vertex
 				float x = (mainRadius + tubeRadius * cosPhi) * cosTheta;
@@ -93,7 +95,13 @@ namespace Engine {
 			}
 		}
 
-		return std::make_unique<Mesh>(vertices, indices);
+		MeshOptimizer::Optimize(vertices, indices);
+		return {std::move(vertices), std::move(indices)};
+	}
+
+	std::unique_ptr<Mesh> Primitives::CreateTorus(float mainRadius, float tubeRadius, unsigned int mainSegments, unsigned int tubeSegments) {
+		MeshGeometry geometry = GenerateTorus(mainRadius, tubeRadius, mainSegments, tubeSegments);
+		return std::make_unique<Mesh>(std::move(geometry.vertices), std::move(geometry.indices));
 	}
 
 } // namespace Engine
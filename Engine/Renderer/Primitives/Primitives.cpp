@@ -0,0 +1,27 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Primitives.cpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/15 15:02:18 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/15 15:02:18 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "Renderer/Primitives/Primitives.h"
+#include <cmath>
+
+namespace Engine {
+
+	std::vector<glm::vec2> Primitives::AngleTable(unsigned int segments, float angleRange) {
+		std::vector<glm::vec2> table(segments + 1);
+		for (unsigned int i = 0; i <= segments; ++i) {
+			const float angle = float(i) / segments * angleRange;
+			table[i]		  = glm::vec2(std::cos(angle), std::sin(angle));
+		}
+		return table;
+	}
+
+} // namespace Engine
@@ -6,14 +6,16 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/04/26 12:27:07 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/04/29 00:57:26 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2025/05/15 15:38:52 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #pragma once
 
 #include "Renderer/Geometry/Mesh.h"
+#include <glm/glm.hpp>
 #include <memory>
+#include <vector>
 
 /**
  * @file Primitives.h
@@ -85,6 +87,25 @@ namespace Engine {
 		 * @return Unique pointer to the generated Mesh.
 		 */
 		static std::unique_ptr<Mesh> CreateQuad();
+
+		/**
+		 * @brief The same shapes as CreateX() with the same defaults, as CPU geometry (not uploaded).
+		 *        Used to pack several primitives into one buffer with Mesh::CreateShared().
+		 */
+		static MeshGeometry GenerateCube();
+		static MeshGeometry GeneratePlane(unsigned int subdivisions = 1);
+		static MeshGeometry GenerateSphere(unsigned int sectorCount = 36, unsigned int stackCount = 18);
+		static MeshGeometry GenerateCylinder(float height = 1.0f, float radius = 0.5f, unsigned int sectorCount = 36);
+		static MeshGeometry GenerateCone(float height = 1.0f, float radius = 0.5f, unsigned int sectorCount = 36);
+		static MeshGeometry GenerateTorus(float mainRadius = 1.0f, float tubeRadius = 0.2f, unsigned int mainSegments = 36, unsigned int tubeSegments = 18);
+		static MeshGeometry GenerateQuad();
+
+	private:
+		/**
+		 * @brief (cos, sin) of angleRange * i / segments for i = 0 .. segments.
+		 *        Rings and grids look angles up here instead of evaluating sin/cos per vertex.
+		 */
+		static std::vector<glm::vec2> AngleTable(unsigned int segments, float angleRange);
 	};
 
 } // namespace Engine
@@ -25,24 +25,36 @@
 namespace Engine {
 
 	Shader::Shader(const std::string &vertexPath, const std::string &fragmentPath) {
+		Build(vertexPath, "", fragmentPath);
+	}
+
+	Shader::Shader(const std::string &vertexPath, const std::string &geometryPath, const std::string &fragmentPath) {
+		Build(vertexPath, geometryPath, fragmentPath);
+	}
+
+	void Shader::Build(const std::string &vertexPath, const std::string &geometryPath, const std::string &fragmentPath) {
+		const bool hasGeometry	 = !geometryPath.empty();
 		std::filesystem::path vp = vertexPath;
 		std::filesystem::path fp = fragmentPath;
 
 		std::string vertexSource   = LoadAndPreprocessShader(vp);
+		std::string geometrySource = hasGeometry ? LoadAndPreprocessShader(std::filesystem::path(geometryPath)) : std::string();
 		std::string fragmentSource = LoadAndPreprocessShader(fp);
 
-		if (vertexSource.empty() || fragmentSource.empty()) {
-			std::cerr << "Error: Failed to load or preprocess shader files: " << vertexPath << ", " << fragmentPath << std::endl;
+		if (vertexSource.empty() || fragmentSource.empty() || (hasGeometry && geometrySource.empty())) {
+			std::cerr << "Error: Failed to load or preprocess shader files: " << vertexPath << ", " << (hasGeometry ? geometryPath + ", " : "") << fragmentPath << std::endl;
 			m_IsValid = false;
 			return;
 		}
 
 		unsigned int vertexShader	= CompileShader(GL_VERTEX_SHADER, vertexSource, vertexPath);
+		unsigned int geometryShader = hasGeometry ? CompileShader(GL_GEOMETRY_SHADER, geometrySource, geometryPath) : 0;
 		unsigned int fragmentShader = CompileShader(GL_FRAGMENT_SHADER, fragmentSource, fragmentPath);
 
-		if (vertexShader == 0 || fragmentShader == 0) {
-			std::cerr << "Error: Shader compilation failed for: " << vertexPath << ", " << fragmentPath << std::endl;
+		if (vertexShader == 0 || fragmentShader == 0 || (hasGeometry && geometryShader == 0)) {
+			std::cerr << "Error: Shader compilation failed for: " << vertexPath << ", " << (hasGeometry ? geometryPath + ", " : "") << fragmentPath << std::endl;
 			if (vertexShader) glDeleteShader(vertexShader);
+			if (geometryShader) glDeleteShader(geometryShader);
 			if (fragmentShader) glDeleteShader(fragmentShader);
 			m_IsValid = false;
 			return;
@@ -52,12 +64,14 @@ namespace Engine {
 		if (!m_RendererID) {
 			std::cerr << "Error: Failed to create shader program." << std::endl;
 			glDeleteShader(vertexShader);
+			if (geometryShader) glDeleteShader(geometryShader);
 			glDeleteShader(fragmentShader);
 			m_IsValid = false;
 			return;
 		}
 
 		glAttachShader(m_RendererID, vertexShader);
+		if (geometryShader) glAttachShader(m_RendererID, geometryShader);
 		glAttachShader(m_RendererID, fragmentShader);
 
 		m_IsValid = LinkProgram(m_RendererID, vertexPath, fragmentPath);
@@ -66,12 +80,16 @@ namespace Engine {
 		glDetachShader(m_RendererID, fragmentShader);
 		glDeleteShader(vertexShader);
 		glDeleteShader(fragmentShader);
+		if (geometryShader) {
+			glDetachShader(m_RendererID, geometryShader);
+			glDeleteShader(geometryShader);
+		}
 
 		if (!m_IsValid) {
 			glDeleteProgram(m_RendererID);
 			m_RendererID = 0;
 		} else {
-			std::cout << "Shader program compiled and linked: " << vertexPath << ", " << fragmentPath << " (ID: " << m_RendererID << ")" << std::endl;
+			std::cout << "Shader program compiled and linked: " << vertexPath << ", " << (hasGeometry ? geometryPath + ", " : "") << fragmentPath << " (ID: " << m_RendererID << ")" << std::endl;
 		}
 	}
 
@@ -137,7 +155,7 @@ namespace Engine {
 		return location;
 	}
 
-	// Compile a shader stage (vertex or fragment), return shader ID or 0 on error
+	// Compile a shader stage (vertex, geometry or fragment), return shader ID or 0 on error
 	unsigned int Shader::CompileShader(unsigned int type, const std::string &source, const std::string &originalPath) {
 		if (source.empty()) {
 			std::cerr << "Error: Cannot compile empty shader source for " << originalPath << std::endl;
@@ -155,7 +173,7 @@ namespace Engine {
 			glGetShaderiv(id, GL_INFO_LOG_LENGTH, &length);
 			std::vector<char> message(length);
 			glGetShaderInfoLog(id, length, &length, message.data());
-			std::cerr << "Failed to compile " << (type == GL_VERTEX_SHADER ? "vertex" : "fragment")
+			std::cerr << "Failed to compile " << (type == GL_VERTEX_SHADER ? "vertex" : type == GL_GEOMETRY_SHADER ? "geometry" : "fragment")
 					  << " shader (" << originalPath << "):\n"
 					  << message.data() << std::endl;
 			std::cerr << "--- Shader Source (" << originalPath << ") ---\n"
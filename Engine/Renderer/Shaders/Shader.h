@@ -35,6 +35,14 @@ namespace Engine {
 		 */
 		Shader(const std::string &vertexPath, const std::string &fragmentPath);
 
+		/**
+		 * @brief Construct and compile a shader program with a geometry stage.
+		 * @param vertexPath   Path to the vertex shader file.
+		 * @param geometryPath Path to the geometry shader file.
+		 * @param fragmentPath Path to the fragment shader file.
+		 */
+		Shader(const std::string &vertexPath, const std::string &geometryPath, const std::string &fragmentPath);
+
 		/**
 		 * @brief Destructor. Deletes the OpenGL shader program.
 		 */
@@ -113,6 +121,14 @@ namespace Engine {
 		 */
 		int GetUniformLocation(const std::string &name);
 
+		/**
+		 * @brief Compile all stages and link the program (geometry stage is optional).
+		 * @param vertexPath   Path to the vertex shader file.
+		 * @param geometryPath Path to the geometry shader file, or empty for none.
+		 * @param fragmentPath Path to the fragment shader file.
+		 */
+		void Build(const std::string &vertexPath, const std::string &geometryPath, const std::string &fragmentPath);
+
 		/**
 		 * @brief Load and preprocess a shader file (handles #include recursively).
 		 * @param filepath Path to the shader file.
@@ -137,7 +153,7 @@ namespace Engine {
 
 		/**
 		 * @brief Compile a GLSL shader from source.
-		 * @param type         GL_VERTEX_SHADER or GL_FRAGMENT_SHADER.
+		 * @param type         GL_VERTEX_SHADER, GL_GEOMETRY_SHADER or GL_FRAGMENT_SHADER.
 		 * @param source       GLSL source code.
 		 * @param originalPath Path for error reporting.
 		 * @return Shader object ID, or 0 on failure.
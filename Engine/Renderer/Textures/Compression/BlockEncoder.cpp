@@ -0,0 +1,347 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   BlockEncoder.cpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/11 10:21:55 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/16 11:30:12 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#include "BlockEncoder.h"
+#include "Core/ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+namespace Engine::Renderer::Textures {
+
+	namespace {
+		/// 4x4 block as RGBA8, row-major.
+		struct PixelBlock {
+			uint8_t rgba[16][4];
+		};
+
+		// Edge blocks replicate the last row/column so padding does not pull the endpoints
+		void LoadBlock(const ImageView &image, int blockX, int blockY, PixelBlock &block) {
+			for (int y = 0; y < BlockSize; ++y) {
+				const uint8_t *row = image.Row(std::min(blockY * BlockSize + y, image.height - 1));
+				for (int x = 0; x < BlockSize; ++x) {
+					const uint8_t *p = row + std::min(blockX * BlockSize + x, image.width - 1) * image.channels;
+					uint8_t *out	 = block.rgba[y * BlockSize + x];
+					switch (image.channels) {
+						case 1: out[0] = out[1] = out[2] = p[0], out[3] = 255; break;
+						case 2: out[0] = p[0], out[1] = p[1], out[2] = 0, out[3] = 255; break;
+						case 3: out[0] = p[0], out[1] = p[1], out[2] = p[2], out[3] = 255; break;
+						default: std::memcpy(out, p, 4); break;
+					}
+				}
+			}
+		}
+
+		uint16_t Pack565(const float color[3]) {
+			const int r = std::clamp(static_cast<int>(color[0] * (31.0f / 255.0f) + 0.5f), 0, 31);
+			const int g = std::clamp(static_cast<int>(color[1] * (63.0f / 255.0f) + 0.5f), 0, 63);
+			const int b = std::clamp(static_cast<int>(color[2] * (31.0f / 255.0f) + 0.5f), 0, 31);
+			return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+		}
+
+		void Unpack565(uint16_t packed, int color[3]) {
+			const int r = packed >> 11, g = (packed >> 5) & 63, b = packed & 31;
+			color[0]	= (r << 3) | (r >> 2);
+			color[1]	= (g << 2) | (g >> 4);
+			color[2]	= (b << 3) | (b >> 2);
+		}
+
+		// Nearest of the four 4-color-mode palette entries for every pixel; returns the squared error
+		int PickColorIndices(const PixelBlock &block, uint16_t c0, uint16_t c1, uint32_t &indices) {
+			int palette[4][3];
+			Unpack565(c0, palette[0]);
+			Unpack565(c1, palette[1]);
+			for (int c = 0; c < 3; ++c) {
+				palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+				palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+			}
+
+			int totalError = 0;
+			indices		   = 0;
+			for (int i = 0; i < 16; ++i) {
+				int bestIndex = 0, bestError = 1 << 30;
+				for (int p = 0; p < 4; ++p) {
+					const int dr	= block.rgba[i][0] - palette[p][0];
+					const int dg	= block.rgba[i][1] - palette[p][1];
+					const int db	= block.rgba[i][2] - palette[p][2];
+					const int error = dr * dr + dg * dg + db * db;
+					if (error < bestError)
+						bestError = error, bestIndex = p;
+				}
+				indices |= static_cast<uint32_t>(bestIndex) << (2 * i);
+				totalError += bestError;
+			}
+			return totalError;
+		}
+
+		void EncodeColorBlock(const PixelBlock &block, uint8_t *out) {
+			// Principal axis of the colors (power iteration on the covariance matrix)
+			float mean[3] = {0.0f, 0.0f, 0.0f};
+			for (int i = 0; i < 16; ++i)
+				for (int c = 0; c < 3; ++c)
+					mean[c] += block.rgba[i][c] * (1.0f / 16.0f);
+			float cov[6] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f}; // rr rg rb gg gb bb
+			for (int i = 0; i < 16; ++i) {
+				const float r = block.rgba[i][0] - mean[0], g = block.rgba[i][1] - mean[1], b = block.rgba[i][2] - mean[2];
+				cov[0] += r * r, cov[1] += r * g, cov[2] += r * b, cov[3] += g * g, cov[4] += g * b, cov[5] += b * b;
+			}
+			float axis[3] = {1.0f, 1.0f, 1.0f};
+			for (int iteration = 0; iteration < 8; ++iteration) {
+				const float x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+				const float y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+				const float z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+				const float m = std::max({std::fabs(x), std::fabs(y), std::fabs(z)});
+				if (m < 1e-6f)
+					break;
+				axis[0] = x / m, axis[1] = y / m, axis[2] = z / m;
+			}
+			const float length = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+			for (float &a : axis)
+				a /= length;
+
+			float tMin = 0.0f, tMax = 0.0f;
+			for (int i = 0; i < 16; ++i) {
+				const float t = (block.rgba[i][0] - mean[0]) * axis[0] + (block.rgba[i][1] - mean[1]) * axis[1] + (block.rgba[i][2] - mean[2]) * axis[2];
+				tMin		  = std::min(tMin, t);
+				tMax		  = std::max(tMax, t);
+			}
+			float e0[3], e1[3];
+			for (int c = 0; c < 3; ++c) {
+				e0[c] = mean[c] + axis[c] * tMax;
+				e1[c] = mean[c] + axis[c] * tMin;
+			}
+
+			uint16_t c0 = Pack565(e0), c1 = Pack565(e1);
+			uint32_t indices;
+			int error = PickColorIndices(block, c0, c1, indices);
+
+			// Least-squares endpoints for the chosen indices, kept while they lower the error
+			static const float weights[4] = {1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f};
+			for (int iteration = 0; iteration < 2 && error > 0; ++iteration) {
+				float aa = 0.0f, ab = 0.0f, bb = 0.0f, ax[3] = {0.0f, 0.0f, 0.0f}, bx[3] = {0.0f, 0.0f, 0.0f};
+				for (int i = 0; i < 16; ++i) {
+					const float a = weights[(indices >> (2 * i)) & 3], b = 1.0f - a;
+					aa += a * a, ab += a * b, bb += b * b;
+					for (int c = 0; c < 3; ++c)
+						ax[c] += a * block.rgba[i][c], bx[c] += b * block.rgba[i][c];
+				}
+				const float det = aa * bb - ab * ab;
+				if (std::fabs(det) < 1e-6f)
+					break;
+				for (int c = 0; c < 3; ++c) {
+					e0[c] = (ax[c] * bb - bx[c] * ab) / det;
+					e1[c] = (bx[c] * aa - ax[c] * ab) / det;
+				}
+				const uint16_t n0 = Pack565(e0), n1 = Pack565(e1);
+				uint32_t newIndices;
+				const int newError = PickColorIndices(block, n0, n1, newIndices);
+				if (newError >= error)
+					break;
+				c0 = n0, c1 = n1, indices = newIndices, error = newError;
+			}
+
+			// 4-color mode needs c0 > c1: swapping the endpoints maps indices 0<->1 and 2<->3
+			if (c0 < c1) {
+				std::swap(c0, c1);
+				indices ^= 0x55555555u;
+			} else if (c0 == c1) {
+				indices = 0;
+			}
+			out[0] = uint8_t(c0), out[1] = uint8_t(c0 >> 8);
+			out[2] = uint8_t(c1), out[3] = uint8_t(c1 >> 8);
+			std::memcpy(out + 4, &indices, 4); // Little-endian hosts only, like the file loaders
+		}
+
+		void EncodeScalarBlock(const PixelBlock &block, int channel, uint8_t *out) {
+			int lo = 255, hi = 0;
+			for (int i = 0; i < 16; ++i) {
+				lo = std::min<int>(lo, block.rgba[i][channel]);
+				hi = std::max<int>(hi, block.rgba[i][channel]);
+			}
+			std::memset(out, 0, 8);
+			out[0] = uint8_t(hi);
+			out[1] = uint8_t(lo);
+			if (hi == lo)
+				return;
+
+			// 8-value mode (first endpoint greater): endpoints plus six interpolants
+			int palette[8] = {hi, lo};
+			for (int p = 2; p < 8; ++p)
+				palette[p] = ((8 - p) * hi + (p - 1) * lo + 3) / 7;
+
+			uint64_t bits = 0;
+			for (int i = 0; i < 16; ++i) {
+				int bestIndex = 0, bestError = 1 << 30;
+				for (int p = 0; p < 8; ++p) {
+					const int error = std::abs(block.rgba[i][channel] - palette[p]);
+					if (error < bestError)
+						bestError = error, bestIndex = p;
+				}
+				bits |= static_cast<uint64_t>(bestIndex) << (3 * i);
+			}
+			for (int b = 0; b < 6; ++b)
+				out[2 + b] = uint8_t(bits >> (8 * b));
+		}
+
+		// Four-color mode unless the endpoints ask for three colors + transparent black (BC1 only)
+		void DecodeColorBlock(const uint8_t *in, bool allowThreeColors, PixelBlock &block) {
+			const uint16_t c0 = uint16_t(in[0] | (in[1] << 8));
+			const uint16_t c1 = uint16_t(in[2] | (in[3] << 8));
+			int palette[4][4];
+			Unpack565(c0, palette[0]);
+			Unpack565(c1, palette[1]);
+			palette[0][3] = palette[1][3] = palette[2][3] = palette[3][3] = 255;
+			const bool fourColors = !allowThreeColors || c0 > c1;
+			for (int c = 0; c < 3; ++c) {
+				palette[2][c] = fourColors ? (2 * palette[0][c] + palette[1][c]) / 3 : (palette[0][c] + palette[1][c]) / 2;
+				palette[3][c] = fourColors ? (palette[0][c] + 2 * palette[1][c]) / 3 : 0;
+			}
+			if (!fourColors)
+				palette[3][3] = 0;
+			for (int i = 0; i < 16; ++i) {
+				const int index = (in[4 + i / BlockSize] >> (2 * (i % BlockSize))) & 3;
+				for (int c = 0; c < 4; ++c)
+					block.rgba[i][c] = uint8_t(palette[index][c]);
+			}
+		}
+
+		void DecodeScalarBlock(const uint8_t *in, int channel, PixelBlock &block) {
+			const int a0 = in[0], a1 = in[1];
+			int palette[8] = {a0, a1};
+			for (int p = 1; p < 7; ++p)
+				palette[p + 1] = a0 > a1 ? ((7 - p) * a0 + p * a1) / 7 : (p < 5 ? ((5 - p) * a0 + p * a1) / 5 : (p == 5 ? 0 : 255));
+			uint64_t bits = 0;
+			for (int b = 0; b < 6; ++b)
+				bits |= uint64_t(in[2 + b]) << (8 * b);
+			for (int i = 0; i < 16; ++i)
+				block.rgba[i][channel] = uint8_t(palette[(bits >> (3 * i)) & 7]);
+		}
+
+		void EncodeBlock(const PixelBlock &block, BlockFormat format, uint8_t *out) {
+			switch (format) {
+				case BlockFormat::BC1: EncodeColorBlock(block, out); break;
+				case BlockFormat::BC3:
+					EncodeScalarBlock(block, 3, out);
+					EncodeColorBlock(block, out + 8);
+					break;
+				case BlockFormat::BC4: EncodeScalarBlock(block, 0, out); break;
+				case BlockFormat::BC5:
+					EncodeScalarBlock(block, 0, out);
+					EncodeScalarBlock(block, 1, out + 8);
+					break;
+				default: break;
+			}
+		}
+	}
+
+	bool BlockEncoder::Encode(const ImageView &image, BlockFormat format, std::vector<uint8_t> &blocks) {
+		if (!image.IsValid() || image.type != ChannelType::UInt8 || image.channels > 4) {
+			std::cerr << "[BlockEncoder] Only 8-bit images with 1 to 4 channels can be encoded." << std::endl;
+			return false;
+		}
+		if (format == BlockFormat::None || format == BlockFormat::BC7) {
+			std::cerr << "[BlockEncoder] No encoder for " << ToString(format) << "." << std::endl;
+			return false;
+		}
+
+		const int blocksX		= BlockCount(image.width);
+		const int blocksY		= BlockCount(image.height);
+		const size_t blockBytes = BlockBytes(format);
+		blocks.resize(size_t(blocksX) * blocksY * blockBytes);
+
+		// Roughly a thousand blocks per task
+		const int grain = std::max(1, 1024 / blocksX);
+		ThreadPool::Get().ParallelFor(0, blocksY, grain, [&](int begin, int end) {
+			PixelBlock block;
+			for (int by = begin; by < end; ++by) {
+				uint8_t *out = blocks.data() + size_t(by) * blocksX * blockBytes;
+				for (int bx = 0; bx < blocksX; ++bx, out += blockBytes) {
+					LoadBlock(image, bx, by, block);
+					EncodeBlock(block, format, out);
+				}
+			}
+		});
+		return true;
+	}
+
+	MipChain BlockEncoder::EncodeChain(const MipChain &chain, BlockFormat format) {
+		if (!chain.IsValid() || chain.IsCompressed())
+			return MipChain();
+
+		std::vector<MipLevel> levels(chain.GetLevelCount());
+		for (int i = 0; i < chain.GetLevelCount(); ++i) {
+			levels[i].width	 = chain.GetLevel(i).width;
+			levels[i].height = chain.GetLevel(i).height;
+			if (!Encode(chain.GetLevelView(i), format, levels[i].pixels))
+				return MipChain();
+		}
+		return MipChain::FromCompressedLevels(std::move(levels), format, chain.GetColorSpace());
+	}
+
+	bool BlockEncoder::Decode(const uint8_t *blocks, int width, int height, BlockFormat format, std::vector<uint8_t> &rgba) {
+		if (format == BlockFormat::None || format == BlockFormat::BC7) {
+			std::cerr << "[BlockEncoder] No decoder for " << ToString(format) << "." << std::endl;
+			return false;
+		}
+
+		const int blocksX		= BlockCount(width);
+		const size_t blockBytes = BlockBytes(format);
+		rgba.resize(size_t(width) * height * 4);
+		PixelBlock block;
+		for (int by = 0; by < BlockCount(height); ++by) {
+			for (int bx = 0; bx < blocksX; ++bx) {
+				const uint8_t *in = blocks + (size_t(by) * blocksX + bx) * blockBytes;
+				std::memset(block.rgba, 0, sizeof(block.rgba));
+				switch (format) {
+					case BlockFormat::BC1: DecodeColorBlock(in, true, block); break;
+					case BlockFormat::BC3:
+						DecodeColorBlock(in + 8, false, block);
+						DecodeScalarBlock(in, 3, block);
+						break;
+					case BlockFormat::BC4: DecodeScalarBlock(in, 0, block); break;
+					case BlockFormat::BC5:
+						DecodeScalarBlock(in, 0, block);
+						DecodeScalarBlock(in + 8, 1, block);
+						break;
+					default: break;
+				}
+				for (int i = 0; i < 16; ++i) {
+					const int x = bx * BlockSize + i % BlockSize, y = by * BlockSize + i / BlockSize;
+					if (x < width && y < height)
+						std::memcpy(&rgba[(size_t(y) * width + x) * 4], block.rgba[i], 4);
+				}
+			}
+		}
+		return true;
+	}
+
+	BlockFormat BlockEncoder::ChooseFormat(const MipChain &chain, MipContent content) {
+		if (content == MipContent::NormalMap || chain.GetChannels() == 2)
+			return BlockFormat::BC5;
+		if (chain.GetChannels() == 1)
+			return BlockFormat::BC4;
+		if (chain.GetChannels() == 4) {
+			const ImageView base = chain.GetLevelView(0);
+			for (int y = 0; y < base.height; ++y) {
+				const uint8_t *row = base.Row(y);
+				for (int x = 0; x < base.width; ++x) {
+					if (row[x * 4 + 3] != 255)
+						return BlockFormat::BC3;
+				}
+			}
+		}
+		return BlockFormat::BC1;
+	}
+
+} // namespace Engine::Renderer::Textures
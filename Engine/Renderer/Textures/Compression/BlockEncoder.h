@@ -0,0 +1,72 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   BlockEncoder.h                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/11 10:21:40 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/16 11:30:12 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#pragma once
+
+#include "Renderer/Textures/MipChain.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @file BlockEncoder.h
+ * @brief Multithreaded CPU encoder for BC1, BC3, BC4 and BC5 (asset cooking).
+ */
+
+namespace Engine {
+	namespace Renderer {
+		namespace Textures {
+
+			/**
+			 * @class BlockEncoder
+			 * @brief Encodes 8-bit images into GPU block-compressed formats.
+			 *
+			 * Color blocks (BC1, color half of BC3) fit their endpoints along the principal axis
+			 * of the block's colors and refine them by least squares; scalar blocks (BC4, BC5,
+			 * alpha of BC3) use the 8-value interpolation mode between the block's extremes.
+			 * Block rows are spread over the ThreadPool. sRGB images are encoded on their stored
+			 * values and uploaded to the sRGB variant of the format.
+			 *
+			 * BC7 has neither an encoder nor a decoder here; files holding it are rejected on load.
+			 */
+			class BlockEncoder {
+			public:
+				/**
+				 * @brief Encode one image (UInt8, 1 to 4 channels).
+				 * @param[out] blocks Row-major blocks, BlockCount(width) * BlockCount(height) of them.
+				 * @return false if the image or format is not supported.
+				 */
+				static bool Encode(const ImageView &image, BlockFormat format, std::vector<uint8_t> &blocks);
+
+				/**
+				 * @brief Encode every level of an uncompressed 8-bit chain.
+				 * @return An empty chain on failure.
+				 */
+				static MipChain EncodeChain(const MipChain &chain, BlockFormat format);
+
+				/**
+				 * @brief Decode blocks back to RGBA8 (BC4 fills red, BC5 red and green).
+				 * @param[out] rgba width * height * 4 bytes, row-major.
+				 * @return false for BC7, which has no decoder.
+				 */
+				static bool Decode(const uint8_t *blocks, int width, int height, BlockFormat format, std::vector<uint8_t> &rgba);
+
+				/**
+				 * @brief Format suited to a chain: BC5 for normal maps and 2-channel data, BC4 for
+				 *        1 channel, BC3 when alpha is not fully opaque, BC1 otherwise.
+				 */
+				static BlockFormat ChooseFormat(const MipChain &chain, MipContent content);
+			};
+
+		} // namespace Textures
+	} // namespace Renderer
+} // namespace Engine
@@ -0,0 +1,86 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   BlockFormat.h                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/11 10:04:12 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/16 11:30:12 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#pragma once
+
+#include <cstddef>
+
+/**
+ * @file BlockFormat.h
+ * @brief GPU block-compressed texture formats (BCn) and their block geometry.
+ */
+
+namespace Engine {
+	namespace Renderer {
+		namespace Textures {
+
+			/**
+			 * @brief Block compression of a mip chain. All BCn formats encode 4x4 pixel blocks.
+			 */
+			enum class BlockFormat {
+				None, ///< Uncompressed pixels.
+				BC1,  ///< RGB (1-bit alpha), 8 bytes per block: opaque color maps.
+				BC3,  ///< RGBA, 16 bytes per block: color with smooth alpha.
+				BC4,  ///< One channel, 8 bytes per block: roughness, AO, height, masks.
+				BC5,  ///< Two channels, 16 bytes per block: tangent-space normal XY.
+				BC7	  ///< RGB(A), 16 bytes per block: high-quality color (recognised in files but rejected, see CompressedFile).
+			};
+
+			constexpr int BlockSize = 4; ///< Block width and height in pixels.
+
+			/// Bytes of one 4x4 block (0 for uncompressed data).
+			inline size_t BlockBytes(BlockFormat format) {
+				switch (format) {
+					case BlockFormat::BC1:
+					case BlockFormat::BC4: return 8;
+					case BlockFormat::BC3:
+					case BlockFormat::BC5:
+					case BlockFormat::BC7: return 16;
+					default: return 0;
+				}
+			}
+
+			/// Channels a format decodes to.
+			inline int BlockFormatChannels(BlockFormat format) {
+				switch (format) {
+					case BlockFormat::BC4: return 1;
+					case BlockFormat::BC5: return 2;
+					case BlockFormat::BC1: return 3;
+					default: return 4;
+				}
+			}
+
+			/// Whether the format has an sRGB variant (color formats only).
+			inline bool BlockFormatHasSRGB(BlockFormat format) {
+				return format == BlockFormat::BC1 || format == BlockFormat::BC3 || format == BlockFormat::BC7;
+			}
+
+			/// Number of blocks covering `pixels` pixels along one axis.
+			inline int BlockCount(int pixels) {
+				return (pixels + BlockSize - 1) / BlockSize;
+			}
+
+			inline const char *ToString(BlockFormat format) {
+				switch (format) {
+					case BlockFormat::BC1: return "BC1";
+					case BlockFormat::BC3: return "BC3";
+					case BlockFormat::BC4: return "BC4";
+					case BlockFormat::BC5: return "BC5";
+					case BlockFormat::BC7: return "BC7";
+					default: return "None";
+				}
+			}
+
+		} // namespace Textures
+	} // namespace Renderer
+} // namespace Engine
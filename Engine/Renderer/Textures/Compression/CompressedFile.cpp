@@ -0,0 +1,379 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   CompressedFile.cpp                                 :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/11 11:36:15 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/16 11:32:40 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#include "CompressedFile.h"
+#include "BlockEncoder.h"
+#include "Core/FileUtils.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace Engine::Renderer::Textures {
+
+	namespace {
+		struct DDSPixelFormat {
+			uint32_t size;
+			uint32_t flags;
+			uint32_t fourCC;
+			uint32_t rgbBitCount;
+			uint32_t masks[4];
+		};
+
+		struct DDSHeader {
+			uint32_t size;
+			uint32_t flags;
+			uint32_t height;
+			uint32_t width;
+			uint32_t pitchOrLinearSize;
+			uint32_t depth;
+			uint32_t mipMapCount;
+			uint32_t reserved1[11];
+			DDSPixelFormat pixelFormat;
+			uint32_t caps[4];
+			uint32_t reserved2;
+		};
+
+		struct DDSHeaderDX10 {
+			uint32_t dxgiFormat;
+			uint32_t resourceDimension;
+			uint32_t miscFlag;
+			uint32_t arraySize;
+			uint32_t miscFlags2;
+		};
+
+		struct KTX2Header {
+			uint8_t identifier[12];
+			uint32_t vkFormat;
+			uint32_t typeSize;
+			uint32_t pixelWidth;
+			uint32_t pixelHeight;
+			uint32_t pixelDepth;
+			uint32_t layerCount;
+			uint32_t faceCount;
+			uint32_t levelCount;
+			uint32_t supercompressionScheme;
+			uint32_t dfdByteOffset;
+			uint32_t dfdByteLength;
+			uint32_t kvdByteOffset;
+			uint32_t kvdByteLength;
+			uint64_t sgdByteOffset;
+			uint64_t sgdByteLength;
+		};
+
+		struct KTX2Level {
+			uint64_t byteOffset;
+			uint64_t byteLength;
+			uint64_t uncompressedByteLength;
+		};
+
+		static_assert(sizeof(DDSHeader) == 124, "DDS header layout");
+		static_assert(sizeof(DDSHeaderDX10) == 20, "DDS DX10 header layout");
+		static_assert(sizeof(KTX2Header) == 80, "KTX2 header layout");
+
+		constexpr uint32_t FourCC(char a, char b, char c, char d) {
+			return uint32_t(uint8_t(a)) | (uint32_t(uint8_t(b)) << 8) | (uint32_t(uint8_t(c)) << 16) | (uint32_t(uint8_t(d)) << 24);
+		}
+
+		constexpr uint32_t DDSMagic			  = FourCC('D', 'D', 'S', ' ');
+		constexpr uint32_t DDSCubemap		  = 0x200;
+		constexpr uint8_t KTX2Identifier[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+
+		/// Format and (when the file says so) color space of a DXGI / Vulkan format code.
+		struct FormatInfo {
+			BlockFormat format = BlockFormat::None;
+			int srgb		   = -1; ///< 1 = sRGB, 0 = linear, -1 = not specified.
+		};
+
+		FormatInfo FromDXGI(uint32_t dxgi) {
+			switch (dxgi) {
+				case 71: return {BlockFormat::BC1, 0};
+				case 72: return {BlockFormat::BC1, 1};
+				case 77: return {BlockFormat::BC3, 0};
+				case 78: return {BlockFormat::BC3, 1};
+				case 80: return {BlockFormat::BC4, 0};
+				case 83: return {BlockFormat::BC5, 0};
+				case 98: return {BlockFormat::BC7, 0};
+				case 99: return {BlockFormat::BC7, 1};
+				default: return {};
+			}
+		}
+
+		uint32_t ToDXGI(BlockFormat format, bool srgb) {
+			switch (format) {
+				case BlockFormat::BC1: return srgb ? 72 : 71;
+				case BlockFormat::BC3: return srgb ? 78 : 77;
+				case BlockFormat::BC4: return 80;
+				case BlockFormat::BC5: return 83;
+				case BlockFormat::BC7: return srgb ? 99 : 98;
+				default: return 0;
+			}
+		}
+
+		FormatInfo FromFourCC(uint32_t fourCC) {
+			switch (fourCC) {
+				case FourCC('D', 'X', 'T', '1'): return {BlockFormat::BC1, -1};
+				case FourCC('D', 'X', 'T', '5'): return {BlockFormat::BC3, -1};
+				case FourCC('A', 'T', 'I', '1'):
+				case FourCC('B', 'C', '4', 'U'): return {BlockFormat::BC4, 0};
+				case FourCC('A', 'T', 'I', '2'):
+				case FourCC('B', 'C', '5', 'U'): return {BlockFormat::BC5, 0};
+				default: return {};
+			}
+		}
+
+		FormatInfo FromVkFormat(uint32_t vkFormat) {
+			switch (vkFormat) {
+				case 131:
+				case 133: return {BlockFormat::BC1, 0};
+				case 132:
+				case 134: return {BlockFormat::BC1, 1};
+				case 137: return {BlockFormat::BC3, 0};
+				case 138: return {BlockFormat::BC3, 1};
+				case 139: return {BlockFormat::BC4, 0};
+				case 141: return {BlockFormat::BC5, 0};
+				case 145: return {BlockFormat::BC7, 0};
+				case 146: return {BlockFormat::BC7, 1};
+				default: return {};
+			}
+		}
+
+		size_t LevelBytes(BlockFormat format, int width, int height) {
+			return size_t(BlockCount(width)) * BlockCount(height) * BlockBytes(format);
+		}
+
+		// Color indices: one byte per pixel row
+		void FlipColorRows(uint8_t *block, int rows) {
+			std::reverse(block + 4, block + 4 + rows);
+		}
+
+		// Scalar indices: 48 bits, 12 bits (four 3-bit indices) per pixel row
+		void FlipScalarRows(uint8_t *block, int rows) {
+			uint64_t bits = 0;
+			for (int b = 0; b < 6; ++b)
+				bits |= uint64_t(block[2 + b]) << (8 * b);
+			uint64_t flipped = bits;
+			for (int row = 0; row < rows; ++row) {
+				const uint64_t mask = 0xFFFull << (12 * (rows - 1 - row));
+				flipped				= (flipped & ~mask) | (((bits >> (12 * row)) & 0xFFF) << (12 * (rows - 1 - row)));
+			}
+			for (int b = 0; b < 6; ++b)
+				block[2 + b] = uint8_t(flipped >> (8 * b));
+		}
+
+		/**
+		 * @brief Mirror a level vertically: block rows swap places and pixel rows swap inside blocks.
+		 *
+		 * Exact when the height is a multiple of 4 or fits in one block row. Otherwise the last
+		 * block row is partial and flipped rows would straddle blocks with different endpoints,
+		 * so the level is decoded, flipped and encoded again (lossy).
+		 * @return false for BC7, which can be neither flipped in place nor re-encoded.
+		 */
+		bool FlipLevel(MipLevel &level, BlockFormat format) {
+			if (format == BlockFormat::BC7)
+				return false;
+			if (level.height > BlockSize && level.height % BlockSize != 0) {
+				std::vector<uint8_t> rgba;
+				if (!BlockEncoder::Decode(level.pixels.data(), level.width, level.height, format, rgba))
+					return false;
+				const size_t rowBytes = size_t(level.width) * 4;
+				for (int y = 0; y < level.height / 2; ++y)
+					std::swap_ranges(rgba.begin() + y * rowBytes, rgba.begin() + (y + 1) * rowBytes, rgba.begin() + (level.height - 1 - y) * rowBytes);
+				return BlockEncoder::Encode(ImageView(rgba.data(), level.width, level.height, 4), format, level.pixels);
+			}
+
+			const size_t blockBytes = BlockBytes(format);
+			const size_t rowPitch	= size_t(BlockCount(level.width)) * blockBytes;
+			const int blockRows		= BlockCount(level.height);
+			for (int row = 0; row < blockRows / 2; ++row) {
+				std::swap_ranges(level.pixels.begin() + row * rowPitch, level.pixels.begin() + (row + 1) * rowPitch,
+								 level.pixels.begin() + (blockRows - 1 - row) * rowPitch);
+			}
+
+			const int rows = std::min(level.height, BlockSize);
+			for (size_t offset = 0; offset < level.pixels.size(); offset += blockBytes) {
+				uint8_t *block = level.pixels.data() + offset;
+				switch (format) {
+					case BlockFormat::BC1: FlipColorRows(block, rows); break;
+					case BlockFormat::BC3:
+						FlipScalarRows(block, rows);
+						FlipColorRows(block + 8, rows);
+						break;
+					case BlockFormat::BC4: FlipScalarRows(block, rows); break;
+					case BlockFormat::BC5:
+						FlipScalarRows(block, rows);
+						FlipScalarRows(block + 8, rows);
+						break;
+					default: break;
+				}
+			}
+			return true;
+		}
+
+		bool ReadFile(const std::string &path, std::vector<uint8_t> &bytes) {
+			std::ifstream file(path, std::ios::binary);
+			if (!file)
+				return false;
+			bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+			return true;
+		}
+
+		MipChain LoadDDS(const std::string &path, const std::vector<uint8_t> &bytes, ColorSpace colorSpace) {
+			DDSHeader header{};
+			uint32_t magic = 0;
+			if (bytes.size() < sizeof(magic) + sizeof(header))
+				return MipChain();
+			std::memcpy(&magic, bytes.data(), sizeof(magic));
+			std::memcpy(&header, bytes.data() + sizeof(magic), sizeof(header));
+			if (magic != DDSMagic || header.size != sizeof(DDSHeader) || (header.caps[1] & DDSCubemap) != 0) {
+				std::cerr << "[CompressedFile] Not a 2D DDS texture: " << path << std::endl;
+				return MipChain();
+			}
+
+			size_t offset	= sizeof(magic) + sizeof(header);
+			FormatInfo info = FromFourCC(header.pixelFormat.fourCC);
+			if (header.pixelFormat.fourCC == FourCC('D', 'X', '1', '0')) {
+				DDSHeaderDX10 dx10{};
+				if (bytes.size() < offset + sizeof(dx10))
+					return MipChain();
+				std::memcpy(&dx10, bytes.data() + offset, sizeof(dx10));
+				offset += sizeof(dx10);
+				info = dx10.arraySize <= 1 ? FromDXGI(dx10.dxgiFormat) : FormatInfo();
+			}
+			if (info.format == BlockFormat::None || info.format == BlockFormat::BC7) {
+				std::cerr << "[CompressedFile] Unsupported DDS format (BC7 cannot be flipped to bottom-up): " << path << std::endl;
+				return MipChain();
+			}
+
+			std::vector<MipLevel> levels(std::max(1u, std::min(header.mipMapCount, 32u)));
+			for (size_t i = 0; i < levels.size(); ++i) {
+				MipLevel &level		= levels[i];
+				level.width			= std::max(1, static_cast<int>(header.width >> i));
+				level.height		= std::max(1, static_cast<int>(header.height >> i));
+				const size_t length = LevelBytes(info.format, level.width, level.height);
+				if (bytes.size() < offset + length) {
+					std::cerr << "[CompressedFile] Truncated DDS: " << path << std::endl;
+					return MipChain();
+				}
+				level.pixels.assign(bytes.begin() + offset, bytes.begin() + offset + length);
+				offset += length;
+			}
+			const ColorSpace space = info.srgb < 0 ? colorSpace : (info.srgb ? ColorSpace::sRGB : ColorSpace::Linear);
+			for (MipLevel &level : levels) {
+				if (!FlipLevel(level, info.format))
+					return MipChain();
+			}
+			return MipChain::FromCompressedLevels(std::move(levels), info.format, space);
+		}
+
+		MipChain LoadKTX2(const std::string &path, const std::vector<uint8_t> &bytes) {
+			KTX2Header header{};
+			if (bytes.size() < sizeof(header))
+				return MipChain();
+			std::memcpy(&header, bytes.data(), sizeof(header));
+			if (std::memcmp(header.identifier, KTX2Identifier, sizeof(KTX2Identifier)) != 0 || header.pixelDepth > 1 ||
+				header.layerCount > 1 || header.faceCount != 1) {
+				std::cerr << "[CompressedFile] Not a 2D KTX2 texture: " << path << std::endl;
+				return MipChain();
+			}
+			const FormatInfo info = FromVkFormat(header.vkFormat);
+			if (info.format == BlockFormat::None || info.format == BlockFormat::BC7 || header.supercompressionScheme != 0) {
+				std::cerr << "[CompressedFile] Unsupported KTX2 format (BC7 cannot be flipped to bottom-up) or supercompression: " << path << std::endl;
+				return MipChain();
+			}
+
+			std::vector<MipLevel> levels(std::max(1u, std::min(header.levelCount, 32u)));
+			if (bytes.size() < sizeof(header) + levels.size() * sizeof(KTX2Level))
+				return MipChain();
+			for (size_t i = 0; i < levels.size(); ++i) {
+				KTX2Level index{};
+				std::memcpy(&index, bytes.data() + sizeof(header) + i * sizeof(KTX2Level), sizeof(index));
+				MipLevel &level = levels[i];
+				level.width		= std::max(1, static_cast<int>(header.pixelWidth >> i));
+				level.height	= std::max(1, static_cast<int>(header.pixelHeight >> i));
+				// Compared without adding offset and length, which could wrap around with crafted values
+				if (index.byteLength != LevelBytes(info.format, level.width, level.height) || index.byteOffset > bytes.size() ||
+					index.byteLength > bytes.size() - index.byteOffset) {
+					std::cerr << "[CompressedFile] Malformed KTX2 level " << i << ": " << path << std::endl;
+					return MipChain();
+				}
+				level.pixels.assign(bytes.begin() + index.byteOffset, bytes.begin() + index.byteOffset + index.byteLength);
+				if (!FlipLevel(level, info.format))
+					return MipChain();
+			}
+			return MipChain::FromCompressedLevels(std::move(levels), info.format, info.srgb ? ColorSpace::sRGB : ColorSpace::Linear);
+		}
+
+		bool HasExtension(const std::string &path, const char *extension) {
+			const size_t length = std::strlen(extension);
+			if (path.size() < length)
+				return false;
+			return std::equal(path.end() - length, path.end(), extension, [](char a, char b) { return std::tolower(static_cast<unsigned char>(a)) == b; });
+		}
+	}
+
+	bool CompressedFile::IsSupported(const std::string &path) {
+		return HasExtension(path, ".dds") || HasExtension(path, ".ktx2");
+	}
+
+	MipChain CompressedFile::Load(const std::string &path, ColorSpace colorSpace) {
+		std::vector<uint8_t> bytes;
+		if (!ReadFile(path, bytes)) {
+			std::cerr << "[CompressedFile] Cannot open: " << path << std::endl;
+			return MipChain();
+		}
+		return HasExtension(path, ".ktx2") ? LoadKTX2(path, bytes) : LoadDDS(path, bytes, colorSpace);
+	}
+
+	bool CompressedFile::SaveDDS(const std::string &path, const MipChain &chain) {
+		if (!chain.IsCompressed() || chain.GetBlockFormat() == BlockFormat::BC7)
+			return false;
+
+		const MipLevel &base = chain.GetLevel(0);
+		DDSHeader header{};
+		header.size					  = sizeof(DDSHeader);
+		header.flags				  = 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000 | 0x80000; // CAPS HEIGHT WIDTH PIXELFORMAT MIPMAPCOUNT LINEARSIZE
+		header.height				  = static_cast<uint32_t>(base.height);
+		header.width				  = static_cast<uint32_t>(base.width);
+		header.pitchOrLinearSize	  = static_cast<uint32_t>(base.GetSize());
+		header.mipMapCount			  = static_cast<uint32_t>(chain.GetLevelCount());
+		header.pixelFormat.size		  = sizeof(DDSPixelFormat);
+		header.pixelFormat.flags	  = 0x4; // FOURCC
+		header.pixelFormat.fourCC	  = FourCC('D', 'X', '1', '0');
+		header.caps[0]				  = 0x1000 | (chain.GetLevelCount() > 1 ? 0x400008 : 0); // TEXTURE (| COMPLEX | MIPMAP)
+		DDSHeaderDX10 dx10{};
+		dx10.dxgiFormat		   = ToDXGI(chain.GetBlockFormat(), chain.GetColorSpace() == ColorSpace::sRGB);
+		dx10.resourceDimension = 3; // TEXTURE2D
+		dx10.arraySize		   = 1;
+
+		return FileUtils::WriteAtomically(path, [&](std::ofstream &file) {
+			file.write(reinterpret_cast<const char *>(&DDSMagic), sizeof(DDSMagic));
+			file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+			file.write(reinterpret_cast<const char *>(&dx10), sizeof(dx10));
+			for (int i = 0; i < chain.GetLevelCount(); ++i) {
+				const MipLevel &source = chain.GetLevel(i);
+				MipLevel level; // Files are top-down
+				level.width	 = source.width;
+				level.height = source.height;
+				level.pixels.assign(source.GetData(), source.GetData() + source.GetSize());
+				if (!FlipLevel(level, chain.GetBlockFormat()))
+					return false;
+				file.write(reinterpret_cast<const char *>(level.pixels.data()), static_cast<std::streamsize>(level.pixels.size()));
+			}
+			return true;
+		});
+	}
+
+} // namespace Engine::Renderer::Textures
@@ -0,0 +1,60 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   CompressedFile.h                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/11 11:36:02 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/16 11:30:12 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#pragma once
+
+#include "Renderer/Textures/MipChain.h"
+#include <string>
+
+/**
+ * @file CompressedFile.h
+ * @brief Reading DDS / KTX2 files holding BCn mip chains, and writing DDS.
+ */
+
+namespace Engine {
+	namespace Renderer {
+		namespace Textures {
+
+			/**
+			 * @class CompressedFile
+			 * @brief Loads and saves pre-compressed 2D textures.
+			 *
+			 * Supported: DDS (legacy DXT1/DXT5/ATI1/ATI2 FourCCs and DX10 headers) and KTX2
+			 * without supercompression, holding BC1, BC3, BC4, BC5 or BC7 levels. Files store
+			 * rows top-down while the engine uploads bottom-up (like stbi's flipped decode), so
+			 * BC1-BC5 blocks are flipped on load and save. BC7 files are rejected: their blocks
+			 * cannot be flipped in place and the engine has no BC7 encoder.
+			 */
+			class CompressedFile {
+			public:
+				/**
+				 * @brief Whether the path has a supported extension (.dds, .ktx2).
+				 */
+				static bool IsSupported(const std::string &path);
+
+				/**
+				 * @brief Read a compressed chain (thread-safe, no GL calls).
+				 * @param colorSpace Used for color formats when the file does not say (legacy DDS).
+				 * @return An empty chain if the file is missing, malformed or of another format.
+				 */
+				static MipChain Load(const std::string &path, ColorSpace colorSpace);
+
+				/**
+				 * @brief Write a compressed chain as DDS with a DX10 header.
+				 */
+				static bool SaveDDS(const std::string &path, const MipChain &chain);
+			};
+
+		} // namespace Textures
+	} // namespace Renderer
+} // namespace Engine
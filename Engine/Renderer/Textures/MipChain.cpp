@@ -0,0 +1,333 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   MipChain.cpp                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/08 10:13:02 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/16 11:32:40 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#include "MipChain.h"
+#include "Core/FileUtils.h"
+#include "Core/ThreadPool.h"
+#include "Resampling/SeparableResampler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+namespace Engine::Renderer::Textures {
+
+	namespace {
+		constexpr char CacheMagic[4]	   = {'V', 'M', 'I', 'P'};
+		constexpr uint32_t CacheVersion = 1;
+
+		struct CacheHeader {
+			char magic[4];
+			uint32_t version;
+			uint64_t key;
+			int32_t channels;
+			int32_t type;
+			int32_t colorSpace;
+			int32_t levelCount;
+		};
+
+		/// Index of the alpha channel, or -1 when there is none.
+		int AlphaChannel(int channels) {
+			return channels == 4 ? 3 : (channels == 2 ? 1 : -1);
+		}
+
+		float ReadNormalized(const uint8_t *p, ChannelType type) {
+			switch (type) {
+				case ChannelType::UInt8: return *p * (1.0f / 255.0f);
+				case ChannelType::UInt16: {
+					uint16_t v;
+					std::memcpy(&v, p, sizeof(v));
+					return v * (1.0f / 65535.0f);
+				}
+				default: {
+					float v;
+					std::memcpy(&v, p, sizeof(v));
+					return v;
+				}
+			}
+		}
+
+		void WriteNormalized(uint8_t *p, ChannelType type, float v) {
+			switch (type) {
+				case ChannelType::UInt8: *p = static_cast<uint8_t>(std::min(255.0f, std::max(0.0f, v * 255.0f + 0.5f))); break;
+				case ChannelType::UInt16: {
+					const uint16_t encoded = static_cast<uint16_t>(std::min(65535.0f, std::max(0.0f, v * 65535.0f + 0.5f)));
+					std::memcpy(p, &encoded, sizeof(encoded));
+					break;
+				}
+				default: std::memcpy(p, &v, sizeof(v)); break;
+			}
+		}
+
+		FilterKernel KernelFor(const MipChainSettings &settings) {
+			switch (settings.filter) {
+				case MipFilter::Box: return {BoxKernel, 0.5f, 0.0f};
+				case MipFilter::Lanczos: return {LanczosKernel, 3.0f, 3.0f};
+				default: return {KaiserKernel, KaiserSupport, settings.kaiserAlpha};
+			}
+		}
+
+		// Filtering shortens averaged normals; bring RGB back onto the unit sphere
+		void RenormalizeNormals(const MutableImageView &view) {
+			const size_t channelBytes = ChannelTypeSize(view.type);
+			const size_t pixelBytes	  = view.BytesPerPixel();
+			ThreadPool::Get().ParallelFor(0, view.height, 32, [&](int rowBegin, int rowEnd) {
+				for (int y = rowBegin; y < rowEnd; ++y) {
+					uint8_t *row = view.Row(y);
+					for (int x = 0; x < view.width; ++x) {
+						uint8_t *pixel = row + x * pixelBytes;
+						float n[3];
+						for (int c = 0; c < 3; ++c)
+							n[c] = ReadNormalized(pixel + c * channelBytes, view.type) * 2.0f - 1.0f;
+						const float length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+						if (length < 1e-6f)
+							continue;
+						for (int c = 0; c < 3; ++c)
+							WriteNormalized(pixel + c * channelBytes, view.type, n[c] / length * 0.5f + 0.5f);
+					}
+				}
+			});
+		}
+
+		// Fraction of texels that pass the alpha test once alpha is multiplied by scale
+		float AlphaCoverage(const ImageView &view, int alphaChannel, float cutoff, float scale) {
+			const size_t channelBytes = ChannelTypeSize(view.type);
+			const size_t pixelBytes	  = view.BytesPerPixel();
+			size_t passed			  = 0;
+			for (int y = 0; y < view.height; ++y) {
+				const uint8_t *alpha = view.Row(y) + alphaChannel * channelBytes;
+				for (int x = 0; x < view.width; ++x)
+					passed += std::min(1.0f, ReadNormalized(alpha + x * pixelBytes, view.type) * scale) > cutoff;
+			}
+			return static_cast<float>(passed) / (static_cast<float>(view.width) * view.height);
+		}
+
+		/**
+		 * @brief Rescale alpha so the level keeps the base level's alpha-test coverage.
+		 *
+		 * Coverage grows monotonically with the scale, so a bisection finds the factor
+		 * (Castano, "Computing Alpha Mipmaps").
+		 */
+		void PreserveAlphaCoverage(const MutableImageView &view, int alphaChannel, float cutoff, float targetCoverage) {
+			float low = 0.0f, high = 4.0f;
+			for (int i = 0; i < 12; ++i) {
+				const float mid = 0.5f * (low + high);
+				(AlphaCoverage(view, alphaChannel, cutoff, mid) > targetCoverage ? high : low) = mid;
+			}
+			const float scale		  = 0.5f * (low + high);
+			const size_t channelBytes = ChannelTypeSize(view.type);
+			const size_t pixelBytes	  = view.BytesPerPixel();
+			for (int y = 0; y < view.height; ++y) {
+				uint8_t *alpha = view.Row(y) + alphaChannel * channelBytes;
+				for (int x = 0; x < view.width; ++x) {
+					uint8_t *texel = alpha + x * pixelBytes;
+					WriteNormalized(texel, view.type, std::min(1.0f, ReadNormalized(texel, view.type) * scale));
+				}
+			}
+		}
+	} // namespace
+
+	int MipChain::FullLevelCount(int width, int height) {
+		int levels = 1;
+		while (width > 1 || height > 1) {
+			width  = std::max(1, width / 2);
+			height = std::max(1, height / 2);
+			++levels;
+		}
+		return levels;
+	}
+
+	MipChain MipChain::Build(const ImageView &base, const MipChainSettings &settings) {
+		MipChain chain;
+		if (!base.IsValid())
+			return chain;
+
+		chain.m_Channels   = base.channels;
+		chain.m_Type	   = base.type;
+		chain.m_ColorSpace = base.colorSpace;
+
+		int levelCount = FullLevelCount(base.width, base.height);
+		if (settings.maxLevels > 0)
+			levelCount = std::min(levelCount, settings.maxLevels);
+		chain.m_Levels.resize(levelCount);
+
+		// Level 0: tightly packed copy of the base
+		MipLevel &level0 = chain.m_Levels[0];
+		level0.width	 = base.width;
+		level0.height	 = base.height;
+		level0.pixels.resize(static_cast<size_t>(base.width) * base.height * base.BytesPerPixel());
+		const size_t rowBytes = static_cast<size_t>(base.width) * base.BytesPerPixel();
+		for (int y = 0; y < base.height; ++y)
+			std::memcpy(&level0.pixels[y * rowBytes], base.Row(y), rowBytes);
+
+		const FilterKernel kernel	 = KernelFor(settings);
+		const int alphaChannel		 = AlphaChannel(chain.m_Channels);
+		const bool keepCoverage		 = settings.alphaCutoff > 0.0f && alphaChannel >= 0;
+		const bool renormalize		 = settings.content == MipContent::NormalMap && chain.m_Channels >= 3;
+		const float targetCoverage	 = keepCoverage ? AlphaCoverage(chain.GetLevelView(0), alphaChannel, settings.alphaCutoff, 1.0f) : 0.0f;
+
+		for (int i = 1; i < levelCount; ++i) {
+			const MipLevel &previous = chain.m_Levels[i - 1];
+			MipLevel &level			 = chain.m_Levels[i];
+			level.width				 = std::max(1, previous.width / 2);
+			level.height			 = std::max(1, previous.height / 2);
+			level.pixels.resize(static_cast<size_t>(level.width) * level.height * base.BytesPerPixel());
+
+			const MutableImageView target = chain.GetMutableLevelView(i);
+			SeparableResampler::Resample(chain.GetLevelView(i - 1), target, kernel);
+			if (renormalize)
+				RenormalizeNormals(target);
+			if (keepCoverage)
+				PreserveAlphaCoverage(target, alphaChannel, settings.alphaCutoff, targetCoverage);
+		}
+		return chain;
+	}
+
+	std::vector<MipChain> MipChain::BuildMany(const std::vector<ImageView> &bases, const MipChainSettings &settings) {
+		std::vector<MipChain> chains(bases.size());
+		ThreadPool::Get().ParallelFor(0, static_cast<int>(bases.size()), 1, [&](int begin, int end) {
+			for (int i = begin; i < end; ++i)
+				chains[i] = Build(bases[i], settings);
+		});
+		return chains;
+	}
+
+	MipChain MipChain::FromCompressedLevels(std::vector<MipLevel> levels, BlockFormat format, ColorSpace colorSpace) {
+		MipChain chain;
+		const size_t blockBytes = BlockBytes(format);
+		if (blockBytes == 0 || levels.empty())
+			return chain;
+		for (const MipLevel &level : levels) {
+			if (level.width < 1 || level.height < 1 || level.pixels.size() != size_t(BlockCount(level.width)) * BlockCount(level.height) * blockBytes)
+				return chain;
+		}
+
+		chain.m_Levels		= std::move(levels);
+		chain.m_Channels	= BlockFormatChannels(format);
+		chain.m_Type		= ChannelType::UInt8;
+		chain.m_ColorSpace	= BlockFormatHasSRGB(format) ? colorSpace : ColorSpace::Linear;
+		chain.m_BlockFormat = format;
+		return chain;
+	}
+
+	MipChain MipChain::FromMappedLevels(std::vector<MipLevel> levels, int channels, ChannelType type, ColorSpace colorSpace, BlockFormat format,
+										std::shared_ptr<const void> backing) {
+		MipChain chain;
+		if (levels.empty() || channels < 1 || channels > 4 || !backing)
+			return chain;
+		const size_t blockBytes = BlockBytes(format);
+		const size_t pixelBytes = size_t(channels) * ChannelTypeSize(type);
+		for (const MipLevel &level : levels) {
+			const size_t expected = format != BlockFormat::None ? size_t(BlockCount(level.width)) * BlockCount(level.height) * blockBytes
+																: size_t(level.width) * level.height * pixelBytes;
+			if (level.width < 1 || level.height < 1 || !level.mapped || level.mappedSize != expected)
+				return chain;
+		}
+
+		chain.m_Levels		= std::move(levels);
+		chain.m_Channels	= format != BlockFormat::None ? BlockFormatChannels(format) : channels;
+		chain.m_Type		= format != BlockFormat::None ? ChannelType::UInt8 : type;
+		chain.m_ColorSpace	= colorSpace;
+		chain.m_BlockFormat = format;
+		chain.m_Backing		= std::move(backing);
+		return chain;
+	}
+
+	size_t MipChain::GetRowPitch(int level) const {
+		const MipLevel &mip = m_Levels[level];
+		if (IsCompressed())
+			return size_t(BlockCount(mip.width)) * BlockBytes(m_BlockFormat);
+		return size_t(mip.width) * m_Channels * ChannelTypeSize(m_Type);
+	}
+
+	int MipChain::GetRowCount(int level) const {
+		return IsCompressed() ? BlockCount(m_Levels[level].height) : m_Levels[level].height;
+	}
+
+	ImageView MipChain::GetLevelView(int level) const {
+		if (IsCompressed())
+			return ImageView();
+		const MipLevel &mip = m_Levels[level];
+		return ImageView(mip.GetData(), mip.width, mip.height, m_Channels, m_Type, m_ColorSpace);
+	}
+
+	MutableImageView MipChain::GetMutableLevelView(int level) {
+		MipLevel &mip = m_Levels[level];
+		return MutableImageView(mip.pixels.data(), mip.width, mip.height, m_Channels, m_Type, m_ColorSpace);
+	}
+
+	size_t MipChain::GetTotalBytes() const {
+		size_t total = 0;
+		for (const MipLevel &level : m_Levels)
+			total += level.GetSize();
+		return total;
+	}
+
+	bool MipChain::SaveToFile(const std::string &path, uint64_t key) const {
+		if (!IsValid() || IsCompressed())
+			return false;
+
+		return FileUtils::WriteAtomically(path, [&](std::ofstream &file) {
+			CacheHeader header{};
+			std::memcpy(header.magic, CacheMagic, sizeof(CacheMagic));
+			header.version	  = CacheVersion;
+			header.key		  = key;
+			header.channels	  = m_Channels;
+			header.type		  = static_cast<int32_t>(m_Type);
+			header.colorSpace = static_cast<int32_t>(m_ColorSpace);
+			header.levelCount = static_cast<int32_t>(m_Levels.size());
+			file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+			for (const MipLevel &level : m_Levels) {
+				const int32_t size[2] = {level.width, level.height};
+				file.write(reinterpret_cast<const char *>(size), sizeof(size));
+				file.write(reinterpret_cast<const char *>(level.GetData()), static_cast<std::streamsize>(level.GetSize()));
+			}
+			return true;
+		});
+	}
+
+	bool MipChain::LoadFromFile(const std::string &path, uint64_t key) {
+		std::ifstream file(path, std::ios::binary);
+		if (!file)
+			return false;
+
+		CacheHeader header{};
+		if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+			std::memcmp(header.magic, CacheMagic, sizeof(CacheMagic)) != 0 || header.version != CacheVersion || header.key != key ||
+			header.channels < 1 || header.channels > 4 || header.type < 0 || header.type > static_cast<int32_t>(ChannelType::Float32) ||
+			header.levelCount < 1 || header.levelCount > 32) {
+			return false;
+		}
+
+		const ChannelType type	 = static_cast<ChannelType>(header.type);
+		const size_t pixelBytes	 = header.channels * ChannelTypeSize(type);
+		std::vector<MipLevel> levels(header.levelCount);
+		for (MipLevel &level : levels) {
+			int32_t size[2];
+			if (!file.read(reinterpret_cast<char *>(size), sizeof(size)) || size[0] < 1 || size[1] < 1 || size[0] > 65536 || size[1] > 65536)
+				return false;
+			level.width	 = size[0];
+			level.height = size[1];
+			level.pixels.resize(static_cast<size_t>(level.width) * level.height * pixelBytes);
+			if (!file.read(reinterpret_cast<char *>(level.pixels.data()), static_cast<std::streamsize>(level.pixels.size())))
+				return false;
+		}
+
+		m_Levels	 = std::move(levels);
+		m_Channels	 = header.channels;
+		m_Type		 = type;
+		m_ColorSpace = static_cast<ColorSpace>(header.colorSpace);
+		return true;
+	}
+
+} // namespace Engine::Renderer::Textures
@@ -0,0 +1,178 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   MipChain.h                                         :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/08 10:12:45 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/12 18:02:17 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#pragma once
+
+#include "Compression/BlockFormat.h"
+#include "Resampling/ImageView.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @file MipChain.h
+ * @brief CPU mipmap chain generation on top of the separable resamplers, with a disk cache.
+ *
+ * Replaces the driver's box-filtered glGenerateMipmap with a selectable filter. Each level
+ * is reduced from the previous one in the image's own format (sRGB images in linear
+ * light), optionally renormalising normal maps and preserving alpha-test coverage. Chains
+ * can be written next to the source texture so later loads skip decoding and filtering.
+ * A chain may also hold block-compressed levels (loaded from DDS/KTX2 or encoded by
+ * BlockEncoder); those are upload-only. Levels can also point straight into a memory-mapped
+ * file (see TextureContainer), in which case the chain keeps the mapping alive.
+ */
+
+namespace Engine {
+	namespace Renderer {
+		namespace Textures {
+
+			/**
+			 * @brief Downsampling filter used between two mip levels.
+			 */
+			enum class MipFilter {
+				Box,	///< 2x2 average (what most drivers do).
+				Kaiser, ///< Kaiser-windowed sinc: sharp, little aliasing (default).
+				Lanczos ///< Lanczos-3: sharpest, slight ringing.
+			};
+
+			/**
+			 * @brief What the texels represent (selects post-filter fix-ups).
+			 */
+			enum class MipContent {
+				Color,	  ///< Plain color / scalar data.
+				NormalMap ///< Tangent-space normals in RGB ([0,1] -> [-1,1]); renormalised per level.
+			};
+
+			/**
+			 * @brief Options for building a mip chain.
+			 */
+			struct MipChainSettings {
+				MipFilter filter	= MipFilter::Kaiser; ///< Reduction filter.
+				MipContent content	= MipContent::Color; ///< Texel semantics.
+				float alphaCutoff	= 0.0f;				 ///< Alpha-test threshold to preserve coverage for (0 = off).
+				float kaiserAlpha	= 4.0f;				 ///< Kaiser window shape.
+				int maxLevels		= 0;				 ///< Maximum number of levels including the base (0 = down to 1x1).
+			};
+
+			/**
+			 * @brief One level of a mip chain (tightly packed rows).
+			 */
+			struct MipLevel {
+				int width = 0;				   ///< Width in pixels.
+				int height = 0;				   ///< Height in pixels.
+				std::vector<uint8_t> pixels;   ///< width * height * bytes-per-pixel bytes, or the level's 4x4 blocks.
+				const uint8_t *mapped = nullptr; ///< Same bytes inside a mapped file instead of `pixels` (read-only).
+				size_t mappedSize = 0;		   ///< Size of the mapped bytes.
+
+				/// Texels of the level, wherever they are stored.
+				const uint8_t *GetData() const { return mapped ? mapped : pixels.data(); }
+				size_t GetSize() const { return mapped ? mappedSize : pixels.size(); }
+			};
+
+			/**
+			 * @brief A full set of mip levels for one image, all in the base image's format.
+			 */
+			class MipChain {
+			public:
+				MipChain() = default;
+
+				/**
+				 * @brief Build a chain from a base image (copied into level 0).
+				 *
+				 * Every reduction is multithreaded across rows.
+				 *
+				 * @return An empty chain if the base view is invalid.
+				 */
+				static MipChain Build(const ImageView &base, const MipChainSettings &settings = MipChainSettings());
+
+				/**
+				 * @brief Build chains for several images at once, in parallel across images.
+				 */
+				static std::vector<MipChain> BuildMany(const std::vector<ImageView> &bases, const MipChainSettings &settings = MipChainSettings());
+
+				/**
+				 * @brief Wrap block-compressed levels (level 0 first, each holding its blocks).
+				 * @return An empty chain if the level sizes do not match the format.
+				 */
+				static MipChain FromCompressedLevels(std::vector<MipLevel> levels, BlockFormat format, ColorSpace colorSpace);
+
+				/**
+				 * @brief Wrap levels whose `mapped` bytes live in externally owned memory.
+				 * @param backing Owner of that memory, kept alive with the chain (e.g. a MappedFile).
+				 * @return An empty chain if a level's size does not match the format.
+				 */
+				static MipChain FromMappedLevels(std::vector<MipLevel> levels, int channels, ChannelType type, ColorSpace colorSpace, BlockFormat format,
+												 std::shared_ptr<const void> backing);
+
+				/**
+				 * @brief Number of levels for a width x height base (down to 1x1).
+				 */
+				static int FullLevelCount(int width, int height);
+
+				/**
+				 * @brief Write the chain to a binary cache file.
+				 * @param key Caller-defined identity of the source (size, timestamp, settings).
+				 * Compressed chains are not cached this way (their DDS file is the cache).
+				 */
+				bool SaveToFile(const std::string &path, uint64_t key) const;
+
+				/**
+				 * @brief Read a chain written by SaveToFile().
+				 * @return false if the file is missing, corrupt or was written for another key.
+				 */
+				bool LoadFromFile(const std::string &path, uint64_t key);
+
+				bool IsValid() const { return !m_Levels.empty(); }
+				int GetLevelCount() const { return static_cast<int>(m_Levels.size()); }
+				const MipLevel &GetLevel(int level) const { return m_Levels[level]; }
+				int GetChannels() const { return m_Channels; }
+				ChannelType GetChannelType() const { return m_Type; }
+				ColorSpace GetColorSpace() const { return m_ColorSpace; }
+				BlockFormat GetBlockFormat() const { return m_BlockFormat; }
+				bool IsCompressed() const { return m_BlockFormat != BlockFormat::None; }
+
+				/**
+				 * @brief Bytes of one storage row of a level (a pixel row, or a row of 4x4 blocks).
+				 */
+				size_t GetRowPitch(int level) const;
+
+				/**
+				 * @brief Storage rows of a level (its height, or its block rows when compressed).
+				 */
+				int GetRowCount(int level) const;
+
+				/**
+				 * @brief View of one level (for uploads or further processing; invalid when compressed).
+				 */
+				ImageView GetLevelView(int level) const;
+
+				/**
+				 * @brief Total size of all levels in bytes.
+				 */
+				size_t GetTotalBytes() const;
+
+			private:
+				MutableImageView GetMutableLevelView(int level);
+
+				std::vector<MipLevel> m_Levels;				 ///< Level 0 is the base image.
+				int m_Channels			 = 0;				 ///< Interleaved channels per pixel.
+				ChannelType m_Type		 = ChannelType::UInt8; ///< Storage type of each channel.
+				ColorSpace m_ColorSpace = ColorSpace::Linear; ///< Transfer function of the color channels.
+				BlockFormat m_BlockFormat = BlockFormat::None; ///< Compression of the levels.
+				std::shared_ptr<const void> m_Backing;		   ///< Owner of mapped level memory (null when levels own their pixels).
+			};
+
+		} // namespace Textures
+	} // namespace Renderer
+} // namespace Engine
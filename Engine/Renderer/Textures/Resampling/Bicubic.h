@@ -13,8 +13,6 @@
 #pragma once
 
 #include "Resampling.h"
-#include <cstdint>
-#include <vector>
 
 namespace Engine {
 	namespace Renderer {
@@ -31,21 +29,11 @@ namespace Engine {
 				/**
 				 * @brief Resample image data using bicubic interpolation.
 				 *
-				 * @param inputData   Source image pixel data (row-major, tightly packed).
-				 * @param inputWidth  Source image width in pixels.
-				 * @param inputHeight Source image height in pixels.
-				 * @param outputWidth Desired output image width in pixels.
-				 * @param outputHeight Desired output image height in pixels.
-				 * @param channels    Number of color channels per pixel (e.g., 3 = RGB, 4 = RGBA).
-				 * @return std::vector<uint8_t> Resampled image data (row-major, tightly packed).
+				 * @param src Source image view.
+				 * @param dst Caller-owned destination view (its size is the output size).
+				 * @return false if a view is invalid or the channel counts differ.
 				 */
-				std::vector<uint8_t> Resample(
-					const std::vector<uint8_t> &inputData,
-					int inputWidth,
-					int inputHeight,
-					int outputWidth,
-					int outputHeight,
-					int channels) const override;
+				bool Resample(const ImageView &src, const MutableImageView &dst) const override;
 			};
 
 		} // namespace Textures
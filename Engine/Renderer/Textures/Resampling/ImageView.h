@@ -0,0 +1,108 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ImageView.h                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/06 10:04:27 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/07 11:18:44 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file ImageView.h
+ * @brief Non-owning views over 2D pixel buffers (pointer, size, row stride, channels, format).
+ *
+ * Views let the resamplers read straight from decoder output and write into any
+ * caller-owned memory (std::vector, mapped pixel-unpack buffer, ...) without copies.
+ * Each view also carries its channel type and transfer function, so resamplers can
+ * filter in linear light and convert between 8-bit, 16-bit and float storage.
+ */
+
+namespace Engine {
+	namespace Renderer {
+		namespace Textures {
+
+			/**
+			 * @brief Storage type of one channel.
+			 */
+			enum class ChannelType {
+				UInt8,	///< Unsigned normalised 8-bit.
+				UInt16, ///< Unsigned normalised 16-bit (e.g. height maps).
+				Float32 ///< 32-bit float, unclamped (HDR).
+			};
+
+			/**
+			 * @brief Transfer function of the stored color channels.
+			 *
+			 * Alpha (channel 4 of RGBA, channel 2 of RG) is always linear.
+			 */
+			enum class ColorSpace {
+				Linear, ///< Values are proportional to light (data maps, HDR).
+				sRGB	///< sRGB-encoded color (albedo, emissive, UI).
+			};
+
+			/// Size in bytes of one channel of the given type.
+			inline size_t ChannelTypeSize(ChannelType type) {
+				return type == ChannelType::UInt8 ? 1 : (type == ChannelType::UInt16 ? 2 : 4);
+			}
+
+			/**
+			 * @brief Read-only view of an image.
+			 */
+			struct ImageView {
+				const uint8_t *data	  = nullptr;			 ///< First byte of the first row.
+				int width			  = 0;					 ///< Width in pixels.
+				int height			  = 0;					 ///< Height in pixels.
+				size_t stride		  = 0;					 ///< Bytes between the starts of two rows (>= width * BytesPerPixel()).
+				int channels		  = 0;					 ///< Interleaved channels per pixel.
+				ChannelType type	  = ChannelType::UInt8;	 ///< Storage type of each channel.
+				ColorSpace colorSpace = ColorSpace::Linear; ///< Transfer function of the color channels.
+
+				ImageView() = default;
+				ImageView(const uint8_t *data, int width, int height, int channels, size_t stride = 0)
+					: data(data), width(width), height(height), stride(stride ? stride : size_t(width) * channels), channels(channels) {}
+				ImageView(const void *data, int width, int height, int channels, ChannelType type, ColorSpace colorSpace, size_t stride = 0)
+					: data(static_cast<const uint8_t *>(data)), width(width), height(height),
+					  stride(stride ? stride : size_t(width) * channels * ChannelTypeSize(type)), channels(channels), type(type), colorSpace(colorSpace) {}
+
+				size_t BytesPerPixel() const { return size_t(channels) * ChannelTypeSize(type); }
+				const uint8_t *Row(int y) const { return data + static_cast<size_t>(y) * stride; }
+				bool IsValid() const { return data && width > 0 && height > 0 && channels > 0 && stride >= size_t(width) * BytesPerPixel(); }
+			};
+
+			/**
+			 * @brief Writable view of an image (caller owns the memory).
+			 */
+			struct MutableImageView {
+				uint8_t *data		  = nullptr;			 ///< First byte of the first row.
+				int width			  = 0;					 ///< Width in pixels.
+				int height			  = 0;					 ///< Height in pixels.
+				size_t stride		  = 0;					 ///< Bytes between the starts of two rows (>= width * BytesPerPixel()).
+				int channels		  = 0;					 ///< Interleaved channels per pixel.
+				ChannelType type	  = ChannelType::UInt8;	 ///< Storage type of each channel.
+				ColorSpace colorSpace = ColorSpace::Linear; ///< Transfer function of the color channels.
+
+				MutableImageView() = default;
+				MutableImageView(uint8_t *data, int width, int height, int channels, size_t stride = 0)
+					: data(data), width(width), height(height), stride(stride ? stride : size_t(width) * channels), channels(channels) {}
+				MutableImageView(void *data, int width, int height, int channels, ChannelType type, ColorSpace colorSpace, size_t stride = 0)
+					: data(static_cast<uint8_t *>(data)), width(width), height(height),
+					  stride(stride ? stride : size_t(width) * channels * ChannelTypeSize(type)), channels(channels), type(type), colorSpace(colorSpace) {}
+
+				size_t BytesPerPixel() const { return size_t(channels) * ChannelTypeSize(type); }
+				uint8_t *Row(int y) const { return data + static_cast<size_t>(y) * stride; }
+				bool IsValid() const { return data && width > 0 && height > 0 && channels > 0 && stride >= size_t(width) * BytesPerPixel(); }
+				operator ImageView() const { return ImageView(data, width, height, channels, type, colorSpace, stride); }
+			};
+
+		} // namespace Textures
+	} // namespace Renderer
+} // namespace Engine
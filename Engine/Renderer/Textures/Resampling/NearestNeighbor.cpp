@@ -6,41 +6,37 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/04/28 11:47:16 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/04/28 15:33:50 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2025/05/07 12:03:37 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "NearestNeighbor.h"
 #include <algorithm>
 #include <cmath>
-#include <vector>
+#include <cstring>
 
 namespace Engine::Renderer::Textures {
 
-	std::vector<uint8_t> NearestNeighbor::Resample(
-		const std::vector<uint8_t> &inputData,
-		int inputWidth,
-		int inputHeight,
-		int outputWidth,
-		int outputHeight,
-		int channels) const {
-		std::vector<uint8_t> outputData(static_cast<size_t>(outputWidth) * outputHeight * channels);
-		const float scaleX = static_cast<float>(inputWidth) / outputWidth;
-		const float scaleY = static_cast<float>(inputHeight) / outputHeight;
+	bool NearestNeighbor::Resample(const ImageView &src, const MutableImageView &dst) const {
+		// Copies source pixels verbatim, so both views must share one pixel format
+		if (!ValidateViews(src, dst) || src.type != dst.type || src.colorSpace != dst.colorSpace)
+			return false;
+		const size_t pixelBytes = src.BytesPerPixel();
+		const float scaleX = static_cast<float>(src.width) / dst.width;
+		const float scaleY = static_cast<float>(src.height) / dst.height;
 
-		for (int y = 0; y < outputHeight; ++y) {
-			for (int x = 0; x < outputWidth; ++x) {
-				int srcX			  = static_cast<int>(std::floor(x * scaleX));
-				int srcY			  = static_cast<int>(std::floor(y * scaleY));
-				srcX				  = std::max(0, std::min(srcX, inputWidth - 1));
-				srcY				  = std::max(0, std::min(srcY, inputHeight - 1));
-				const size_t srcIndex = (static_cast<size_t>(srcY) * inputWidth + srcX) * channels;
-				const size_t dstIndex = (static_cast<size_t>(y) * outputWidth + x) * channels;
-				for (int c = 0; c < channels; ++c)
-					outputData[dstIndex + c] = inputData[srcIndex + c];
+		for (int y = 0; y < dst.height; ++y) {
+			int srcY			  = static_cast<int>(std::floor(y * scaleY));
+			srcY				  = std::max(0, std::min(srcY, src.height - 1));
+			const uint8_t *srcRow = src.Row(srcY);
+			uint8_t *dstRow		  = dst.Row(y);
+			for (int x = 0; x < dst.width; ++x) {
+				int srcX = static_cast<int>(std::floor(x * scaleX));
+				srcX	 = std::max(0, std::min(srcX, src.width - 1));
+				std::memcpy(dstRow + x * pixelBytes, srcRow + srcX * pixelBytes, pixelBytes);
 			}
 		}
-		return outputData;
+		return true;
 	}
 
 } // namespace Engine::Renderer::Textures
@@ -12,9 +12,7 @@
 
 #pragma once
 
-#include <algorithm>
-#include <cstdint>
-#include <vector>
+#include "ImageView.h"
 
 /**
  * @file Resampling.h
@@ -23,6 +21,10 @@
  * Provides a unified interface for implementing various image resampling
  * (scaling/interpolation) algorithms. Derived classes implement the Resample()
  * method for specific interpolation strategies (e.g., Nearest Neighbor, Bilinear, Bicubic, Lanczos).
+ * The filtered resamplers share the multithreaded SIMD core in SeparableResampler.h.
+ *
+ * Resamplers read from and write to non-owning image views, so callers control every
+ * allocation (e.g. decode buffer in, mapped pixel-unpack buffer out).
  */
 
 namespace Engine {
@@ -43,62 +45,23 @@ namespace Engine {
 				virtual ~Resampling() = default;
 
 				/**
-				 * @brief Resample image data to a new resolution.
+				 * @brief Resample an image into a caller-provided buffer.
 				 *
-				 * @param inputData   Source image pixel data (row-major, tightly packed).
-				 * @param inputWidth  Source image width in pixels.
-				 * @param inputHeight Source image height in pixels.
-				 * @param outputWidth Desired output image width in pixels.
-				 * @param outputHeight Desired output image height in pixels.
-				 * @param channels    Number of color channels per pixel (e.g., 3 = RGB, 4 = RGBA).
-				 * @return std::vector<uint8_t> Resampled image data (row-major, tightly packed).
-				 */
-				virtual std::vector<uint8_t> Resample(
-					const std::vector<uint8_t> &inputData,
-					int inputWidth,
-					int inputHeight,
-					int outputWidth,
-					int outputHeight,
-					int channels) const = 0;
-
-			protected:
-				/**
-				 * @brief Safely fetch a pixel from image data, clamping coordinates to valid range.
+				 * The output resolution is the size of dst. Rows may be padded (stride), and
+				 * src and dst must not overlap.
 				 *
-				 * @param data     Image pixel data (row-major, tightly packed).
-				 * @param width    Image width in pixels.
-				 * @param height   Image height in pixels.
-				 * @param channels Number of color channels per pixel.
-				 * @param x        X coordinate (will be clamped to [0, width-1]).
-				 * @param y        Y coordinate (will be clamped to [0, height-1]).
-				 * @param pixel    Output buffer to receive the pixel data (must be at least 'channels' in size).
+				 * @param src Source image view.
+				 * @param dst Destination image view (same channel count as src).
+				 * @return false if a view is invalid or the channel counts differ.
 				 */
-				inline void GetPixelClamped(
-					const std::vector<uint8_t> &data,
-					int width,
-					int height,
-					int channels,
-					int x,
-					int y,
-					uint8_t *pixel) const {
-					x				   = std::max(0, std::min(x, width - 1));
-					y				   = std::max(0, std::min(y, height - 1));
-					const size_t index = (static_cast<size_t>(y) * width + x) * channels;
-					for (int c = 0; c < channels; ++c) {
-						pixel[c] = data[index + c];
-					}
-				}
+				virtual bool Resample(const ImageView &src, const MutableImageView &dst) const = 0;
 
+			protected:
 				/**
-				 * @brief Linearly interpolate between two uint8_t values.
-				 *
-				 * @param a First value.
-				 * @param b Second value.
-				 * @param t Interpolation factor in [0, 1].
-				 * @return Interpolated value.
+				 * @brief Check that both views are usable together.
 				 */
-				inline uint8_t Lerp(uint8_t a, uint8_t b, float t) const {
-					return static_cast<uint8_t>(static_cast<float>(a) * (1.0f - t) + static_cast<float>(b) * t);
+				static bool ValidateViews(const ImageView &src, const MutableImageView &dst) {
+					return src.IsValid() && dst.IsValid() && src.channels == dst.channels;
 				}
 			};
 
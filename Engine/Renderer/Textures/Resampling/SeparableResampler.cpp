@@ -0,0 +1,533 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   SeparableResampler.cpp                             :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/05 11:32:46 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/07 11:42:19 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#include "SeparableResampler.h"
+#include "Core/ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define ENGINE_RESAMPLE_X86 1
+#include <immintrin.h>
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace Engine::Renderer::Textures {
+
+	// ------------------------------------------------------------------------
+	// Kernels
+	// ------------------------------------------------------------------------
+
+	float BoxKernel(float x, float /*param*/) {
+		// Half-open so a sample exactly between two pixels only counts once
+		return (x >= -0.5f && x < 0.5f) ? 1.0f : 0.0f;
+	}
+
+	float TriangleKernel(float x, float /*param*/) {
+		x = std::abs(x);
+		return x < 1.0f ? 1.0f - x : 0.0f;
+	}
+
+	float CubicKernel(float x, float /*param*/) {
+		x = std::abs(x);
+		if (x < 1.0f)
+			return 1.5f * x * x * x - 2.5f * x * x + 1.0f;
+		else if (x < 2.0f)
+			return -0.5f * x * x * x + 2.5f * x * x - 4.0f * x + 2.0f;
+		return 0.0f;
+	}
+
+	float LanczosKernel(float x, float a) {
+		if (x == 0.0f) return 1.0f;
+		if (std::abs(x) >= a) return 0.0f;
+		const float pix	  = static_cast<float>(M_PI) * x;
+		const float pix_a = pix / a;
+		return (std::sin(pix) * std::sin(pix_a)) / (pix * pix_a);
+	}
+
+	namespace {
+		// Zeroth-order modified Bessel function of the first kind (power series)
+		double BesselI0(double x) {
+			double sum = 1.0, term = 1.0;
+			const double quarterSq = x * x * 0.25;
+			for (int k = 1; k < 32 && term > sum * 1e-12; ++k) {
+				term *= quarterSq / (static_cast<double>(k) * k);
+				sum += term;
+			}
+			return sum;
+		}
+	} // namespace
+
+	float KaiserKernel(float x, float alpha) {
+		const double ratio = x / KaiserSupport;
+		if (std::abs(ratio) >= 1.0) return 0.0f;
+		const double pix  = M_PI * x;
+		const double sinc = x == 0.0f ? 1.0 : std::sin(pix) / pix;
+		return static_cast<float>(sinc * BesselI0(alpha * std::sqrt(1.0 - ratio * ratio)) / BesselI0(alpha));
+	}
+
+	// ------------------------------------------------------------------------
+	// Weight tables
+	// ------------------------------------------------------------------------
+
+	FilterWeightTable FilterWeightTable::Build(int inputSize, int outputSize, const FilterKernel &kernel) {
+		FilterWeightTable table;
+		const double scale		 = static_cast<double>(inputSize) / outputSize;
+		const double filterScale = std::max(1.0, scale); // Stretch the kernel when downscaling
+		const double support	 = kernel.support * filterScale;
+
+		table.taps = std::min(inputSize, static_cast<int>(std::ceil(support * 2.0)) + 1);
+		table.starts.resize(outputSize);
+		table.weights.assign(static_cast<size_t>(outputSize) * table.taps, 0.0f);
+
+		std::vector<double> raw(static_cast<size_t>(std::ceil(support * 2.0)) + 1);
+		for (int o = 0; o < outputSize; ++o) {
+			const double center = (o + 0.5) * scale - 0.5;
+			const int first		= static_cast<int>(std::ceil(center - support));
+
+			// Window shifted inside the image; out-of-range taps are clamped onto it below
+			const int start = std::max(0, std::min(first, inputSize - table.taps));
+			table.starts[o] = start;
+
+			double total = 0.0;
+			for (size_t i = 0; i < raw.size(); ++i) {
+				const double distance = (center - (first + static_cast<int>(i))) / filterScale;
+				raw[i]				  = kernel.function(static_cast<float>(distance), kernel.param);
+				total += raw[i];
+			}
+
+			float *weights = &table.weights[static_cast<size_t>(o) * table.taps];
+			if (std::abs(total) < 1e-8) {
+				// Degenerate kernel: fall back to the nearest pixel
+				const int nearest = std::max(0, std::min(static_cast<int>(std::floor(center + 0.5)), inputSize - 1));
+				weights[nearest - start] = 1.0f;
+				continue;
+			}
+			for (size_t i = 0; i < raw.size(); ++i) {
+				const int source = std::max(0, std::min(first + static_cast<int>(i), inputSize - 1));
+				weights[source - start] += static_cast<float>(raw[i] / total);
+			}
+		}
+		return table;
+	}
+
+	// ------------------------------------------------------------------------
+	// Scalar passes (reference)
+	// ------------------------------------------------------------------------
+
+	namespace {
+		inline uint8_t RoundToUint8(float v) {
+			return static_cast<uint8_t>(std::min(255.0f, std::max(0.0f, v + 0.5f)));
+		}
+
+		inline uint16_t RoundToUint16(float v) {
+			return static_cast<uint16_t>(std::min(65535.0f, std::max(0.0f, v + 0.5f)));
+		}
+
+		/// Index of the (always linear) alpha channel, or -1 when there is none.
+		inline int AlphaChannel(int channels) {
+			return channels == 4 ? 3 : (channels == 2 ? 1 : -1);
+		}
+
+		inline float SrgbToLinear(float v) {
+			return v <= 0.04045f ? v / 12.92f : std::pow((v + 0.055f) / 1.055f, 2.4f);
+		}
+
+		inline float LinearToSrgb(float v) {
+			return v <= 0.0031308f ? v * 12.92f : 1.055f * std::pow(v, 1.0f / 2.4f) - 0.055f;
+		}
+
+		/**
+		 * @brief Lookup tables for 8-bit sRGB <-> linear float conversion.
+		 *
+		 * Encoding rounds in the sRGB domain exactly like the formula would: a coarse
+		 * table gives the lowest candidate code for a linear value, then the code is
+		 * advanced past every decision threshold (linear value of code - 0.5) below it.
+		 */
+		struct SrgbTables {
+			static constexpr int CoarseSize = 4096;
+
+			float toLinear[256];		 ///< Linear value of each 8-bit code.
+			float thresholds[256];		 ///< Linear value of code - 0.5 (rounding boundary).
+			uint8_t coarse[CoarseSize]; ///< Highest code whose threshold <= i / CoarseSize.
+
+			SrgbTables() {
+				for (int k = 0; k < 256; ++k) {
+					toLinear[k]	  = SrgbToLinear(k / 255.0f);
+					thresholds[k] = k == 0 ? -1.0f : SrgbToLinear((k - 0.5f) / 255.0f);
+				}
+				int code = 0;
+				for (int i = 0; i < CoarseSize; ++i) {
+					const float v = static_cast<float>(i) / CoarseSize;
+					while (code < 255 && v >= thresholds[code + 1])
+						++code;
+					coarse[i] = static_cast<uint8_t>(code);
+				}
+			}
+
+			uint8_t Encode(float v) const {
+				if (!(v > 0.0f)) return 0; // Also catches NaN
+				if (v >= 1.0f) return 255;
+				int code = coarse[static_cast<int>(v * CoarseSize)];
+				while (code < 255 && v >= thresholds[code + 1])
+					++code;
+				return static_cast<uint8_t>(code);
+			}
+		};
+
+		const SrgbTables &GetSrgbTables() {
+			static const SrgbTables tables;
+			return tables;
+		}
+
+		/**
+		 * @brief Convert one source row to normalised linear floats (alpha stays linear).
+		 */
+		void DecodeRow(const ImageView &src, const uint8_t *row, float *dst) {
+			const int channels = src.channels;
+			const int alpha	   = AlphaChannel(channels);
+			const size_t count = static_cast<size_t>(src.width) * channels;
+
+			// Plain normalisation first, then the transfer function on color channels only
+			switch (src.type) {
+				case ChannelType::UInt8:
+					if (src.colorSpace == ColorSpace::sRGB) {
+						const float *lut = GetSrgbTables().toLinear;
+						for (size_t i = 0; i < count; i += channels)
+							for (int c = 0; c < channels; ++c)
+								dst[i + c] = c == alpha ? row[i + c] * (1.0f / 255.0f) : lut[row[i + c]];
+						return;
+					}
+					for (size_t i = 0; i < count; ++i)
+						dst[i] = row[i] * (1.0f / 255.0f);
+					return;
+				case ChannelType::UInt16:
+					for (size_t i = 0; i < count; ++i) {
+						uint16_t v;
+						std::memcpy(&v, row + i * 2, sizeof(v));
+						dst[i] = v * (1.0f / 65535.0f);
+					}
+					break;
+				case ChannelType::Float32: std::memcpy(dst, row, count * sizeof(float)); break;
+			}
+			if (src.colorSpace == ColorSpace::sRGB)
+				for (size_t i = 0; i < count; i += channels)
+					for (int c = 0; c < channels; ++c)
+						if (c != alpha)
+							dst[i + c] = SrgbToLinear(dst[i + c]);
+		}
+
+		/**
+		 * @brief Convert one row of normalised linear floats to the destination format.
+		 *
+		 * May rewrite values in place (sRGB encoding of 16-bit / float outputs).
+		 */
+		void EncodeRow(float *values, const MutableImageView &dst, uint8_t *row) {
+			const int channels = dst.channels;
+			const int alpha	   = AlphaChannel(channels);
+			const size_t count = static_cast<size_t>(dst.width) * channels;
+
+			if (dst.type == ChannelType::UInt8) {
+				if (dst.colorSpace == ColorSpace::sRGB) {
+					const SrgbTables &tables = GetSrgbTables();
+					for (size_t i = 0; i < count; i += channels)
+						for (int c = 0; c < channels; ++c)
+							row[i + c] = c == alpha ? RoundToUint8(values[i + c] * 255.0f) : tables.Encode(values[i + c]);
+					return;
+				}
+				for (size_t i = 0; i < count; ++i)
+					row[i] = RoundToUint8(values[i] * 255.0f);
+				return;
+			}
+
+			// 16-bit / float sRGB outputs are rare (no lookup table); HDR keeps the full range
+			if (dst.colorSpace == ColorSpace::sRGB)
+				for (size_t i = 0; i < count; i += channels)
+					for (int c = 0; c < channels; ++c)
+						if (c != alpha)
+							values[i + c] = LinearToSrgb(std::max(0.0f, values[i + c]));
+			if (dst.type == ChannelType::Float32) {
+				std::memcpy(row, values, count * sizeof(float));
+				return;
+			}
+			for (size_t i = 0; i < count; ++i) {
+				const uint16_t encoded = RoundToUint16(values[i] * 65535.0f);
+				std::memcpy(row + i * 2, &encoded, sizeof(encoded));
+			}
+		}
+
+		template <typename T>
+		void HorizontalRowScalar(const T *src, float *dst, int outputWidth, int channels, const FilterWeightTable &table) {
+			for (int x = 0; x < outputWidth; ++x) {
+				const T *pixels		 = src + static_cast<size_t>(table.starts[x]) * channels;
+				const float *weights = &table.weights[static_cast<size_t>(x) * table.taps];
+				for (int c = 0; c < channels; ++c) {
+					float sum = 0.0f;
+					for (int t = 0; t < table.taps; ++t)
+						sum += weights[t] * static_cast<float>(pixels[t * channels + c]);
+					dst[x * channels + c] = sum;
+				}
+			}
+		}
+
+		void VerticalRowScalar(const float *const *rows, const float *weights, int taps, uint8_t *dst, int count, int begin = 0) {
+			for (int i = begin; i < count; ++i) {
+				float sum = 0.0f;
+				for (int t = 0; t < taps; ++t)
+					sum += weights[t] * rows[t][i];
+				dst[i] = RoundToUint8(sum);
+			}
+		}
+
+		void VerticalRowFloatScalar(const float *const *rows, const float *weights, int taps, float *dst, int count, int begin = 0) {
+			for (int i = begin; i < count; ++i) {
+				float sum = 0.0f;
+				for (int t = 0; t < taps; ++t)
+					sum += weights[t] * rows[t][i];
+				dst[i] = sum;
+			}
+		}
+
+		// ------------------------------------------------------------------------
+		// SIMD passes: same per-element operation order as the scalar code (mul, then add; no FMA)
+		// ------------------------------------------------------------------------
+
+#ifdef ENGINE_RESAMPLE_X86
+		__attribute__((target("sse4.1"))) inline __m128 LoadPixel4(const uint8_t *p) {
+			int32_t packed;
+			std::memcpy(&packed, p, sizeof(packed));
+			return _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(packed)));
+		}
+
+		__attribute__((target("sse4.1"))) inline __m128 LoadPixel4(const float *p) {
+			return _mm_loadu_ps(p);
+		}
+
+		__attribute__((target("avx2"))) inline __m256 LoadPixelPair(const uint8_t *p0, const uint8_t *p1) {
+			int32_t packed0, packed1;
+			std::memcpy(&packed0, p0, sizeof(packed0));
+			std::memcpy(&packed1, p1, sizeof(packed1));
+			return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_set_epi32(0, 0, packed1, packed0)));
+		}
+
+		__attribute__((target("avx2"))) inline __m256 LoadPixelPair(const float *p0, const float *p1) {
+			return _mm256_set_m128(_mm_loadu_ps(p1), _mm_loadu_ps(p0));
+		}
+
+		template <typename T>
+		__attribute__((target("sse4.1"))) void HorizontalRowRGBA_SSE41(const T *src, float *dst, int outputWidth, const FilterWeightTable &table) {
+			for (int x = 0; x < outputWidth; ++x) {
+				const T *pixels		 = src + static_cast<size_t>(table.starts[x]) * 4;
+				const float *weights = &table.weights[static_cast<size_t>(x) * table.taps];
+				__m128 sum			 = _mm_setzero_ps();
+				for (int t = 0; t < table.taps; ++t)
+					sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weights[t]), LoadPixel4(pixels + t * 4)));
+				_mm_storeu_ps(dst + x * 4, sum);
+			}
+		}
+
+		__attribute__((target("sse4.1"))) void VerticalRow_SSE41(const float *const *rows, const float *weights, int taps, uint8_t *dst, int count) {
+			const __m128 half = _mm_set1_ps(0.5f), zero = _mm_setzero_ps(), maxValue = _mm_set1_ps(255.0f);
+			int i = 0;
+			for (; i + 4 <= count; i += 4) {
+				__m128 sum = _mm_setzero_ps();
+				for (int t = 0; t < taps; ++t)
+					sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weights[t]), _mm_loadu_ps(rows[t] + i)));
+				sum			  = _mm_min_ps(maxValue, _mm_max_ps(zero, _mm_add_ps(sum, half)));
+				__m128i bytes = _mm_cvttps_epi32(sum);
+				bytes		  = _mm_packus_epi16(_mm_packus_epi32(bytes, bytes), _mm_setzero_si128());
+				const int32_t packed = _mm_cvtsi128_si32(bytes);
+				std::memcpy(dst + i, &packed, sizeof(packed));
+			}
+			VerticalRowScalar(rows, weights, taps, dst, count, i);
+		}
+
+		__attribute__((target("sse4.1"))) void VerticalRowFloat_SSE41(const float *const *rows, const float *weights, int taps, float *dst, int count) {
+			int i = 0;
+			for (; i + 4 <= count; i += 4) {
+				__m128 sum = _mm_setzero_ps();
+				for (int t = 0; t < taps; ++t)
+					sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weights[t]), _mm_loadu_ps(rows[t] + i)));
+				_mm_storeu_ps(dst + i, sum);
+			}
+			VerticalRowFloatScalar(rows, weights, taps, dst, count, i);
+		}
+
+		template <typename T>
+		__attribute__((target("avx2"))) void HorizontalRowRGBA_AVX2(const T *src, float *dst, int outputWidth, const FilterWeightTable &table) {
+			int x = 0;
+			for (; x + 2 <= outputWidth; x += 2) {
+				// Two output pixels per iteration: low lane = x, high lane = x + 1
+				const T *pixels0	  = src + static_cast<size_t>(table.starts[x]) * 4;
+				const T *pixels1	  = src + static_cast<size_t>(table.starts[x + 1]) * 4;
+				const float *weights0 = &table.weights[static_cast<size_t>(x) * table.taps];
+				const float *weights1 = weights0 + table.taps;
+				__m256 sum			  = _mm256_setzero_ps();
+				for (int t = 0; t < table.taps; ++t) {
+					const __m256 values	 = LoadPixelPair(pixels0 + t * 4, pixels1 + t * 4);
+					const __m256 weights = _mm256_set_m128(_mm_set1_ps(weights1[t]), _mm_set1_ps(weights0[t]));
+					sum					 = _mm256_add_ps(sum, _mm256_mul_ps(weights, values));
+				}
+				_mm256_storeu_ps(dst + x * 4, sum);
+			}
+			for (; x < outputWidth; ++x) {
+				const T *pixels		 = src + static_cast<size_t>(table.starts[x]) * 4;
+				const float *weights = &table.weights[static_cast<size_t>(x) * table.taps];
+				__m128 sum			 = _mm_setzero_ps();
+				for (int t = 0; t < table.taps; ++t)
+					sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weights[t]), LoadPixel4(pixels + t * 4)));
+				_mm_storeu_ps(dst + x * 4, sum);
+			}
+		}
+
+		__attribute__((target("avx2"))) void VerticalRow_AVX2(const float *const *rows, const float *weights, int taps, uint8_t *dst, int count) {
+			const __m256 half = _mm256_set1_ps(0.5f), zero = _mm256_setzero_ps(), maxValue = _mm256_set1_ps(255.0f);
+			int i = 0;
+			for (; i + 8 <= count; i += 8) {
+				__m256 sum = _mm256_setzero_ps();
+				for (int t = 0; t < taps; ++t)
+					sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_set1_ps(weights[t]), _mm256_loadu_ps(rows[t] + i)));
+				sum						= _mm256_min_ps(maxValue, _mm256_max_ps(zero, _mm256_add_ps(sum, half)));
+				const __m256i ints		= _mm256_cvttps_epi32(sum);
+				const __m128i words		= _mm_packus_epi32(_mm256_castsi256_si128(ints), _mm256_extracti128_si256(ints, 1));
+				const __m128i bytes		= _mm_packus_epi16(words, words);
+				_mm_storel_epi64(reinterpret_cast<__m128i *>(dst + i), bytes);
+			}
+			VerticalRowScalar(rows, weights, taps, dst, count, i);
+		}
+
+		__attribute__((target("avx2"))) void VerticalRowFloat_AVX2(const float *const *rows, const float *weights, int taps, float *dst, int count) {
+			int i = 0;
+			for (; i + 8 <= count; i += 8) {
+				__m256 sum = _mm256_setzero_ps();
+				for (int t = 0; t < taps; ++t)
+					sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_set1_ps(weights[t]), _mm256_loadu_ps(rows[t] + i)));
+				_mm256_storeu_ps(dst + i, sum);
+			}
+			VerticalRowFloatScalar(rows, weights, taps, dst, count, i);
+		}
+#endif
+
+		template <typename T>
+		void HorizontalRow(const T *src, float *dst, int outputWidth, int channels, const FilterWeightTable &table, SimdLevel simd) {
+#ifdef ENGINE_RESAMPLE_X86
+			if (channels == 4 && simd == SimdLevel::AVX2)
+				return HorizontalRowRGBA_AVX2(src, dst, outputWidth, table);
+			if (channels == 4 && simd == SimdLevel::SSE41)
+				return HorizontalRowRGBA_SSE41(src, dst, outputWidth, table);
+#endif
+			HorizontalRowScalar(src, dst, outputWidth, channels, table);
+		}
+
+		void VerticalRowFloat(const float *const *rows, const float *weights, int taps, float *dst, int count, SimdLevel simd) {
+#ifdef ENGINE_RESAMPLE_X86
+			if (simd == SimdLevel::AVX2)
+				return VerticalRowFloat_AVX2(rows, weights, taps, dst, count);
+			if (simd == SimdLevel::SSE41)
+				return VerticalRowFloat_SSE41(rows, weights, taps, dst, count);
+#endif
+			VerticalRowFloatScalar(rows, weights, taps, dst, count);
+		}
+	} // namespace
+
+	// ------------------------------------------------------------------------
+	// Driver
+	// ------------------------------------------------------------------------
+
+	SimdLevel SeparableResampler::DetectSimdLevel() {
+#ifdef ENGINE_RESAMPLE_X86
+		static const SimdLevel level = []() {
+			__builtin_cpu_init();
+			if (__builtin_cpu_supports("avx2"))
+				return SimdLevel::AVX2;
+			if (__builtin_cpu_supports("sse4.1"))
+				return SimdLevel::SSE41;
+			return SimdLevel::Scalar;
+		}();
+		return level;
+#else
+		return SimdLevel::Scalar;
+#endif
+	}
+
+	void SeparableResampler::Resample(const ImageView &src, const MutableImageView &dst, const FilterKernel &kernel, SimdLevel simd) {
+		if (!src.IsValid() || !dst.IsValid() || src.channels != dst.channels)
+			return;
+
+		const int inputHeight  = src.height;
+		const int outputWidth  = dst.width;
+		const int outputHeight = dst.height;
+		const int channels	   = src.channels;
+
+		// 8-bit linear in and out keeps the 0..255 integer-scale path; anything else
+		// (sRGB, 16-bit, float) is filtered as normalised linear light
+		const bool bytePath = src.type == ChannelType::UInt8 && dst.type == ChannelType::UInt8 &&
+							  src.colorSpace == ColorSpace::Linear && dst.colorSpace == ColorSpace::Linear;
+		const bool directFloat = src.type == ChannelType::Float32 && src.colorSpace == ColorSpace::Linear;
+
+		const FilterWeightTable columns = FilterWeightTable::Build(src.width, outputWidth, kernel);
+		const FilterWeightTable rows	= FilterWeightTable::Build(inputHeight, outputHeight, kernel);
+		const int rowValues				= outputWidth * channels; // Values per intermediate / output row
+
+		// Pass 1: horizontal, every source row -> float intermediate (inputHeight x outputWidth)
+		std::vector<float> intermediate(static_cast<size_t>(inputHeight) * rowValues);
+		ThreadPool::Get().ParallelFor(0, inputHeight, 16, [&](int rowBegin, int rowEnd) {
+			std::vector<float> decoded(bytePath || directFloat ? 0 : static_cast<size_t>(src.width) * channels);
+			for (int y = rowBegin; y < rowEnd; ++y) {
+				const uint8_t *srcRow = src.Row(y);
+				float *dstRow		  = &intermediate[static_cast<size_t>(y) * rowValues];
+				if (bytePath) {
+					HorizontalRow(srcRow, dstRow, outputWidth, channels, columns, simd);
+				} else if (directFloat) {
+					HorizontalRow(reinterpret_cast<const float *>(srcRow), dstRow, outputWidth, channels, columns, simd);
+				} else {
+					DecodeRow(src, srcRow, decoded.data());
+					HorizontalRow(static_cast<const float *>(decoded.data()), dstRow, outputWidth, channels, columns, simd);
+				}
+			}
+		});
+
+		// Pass 2: vertical, intermediate -> output (channel-agnostic, contiguous floats)
+		ThreadPool::Get().ParallelFor(0, outputHeight, 16, [&](int rowBegin, int rowEnd) {
+			std::vector<const float *> sourceRows(rows.taps);
+			std::vector<float> filtered(bytePath ? 0 : static_cast<size_t>(rowValues));
+			for (int y = rowBegin; y < rowEnd; ++y) {
+				for (int t = 0; t < rows.taps; ++t)
+					sourceRows[t] = &intermediate[static_cast<size_t>(rows.starts[y] + t) * rowValues];
+				const float *weights = &rows.weights[static_cast<size_t>(y) * rows.taps];
+				uint8_t *dstRow		 = dst.Row(y);
+				if (!bytePath) {
+					VerticalRowFloat(sourceRows.data(), weights, rows.taps, filtered.data(), rowValues, simd);
+					EncodeRow(filtered.data(), dst, dstRow);
+					continue;
+				}
+#ifdef ENGINE_RESAMPLE_X86
+				if (simd == SimdLevel::AVX2) {
+					VerticalRow_AVX2(sourceRows.data(), weights, rows.taps, dstRow, rowValues);
+					continue;
+				}
+				if (simd == SimdLevel::SSE41) {
+					VerticalRow_SSE41(sourceRows.data(), weights, rows.taps, dstRow, rowValues);
+					continue;
+				}
+#endif
+				VerticalRowScalar(sourceRows.data(), weights, rows.taps, dstRow, rowValues);
+			}
+		});
+	}
+
+} // namespace Engine::Renderer::Textures
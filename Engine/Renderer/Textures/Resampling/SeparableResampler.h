@@ -0,0 +1,119 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   SeparableResampler.h                               :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/05 11:32:40 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/07 11:42:19 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#pragma once
+
+#include "ImageView.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @file SeparableResampler.h
+ * @brief Two-pass (horizontal then vertical) resampling core shared by the filtered resamplers.
+ *
+ * Weights are precomputed once per axis into fixed-size tap tables whose windows are
+ * clamped to the image at build time, so the inner loops never bounds-check. The
+ * horizontal pass writes a float intermediate image, the vertical pass converts it to
+ * the destination format.
+ *
+ * 8-bit linear images are filtered directly on their 0..255 values. Every other format
+ * (sRGB, 16-bit, float) is decoded per row to normalised linear light (sRGB through a
+ * 256-entry table), filtered by the same SIMD loops, and encoded back (sRGB through an
+ * exactly-rounding table), so gamma-correct resampling costs one lookup per value.
+ * Both passes have AVX2 and SSE4.1 paths (selected at runtime, scalar fallback) that
+ * accumulate in the same order as the scalar code without FMA, so every path produces
+ * bit-identical output. Rows are split across the engine ThreadPool.
+ */
+
+namespace Engine {
+	namespace Renderer {
+		namespace Textures {
+
+			/**
+			 * @brief Instruction set used by the resampling inner loops.
+			 */
+			enum class SimdLevel {
+				Scalar, ///< Portable reference path.
+				SSE41,	///< 4-wide float.
+				AVX2	///< 8-wide float.
+			};
+
+			/**
+			 * @brief 1D reconstruction filter.
+			 */
+			struct FilterKernel {
+				float (*function)(float x, float param); ///< Weight at distance x (source pixels, unscaled).
+				float support;							 ///< Radius beyond which the weight is zero.
+				float param;							 ///< Filter-specific parameter (e.g. Lanczos 'a').
+			};
+
+			/**
+			 * @brief Per-output-pixel contributions of source pixels along one axis.
+			 *
+			 * Output pixel i reads source pixels [starts[i], starts[i] + taps) with weights
+			 * weights[i * taps + t]. Taps falling outside the image are folded onto the edge pixel.
+			 */
+			struct FilterWeightTable {
+				int taps = 0;				 ///< Fixed number of taps per output pixel.
+				std::vector<int> starts;	 ///< First source pixel of each window.
+				std::vector<float> weights; ///< Normalised weights, outputSize * taps.
+
+				/**
+				 * @brief Build the table for resampling inputSize pixels to outputSize pixels.
+				 *
+				 * When downscaling, the kernel is stretched by inputSize / outputSize so it
+				 * covers every source pixel (antialiasing); upscaling uses the kernel as is.
+				 */
+				static FilterWeightTable Build(int inputSize, int outputSize, const FilterKernel &kernel);
+			};
+
+			/**
+			 * @brief Separable resampler for 8-bit, 16-bit and float images with any channel count.
+			 */
+			class SeparableResampler {
+			public:
+				/**
+				 * @brief Resample src into dst (output size = dst size, same channel count).
+				 *
+				 * Channel type and color space may differ between the views (e.g. 16-bit
+				 * sRGB in, linear float out). Rows of either view may be padded. The result does not depend on the SIMD
+				 * level or the number of threads.
+				 *
+				 * @param simd Instruction set override (defaults to the best supported one).
+				 */
+				static void Resample(const ImageView &src, const MutableImageView &dst, const FilterKernel &kernel,
+									 SimdLevel simd = DetectSimdLevel());
+
+				/**
+				 * @brief Best instruction set supported by the running CPU.
+				 */
+				static SimdLevel DetectSimdLevel();
+			};
+
+			/// Box kernel, support 0.5: exact 2x2 averaging for power-of-two mip reduction.
+			float BoxKernel(float x, float param);
+			/// Triangle (tent) kernel, support 1: bilinear interpolation when upscaling.
+			float TriangleKernel(float x, float param);
+			/// Catmull-Rom cubic (B = 0, C = 0.5), support 2.
+			float CubicKernel(float x, float param);
+			/// Lanczos windowed sinc, support param ('a').
+			float LanczosKernel(float x, float param);
+
+			/// Support of KaiserKernel (source pixels, unscaled).
+			constexpr float KaiserSupport = 3.0f;
+			/// Kaiser-windowed sinc, support KaiserSupport; param is the window shape (alpha, ~4).
+			float KaiserKernel(float x, float param);
+
+		} // namespace Textures
+	} // namespace Renderer
+} // namespace Engine
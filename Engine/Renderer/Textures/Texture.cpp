@@ -6,18 +6,34 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/04/26 12:00:38 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/04/28 16:15:05 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2025/05/16 11:34:30 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "Texture.h"
+#include "Core/FileUtils.h"
+#include "Compression/CompressedFile.h"
+#include "TextureContainer.h"
 #include "Resampling/Resampling.h"
 
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
 #include <glad/glad.h>
 #include <iostream>
 #include <memory>
 #include <stb_image.h>
-#include <vector>
+
+// S3TC enums (EXT_texture_compression_s3tc / EXT_texture_sRGB), not part of core GL
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_SRGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_SRGB_S3TC_DXT1_EXT 0x8C4C
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT 0x8C4F
+#endif
 
 namespace Engine {
 
@@ -33,72 +49,442 @@ namespace Engine {
 				default: return nullptr;
 			}
 		}
+
+		struct UploadFormat {
+			GLenum internalFormat; ///< GPU storage format.
+			GLenum dataFormat;	   ///< Channel layout of the client data.
+			GLenum pixelType;	   ///< Type of each client channel.
+		};
+
+		// GL format for the decoded image (channels in [1, 4]); sRGB only exists for 8-bit RGB(A)
+		UploadFormat ChooseUploadFormat(Renderer::Textures::ChannelType type, int channels, bool srgb) {
+			using Renderer::Textures::ChannelType;
+			static const GLenum dataFormats[4]	  = {GL_RED, GL_RG, GL_RGB, GL_RGBA};
+			static const GLenum unorm8Formats[4]  = {GL_R8, GL_RG8, GL_RGB8, GL_RGBA8};
+			static const GLenum srgb8Formats[4]	  = {GL_R8, GL_RG8, GL_SRGB8, GL_SRGB8_ALPHA8};
+			static const GLenum unorm16Formats[4] = {GL_R16, GL_RG16, GL_RGB16, GL_RGBA16};
+			static const GLenum float16Formats[4] = {GL_R16F, GL_RG16F, GL_RGB16F, GL_RGBA16F};
+
+			const int index = channels - 1;
+			switch (type) {
+				case ChannelType::UInt16: return {unorm16Formats[index], dataFormats[index], GL_UNSIGNED_SHORT};
+				case ChannelType::Float32: return {float16Formats[index], dataFormats[index], GL_FLOAT};
+				default: return {srgb ? srgb8Formats[index] : unorm8Formats[index], dataFormats[index], GL_UNSIGNED_BYTE};
+			}
+		}
+
+		GLenum CompressedInternalFormat(Renderer::Textures::BlockFormat format, bool srgb) {
+			using Renderer::Textures::BlockFormat;
+			switch (format) {
+				case BlockFormat::BC1: return srgb ? GL_COMPRESSED_SRGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+				case BlockFormat::BC3: return srgb ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+				case BlockFormat::BC4: return GL_COMPRESSED_RED_RGTC1;
+				case BlockFormat::BC5: return GL_COMPRESSED_RG_RGTC2;
+				default: return srgb ? GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM : GL_COMPRESSED_RGBA_BPTC_UNORM;
+			}
+		}
+
+		// GL format of a chain (for compressed chains only internalFormat is meaningful)
+		UploadFormat ChainUploadFormat(const Renderer::Textures::MipChain &chain) {
+			const bool srgb = chain.GetColorSpace() == Renderer::Textures::ColorSpace::sRGB;
+			if (chain.IsCompressed())
+				return {CompressedInternalFormat(chain.GetBlockFormat(), srgb), GL_NONE, GL_NONE};
+			return ChooseUploadFormat(chain.GetChannelType(), chain.GetChannels(), srgb);
+		}
+
+		Renderer::Textures::ColorSpace ToColorSpace(TextureColorSpace colorSpace) {
+			return colorSpace == TextureColorSpace::sRGB ? Renderer::Textures::ColorSpace::sRGB : Renderer::Textures::ColorSpace::Linear;
+		}
+
+		constexpr uint64_t FnvOffset = 14695981039346656037ull;
+
+		// FNV-1a over raw bytes, continuing from `hash`
+		uint64_t HashBytes(uint64_t hash, const void *data, size_t size) {
+			for (size_t i = 0; i < size; ++i)
+				hash = (hash ^ static_cast<const uint8_t *>(data)[i]) * 1099511628211ull;
+			return hash;
+		}
+
+		// Every load option that changes the built chain (sRGB, size, resampler, mip filter...)
+		uint64_t HashMipOptions(const TextureLoadParams &params) {
+			const int32_t options[7] = {params.targetWidth, params.targetHeight, static_cast<int32_t>(params.algorithm),
+										static_cast<int32_t>(params.colorSpace), static_cast<int32_t>(params.mipSettings.filter),
+										static_cast<int32_t>(params.mipSettings.content), params.mipSettings.maxLevels};
+			uint64_t hash = HashBytes(FnvOffset, options, sizeof(options));
+			hash		  = HashBytes(hash, &params.mipSettings.alphaCutoff, sizeof(float));
+			return HashBytes(hash, &params.mipSettings.kaiserAlpha, sizeof(float));
+		}
+
+		// Identity of a cached mip chain, checked against its header: source file size/timestamp and the load options
+		uint64_t ComputeMipCacheKey(const std::string &path, const TextureLoadParams &params) {
+			std::error_code error;
+			const auto fileSize	 = std::filesystem::file_size(path, error);
+			const auto writeTime = std::filesystem::last_write_time(path, error);
+			if (error)
+				return 0;
+
+			const int64_t time	   = static_cast<int64_t>(writeTime.time_since_epoch().count());
+			const uint64_t size	   = static_cast<uint64_t>(fileSize);
+			const uint64_t options = HashMipOptions(params);
+			uint64_t hash		   = HashBytes(FnvOffset, &size, sizeof(size));
+			hash				   = HashBytes(hash, &time, sizeof(time));
+			hash				   = HashBytes(hash, &options, sizeof(options));
+			return hash == 0 ? 1 : hash;
+		}
+
+		// '<path>.<options>.mips': loads of one image with different options keep separate caches
+		// instead of overwriting each other's file on every load
+		std::string GetMipCachePath(const std::string &path, const TextureLoadParams &params) {
+			char options[17];
+			std::snprintf(options, sizeof(options), "%016llx", static_cast<unsigned long long>(HashMipOptions(params)));
+			return path + "." + options + ".mips";
+		}
+
+		// Upload every level of a CPU-built or compressed chain to the bound GL_TEXTURE_2D
+		void UploadMipChain(const Renderer::Textures::MipChain &chain, const UploadFormat &format) {
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+			for (int level = 0; level < chain.GetLevelCount(); ++level) {
+				const Renderer::Textures::MipLevel &mip = chain.GetLevel(level);
+				if (chain.IsCompressed())
+					glCompressedTexImage2D(GL_TEXTURE_2D, level, format.internalFormat, mip.width, mip.height, 0, static_cast<GLsizei>(mip.GetSize()), mip.GetData());
+				else
+					glTexImage2D(GL_TEXTURE_2D, level, format.internalFormat, mip.width, mip.height, 0, format.dataFormat, format.pixelType, mip.GetData());
+			}
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, chain.GetLevelCount() - 1);
+		}
+
+		void SetSamplingParameters() {
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		}
+
+		/**
+		 * @brief Decoder output in the format the rest of the pipeline works with.
+		 */
+		struct DecodedImage {
+			void *data							 = nullptr; ///< stb-owned pixels.
+			int width							 = 0;
+			int height							 = 0;
+			int channels						 = 0;
+			Renderer::Textures::ChannelType type = Renderer::Textures::ChannelType::UInt8;
+			bool srgb							 = false; ///< Color channels are sRGB-encoded.
+
+			DecodedImage()								  = default;
+			DecodedImage(const DecodedImage &)			  = delete;
+			DecodedImage &operator=(const DecodedImage &) = delete;
+			~DecodedImage() { stbi_image_free(data); }
+
+			Renderer::Textures::ImageView View() const {
+				using Renderer::Textures::ColorSpace;
+				return Renderer::Textures::ImageView(data, width, height, channels, type, srgb ? ColorSpace::sRGB : ColorSpace::Linear);
+			}
+		};
+
+		/**
+		 * @brief Decode an image file (thread-safe, no GL calls).
+		 *
+		 * HDR files decode to linear float; 16-bit files keep their precision for data maps
+		 * (16-bit color maps are reduced to 8 bits, as there is no 16-bit sRGB format).
+		 * Single/dual-channel images have no sRGB format and are always treated as linear.
+		 */
+		bool DecodeImage(const std::string &path, TextureColorSpace colorSpace, DecodedImage &image) {
+			using Renderer::Textures::ChannelType;
+			stbi_set_flip_vertically_on_load(1); // Same value from every thread
+
+			if (stbi_is_hdr(path.c_str())) {
+				image.data = stbi_loadf(path.c_str(), &image.width, &image.height, &image.channels, 0);
+				image.type = ChannelType::Float32;
+				colorSpace = TextureColorSpace::Linear;
+			} else if (colorSpace == TextureColorSpace::Linear && stbi_is_16_bit(path.c_str())) {
+				image.data = stbi_load_16(path.c_str(), &image.width, &image.height, &image.channels, 0);
+				image.type = ChannelType::UInt16;
+			} else {
+				image.data = stbi_load(path.c_str(), &image.width, &image.height, &image.channels, 0);
+			}
+			image.srgb = colorSpace == TextureColorSpace::sRGB && image.type == ChannelType::UInt8 && image.channels >= 3;
+			return image.data != nullptr;
+		}
 	}
 
 	Texture::Texture(const std::string &path, int targetWidth, int targetHeight, ResamplingAlgorithm algorithm)
-		: m_RendererID(0), m_FilePath(path), m_Width(0), m_Height(0), m_Channels(0) {
-		stbi_set_flip_vertically_on_load(1);
+		: Texture(path, TextureLoadParams(targetWidth, targetHeight, algorithm, TextureColorSpace::sRGB)) {}
+
+	Texture::Texture(const std::string &path, const TextureLoadParams &params)
+		: m_RendererID(0), m_FilePath(path), m_Width(0), m_Height(0), m_Channels(0), m_ColorSpace(params.colorSpace) {
+		using Renderer::Textures::MipChain;
+
+		if (params.cpuMipmaps) {
+			const MipChain chain = LoadMipChain(path, params);
+			if (!chain.IsValid())
+				return;
 
-		int srcWidth = 0, srcHeight = 0, srcChannels = 0;
-		unsigned char *srcData = stbi_load(path.c_str(), &srcWidth, &srcHeight, &srcChannels, 0);
+			const UploadFormat format = ChainUploadFormat(chain);
+			glGenTextures(1, &m_RendererID);
+			glBindTexture(GL_TEXTURE_2D, m_RendererID);
+			UploadMipChain(chain, format);
+			SetSamplingParameters();
+			glBindTexture(GL_TEXTURE_2D, 0);
 
-		if (!srcData) {
+			m_Width			 = chain.GetLevel(0).width;
+			m_Height		 = chain.GetLevel(0).height;
+			m_Channels		 = chain.GetChannels();
+			m_ColorSpace	 = chain.GetColorSpace() == Renderer::Textures::ColorSpace::sRGB ? TextureColorSpace::sRGB : TextureColorSpace::Linear;
+			m_LevelCount	 = chain.GetLevelCount();
+			m_BytesPerPixel	 = m_Channels * static_cast<int>(Renderer::Textures::ChannelTypeSize(chain.GetChannelType()));
+			m_BlockBytes	 = static_cast<int>(Renderer::Textures::BlockBytes(chain.GetBlockFormat()));
+			m_InternalFormat = format.internalFormat;
+			m_Ready			 = true;
+			return;
+		}
+
+		// Driver mips: resample into a pixel-unpack buffer, then glGenerateMipmap
+		if (Renderer::Textures::CompressedFile::IsSupported(path)) {
+			std::cerr << "[Texture] Compressed files need cpuMipmaps (mips are read from the file): " << path << std::endl;
+			return;
+		}
+		DecodedImage image;
+		if (!DecodeImage(path, params.colorSpace, image)) {
 			std::cerr << "[Texture] Failed to load: " << path << std::endl;
 			return;
 		}
 
-		m_Channels = srcChannels;
-		m_Width	   = (targetWidth > 0) ? targetWidth : srcWidth;
-		m_Height   = (targetHeight > 0) ? targetHeight : srcHeight;
+		m_Channels	 = image.channels;
+		m_ColorSpace = image.srgb ? TextureColorSpace::sRGB : TextureColorSpace::Linear;
+		m_Width		 = (params.targetWidth > 0) ? params.targetWidth : image.width;
+		m_Height	 = (params.targetHeight > 0) ? params.targetHeight : image.height;
 
-		const bool doResample = (m_Width != srcWidth || m_Height != srcHeight) && algorithm != ResamplingAlgorithm::None;
-		std::vector<uint8_t> resampled;
-		const unsigned char *uploadData = srcData;
+		glGenTextures(1, &m_RendererID);
+		glBindTexture(GL_TEXTURE_2D, m_RendererID);
 
-		if (doResample) {
-			auto resampler = CreateResampler(algorithm);
-			if (resampler) {
-				std::vector<uint8_t> input(srcData, srcData + size_t(srcWidth) * srcHeight * srcChannels);
-				resampled = resampler->Resample(input, srcWidth, srcHeight, m_Width, m_Height, srcChannels);
-				if (!resampled.empty()) {
-					uploadData = resampled.data();
-				} else {
-					std::cerr << "[Texture] Resampling failed for: " << path << ", using original." << std::endl;
-					m_Width	 = srcWidth;
-					m_Height = srcHeight;
+		const Renderer::Textures::ImageView source = image.View();
+		const UploadFormat format				   = ChooseUploadFormat(image.type, m_Channels, image.srgb);
+		const size_t pixelBytes					   = source.BytesPerPixel();
+
+		const bool doResample = (m_Width != image.width || m_Height != image.height) && params.algorithm != ResamplingAlgorithm::None;
+		auto resampler		  = doResample ? CreateResampler(params.algorithm) : nullptr;
+		if (doResample && !resampler) {
+			std::cerr << "[Texture] Invalid resampling algorithm for: " << path << ", using original." << std::endl;
+		}
+
+		bool uploaded = false;
+		if (resampler) {
+			// Resample straight from the decoder output into a mapped pixel-unpack buffer (no CPU copies).
+			// sRGB images are filtered in linear light. Rows are padded to the default GL_UNPACK_ALIGNMENT of 4.
+			const size_t stride = (size_t(m_Width) * pixelBytes + 3) & ~size_t(3);
+			const size_t bytes	= stride * m_Height;
+
+			GLuint pbo = 0;
+			glGenBuffers(1, &pbo);
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+			glBufferData(GL_PIXEL_UNPACK_BUFFER, bytes, nullptr, GL_STREAM_DRAW);
+			auto *mapped = static_cast<uint8_t *>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, bytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+			if (mapped) {
+				const Renderer::Textures::MutableImageView target(mapped, m_Width, m_Height, m_Channels, source.type, source.colorSpace, stride);
+				const bool resampled = resampler->Resample(source, target);
+				if (glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) && resampled) {
+					glTexImage2D(GL_TEXTURE_2D, 0, format.internalFormat, m_Width, m_Height, 0, format.dataFormat, format.pixelType, nullptr);
+					uploaded = true;
 				}
+			}
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+			glDeleteBuffers(1, &pbo);
+
+			if (!uploaded) {
+				std::cerr << "[Texture] Resampling failed for: " << path << ", using original." << std::endl;
+			}
+		}
+
+		if (!uploaded) {
+			// Upload the decoded image as-is (tightly packed rows)
+			m_Width	 = image.width;
+			m_Height = image.height;
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+			glTexImage2D(GL_TEXTURE_2D, 0, format.internalFormat, m_Width, m_Height, 0, format.dataFormat, format.pixelType, image.data);
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		}
+		glGenerateMipmap(GL_TEXTURE_2D);
+		SetSamplingParameters();
+		glBindTexture(GL_TEXTURE_2D, 0);
+		m_LevelCount	 = Renderer::Textures::MipChain::FullLevelCount(m_Width, m_Height);
+		m_BytesPerPixel	 = static_cast<int>(pixelBytes);
+		m_InternalFormat = format.internalFormat;
+		m_Ready			 = true;
+	}
+
+	std::string Texture::GetCookedPath(const std::string &path) {
+		return std::filesystem::path(path).replace_extension(".dds").string();
+	}
+
+	std::string Texture::GetContainerPath(const std::string &path) {
+		return std::filesystem::path(path).replace_extension(".vtex").string();
+	}
+
+	Renderer::Textures::MipChain Texture::LoadMipChain(const std::string &path, const TextureLoadParams &params) {
+		using Renderer::Textures::CompressedFile;
+		using Renderer::Textures::MipChain;
+		using Renderer::Textures::TextureContainer;
+
+		// Pre-compressed files and containers are uploaded as stored (no resampling or mip generation)
+		if (TextureContainer::IsContainer(path))
+			return TextureContainer::Load(path);
+		if (CompressedFile::IsSupported(path))
+			return CompressedFile::Load(path, ToColorSpace(params.colorSpace));
+		if (params.useCooked) {
+			// A container is mapped in place, so it wins over a DDS that must be read and flipped
+			const std::string containerPath = GetContainerPath(path);
+			if (FileUtils::IsCookedUpToDate(path, containerPath)) {
+				MipChain container = TextureContainer::Load(containerPath);
+				if (container.IsValid())
+					return container;
+			}
+			const std::string cookedPath = GetCookedPath(path);
+			if (FileUtils::IsCookedUpToDate(path, cookedPath)) {
+				MipChain cooked = CompressedFile::Load(cookedPath, ToColorSpace(params.colorSpace));
+				if (cooked.IsValid())
+					return cooked;
+			}
+		}
+
+		// A valid cached chain replaces decoding, resampling and mip generation
+		const uint64_t cacheKey		= params.cacheMipmaps ? ComputeMipCacheKey(path, params) : 0;
+		const std::string cachePath = params.cacheMipmaps ? GetMipCachePath(path, params) : std::string();
+		if (cacheKey != 0) {
+			// The key covers every option; the color space is checked on its own as it changes how texels upload
+			MipChain cached;
+			if (cached.LoadFromFile(cachePath, cacheKey) && cached.GetColorSpace() == ToColorSpace(params.colorSpace))
+				return cached;
+		}
+
+		DecodedImage image;
+		if (!DecodeImage(path, params.colorSpace, image)) {
+			std::cerr << "[Texture] Failed to load: " << path << std::endl;
+			return MipChain();
+		}
+
+		// Base level (resampled into CPU memory when needed), then the filtered chain
+		const Renderer::Textures::ImageView source = image.View();
+		Renderer::Textures::ImageView base		   = source;
+		std::vector<uint8_t> resampled;
+		const int width		  = (params.targetWidth > 0) ? params.targetWidth : image.width;
+		const int height	  = (params.targetHeight > 0) ? params.targetHeight : image.height;
+		const bool doResample = (width != image.width || height != image.height) && params.algorithm != ResamplingAlgorithm::None;
+		if (doResample) {
+			auto resampler = CreateResampler(params.algorithm);
+			resampled.resize(size_t(width) * height * source.BytesPerPixel());
+			const Renderer::Textures::MutableImageView target(resampled.data(), width, height, source.channels, source.type, source.colorSpace);
+			if (resampler && resampler->Resample(source, target)) {
+				base = target;
 			} else {
-				std::cerr << "[Texture] Invalid resampling algorithm for: " << path << ", using original." << std::endl;
-				m_Width	 = srcWidth;
-				m_Height = srcHeight;
+				std::cerr << "[Texture] Resampling failed for: " << path << ", using original." << std::endl;
 			}
 		}
 
-		glGenTextures(1, &m_RendererID);
+		MipChain chain = MipChain::Build(base, params.mipSettings);
+		if (cacheKey != 0)
+			chain.SaveToFile(cachePath, cacheKey);
+		return chain;
+	}
+
+	std::shared_ptr<Texture> Texture::CreatePlaceholder(uint32_t rgba) {
+		const uint8_t texel[4] = {uint8_t(rgba >> 24), uint8_t(rgba >> 16), uint8_t(rgba >> 8), uint8_t(rgba)};
+
+		std::shared_ptr<Texture> texture(new Texture());
+		texture->m_Width	= 1;
+		texture->m_Height	= 1;
+		texture->m_Channels = 4;
+		glGenTextures(1, &texture->m_RendererID);
+		glBindTexture(GL_TEXTURE_2D, texture->m_RendererID);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, texel);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+		SetSamplingParameters();
+		glBindTexture(GL_TEXTURE_2D, 0);
+		return texture;
+	}
+
+	void Texture::AllocateLevel(const Renderer::Textures::MipChain &chain, int level) {
+		const Renderer::Textures::MipLevel &mip = chain.GetLevel(level);
+		const UploadFormat format				= ChainUploadFormat(chain);
 		glBindTexture(GL_TEXTURE_2D, m_RendererID);
+		if (chain.IsCompressed())
+			glCompressedTexImage2D(GL_TEXTURE_2D, level, format.internalFormat, mip.width, mip.height, 0, static_cast<GLsizei>(mip.GetSize()), nullptr);
+		else
+			glTexImage2D(GL_TEXTURE_2D, level, format.internalFormat, mip.width, mip.height, 0, format.dataFormat, format.pixelType, nullptr);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		m_InternalFormat = format.internalFormat;
+		m_BlockBytes	 = static_cast<int>(Renderer::Textures::BlockBytes(chain.GetBlockFormat()));
+	}
 
-		GLenum internalFormat = GL_RGB8, dataFormat = GL_RGB;
-		if (m_Channels == 4) {
-			internalFormat = GL_SRGB8_ALPHA8; // Use sRGB format for 4 channels
-			dataFormat	   = GL_RGBA;
-		} else if (m_Channels == 3) {  // Explicit check for 3 channels
-			internalFormat = GL_SRGB8; // Use sRGB format for 3 channels
-			dataFormat	   = GL_RGB;
-		} else if (m_Channels == 1) {
-			internalFormat = GL_R8; // Keep linear for single channel (e.g., roughness, metallic)
-			dataFormat	   = GL_RED;
+	void Texture::UploadRows(const Renderer::Textures::MipChain &chain, int level, int firstRow, int rowCount, const void *pixels) {
+		const Renderer::Textures::MipLevel &mip = chain.GetLevel(level);
+		const UploadFormat format				= ChainUploadFormat(chain);
+		glBindTexture(GL_TEXTURE_2D, m_RendererID);
+		if (chain.IsCompressed()) {
+			// Block rows: the last one may cover fewer than 4 pixel rows
+			const int y		 = firstRow * Renderer::Textures::BlockSize;
+			const int height = std::min(rowCount * Renderer::Textures::BlockSize, mip.height - y);
+			glCompressedTexSubImage2D(GL_TEXTURE_2D, level, 0, y, mip.width, height, format.internalFormat,
+									  static_cast<GLsizei>(rowCount * chain.GetRowPitch(level)), pixels);
+		} else {
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+			glTexSubImage2D(GL_TEXTURE_2D, level, 0, firstRow, mip.width, rowCount, format.dataFormat, format.pixelType, pixels);
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 		}
+		glBindTexture(GL_TEXTURE_2D, 0);
+	}
 
-		glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, m_Width, m_Height, 0, dataFormat, GL_UNSIGNED_BYTE, uploadData);
-		glGenerateMipmap(GL_TEXTURE_2D);
+	void Texture::CommitLevel(const Renderer::Textures::MipChain &chain, int level) {
+		// Levels below BASE_LEVEL (e.g. the 1x1 placeholder in level 0) are ignored for completeness
+		glBindTexture(GL_TEXTURE_2D, m_RendererID);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, chain.GetLevelCount() - 1);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level);
+		glBindTexture(GL_TEXTURE_2D, 0);
+
+		m_Width			= chain.GetLevel(0).width;
+		m_Height		= chain.GetLevel(0).height;
+		m_Channels		= chain.GetChannels();
+		m_ColorSpace	= chain.GetColorSpace() == Renderer::Textures::ColorSpace::sRGB ? TextureColorSpace::sRGB : TextureColorSpace::Linear;
+		m_LevelCount	= chain.GetLevelCount();
+		m_BaseLevel		= level;
+		m_BytesPerPixel = m_Channels * static_cast<int>(Renderer::Textures::ChannelTypeSize(chain.GetChannelType()));
+		m_Ready			= true;
+	}
+
+	uint64_t Texture::GetLevelBytes(int level) const {
+		const int width	 = std::max(1, m_Width >> level);
+		const int height = std::max(1, m_Height >> level);
+		if (m_BlockBytes != 0)
+			return uint64_t(Renderer::Textures::BlockCount(width)) * Renderer::Textures::BlockCount(height) * m_BlockBytes;
+		return uint64_t(width) * height * m_BytesPerPixel;
+	}
+
+	uint64_t Texture::GetResidentBytes() const {
+		uint64_t total = 0;
+		for (int level = m_BaseLevel; level < m_LevelCount; ++level)
+			total += GetLevelBytes(level);
+		return total;
+	}
 
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	void Texture::EvictLevels(int newBaseLevel) {
+		newBaseLevel = std::min(newBaseLevel, m_LevelCount - 1);
+		if (newBaseLevel <= m_BaseLevel)
+			return;
 
-		stbi_image_free(srcData);
+		// Sample from the new base first, then re-specify the dropped levels as empty to release them
+		glBindTexture(GL_TEXTURE_2D, m_RendererID);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, newBaseLevel);
+		for (int level = m_BaseLevel; level < newBaseLevel; ++level) {
+			if (m_BlockBytes != 0)
+				glCompressedTexImage2D(GL_TEXTURE_2D, level, m_InternalFormat, 0, 0, 0, 0, nullptr);
+			else
+				glTexImage2D(GL_TEXTURE_2D, level, m_InternalFormat, 0, 0, 0, GL_RED, GL_UNSIGNED_BYTE, nullptr);
+		}
 		glBindTexture(GL_TEXTURE_2D, 0);
+		m_BaseLevel = newBaseLevel;
 	}
 
 	Texture::~Texture() {
@@ -6,19 +6,23 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/04/26 12:00:30 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/04/28 15:29:29 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2025/05/16 11:34:30 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #pragma once
 
+#include "Renderer/Textures/MipChain.h"
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
 /**
  * @file Texture.h
  * @brief Defines the Texture class for OpenGL texture management and image resampling.
+ * Supports 8-bit, 16-bit and HDR (float) images, resampled in linear light, and
+ * block-compressed (BCn) DDS / KTX2 files.
  */
 
 namespace Engine {
@@ -36,11 +40,42 @@ namespace Engine {
 		Lanczos			 ///< High quality, slower, may introduce ringing.
 	};
 
+	/**
+	 * @brief How the texel values of an image file should be interpreted.
+	 *
+	 * Color maps are sRGB-encoded: they are resampled in linear light and uploaded to
+	 * sRGB formats. Data maps (normal, roughness, height, ...) are linear and keep
+	 * 16-bit precision when the file provides it. HDR files are always linear float.
+	 */
+	enum class TextureColorSpace {
+		sRGB,  ///< Color data (albedo, emissive, sprites).
+		Linear ///< Non-color data (normals, roughness, metallic, AO, height, masks).
+	};
+
+	/**
+	 * @brief Options used when loading a texture from disk.
+	 */
+	struct TextureLoadParams {
+		int targetWidth				  = 0;							///< Desired width (0 = keep original).
+		int targetHeight			  = 0;							///< Desired height (0 = keep original).
+		ResamplingAlgorithm algorithm = ResamplingAlgorithm::Bilinear; ///< Filter used when resizing.
+		TextureColorSpace colorSpace  = TextureColorSpace::sRGB;		///< Interpretation of the texels.
+		bool cpuMipmaps				  = true;							///< Build mips with MipChain (false = glGenerateMipmap).
+		bool cacheMipmaps			  = true;							///< Read/write the CPU chain as '<path>.<options hash>.mips'.
+		bool useCooked				  = true;							///< Load the cooked '<name>.vtex' / '<name>.dds' instead when up to date.
+		Renderer::Textures::MipChainSettings mipSettings;				///< Filter and content of the CPU chain.
+
+		TextureLoadParams() = default;
+		TextureLoadParams(int targetWidth, int targetHeight, ResamplingAlgorithm algorithm, TextureColorSpace colorSpace)
+			: targetWidth(targetWidth), targetHeight(targetHeight), algorithm(algorithm), colorSpace(colorSpace) {}
+	};
+
 	/**
 	 * @brief Represents an OpenGL texture with optional image resampling.
 	 *
 	 * Loads image data from disk, optionally resamples to a target resolution,
-	 * and uploads to the GPU as an OpenGL texture object.
+	 * and uploads to the GPU as an OpenGL texture object. Mip levels are built on the
+	 * CPU and cached next to the source file, so later loads skip decoding entirely.
 	 */
 	class Texture {
 	public:
@@ -59,6 +94,49 @@ namespace Engine {
 				int targetHeight			  = 0,
 				ResamplingAlgorithm algorithm = ResamplingAlgorithm::Bilinear);
 
+		/**
+		 * @brief Construct a Texture from an image file with explicit load options.
+		 *
+		 * 8-bit files map to (s)RGB8 formats, 16-bit linear files to R16..RGBA16 and
+		 * HDR files (.hdr) to 16-bit float formats. DDS / KTX2 files (and cooked '.dds'
+		 * siblings, see GetCookedPath()) are uploaded block-compressed as stored; their
+		 * size and mips come from the file. Containers ('.vtex', see GetContainerPath()) are
+		 * memory-mapped and uploaded raw or compressed, without decoding.
+		 *
+		 * @param path Path to the image file.
+		 * @param params Target size, resampling filter and color space.
+		 */
+		Texture(const std::string &path, const TextureLoadParams &params);
+
+		/**
+		 * @brief Create a 1x1 texture of a single color, used until streamed data arrives.
+		 * @param rgba Color packed as 0xRRGGBBAA.
+		 */
+		static std::shared_ptr<Texture> CreatePlaceholder(uint32_t rgba);
+
+		/**
+		 * @brief Decode, resample and build the mip chain of an image on the calling thread.
+		 *
+		 * No GL calls: safe to run on worker threads. Reads and refreshes the '<path>.<options hash>.mips'
+		 * cache when params.cacheMipmaps is set.
+		 *
+		 * @return An empty chain if the file cannot be decoded.
+		 */
+		static Renderer::Textures::MipChain LoadMipChain(const std::string &path, const TextureLoadParams &params);
+
+		/**
+		 * @brief Where the texture cooker writes the compressed version of an image ('<name>.dds').
+		 */
+		static std::string GetCookedPath(const std::string &path);
+
+		/**
+		 * @brief Where the texture cooker writes the container version of an image ('<name>.vtex').
+		 */
+		static std::string GetContainerPath(const std::string &path);
+
+		Texture(const Texture &)			= delete;
+		Texture &operator=(const Texture &) = delete;
+
 		/**
 		 * @brief Destroy the Texture and free GPU resources.
 		 */
@@ -99,12 +177,93 @@ namespace Engine {
 		 */
 		int GetChannels() const { return m_Channels; }
 
+		/**
+		 * @brief Get the color space the texels were interpreted in.
+		 * @return TextureColorSpace given at load time.
+		 */
+		TextureColorSpace GetColorSpace() const { return m_ColorSpace; }
+
+		/**
+		 * @brief Whether the texels are stored block-compressed (BCn).
+		 */
+		bool IsCompressed() const { return m_BlockBytes != 0; }
+
+		/**
+		 * @brief Whether image data has been uploaded (false while a placeholder).
+		 *
+		 * Streamed textures become ready with their coarsest level and sharpen afterwards.
+		 */
+		bool IsReady() const { return m_Ready; }
+
+		/**
+		 * @brief Number of mip levels of the image (0 while a placeholder).
+		 */
+		int GetLevelCount() const { return m_LevelCount; }
+
+		/**
+		 * @brief Finest level currently resident on the GPU (GL_TEXTURE_BASE_LEVEL).
+		 */
+		int GetBaseLevel() const { return m_BaseLevel; }
+
+		/**
+		 * @brief Estimated GPU size of one level, in bytes.
+		 */
+		uint64_t GetLevelBytes(int level) const;
+
+		/**
+		 * @brief Estimated GPU size of the resident levels (base level and coarser), in bytes.
+		 */
+		uint64_t GetResidentBytes() const;
+
+		/**
+		 * @brief Free every level finer than newBaseLevel and sample from newBaseLevel on.
+		 *
+		 * Used by TextureResidency to stay under its memory budget. Freed levels can be
+		 * streamed back in with TextureStreamer::StreamLevels().
+		 */
+		void EvictLevels(int newBaseLevel);
+
 	private:
+		friend class TextureStreamer;
+
+		Texture() = default;
+
+		/**
+		 * @brief Define storage for one level of a chain (contents undefined). Used by TextureStreamer.
+		 *
+		 * No pixel-unpack buffer may be bound.
+		 */
+		void AllocateLevel(const Renderer::Textures::MipChain &chain, int level);
+
+		/**
+		 * @brief Upload storage rows [firstRow, firstRow + rowCount) of one level.
+		 *
+		 * Rows are MipChain::GetRowCount() units: pixel rows, or block rows when compressed.
+		 * @param pixels Client pointer, or byte offset when a pixel-unpack buffer is bound.
+		 */
+		void UploadRows(const Renderer::Textures::MipChain &chain, int level, int firstRow, int rowCount, const void *pixels);
+
+		/**
+		 * @brief Make a fully uploaded level the finest sampled one.
+		 *
+		 * Levels are streamed coarsest first, so the texture stays complete (and sampleable)
+		 * after every commit. Committing level 0 marks the texture ready.
+		 */
+		void CommitLevel(const Renderer::Textures::MipChain &chain, int level);
+
+
 		unsigned int m_RendererID = 0; ///< OpenGL texture object handle.
 		std::string m_FilePath;		   ///< Path to the source image file.
 		int m_Width	   = 0;			   ///< Final texture width (after resampling).
 		int m_Height   = 0;			   ///< Final texture height (after resampling).
 		int m_Channels = 0;			   ///< Number of channels in the original image.
+		TextureColorSpace m_ColorSpace = TextureColorSpace::sRGB; ///< Interpretation of the texels.
+		bool m_Ready				   = false;					  ///< Image data uploaded (not a placeholder).
+		int m_LevelCount			   = 0;						  ///< Mip levels of the image (0 = placeholder).
+		int m_BaseLevel				   = 0;						  ///< Finest resident level.
+		int m_BytesPerPixel			   = 4;						  ///< GPU bytes per texel (estimate).
+		int m_BlockBytes			   = 0;						  ///< Bytes per 4x4 block (0 = uncompressed).
+		unsigned int m_InternalFormat  = 0;						  ///< GL internal format of the image levels.
 	};
 
 } // namespace Engine
@@ -0,0 +1,94 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   TextureCache.cpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/12 09:42:31 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/16 11:32:40 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#include "Renderer/Textures/TextureCache.h"
+#include "Core/FileUtils.h"
+#include "Renderer/Textures/TextureStreamer.h"
+
+namespace Engine {
+
+	TextureCache &TextureCache::Get() {
+		static TextureCache cache;
+		return cache;
+	}
+
+	TextureCache::Key TextureCache::MakeKey(const std::string &path, const TextureLoadParams &params) {
+
+		const Renderer::Textures::MipChainSettings &mips = params.mipSettings;
+		return Key(FileUtils::CanonicalPath(path), params.targetWidth, params.targetHeight, static_cast<int>(params.algorithm), static_cast<int>(params.colorSpace),
+				   params.cpuMipmaps, params.useCooked, static_cast<int>(mips.filter), static_cast<int>(mips.content), mips.alphaCutoff, mips.kaiserAlpha,
+				   mips.maxLevels);
+	}
+
+	std::shared_ptr<Texture> TextureCache::FindLocked(const Key &key) const {
+		auto it = m_Entries.find(key);
+		return it != m_Entries.end() ? it->second.lock() : nullptr;
+	}
+
+	std::shared_ptr<Texture> TextureCache::Find(const std::string &path, const TextureLoadParams &params) const {
+		const Key key = MakeKey(path, params);
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return FindLocked(key);
+	}
+
+	std::shared_ptr<Texture> TextureCache::Load(const std::string &path, const TextureLoadParams &params) {
+		const Key key = MakeKey(path, params);
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			if (std::shared_ptr<Texture> texture = FindLocked(key)) {
+				++m_Stats.hits;
+				return texture;
+			}
+			++m_Stats.misses;
+		}
+
+		// Loaded without the lock so Find() from other threads is not blocked by decoding
+		auto texture = std::make_shared<Texture>(path, params);
+		if (texture->GetID() == 0)
+			return nullptr;
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Entries[key] = texture;
+		return texture;
+	}
+
+	std::shared_ptr<Texture> TextureCache::Stream(const std::string &path, const TextureLoadParams &params, uint32_t placeholderRGBA) {
+		const Key key = MakeKey(path, params);
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (std::shared_ptr<Texture> texture = FindLocked(key)) {
+			++m_Stats.hits;
+			return texture;
+		}
+		++m_Stats.misses;
+		std::shared_ptr<Texture> texture = TextureStreamer::Get().Load(path, params, placeholderRGBA);
+		m_Entries[key]					 = texture;
+		return texture;
+	}
+
+	size_t TextureCache::GetLiveCount() {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		for (auto it = m_Entries.begin(); it != m_Entries.end();)
+			it = it->second.expired() ? m_Entries.erase(it) : std::next(it);
+		return m_Entries.size();
+	}
+
+	TextureCache::Stats TextureCache::GetStats() const {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_Stats;
+	}
+
+	void TextureCache::Clear() {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Entries.clear();
+	}
+
+} // namespace Engine
@@ -0,0 +1,100 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   TextureCache.h                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/12 09:42:18 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/12 11:26:03 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#pragma once
+
+#include "Renderer/Textures/Texture.h"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+/**
+ * @file TextureCache.h
+ * @brief Engine-wide texture deduplication keyed by canonical path and load options.
+ */
+
+namespace Engine {
+
+	/**
+	 * @class TextureCache
+	 * @brief Hands out shared textures so each file is decoded and uploaded once per set of options.
+	 *
+	 * Entries are weak: a texture is freed when its last user drops it, and the next request
+	 * loads it again. Paths are canonicalised, so "a/../b.png" and "b.png" share an entry.
+	 * Lookups are thread-safe; Load() and Stream() create GL objects and must run on the GL thread.
+	 */
+	class TextureCache {
+	public:
+		/**
+		 * @brief Counters for profiling.
+		 */
+		struct Stats {
+			uint64_t hits	= 0; ///< Requests served by a live texture.
+			uint64_t misses = 0; ///< Requests that loaded a texture.
+		};
+
+		/**
+		 * @brief Engine-wide cache.
+		 */
+		static TextureCache &Get();
+
+		TextureCache(const TextureCache &)			  = delete;
+		TextureCache &operator=(const TextureCache &) = delete;
+
+		/**
+		 * @brief Live texture for this file and options, if any (any thread).
+		 */
+		std::shared_ptr<Texture> Find(const std::string &path, const TextureLoadParams &params = TextureLoadParams()) const;
+
+		/**
+		 * @brief Cached texture, or a synchronous load (GL thread).
+		 * @return nullptr if the file cannot be loaded (failures are not cached).
+		 */
+		std::shared_ptr<Texture> Load(const std::string &path, const TextureLoadParams &params = TextureLoadParams());
+
+		/**
+		 * @brief Cached texture, or a TextureStreamer load behind a placeholder (GL thread).
+		 * @param placeholderRGBA Color shown until the data arrives (first request wins).
+		 */
+		std::shared_ptr<Texture> Stream(const std::string &path, const TextureLoadParams &params = TextureLoadParams(), uint32_t placeholderRGBA = 0x808080FF);
+
+		/**
+		 * @brief Number of cached textures still alive (drops expired entries).
+		 */
+		size_t GetLiveCount();
+
+		Stats GetStats() const;
+
+		/**
+		 * @brief Forget every entry (textures stay alive while referenced).
+		 */
+		void Clear();
+
+	private:
+		TextureCache() = default;
+
+		/// Canonical path plus every option that changes the uploaded texels.
+		using Key = std::tuple<std::string, int, int, int, int, bool, bool, int, int, float, float, int>;
+
+		static Key MakeKey(const std::string &path, const TextureLoadParams &params);
+		std::shared_ptr<Texture> FindLocked(const Key &key) const;
+
+		mutable std::mutex m_Mutex;
+		std::map<Key, std::weak_ptr<Texture>> m_Entries;
+		mutable Stats m_Stats;
+	};
+
+} // namespace Engine
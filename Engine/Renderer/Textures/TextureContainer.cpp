@@ -0,0 +1,137 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   TextureContainer.cpp                               :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/12 16:35:14 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/16 11:32:40 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#include "Renderer/Textures/TextureContainer.h"
+#include "Core/FileUtils.h"
+#include "Core/MappedFile.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace Engine::Renderer::Textures {
+
+	namespace {
+		constexpr char ContainerMagic[4]	  = {'V', 'T', 'E', 'X'};
+		constexpr uint32_t ContainerVersion = 1;
+
+		struct ContainerHeader {
+			char magic[4];
+			uint32_t version;
+			uint32_t width;
+			uint32_t height;
+			uint32_t levelCount;
+			uint32_t channels;
+			uint32_t channelType; ///< ChannelType
+			uint32_t colorSpace;  ///< ColorSpace
+			uint32_t blockFormat; ///< BlockFormat
+			uint32_t reserved[3];
+		};
+
+		struct ContainerLevel {
+			uint64_t offset; ///< From the start of the file, multiple of Alignment.
+			uint64_t size;	 ///< Bytes of texels.
+			uint32_t width;
+			uint32_t height;
+		};
+
+		static_assert(sizeof(ContainerHeader) == 48, "Container header layout");
+		static_assert(sizeof(ContainerLevel) == 24, "Container level layout");
+
+		uint64_t AlignUp(uint64_t value) {
+			return (value + TextureContainer::Alignment - 1) / TextureContainer::Alignment * TextureContainer::Alignment;
+		}
+	} // namespace
+
+	bool TextureContainer::IsContainer(const std::string &path) {
+		return path.size() > 5 && path.compare(path.size() - 5, 5, ".vtex") == 0;
+	}
+
+	MipChain TextureContainer::Load(const std::string &path) {
+		std::shared_ptr<MappedFile> file = MappedFile::Open(path);
+		if (!file || file->GetSize() < sizeof(ContainerHeader))
+			return MipChain();
+
+		ContainerHeader header;
+		std::memcpy(&header, file->GetData(), sizeof(header));
+		if (std::memcmp(header.magic, ContainerMagic, sizeof(ContainerMagic)) != 0 || header.version != ContainerVersion || header.levelCount < 1 ||
+			header.levelCount > 32 || header.channelType > static_cast<uint32_t>(ChannelType::Float32) ||
+			header.colorSpace > static_cast<uint32_t>(ColorSpace::sRGB) || header.blockFormat > static_cast<uint32_t>(BlockFormat::BC7) ||
+			sizeof(ContainerHeader) + header.levelCount * sizeof(ContainerLevel) > file->GetSize()) {
+			std::cerr << "[TextureContainer] Invalid file: " << path << std::endl;
+			return MipChain();
+		}
+
+		std::vector<MipLevel> levels(header.levelCount);
+		for (uint32_t i = 0; i < header.levelCount; ++i) {
+			ContainerLevel entry;
+			std::memcpy(&entry, file->GetData() + sizeof(ContainerHeader) + i * sizeof(ContainerLevel), sizeof(entry));
+			if (entry.offset % Alignment != 0 || entry.offset > file->GetSize() || entry.size > file->GetSize() - entry.offset) {
+				std::cerr << "[TextureContainer] Truncated file: " << path << std::endl;
+				return MipChain();
+			}
+			levels[i].width		 = static_cast<int>(entry.width);
+			levels[i].height	 = static_cast<int>(entry.height);
+			levels[i].mapped	 = file->GetData() + entry.offset;
+			levels[i].mappedSize = static_cast<size_t>(entry.size);
+		}
+
+		// Start reading every level now; the upload touches them later
+		const size_t dataBegin = static_cast<size_t>(levels.front().mapped - file->GetData());
+		file->Prefetch(dataBegin, file->GetSize() - dataBegin);
+
+		MipChain chain = MipChain::FromMappedLevels(std::move(levels), static_cast<int>(header.channels), static_cast<ChannelType>(header.channelType),
+													static_cast<ColorSpace>(header.colorSpace), static_cast<BlockFormat>(header.blockFormat), file);
+		if (!chain.IsValid())
+			std::cerr << "[TextureContainer] Level sizes do not match the format: " << path << std::endl;
+		return chain;
+	}
+
+	bool TextureContainer::Save(const std::string &path, const MipChain &chain) {
+		if (!chain.IsValid())
+			return false;
+
+		ContainerHeader header{};
+		std::memcpy(header.magic, ContainerMagic, sizeof(ContainerMagic));
+		header.version	   = ContainerVersion;
+		header.width	   = static_cast<uint32_t>(chain.GetLevel(0).width);
+		header.height	   = static_cast<uint32_t>(chain.GetLevel(0).height);
+		header.levelCount  = static_cast<uint32_t>(chain.GetLevelCount());
+		header.channels	   = static_cast<uint32_t>(chain.GetChannels());
+		header.channelType = static_cast<uint32_t>(chain.GetChannelType());
+		header.colorSpace  = static_cast<uint32_t>(chain.GetColorSpace());
+		header.blockFormat = static_cast<uint32_t>(chain.GetBlockFormat());
+
+		std::vector<ContainerLevel> entries(chain.GetLevelCount());
+		uint64_t offset = AlignUp(sizeof(ContainerHeader) + entries.size() * sizeof(ContainerLevel));
+		for (int i = 0; i < chain.GetLevelCount(); ++i) {
+			const MipLevel &level = chain.GetLevel(i);
+			entries[i]			  = {offset, level.GetSize(), static_cast<uint32_t>(level.width), static_cast<uint32_t>(level.height)};
+			offset				  = AlignUp(offset + level.GetSize());
+		}
+
+		return FileUtils::WriteAtomically(path, [&](std::ofstream &file) {
+			file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+			file.write(reinterpret_cast<const char *>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(ContainerLevel)));
+			const std::vector<char> padding(Alignment, 0);
+			uint64_t position = sizeof(header) + entries.size() * sizeof(ContainerLevel);
+			for (int i = 0; i < chain.GetLevelCount(); ++i) {
+				file.write(padding.data(), static_cast<std::streamsize>(entries[i].offset - position));
+				file.write(reinterpret_cast<const char *>(chain.GetLevel(i).GetData()), static_cast<std::streamsize>(entries[i].size));
+				position = entries[i].offset + entries[i].size;
+			}
+			return true;
+		});
+	}
+
+} // namespace Engine::Renderer::Textures
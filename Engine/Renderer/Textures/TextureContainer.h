@@ -0,0 +1,65 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   TextureContainer.h                                 :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/12 16:35:09 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/12 18:02:17 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#pragma once
+
+#include "Renderer/Textures/MipChain.h"
+#include <string>
+
+/**
+ * @file TextureContainer.h
+ * @brief Engine-native texture files (.vtex) laid out for memory-mapped, decode-free loads.
+ */
+
+namespace Engine {
+	namespace Renderer {
+		namespace Textures {
+
+			/**
+			 * @class TextureContainer
+			 * @brief Reads and writes .vtex files.
+			 *
+			 * Layout: a fixed header, one table entry per mip level (offset, size, dimensions),
+			 * then each level's texels exactly as glTex(Sub)Image2D / glCompressedTex(Sub)Image2D
+			 * take them (bottom-up rows, raw or BCn), every level starting on a 4 KiB boundary.
+			 * Loading maps the file and points the chain's levels into the mapping, so nothing is
+			 * decoded or copied before the GL upload.
+			 */
+			class TextureContainer {
+			public:
+				static constexpr uint32_t Alignment = 4096; ///< Alignment of every level's data in the file.
+
+				/**
+				 * @brief Whether the path has the container extension (.vtex).
+				 */
+				static bool IsContainer(const std::string &path);
+
+				/**
+				 * @brief Map a container (thread-safe, no GL calls).
+				 *
+				 * The level data is prefetched asynchronously by the OS, so calling this on a
+				 * worker thread keeps page faults off the uploading thread.
+				 *
+				 * @return An empty chain if the file is missing or malformed.
+				 */
+				static MipChain Load(const std::string &path);
+
+				/**
+				 * @brief Write any valid chain (raw or compressed) as a container.
+				 */
+				static bool Save(const std::string &path, const MipChain &chain);
+			};
+
+		} // namespace Textures
+	} // namespace Renderer
+} // namespace Engine
@@ -0,0 +1,250 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   TextureCooker.cpp                                  :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/11 13:58:51 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/12 18:02:17 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#include "Renderer/Textures/TextureCooker.h"
+#include "Core/ThreadPool.h"
+#include "Renderer/Textures/Compression/BlockEncoder.h"
+#include "Renderer/Textures/Compression/CompressedFile.h"
+#include "Renderer/Textures/TextureContainer.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+namespace Engine {
+
+	namespace {
+
+		/// First channel of a pixel as a [0,1] value, whatever the storage type.
+		float ReadFirstChannel(const Renderer::Textures::ImageView &view, int x, int y) {
+			using Renderer::Textures::ChannelType;
+			const uint8_t *pixel = view.Row(y) + size_t(x) * view.BytesPerPixel();
+			switch (view.type) {
+				case ChannelType::UInt8: return pixel[0] / 255.0f;
+				case ChannelType::UInt16: {
+					uint16_t value;
+					std::memcpy(&value, pixel, sizeof(value));
+					return value / 65535.0f;
+				}
+				case ChannelType::Float32: {
+					float value;
+					std::memcpy(&value, pixel, sizeof(value));
+					return std::clamp(value, 0.0f, 1.0f);
+				}
+			}
+			return 0.0f;
+		}
+
+		/// Source image formats picked up when cooking a directory.
+		bool IsCookableImage(const std::filesystem::path &path) {
+			std::string extension = path.extension().string();
+			std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+			return extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".tga" || extension == ".bmp";
+		}
+
+	} // namespace
+
+	int ChannelPackSources::GetChannelMask() const {
+		return (ao.empty() ? 0 : AO) | (roughness.empty() ? 0 : Roughness) | (metallic.empty() ? 0 : Metallic) | (height.empty() ? 0 : Height);
+	}
+
+	std::string ChannelPackSources::GetPackedPath() const {
+		namespace fs = std::filesystem;
+		std::vector<std::string> stems;
+		fs::path directory;
+		for (const std::string *path : {&ao, &roughness, &metallic, &height}) {
+			if (path->empty())
+				continue;
+			if (stems.empty())
+				directory = fs::path(*path).parent_path();
+			stems.push_back(fs::path(*path).stem().string());
+		}
+		if (stems.empty())
+			return std::string();
+
+		// "Bricks_AmbientOcclusion" + "Bricks_Height" -> "Bricks"
+		std::string prefix = stems.front();
+		for (const std::string &stem : stems)
+			prefix.erase(std::mismatch(prefix.begin(), prefix.end(), stem.begin(), stem.end()).first, prefix.end());
+		while (!prefix.empty() && (prefix.back() == '_' || prefix.back() == '-' || prefix.back() == '.'))
+			prefix.pop_back();
+		if (prefix.empty())
+			prefix = "Packed";
+		return (directory / (prefix + "_ORM.dds")).string();
+	}
+
+	bool TextureCooker::Cook(const std::string &path, const TextureCookSettings &settings) {
+		using namespace Renderer::Textures;
+		const auto start = std::chrono::steady_clock::now();
+
+		TextureLoadParams params;
+		params.colorSpace	= settings.colorSpace;
+		params.mipSettings	= settings.mipSettings;
+		params.cacheMipmaps = false;
+		params.useCooked	= false;
+		const MipChain chain = Texture::LoadMipChain(path, params);
+		if (!chain.IsValid())
+			return false;
+		const bool compress = settings.compress || !settings.container; // DDS files are always compressed
+		if (chain.IsCompressed() || (compress && chain.GetChannelType() != ChannelType::UInt8)) {
+			std::cerr << "[TextureCooker] Only 8-bit images can be compressed: " << path << std::endl;
+			return false;
+		}
+
+		const BlockFormat format = !compress						   ? BlockFormat::None
+								   : settings.format != BlockFormat::None ? settings.format
+																		  : BlockEncoder::ChooseFormat(chain, settings.mipSettings.content);
+		const MipChain cooked	 = compress ? BlockEncoder::EncodeChain(chain, format) : chain;
+		const std::string output = settings.container ? Texture::GetContainerPath(path) : Texture::GetCookedPath(path);
+		if (!cooked.IsValid() || !(settings.container ? TextureContainer::Save(output, cooked) : CompressedFile::SaveDDS(output, cooked))) {
+			std::cerr << "[TextureCooker] Failed to cook: " << path << std::endl;
+			return false;
+		}
+
+		const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		std::cout << "[TextureCooker] " << path << " -> " << output << " (" << (compress ? ToString(format) : "raw") << ", "
+				  << chain.GetTotalBytes() / (1024.0 * 1024.0) << " MiB -> " << cooked.GetTotalBytes() / (1024.0 * 1024.0) << " MiB, "
+				  << ms << " ms)" << std::endl;
+		return true;
+	}
+
+	bool TextureCooker::PackChannels(const ChannelPackSources &sources, const std::string &outputPath, Renderer::Textures::BlockFormat format) {
+		using namespace Renderer::Textures;
+		const auto start = std::chrono::steady_clock::now();
+
+		const std::string *paths[4] = {&sources.ao, &sources.roughness, &sources.metallic, &sources.height};
+		const uint8_t neutral[4]	= {255, 255, 0, 128};
+
+		// Every source is decoded at the size of the first one (base level only)
+		MipChain channels[4];
+		int width = 0, height = 0;
+		for (int c = 0; c < 4; ++c) {
+			if (paths[c]->empty())
+				continue;
+			TextureLoadParams params(width, height, ResamplingAlgorithm::Bilinear, TextureColorSpace::Linear);
+			params.mipSettings.maxLevels = 1;
+			params.cacheMipmaps			 = false;
+			params.useCooked			 = false;
+			channels[c]					 = Texture::LoadMipChain(*paths[c], params);
+			if (!channels[c].IsValid() || channels[c].IsCompressed()) {
+				std::cerr << "[TextureCooker] Cannot pack (needs an uncompressed image): " << *paths[c] << std::endl;
+				return false;
+			}
+			if (width == 0) {
+				width  = channels[c].GetLevel(0).width;
+				height = channels[c].GetLevel(0).height;
+			}
+		}
+		if (width == 0) {
+			std::cerr << "[TextureCooker] Nothing to pack for: " << outputPath << std::endl;
+			return false;
+		}
+
+		std::vector<uint8_t> packed(size_t(width) * height * 4);
+		ThreadPool::Get().ParallelFor(0, height, 16, [&](int rowBegin, int rowEnd) {
+			for (int c = 0; c < 4; ++c) {
+				const ImageView source = channels[c].IsValid() ? channels[c].GetLevelView(0) : ImageView();
+				for (int y = rowBegin; y < rowEnd; ++y) {
+					uint8_t *row = packed.data() + size_t(y) * width * 4;
+					for (int x = 0; x < width; ++x)
+						row[x * 4 + c] = source.IsValid() ? static_cast<uint8_t>(std::lround(ReadFirstChannel(source, x, y) * 255.0f)) : neutral[c];
+				}
+			}
+		});
+
+		const MipChain chain = MipChain::Build(ImageView(packed.data(), width, height, 4, ChannelType::UInt8, ColorSpace::Linear));
+		if (format == BlockFormat::None)
+			format = sources.height.empty() ? BlockFormat::BC1 : BlockFormat::BC3;
+		const MipChain compressed = BlockEncoder::EncodeChain(chain, format);
+		if (!compressed.IsValid() || !CompressedFile::SaveDDS(outputPath, compressed)) {
+			std::cerr << "[TextureCooker] Failed to pack: " << outputPath << std::endl;
+			return false;
+		}
+
+		const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		const int mapCount = static_cast<int>(channels[0].IsValid()) + channels[1].IsValid() + channels[2].IsValid() + channels[3].IsValid();
+		std::cout << "[TextureCooker] Packed " << mapCount << " maps -> " << outputPath << " (" << ToString(format)
+				  << ", " << compressed.GetTotalBytes() / (1024.0 * 1024.0) << " MiB, " << ms << " ms)" << std::endl;
+		return true;
+	}
+
+	bool TextureCooker::IsPackUpToDate(const ChannelPackSources &sources, const std::string &outputPath) {
+		namespace fs = std::filesystem;
+		std::error_code error;
+		const fs::file_time_type packedTime = fs::last_write_time(outputPath, error);
+		if (error)
+			return false;
+		for (const std::string *path : {&sources.ao, &sources.roughness, &sources.metallic, &sources.height}) {
+			if (path->empty())
+				continue;
+			const fs::file_time_type sourceTime = fs::last_write_time(*path, error);
+			if (error || sourceTime > packedTime)
+				return false;
+		}
+		return true;
+	}
+
+	int TextureCooker::RunCommandLine(int argc, char **argv) {
+		using Renderer::Textures::BlockFormat;
+		TextureCookSettings settings;
+		int cooked = 0, failed = 0;
+		for (int i = 0; i < argc; ++i) {
+			const char *arg = argv[i];
+			if (std::strcmp(arg, "--linear") == 0) {
+				settings.colorSpace = TextureColorSpace::Linear;
+			} else if (std::strcmp(arg, "--normal") == 0) {
+				settings.colorSpace			 = TextureColorSpace::Linear;
+				settings.mipSettings.content = Renderer::Textures::MipContent::NormalMap;
+			} else if (std::strcmp(arg, "--vtex") == 0) {
+				settings.container = true;
+			} else if (std::strcmp(arg, "--raw") == 0) {
+				settings.compress = false;
+			} else if (std::strcmp(arg, "--pack") == 0 && i + 4 < argc) {
+				ChannelPackSources sources;
+				for (std::string *path : {&sources.ao, &sources.roughness, &sources.metallic, &sources.height}) {
+					const char *source = argv[++i];
+					*path			   = std::strcmp(source, "-") == 0 ? "" : source;
+				}
+				(PackChannels(sources, sources.GetPackedPath(), settings.format) ? cooked : failed)++;
+			} else if (std::strcmp(arg, "--format") == 0 && i + 1 < argc) {
+				const char *name = argv[++i];
+				settings.format	 = std::strcmp(name, "bc1") == 0	  ? BlockFormat::BC1
+								   : std::strcmp(name, "bc3") == 0 ? BlockFormat::BC3
+								   : std::strcmp(name, "bc4") == 0 ? BlockFormat::BC4
+								   : std::strcmp(name, "bc5") == 0 ? BlockFormat::BC5
+																   : BlockFormat::None;
+			} else if (std::filesystem::is_directory(arg)) {
+				for (const auto &entry : std::filesystem::recursive_directory_iterator(arg)) {
+					if (entry.is_regular_file() && IsCookableImage(entry.path()))
+						(Cook(entry.path().string(), settings) ? cooked : failed)++;
+				}
+			} else {
+				// Options apply to the images that follow them
+				(Cook(arg, settings) ? cooked : failed)++;
+			}
+		}
+		if (cooked + failed == 0) {
+			std::cerr << "Usage: --cook [--linear] [--normal] [--vtex [--raw]] [--format bc1|bc3|bc4|bc5] <images or dirs...>" << std::endl;
+			std::cerr << "       --cook --pack <ao> <roughness> <metallic> <height>   ('-' = no map)" << std::endl;
+			return EXIT_FAILURE;
+		}
+		std::cout << "[TextureCooker] " << cooked << " cooked, " << failed << " failed." << std::endl;
+		return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+} // namespace Engine
@@ -0,0 +1,112 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   TextureCooker.h                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/11 13:58:44 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/12 18:02:17 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#pragma once
+
+#include "Renderer/Textures/Texture.h"
+#include <string>
+
+/**
+ * @file TextureCooker.h
+ * @brief Offline conversion of source images into block-compressed DDS files or .vtex
+ *        containers, and
+ *        channel packing of single-channel material maps.
+ */
+
+namespace Engine {
+
+	/**
+	 * @brief Options for cooking one image.
+	 */
+	struct TextureCookSettings {
+		Renderer::Textures::BlockFormat format = Renderer::Textures::BlockFormat::None; ///< None = chosen from the image.
+		TextureColorSpace colorSpace		   = TextureColorSpace::sRGB;				 ///< Interpretation of the texels.
+		Renderer::Textures::MipChainSettings mipSettings;								 ///< Filter and content of the mips.
+		bool container										   = false; ///< Write '<name>.vtex' (memory-mapped loads) instead of '<name>.dds'.
+		bool compress										   = true;	///< Encode to BCn (false keeps raw texels; containers only).
+	};
+
+	/**
+	 * @brief Single-channel maps packed into one texture (empty path = channel not provided).
+	 *
+	 * Layout: R = ambient occlusion, G = roughness, B = metallic, A = height. Each source
+	 * contributes its first channel; the pack takes the size of the first source given.
+	 */
+	struct ChannelPackSources {
+		/// Bits of GetChannelMask(), shared with the shaders' u_PackedChannels.
+		enum Channel : int {
+			AO		  = 1 << 0, ///< Red
+			Roughness = 1 << 1, ///< Green
+			Metallic  = 1 << 2, ///< Blue
+			Height	  = 1 << 3	///< Alpha
+		};
+
+		std::string ao;		   ///< Ambient occlusion map.
+		std::string roughness; ///< Roughness map.
+		std::string metallic;  ///< Metallic map.
+		std::string height;	   ///< Height (parallax) map.
+
+		/**
+		 * @brief Channel bits of the sources that were provided.
+		 */
+		int GetChannelMask() const;
+
+		/**
+		 * @brief Default pack location: '<dir>/<common name prefix>_ORM.dds' next to the first source.
+		 */
+		std::string GetPackedPath() const;
+	};
+
+	/**
+	 * @class TextureCooker
+	 * @brief Builds the mip chain of an image, encodes it to BCn and writes Texture::GetCookedPath()
+	 *        (or Texture::GetContainerPath()).
+	 *
+	 * Textures loaded with TextureLoadParams::useCooked pick the cooked file up automatically.
+	 * Directories are cooked recursively (.png, .jpg, .tga, .bmp). Run from the command line with:
+	 *   VintzGameEngine --cook [--linear] [--normal] [--vtex [--raw]] [--format bc1|bc3|bc4|bc5] <images or dirs...>
+	 *   VintzGameEngine --cook --pack <ao> <roughness> <metallic> <height>   ('-' = no map)
+	 */
+	class TextureCooker {
+	public:
+		/**
+		 * @brief Cook one image (no GL calls).
+		 * @return false if the image cannot be decoded or encoded.
+		 */
+		static bool Cook(const std::string &path, const TextureCookSettings &settings = TextureCookSettings());
+
+		/**
+		 * @brief Pack single-channel maps into one BCn DDS (no GL calls).
+		 *
+		 * Missing channels are filled with neutral values (AO 1, roughness 1, metallic 0,
+		 * height 0.5); the material falls back to its scalars for them anyway.
+		 *
+		 * @param format None = BC1 without a height map, BC3 with one.
+		 * @return false if a source cannot be decoded or nothing was provided.
+		 */
+		static bool PackChannels(const ChannelPackSources &sources, const std::string &outputPath,
+								 Renderer::Textures::BlockFormat format = Renderer::Textures::BlockFormat::None);
+
+		/**
+		 * @brief True if the packed file exists and is newer than every source.
+		 */
+		static bool IsPackUpToDate(const ChannelPackSources &sources, const std::string &outputPath);
+
+		/**
+		 * @brief Parse the arguments following "--cook" and cook every listed image.
+		 * @return Process exit code.
+		 */
+		static int RunCommandLine(int argc, char **argv);
+	};
+
+} // namespace Engine
@@ -0,0 +1,229 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   TextureResidency.cpp                               :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/10 14:21:18 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/12 14:08:51 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#include "Renderer/Textures/TextureResidency.h"
+#include "Renderer/Geometry/Mesh.h"
+#include "Renderer/Materials/MaterialPBR.h"
+#include "Renderer/Textures/TextureStreamer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace Engine {
+
+	TextureResidency::View TextureResidency::View::FromCamera(const glm::mat4 &view, const glm::mat4 &projection, int viewportHeight) {
+		View result;
+
+		// Gribb-Hartmann: planes are sums / differences of the view-projection rows
+		const glm::mat4 viewProjection = projection * view;
+		auto row					   = [&viewProjection](int r) {
+			  return glm::vec4(viewProjection[0][r], viewProjection[1][r], viewProjection[2][r], viewProjection[3][r]);
+		};
+		for (int axis = 0; axis < 3; ++axis) {
+			result.frustumPlanes[axis * 2]	   = row(3) + row(axis);
+			result.frustumPlanes[axis * 2 + 1] = row(3) - row(axis);
+		}
+		for (glm::vec4 &plane : result.frustumPlanes)
+			plane /= glm::length(glm::vec3(plane));
+
+		result.cameraPosition		   = glm::vec3(glm::inverse(view)[3]);
+		result.pixelsPerUnitAtDistance = 0.5f * static_cast<float>(viewportHeight) * projection[1][1];
+		return result;
+	}
+
+	TextureResidency &TextureResidency::Get() {
+		static TextureResidency residency;
+		return residency;
+	}
+
+	void TextureResidency::Track(const std::shared_ptr<Texture> &texture, const TextureLoadParams &params) {
+		Entry &entry  = m_Entries[texture.get()];
+		entry		  = Entry();
+		entry.texture = texture;
+		entry.params  = params;
+	}
+
+	void TextureResidency::ReportUsage(const Texture *texture, float pixelsPerUV) {
+		auto it = m_Entries.find(texture);
+		if (it == m_Entries.end())
+			return;
+		Entry &entry = it->second;
+		if (entry.lastUsedFrame != m_Frame) {
+			entry.lastUsedFrame = m_Frame;
+			entry.pixelsPerUV	= pixelsPerUV;
+		} else {
+			entry.pixelsPerUV = std::max(entry.pixelsPerUV, pixelsPerUV);
+		}
+	}
+
+	void TextureResidency::ReportMaterial(const MaterialPBR &material, float pixelsPerUV) {
+		const std::pair<bool, const std::shared_ptr<Texture> *> maps[] = {
+			{material.hasAlbedoMap, &material.albedoMap},
+			{material.hasNormalMap, &material.normalMap},
+			{material.hasAOMap, &material.aoMap},
+			{material.hasRoughnessMap, &material.roughnessMap},
+			{material.hasMetallicMap, &material.metallicMap},
+			{material.hasSpecularMap, &material.specularMap},
+			{material.hasEmissiveMap, &material.emissiveMap},
+			{material.hasOpacityMap, &material.opacityMap},
+			{material.hasHeightMap, &material.heightMap},
+			{material.hasClearcoatMap, &material.clearcoatMap},
+			{material.hasAnisotropyMap, &material.anisotropyMap},
+			{material.hasSubsurfaceMap, &material.subsurfaceMap},
+			{material.hasPackedMap, &material.packedMap},
+		};
+		for (const auto &map : maps) {
+			if (map.first && *map.second)
+				ReportUsage(map.second->get(), pixelsPerUV);
+		}
+	}
+
+	float TextureResidency::ComputePixelsPerUV(const Mesh &mesh, const glm::mat4 &model, const View &view) {
+		const float unitsPerUV = mesh.GetWorldUnitsPerUV();
+		if (unitsPerUV <= 0.0f)
+			return 0.0f;
+
+		const glm::vec3 center = glm::vec3(model * glm::vec4(mesh.GetBoundsCenter(), 1.0f));
+		const float scale	   = std::max({glm::length(glm::vec3(model[0])), glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))});
+		const float radius	   = mesh.GetBoundsRadius() * scale;
+		for (const glm::vec4 &plane : view.frustumPlanes) {
+			if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+				return -1.0f;
+		}
+
+		// Densest point: the sphere surface closest to the camera
+		const float distance = std::max(glm::length(center - view.cameraPosition) - radius, 0.01f);
+		return unitsPerUV * scale * view.pixelsPerUnitAtDistance / distance;
+	}
+
+	int TextureResidency::RequiredLevel(const Texture &texture, float pixelsPerUV) {
+		const int lastLevel = texture.GetLevelCount() - 1;
+		if (pixelsPerUV <= 0.0f)
+			return lastLevel;
+		const float texelsPerPixel = static_cast<float>(std::max(texture.GetWidth(), texture.GetHeight())) / pixelsPerUV;
+		if (texelsPerPixel <= 1.0f)
+			return 0;
+		return std::min(static_cast<int>(std::floor(std::log2(texelsPerPixel))), lastLevel);
+	}
+
+	int TextureResidency::CoarseTailLevel(const Texture &texture) {
+		const int size = std::max(texture.GetWidth(), texture.GetHeight());
+		int level	   = 0;
+		while (level < texture.GetLevelCount() - 1 && (size >> level) > MinResidentSize)
+			++level;
+		return level;
+	}
+
+	void TextureResidency::Update() {
+		struct Candidate {
+			std::shared_ptr<Texture> texture;
+			uint64_t lastUsedFrame;
+			int keepLevel; ///< Coarsest base level allowed after eviction.
+		};
+		struct Want {
+			std::shared_ptr<Texture> texture;
+			Entry *entry;
+			int level;
+		};
+
+		TextureStreamer &streamer = TextureStreamer::Get();
+		std::vector<Candidate> candidates;
+		std::vector<Want> wants;
+		uint64_t resident	 = 0;
+		m_Stats.visible		 = 0;
+		m_Stats.frameMisses	 = 0;
+
+		for (auto it = m_Entries.begin(); it != m_Entries.end();) {
+			std::shared_ptr<Texture> texture = it->second.texture.lock();
+			if (!texture) {
+				it = m_Entries.erase(it);
+				continue;
+			}
+			Entry &entry = (it++)->second;
+			if (texture->GetLevelCount() == 0)
+				continue; // Initial load still pending
+
+			// Levels being streamed in count against the budget already
+			const bool streaming = streamer.IsStreaming(texture.get());
+			resident += texture->GetResidentBytes();
+			if (!streaming)
+				entry.pendingLevel = -1;
+			for (int level = std::max(entry.pendingLevel, 0); streaming && level < texture->GetBaseLevel(); ++level)
+				resident += texture->GetLevelBytes(level);
+
+			const bool used		= entry.lastUsedFrame == m_Frame;
+			const int required	= used ? RequiredLevel(*texture, entry.pixelsPerUV) : texture->GetLevelCount() - 1;
+			if (used) {
+				++m_Stats.visible;
+				if (required < texture->GetBaseLevel()) {
+					++m_Stats.frameMisses;
+					if (!streaming)
+						wants.push_back({texture, &entry, required});
+				}
+			}
+			if (!streaming)
+				candidates.push_back({texture, entry.lastUsedFrame, used ? required : CoarseTailLevel(*texture)});
+		}
+		m_Stats.misses += m_Stats.frameMisses;
+
+		// Largest on screen first
+		std::sort(wants.begin(), wants.end(), [](const Want &a, const Want &b) { return a.entry->pixelsPerUV > b.entry->pixelsPerUV; });
+		uint64_t incoming = 0;
+		for (const Want &want : wants) {
+			for (int level = want.level; level < want.texture->GetBaseLevel(); ++level)
+				incoming += want.texture->GetLevelBytes(level);
+		}
+
+		// Make room: least recently used textures lose their finest levels first
+		const uint64_t limit = m_Budget > incoming ? m_Budget - incoming : 0;
+		if (resident > limit) {
+			std::sort(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b) {
+				if (a.lastUsedFrame != b.lastUsedFrame)
+					return a.lastUsedFrame < b.lastUsedFrame;
+				return a.texture->GetResidentBytes() > b.texture->GetResidentBytes();
+			});
+			for (const Candidate &candidate : candidates) {
+				Texture &texture = *candidate.texture;
+				while (resident > limit && texture.GetBaseLevel() < candidate.keepLevel) {
+					resident -= texture.GetLevelBytes(texture.GetBaseLevel());
+					texture.EvictLevels(texture.GetBaseLevel() + 1);
+					++m_Stats.evictions;
+				}
+				if (resident <= limit)
+					break;
+			}
+		}
+
+		// Stream in as much of each request as fits; the rest stays coarse and misses again
+		for (const Want &want : wants) {
+			const int baseLevel = want.texture->GetBaseLevel();
+			int level			= baseLevel;
+			uint64_t bytes		= 0;
+			while (level > want.level && resident + bytes + want.texture->GetLevelBytes(level - 1) <= m_Budget)
+				bytes += want.texture->GetLevelBytes(--level);
+			if (level == baseLevel)
+				continue;
+			streamer.StreamLevels(want.texture, want.entry->params, level);
+			want.entry->pendingLevel = level;
+			resident += bytes;
+			++m_Stats.streamIns;
+		}
+
+		m_Stats.residentBytes = resident;
+		m_Stats.budgetBytes	  = m_Budget;
+		m_Stats.tracked		  = static_cast<int>(m_Entries.size());
+		++m_Frame;
+	}
+
+} // namespace Engine
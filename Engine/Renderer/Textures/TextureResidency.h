@@ -0,0 +1,148 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   TextureResidency.h                                 :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/10 14:21:07 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/10 16:52:29 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#pragma once
+
+#include "Renderer/Textures/Texture.h"
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <memory>
+#include <unordered_map>
+
+/**
+ * @file TextureResidency.h
+ * @brief Keeps streamed textures at the mip level visible draws need, under a GPU memory budget.
+ */
+
+namespace Engine {
+
+	class Mesh;
+	struct MaterialPBR;
+
+	/**
+	 * @class TextureResidency
+	 * @brief Tracks the required mip level of every streamed texture and evicts / streams levels.
+	 *
+	 * Each frame:
+	 *   - Visible draws report their screen-space UV density (ReportMaterial / ReportUsage),
+	 *     from which the finest level worth sampling is derived.
+	 *   - Update() streams missing levels back in through TextureStreamer::StreamLevels() and,
+	 *     when the resident size exceeds the budget, evicts detail from the least recently used
+	 *     textures first (Texture::EvictLevels, which raises GL_TEXTURE_BASE_LEVEL).
+	 *
+	 * Textures never drop below their coarse tail (MinResidentSize), so something is always
+	 * bound. Only textures created by TextureStreamer::Load() are tracked: their levels can be
+	 * reloaded from disk (the .mips cache makes that cheap).
+	 */
+	class TextureResidency {
+	public:
+		/**
+		 * @brief Camera data needed to turn mesh bounds into screen-space UV density.
+		 */
+		struct View {
+			glm::vec4 frustumPlanes[6];	   ///< World-space planes (xyz normal, w distance), pointing inwards.
+			glm::vec3 cameraPosition;	   ///< World-space eye position.
+			float pixelsPerUnitAtDistance; ///< Viewport pixels covered by one world unit at distance 1.
+
+			/**
+			 * @brief Build from the frame's matrices and viewport height in pixels.
+			 */
+			static View FromCamera(const glm::mat4 &view, const glm::mat4 &projection, int viewportHeight);
+		};
+
+		/**
+		 * @brief Counters for profiling overlays.
+		 */
+		struct Stats {
+			uint64_t residentBytes = 0; ///< Resident levels of tracked textures (incl. pending stream-ins).
+			uint64_t budgetBytes   = 0; ///< Current budget.
+			int tracked			   = 0; ///< Live streamed textures.
+			int visible			   = 0; ///< Textures reported this frame.
+			int frameMisses		   = 0; ///< Reported textures sampled coarser than required this frame.
+			uint64_t misses		   = 0; ///< Total of frameMisses.
+			uint64_t evictions	   = 0; ///< Levels evicted.
+			uint64_t streamIns	   = 0; ///< Stream-in requests issued.
+		};
+
+		static constexpr int MinResidentSize = 64; ///< Levels this size or smaller are never evicted.
+
+		/**
+		 * @brief Engine-wide residency manager.
+		 */
+		static TextureResidency &Get();
+
+		TextureResidency(const TextureResidency &)			  = delete;
+		TextureResidency &operator=(const TextureResidency &) = delete;
+
+		/**
+		 * @brief Start tracking a streamed texture (called by TextureStreamer::Load()).
+		 * @param params Load options, reused to stream evicted levels back in.
+		 */
+		void Track(const std::shared_ptr<Texture> &texture, const TextureLoadParams &params);
+
+		/**
+		 * @brief Report that a texture is sampled at the given density this frame.
+		 * @param pixelsPerUV Screen pixels covered by one UV unit (the densest use wins).
+		 */
+		void ReportUsage(const Texture *texture, float pixelsPerUV);
+
+		/**
+		 * @brief ReportUsage() for every map of a material.
+		 */
+		void ReportMaterial(const MaterialPBR &material, float pixelsPerUV);
+
+		/**
+		 * @brief Screen-space UV density of a mesh drawn with the given model matrix.
+		 * @return Pixels per UV unit, 0 if the mesh has no UVs, or a negative value if culled.
+		 */
+		static float ComputePixelsPerUV(const Mesh &mesh, const glm::mat4 &model, const View &view);
+
+		/**
+		 * @brief Evict and stream levels from this frame's reports (GL thread, after the reports).
+		 */
+		void Update();
+
+		/**
+		 * @brief Set the GPU memory budget for tracked textures, in bytes.
+		 */
+		void SetBudget(uint64_t bytes) { m_Budget = bytes; }
+		uint64_t GetBudget() const { return m_Budget; }
+
+		const Stats &GetStats() const { return m_Stats; }
+
+		/**
+		 * @brief Forget every tracked texture.
+		 */
+		void Clear() { m_Entries.clear(); }
+
+	private:
+		TextureResidency() = default;
+
+		struct Entry {
+			std::weak_ptr<Texture> texture;
+			TextureLoadParams params;
+			float pixelsPerUV	   = 0.0f; ///< Densest use reported this frame.
+			uint64_t lastUsedFrame = 0;	   ///< Frame of the last report (0 = never).
+			int pendingLevel	   = -1;   ///< Finest level requested from the streamer.
+		};
+
+		static int RequiredLevel(const Texture &texture, float pixelsPerUV);
+		static int CoarseTailLevel(const Texture &texture);
+
+		std::unordered_map<const Texture *, Entry> m_Entries;
+		uint64_t m_Budget = 1024ull * 1024ull * 1024ull; ///< 1 GiB by default.
+		uint64_t m_Frame  = 1;
+		Stats m_Stats;
+	};
+
+} // namespace Engine
@@ -0,0 +1,278 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   TextureStreamer.cpp                                :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/09 14:02:51 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/16 11:31:48 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#include "Renderer/Textures/TextureStreamer.h"
+#include "Core/ThreadPool.h"
+#include "Renderer/Textures/TextureResidency.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <glad/glad.h>
+#include <iostream>
+#include <thread>
+
+namespace Engine {
+
+	TextureStreamer &TextureStreamer::Get() {
+		static TextureStreamer streamer;
+		return streamer;
+	}
+
+	TextureStreamer::TextureStreamer()
+		: m_Completed(std::make_shared<CompletionQueue>()) {
+		// Two decodes per worker keep the pool busy without holding every image in memory
+		m_MaxInFlight = static_cast<int>(ThreadPool::Get().GetThreadCount()) * 2;
+	}
+
+	TextureStreamer::~TextureStreamer() {
+		// The GL context is gone at static destruction time; Shutdown() must have run before
+		if (m_StagingBuffer != 0)
+			std::cerr << "[TextureStreamer] Destroyed without Shutdown(), leaking GL resources." << std::endl;
+	}
+
+	std::shared_ptr<Texture> TextureStreamer::Load(const std::string &path, const TextureLoadParams &params, uint32_t placeholderRGBA) {
+		std::shared_ptr<Texture> texture = Texture::CreatePlaceholder(placeholderRGBA);
+		texture->m_FilePath				 = path;
+
+		Request request;
+		request.texture			  = texture;
+		request.key				  = texture.get();
+		request.path			  = path;
+		request.params			  = params;
+		request.params.cpuMipmaps = true;
+		TextureResidency::Get().Track(texture, request.params);
+		m_Pending.push_back(std::move(request));
+		m_Streaming.insert(texture.get());
+		++m_Stats.requested;
+		return texture;
+	}
+
+	void TextureStreamer::StreamLevels(const std::shared_ptr<Texture> &texture, const TextureLoadParams &params, int finestLevel) {
+		if (!texture || IsStreaming(texture.get()))
+			return;
+
+		Request request;
+		request.texture			  = texture;
+		request.key				  = texture.get();
+		request.path			  = texture->m_FilePath;
+		request.params			  = params;
+		request.params.cpuMipmaps = true;
+		request.finestLevel		  = std::max(0, finestLevel);
+		m_Pending.push_back(std::move(request));
+		m_Streaming.insert(texture.get());
+		++m_Stats.requested;
+	}
+
+	void TextureStreamer::Finish(const Texture *key) {
+		m_Streaming.erase(key);
+		m_Current.reset();
+	}
+
+	void TextureStreamer::CreateStagingBuffer() {
+		const GLsizeiptr size	  = static_cast<GLsizeiptr>(RegionSize) * RegionCount;
+		const GLbitfield mapFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glGenBuffers(1, &m_StagingBuffer);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_StagingBuffer);
+		glBufferStorage(GL_PIXEL_UNPACK_BUFFER, size, nullptr, mapFlags);
+		m_StagingMemory = static_cast<uint8_t *>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, mapFlags));
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		if (!m_StagingMemory)
+			std::cerr << "[TextureStreamer] Failed to map the staging buffer, uploading from client memory." << std::endl;
+	}
+
+	void TextureStreamer::Update(double budgetMs) {
+		using Clock		 = std::chrono::steady_clock;
+		const auto start = Clock::now();
+
+		// Collect finished decodes
+		{
+			std::lock_guard<std::mutex> lock(m_Completed->mutex);
+			m_InFlight -= static_cast<int>(m_Completed->items.size());
+			for (Decoded &decoded : m_Completed->items)
+				m_Ready.push_back(std::move(decoded));
+			m_Completed->items.clear();
+		}
+
+		// Dispatch new decodes (requests whose texture was already dropped are skipped)
+		while (!m_Pending.empty() && m_InFlight < m_MaxInFlight) {
+			Request request = std::move(m_Pending.front());
+			m_Pending.pop_front();
+			if (request.texture.expired()) {
+				m_Streaming.erase(request.key);
+				continue;
+			}
+			++m_InFlight;
+			ThreadPool::Get().Submit([queue = m_Completed, request = std::move(request)]() {
+				Decoded decoded;
+				decoded.texture		= request.texture;
+				decoded.key			= request.key;
+				decoded.path		= request.path;
+				decoded.finestLevel = request.finestLevel;
+				if (!request.texture.expired())
+					decoded.chain = Texture::LoadMipChain(request.path, request.params);
+				std::lock_guard<std::mutex> lock(queue->mutex);
+				queue->items.push_back(std::move(decoded));
+			});
+		}
+
+		if (!m_Current && m_Ready.empty())
+			return;
+		if (m_StagingBuffer == 0)
+			CreateStagingBuffer();
+
+		// Staging region of this frame: skip uploads while the GPU still reads it
+		GLsync &fence = m_RegionFences[m_Region];
+		if (fence) {
+			if (glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+				return;
+			glDeleteSync(fence);
+			fence = nullptr;
+		}
+
+		size_t regionOffset = 0;
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_StagingMemory ? m_StagingBuffer : 0);
+		while (std::chrono::duration<double, std::milli>(Clock::now() - start).count() < budgetMs) {
+			if (!UploadStep(regionOffset))
+				break;
+		}
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+		if (regionOffset > 0) {
+			fence	 = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+			m_Region = (m_Region + 1) % RegionCount;
+		}
+	}
+
+	bool TextureStreamer::UploadStep(size_t &regionOffset) {
+		// Next texture: start from its coarsest missing level
+		while (!m_Current) {
+			if (m_Ready.empty())
+				return false;
+			m_Current = std::make_unique<Decoded>(std::move(m_Ready.front()));
+			m_Ready.pop_front();
+			std::shared_ptr<Texture> texture = m_Current->texture.lock();
+			if (!texture) {
+				Finish(m_Current->key);
+			} else if (!m_Current->chain.IsValid()) {
+				std::cerr << "[TextureStreamer] Keeping placeholder for: " << m_Current->path << std::endl;
+				++m_Stats.failed;
+				Finish(m_Current->key);
+			} else {
+				const int levelCount = m_Current->chain.GetLevelCount();
+				const int resident	 = texture->GetLevelCount() > 0 ? std::min(texture->GetBaseLevel(), levelCount) : levelCount;
+				m_CurrentLevel		 = resident - 1;
+				m_CurrentRow		 = 0;
+				if (m_CurrentLevel < m_Current->finestLevel)
+					Finish(m_Current->key); // Already resident (evictions raced with this request)
+			}
+		}
+
+		std::shared_ptr<Texture> texture = m_Current->texture.lock();
+		if (!texture) {
+			Finish(m_Current->key);
+			return true;
+		}
+
+		// Storage rows: pixel rows, or 4-pixel block rows for compressed chains
+		const Renderer::Textures::MipChain &chain = m_Current->chain;
+		const Renderer::Textures::MipLevel &mip	  = chain.GetLevel(m_CurrentLevel);
+		const size_t rowBytes					  = chain.GetRowPitch(m_CurrentLevel);
+		const int rowCount						  = chain.GetRowCount(m_CurrentLevel);
+		if (m_CurrentRow == 0) {
+			GLint boundBuffer = 0;
+			glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &boundBuffer);
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+			texture->AllocateLevel(chain, m_CurrentLevel);
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, boundBuffer);
+		}
+
+		int rows = rowCount - m_CurrentRow;
+		if (m_StagingMemory && rowBytes > RegionSize) {
+			// A single row never fits in a region: upload it from client memory, one row per step
+			rows = 1;
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+			texture->UploadRows(chain, m_CurrentLevel, m_CurrentRow, rows, mip.GetData() + m_CurrentRow * rowBytes);
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_StagingBuffer);
+		} else if (m_StagingMemory) {
+			// Copy as many whole rows as fit in the region, 16-byte aligned
+			regionOffset		   = (regionOffset + 15) & ~size_t(15);
+			const size_t available = regionOffset < RegionSize ? RegionSize - regionOffset : 0;
+			rows				   = std::min<int>(rows, static_cast<int>(available / rowBytes));
+			if (rows == 0)
+				return false; // Region full until next frame
+			const size_t stagingOffset = static_cast<size_t>(m_Region) * RegionSize + regionOffset;
+			std::memcpy(m_StagingMemory + stagingOffset, mip.GetData() + m_CurrentRow * rowBytes, rows * rowBytes);
+			texture->UploadRows(chain, m_CurrentLevel, m_CurrentRow, rows, reinterpret_cast<const void *>(stagingOffset));
+			regionOffset += rows * rowBytes;
+		} else {
+			texture->UploadRows(chain, m_CurrentLevel, m_CurrentRow, rows, mip.GetData() + m_CurrentRow * rowBytes);
+			regionOffset += rows * rowBytes;
+		}
+		m_Stats.uploadBytes += rows * rowBytes;
+		m_CurrentRow += rows;
+
+		if (m_CurrentRow == rowCount) {
+			texture->CommitLevel(chain, m_CurrentLevel);
+			m_CurrentRow = 0;
+			if (--m_CurrentLevel < m_Current->finestLevel) {
+				++m_Stats.completed;
+				Finish(m_Current->key);
+			}
+		}
+		return true;
+	}
+
+	void TextureStreamer::Flush() {
+		while (!IsIdle()) {
+			Update(1e9);
+			if (!IsIdle()) {
+				// Waiting on workers or on the GPU to release a staging region
+				GLsync fence = m_RegionFences[m_Region];
+				if (fence)
+					glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000); // 1 ms
+				else
+					std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+		}
+	}
+
+	bool TextureStreamer::IsIdle() const {
+		return m_Pending.empty() && m_InFlight == 0 && m_Ready.empty() && !m_Current;
+	}
+
+	void TextureStreamer::Shutdown() {
+		for (GLsync &fence : m_RegionFences) {
+			if (fence)
+				glDeleteSync(fence);
+			fence = nullptr;
+		}
+		if (m_StagingBuffer != 0) {
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_StagingBuffer);
+			glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+			glDeleteBuffers(1, &m_StagingBuffer);
+		}
+		m_StagingBuffer = 0;
+		m_StagingMemory = nullptr;
+
+		// Running decodes keep the old queue alive and finish into it unobserved
+		m_Pending.clear();
+		m_Ready.clear();
+		m_Current.reset();
+		m_Streaming.clear();
+		m_Completed = std::make_shared<CompletionQueue>();
+		m_InFlight	= 0;
+	}
+
+} // namespace Engine
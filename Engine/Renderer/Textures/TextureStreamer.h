@@ -0,0 +1,173 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   TextureStreamer.h                                  :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/09 14:02:33 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/16 11:31:48 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#pragma once
+
+#include "Renderer/Textures/MipChain.h"
+#include "Renderer/Textures/Texture.h"
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+/**
+ * @file TextureStreamer.h
+ * @brief Asynchronous texture loading: decode on the ThreadPool, upload under a per-frame budget.
+ */
+
+// Forward declaration (avoids pulling glad into every includer)
+typedef struct __GLsync *GLsync;
+
+namespace Engine {
+
+	/**
+	 * @class TextureStreamer
+	 * @brief Loads textures in the background while a 1x1 placeholder is bound in their place.
+	 *
+	 * Usage:
+	 *   - Load() returns immediately with a placeholder Texture whose ID never changes.
+	 *   - Worker threads decode, resample and build the mip chain (Texture::LoadMipChain).
+	 *   - Update(), called once per frame on the GL thread, copies finished chains into a
+	 *     persistently mapped staging buffer and uploads them with glTex(Compressed)SubImage2D, coarsest
+	 *     level first, until the frame's time budget is spent. The texture sharpens level by
+	 *     level and is always complete.
+	 *
+	 * At most GetMaxInFlight() decodes are outstanding, which bounds the CPU memory held by
+	 * decoded images that are waiting for upload.
+	 */
+	class TextureStreamer {
+	public:
+		/**
+		 * @brief Counters for profiling and loading screens.
+		 */
+		struct Stats {
+			int requested		 = 0; ///< Load() calls.
+			int completed		 = 0; ///< Loads and stream-ins fully uploaded.
+			int failed			 = 0; ///< Textures that could not be decoded (placeholder kept).
+			uint64_t uploadBytes = 0; ///< Bytes uploaded through the staging buffer.
+		};
+
+		/**
+		 * @brief Engine-wide streamer (GL resources are created on first use).
+		 */
+		static TextureStreamer &Get();
+
+		~TextureStreamer();
+
+		TextureStreamer(const TextureStreamer &)			= delete;
+		TextureStreamer &operator=(const TextureStreamer &) = delete;
+
+		/**
+		 * @brief Queue a texture load (GL thread).
+		 *
+		 * @param path Image file.
+		 * @param params Load options (a CPU mip chain is always built).
+		 * @param placeholderRGBA Color shown until the data arrives, packed as 0xRRGGBBAA.
+		 * @return Texture usable right away; IsReady() turns true once its coarsest level is uploaded.
+		 */
+		std::shared_ptr<Texture> Load(const std::string &path, const TextureLoadParams &params = TextureLoadParams(), uint32_t placeholderRGBA = 0x808080FF);
+
+		/**
+		 * @brief Re-upload levels of a texture down to finestLevel (GL thread).
+		 *
+		 * Used by TextureResidency after EvictLevels(): the chain is reloaded (from the
+		 * .mips cache when enabled) and only the levels finer than the resident base are
+		 * uploaded.
+		 */
+		void StreamLevels(const std::shared_ptr<Texture> &texture, const TextureLoadParams &params, int finestLevel);
+
+		/**
+		 * @brief Whether a Load() or StreamLevels() for this texture is still in progress.
+		 */
+		bool IsStreaming(const Texture *texture) const { return m_Streaming.count(texture) != 0; }
+
+		/**
+		 * @brief Dispatch decodes and upload finished ones (GL thread, once per frame).
+		 * @param budgetMs Upload time allowed this frame, in milliseconds.
+		 */
+		void Update(double budgetMs = 2.0);
+
+		/**
+		 * @brief Block until every queued texture is uploaded (loading screens, benchmarks).
+		 */
+		void Flush();
+
+		/**
+		 * @brief Whether nothing is queued, decoding or uploading.
+		 */
+		bool IsIdle() const;
+
+		/**
+		 * @brief Release GL resources (call before the context is destroyed).
+		 *
+		 * Decodes still running finish in the background and are discarded.
+		 */
+		void Shutdown();
+
+		void SetMaxInFlight(int count) { m_MaxInFlight = count > 0 ? count : 1; }
+		int GetMaxInFlight() const { return m_MaxInFlight; }
+		const Stats &GetStats() const { return m_Stats; }
+
+	private:
+		TextureStreamer();
+
+		struct Request {
+			std::weak_ptr<Texture> texture; ///< Dropped textures are skipped.
+			const Texture *key = nullptr;	///< m_Streaming entry, released even if the texture is dropped.
+			std::string path;
+			TextureLoadParams params;
+			int finestLevel = 0; ///< Last level to upload.
+		};
+
+		struct Decoded {
+			std::weak_ptr<Texture> texture;
+			const Texture *key = nullptr;
+			std::string path;
+			Renderer::Textures::MipChain chain;
+			int finestLevel = 0;
+		};
+
+		/// Shared with worker tasks so they can finish after Shutdown().
+		struct CompletionQueue {
+			std::mutex mutex;
+			std::deque<Decoded> items;
+		};
+
+		static constexpr int RegionCount	   = 3;				   ///< Staging regions (frames in flight).
+		static constexpr size_t RegionSize = 16u * 1024u * 1024u; ///< Bytes per staging region (larger rows are uploaded from client memory).
+
+		void CreateStagingBuffer();
+		bool UploadStep(size_t &regionOffset);
+		void Finish(const Texture *key);
+
+		std::deque<Request> m_Pending;						///< Not yet dispatched to the pool.
+		std::shared_ptr<CompletionQueue> m_Completed;		///< Decoded by workers, waiting for upload.
+		std::deque<Decoded> m_Ready;						///< Collected on the GL thread.
+		std::unique_ptr<Decoded> m_Current;					///< Texture being uploaded.
+		std::unordered_set<const Texture *> m_Streaming;	///< Textures with a request in progress.
+		int m_CurrentLevel = -1;							///< Level being uploaded (counts down to finestLevel).
+		int m_CurrentRow   = 0;								///< Next row of that level.
+		int m_InFlight	   = 0;								///< Dispatched, not yet collected.
+		int m_MaxInFlight  = 1;								///< Decode concurrency limit.
+
+		unsigned int m_StagingBuffer = 0;					///< Persistently mapped pixel-unpack buffer.
+		uint8_t *m_StagingMemory	 = nullptr;				///< Its mapping.
+		GLsync m_RegionFences[RegionCount] = {};			///< Last use of each region.
+		int m_Region					   = 0;				///< Region used by the next Update().
+
+		Stats m_Stats;
+	};
+
+} // namespace Engine
@@ -0,0 +1,66 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   GLContext.h                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/16 10:48:30 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/16 10:48:30 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#pragma once
+
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>
+#include <glad/glad.h>
+#include <iostream>
+
+/**
+ * @file GLContext.h
+ * @brief Hidden OpenGL context for tests and benchmarks that need the GPU.
+ */
+
+namespace Engine {
+	namespace Tests {
+
+		/**
+		 * @brief Create an invisible window with a current 4.5 core context (the engine's version).
+		 * @return nullptr when no display or driver is available; callers skip their GL part.
+		 */
+		inline GLFWwindow *CreateHiddenContext(int width = 64, int height = 64) {
+			if (!glfwInit()) {
+				std::cerr << "[GLContext] No display: GL checks skipped" << std::endl;
+				return nullptr;
+			}
+			glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+			glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 5);
+			glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+			glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+			GLFWwindow *window = glfwCreateWindow(width, height, "Engine test", nullptr, nullptr);
+			if (!window) {
+				std::cerr << "[GLContext] No OpenGL 4.5 context: GL checks skipped" << std::endl;
+				glfwTerminate();
+				return nullptr;
+			}
+			glfwMakeContextCurrent(window);
+			if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+				std::cerr << "[GLContext] Failed to load OpenGL functions: GL checks skipped" << std::endl;
+				glfwDestroyWindow(window);
+				glfwTerminate();
+				return nullptr;
+			}
+			return window;
+		}
+
+		/// Release a context made by CreateHiddenContext() (GL objects must be destroyed first).
+		inline void DestroyHiddenContext(GLFWwindow *window) {
+			if (!window) return;
+			glfwDestroyWindow(window);
+			glfwTerminate();
+		}
+
+	} // namespace Tests
+} // namespace Engine
@@ -0,0 +1,52 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Harness.h                                          :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/16 10:35:40 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/16 10:35:40 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#pragma once
+
+#include <iostream>
+
+/**
+ * @file Harness.h
+ * @brief Minimal helpers shared by the Tests/ executables.
+ *
+ * Each test is a standalone program: CHECK records failures without stopping, and
+ * main returns Tests::Result() so `make test` fails on the first failing program.
+ */
+
+namespace Engine {
+	namespace Tests {
+
+		/// Number of failed CHECKs in this program.
+		inline int &Failures() {
+			static int failures = 0;
+			return failures;
+		}
+
+		/// Exit code for main: 0 when every CHECK passed.
+		inline int Result() {
+			if (Failures() == 0) std::cout << "[Tests] OK" << std::endl;
+			else std::cerr << "[Tests] " << Failures() << " check(s) failed" << std::endl;
+			return Failures() == 0 ? 0 : 1;
+		}
+
+	} // namespace Tests
+} // namespace Engine
+
+/// Record a failure (with file, line and the failing expression) when cond is false.
+#define CHECK(cond)                                                                            \
+	do {                                                                                       \
+		if (!(cond)) {                                                                         \
+			std::cerr << "[CHECK] " << __FILE__ << ":" << __LINE__ << ": " << #cond << std::endl; \
+			++Engine::Tests::Failures();                                                       \
+		}                                                                                      \
+	} while (0)
@@ -0,0 +1,144 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   PrimitiveAllocationTest.cpp                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/05/16 10:51:14 by vvaucoul          #+#    #+#             */
+/*   Updated: 2025/05/16 11:35:12 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+
+#include "GLContext.h"
+#include "Harness.h"
+#include "Renderer/Geometry/Mesh.h"
+#include "Renderer/Primitives/Primitives.h"
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <vector>
+
+// Building a primitive must cost a fixed number of heap allocations, whatever its tessellation
+// and however many are built: every buffer is sized up front instead of growing by push_back.
+// Global operator new is replaced by a counter; each generator is measured for several detail
+// levels and batch sizes, first on the CPU only (Primitives::Generate*), then through the
+// rvalue Mesh constructor (needs a GL context, skipped without one). The CPU path must also
+// stay under kMaxGenerateAllocations.
+
+namespace {
+	std::atomic<size_t> s_Allocations{0};
+
+	void *CountedAlloc(size_t size) {
+		++s_Allocations;
+		return std::malloc(size ? size : 1);
+	}
+} // namespace
+
+void *operator new(size_t size) {
+	if (void *p = CountedAlloc(size)) return p;
+	throw std::bad_alloc();
+}
+void *operator new[](size_t size) {
+	if (void *p = CountedAlloc(size)) return p;
+	throw std::bad_alloc();
+}
+void *operator new(size_t size, const std::nothrow_t &) noexcept { return CountedAlloc(size); }
+void *operator new[](size_t size, const std::nothrow_t &) noexcept { return CountedAlloc(size); }
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+void operator delete[](void *p, size_t) noexcept { std::free(p); }
+void operator delete(void *p, const std::nothrow_t &) noexcept { std::free(p); }
+void operator delete[](void *p, const std::nothrow_t &) noexcept { std::free(p); }
+
+using namespace Engine;
+
+namespace {
+	struct Generator {
+		const char *name;
+		MeshGeometry (*generate)(unsigned int detail);
+	};
+
+	// detail drives the tessellation; the cube and quad are fixed-size and only vary in count
+	const Generator kGenerators[] = {
+		{"cube", [](unsigned int) { return Primitives::GenerateCube(); }},
+		{"quad", [](unsigned int) { return Primitives::GenerateQuad(); }},
+		{"plane", [](unsigned int detail) { return Primitives::GeneratePlane(detail); }},
+		{"sphere", [](unsigned int detail) { return Primitives::GenerateSphere(detail, detail / 2); }},
+		{"cylinder", [](unsigned int detail) { return Primitives::GenerateCylinder(1.0f, 0.5f, detail); }},
+		{"cone", [](unsigned int detail) { return Primitives::GenerateCone(1.0f, 0.5f, detail); }},
+		{"torus", [](unsigned int detail) { return Primitives::GenerateTorus(1.0f, 0.2f, detail, detail / 2); }},
+	};
+
+	// Kept below 65536 vertices: larger meshes use 32-bit indices and skip the 16-bit copy
+	const unsigned int kDetails[] = {8, 32, 128};
+	const size_t kCounts[]		  = {1, 8, 32};
+
+	// Vertices, indices, two angle tables (sphere, torus) and the optimizer's scratch block
+	constexpr size_t kMaxGenerateAllocations = 5;
+
+	/// Allocations of `count` builds, or SIZE_MAX if they differ between builds.
+	template <typename Build>
+	size_t AllocationsPerBuild(size_t count, Build build) {
+		const size_t before = s_Allocations.load();
+		for (size_t i = 0; i < count; ++i)
+			build(i);
+		const size_t total = s_Allocations.load() - before;
+		return total % count == 0 ? total / count : SIZE_MAX;
+	}
+
+	/// Measure every (detail, count) pair and CHECK they all cost the same per build, at most `maxPerBuild`.
+	template <typename Build>
+	void CheckConstant(const char *what, const Generator &generator, size_t maxPerBuild, Build build) {
+		size_t expected = SIZE_MAX;
+		for (unsigned int detail : kDetails) {
+			for (size_t count : kCounts) {
+				const size_t perBuild = AllocationsPerBuild(count, [&](size_t i) { build(detail, i); });
+				if (expected == SIZE_MAX)
+					expected = perBuild;
+				if (perBuild != expected)
+					std::cerr << "[PrimitiveAllocationTest] " << what << " " << generator.name << " (detail " << detail << ", " << count
+							  << " built): " << perBuild << " allocations per build, expected " << expected << std::endl;
+				CHECK(perBuild == expected);
+			}
+		}
+		if (expected > maxPerBuild)
+			std::cerr << "[PrimitiveAllocationTest] " << what << " " << generator.name << ": " << expected << " allocations per build, at most "
+					  << maxPerBuild << " allowed" << std::endl;
+		CHECK(expected <= maxPerBuild);
+		std::cout << "[PrimitiveAllocationTest] " << what << " " << generator.name << ": " << expected << " allocations each" << std::endl;
+	}
+} // namespace
+
+int main() {
+	for (const Generator &generator : kGenerators)
+		CheckConstant("Generate", generator, kMaxGenerateAllocations, [&](unsigned int detail, size_t) { generator.generate(detail); });
+
+	GLFWwindow *window = Tests::CreateHiddenContext();
+	if (window) {
+		// Cluster every mesh so the meshlet build is part of the measured constructor
+		Mesh::SetMeshletMinTriangles(1);
+		std::vector<std::unique_ptr<Mesh>> meshes;
+		meshes.reserve(kCounts[sizeof(kCounts) / sizeof(kCounts[0]) - 1]);
+		for (const Generator &generator : kGenerators) {
+			// One mesh first: the driver and the engine's statics may allocate on first use
+			{
+				MeshGeometry warmup = generator.generate(kDetails[0]);
+				Mesh mesh(std::move(warmup.vertices), std::move(warmup.indices));
+			}
+			// GL object creation allocates inside the driver: only the constant count is checked here
+			CheckConstant("Generate + Mesh", generator, SIZE_MAX, [&](unsigned int detail, size_t i) {
+				if (i == 0)
+					meshes.clear();
+				MeshGeometry geometry = generator.generate(detail);
+				meshes.emplace_back(new Mesh(std::move(geometry.vertices), std::move(geometry.indices)));
+			});
+			meshes.clear();
+		}
+		Tests::DestroyHiddenContext(window);
+	}
+	return Tests::Result();
+}
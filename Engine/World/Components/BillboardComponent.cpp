@@ -6,13 +6,14 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/04/28 10:40:00 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/04/29 00:55:25 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2025/05/15 15:38:52 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "World/Components/BillboardComponent.h"
-#include "Renderer/Primitives/Primitives.h"
+#include "Renderer/Primitives/PrimitiveCache.h"
 #include "Renderer/Shaders/Shader.h"
+#include "Renderer/Textures/TextureCache.h"
 #include "World/Actor.h"
 #include <glad/glad.h>
 #include <glm/gtc/matrix_transform.hpp>
@@ -20,11 +21,11 @@
 
 namespace Engine {
 
-	std::unique_ptr<Mesh> BillboardComponent::s_QuadMesh = nullptr;
+	std::shared_ptr<Mesh> BillboardComponent::s_QuadMesh = nullptr;
 
 	void BillboardComponent::InitQuad() {
 		if (!s_QuadMesh) {
-			s_QuadMesh = Primitives::CreateQuad();
+			s_QuadMesh = PrimitiveCache::Get().GetQuad();
 			if (!s_QuadMesh) {
 				std::cerr << "[BillboardComponent] Failed to create quad mesh." << std::endl;
 			}
@@ -45,7 +46,10 @@ namespace Engine {
 
 	void BillboardComponent::SetSprite(const std::string &path) {
 		try {
-			m_SpriteTexture = std::make_shared<Texture>(path);
+			// Sprites are alpha-tested (unlit shader discards below 0.1): keep their coverage in every mip
+			TextureLoadParams params;
+			params.mipSettings.alphaCutoff = 0.1f;
+			m_SpriteTexture				   = TextureCache::Get().Load(path, params);
 		} catch (const std::exception &e) {
 			std::cerr << "[BillboardComponent] Texture load failed: " << path << " (" << e.what() << ")" << std::endl;
 			m_SpriteTexture = nullptr;
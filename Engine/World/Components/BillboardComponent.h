@@ -6,7 +6,7 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/04/28 10:38:16 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/04/29 00:57:26 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2025/05/15 15:38:52 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -81,7 +81,7 @@ namespace Engine {
 		std::shared_ptr<Texture> m_SpriteTexture; ///< Sprite texture.
 		glm::vec2 m_Size;						  ///< Billboard size (width, height).
 
-		static std::unique_ptr<Mesh> s_QuadMesh; ///< Shared quad mesh for all billboards.
+		static std::shared_ptr<Mesh> s_QuadMesh; ///< Shared quad mesh for all billboards (from PrimitiveCache).
 	};
 
 } // namespace Engine
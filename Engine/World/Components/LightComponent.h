@@ -35,13 +35,20 @@ namespace Engine {
 		const glm::vec3 &GetColor() const { return m_Color; }
 		float GetIntensity() const { return m_Intensity; }
 
+		bool CastsShadows() const { return m_CastShadows; }
+		float GetShadowImportance() const { return m_ShadowImportance; }
+
 		// --- Setters ---
 		void SetColor(const glm::vec3 &color) { m_Color = color; }
 		void SetIntensity(float intensity) { m_Intensity = intensity; }
+		void SetCastShadows(bool castShadows) { m_CastShadows = castShadows; }
+		void SetShadowImportance(float importance) { m_ShadowImportance = importance; }
 
 	protected:
 		glm::vec3 m_Color;
 		float m_Intensity;
+		bool m_CastShadows		= true; ///< Whether the light requests shadow map tiles.
+		float m_ShadowImportance = 1.0f; ///< Scales the shadow tile resolution and update priority.
 
 		// Position and Rotation are now handled by the base SceneComponent
 	};
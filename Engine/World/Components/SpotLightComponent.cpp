@@ -22,7 +22,7 @@
 namespace Engine {
 
 	SpotLightComponent::SpotLightComponent(Actor *owner, const glm::vec3 &color, float intensity, float cutOff, float outerCutOff, float constant, float linear, float quadratic)
-		: PointLightComponent(owner, color, intensity, constant, linear, quadratic), // Call base constructor
+		: PointLightComponent(owner, color, intensity, 10.0f, 0.0f, 0.0f, 0.0f, constant, linear, quadratic), // Call base constructor (default attenuation radius)
 		  m_CutOff(cutOff),															 // Corrected member name from m_InnerCutOff
 		  m_OuterCutOff(outerCutOff) {
 		// Add billboard component to the owner actor
@@ -6,22 +6,29 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/04/26 13:28:37 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/04/29 00:58:58 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2025/05/16 10:55:37 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "World/Components/StaticMeshComponent.h"
 #include "Renderer/Geometry/Mesh.h"
 #include "Renderer/Geometry/Model.h"
+#include "Renderer/Geometry/ModelCache.h"
 #include "Renderer/Materials/DefaultMaterial.h" // Include default material getter
 #include "Renderer/Materials/MaterialPBR.h"
 #include "Renderer/Shaders/Shader.h"
 #include "Renderer/Textures/Texture.h"
 #include "World/Actor.h"
 #include "World/Components/SceneComponent.h"
+#include <vector>
 
 namespace Engine {
 
+	namespace {
+		// Object-space views of an instanced depth draw, reused across draws (GL thread only)
+		std::vector<ClusterCullView> s_InstanceCulls;
+	} // namespace
+
 	// --- Constructors & Destructor ---
 
 	StaticMeshComponent::StaticMeshComponent(Actor *owner, Mesh *mesh)
@@ -30,7 +37,7 @@ namespace Engine {
 	}
 
 	StaticMeshComponent::StaticMeshComponent(Actor *owner, const std::string &objPath, std::shared_ptr<MaterialPBR> material)
-		: ActorComponent(owner), m_Mesh(nullptr), m_Model(std::make_unique<Model>(objPath)), m_Material(material ? material : GetDefaultMaterial()) {
+		: ActorComponent(owner), m_Mesh(nullptr), m_Model(ModelCache::Get().Stream(objPath)), m_Material(material ? material : GetDefaultMaterial()) {
 		// Use provided material or default if null.
 		// If the model loaded its own materials, they should ideally override this default.
 		// Consider adding logic here or in Model::Draw to prioritize Model's materials if they exist.
@@ -46,19 +53,46 @@ namespace Engine {
 
 	// --- Rendering Methods ---
 
-	void StaticMeshComponent::Render(Shader &shader, RenderMode mode) {
+	void StaticMeshComponent::ReportTextureUsage(const TextureResidency::View &view) const {
+		const glm::mat4 modelMatrix = GetOwner()->GetRootComponent()->GetWorldTransform();
+		if (m_Model) {
+			if (m_Model->IsReady())
+				m_Model->ReportTextureUsage(modelMatrix, view);
+		} else if (m_Mesh && m_Material) {
+			const float pixelsPerUV = TextureResidency::ComputePixelsPerUV(*m_Mesh, modelMatrix, view);
+			if (pixelsPerUV > 0.0f)
+				TextureResidency::Get().ReportMaterial(*m_Material, pixelsPerUV);
+		}
+	}
+
+	void StaticMeshComponent::SelectLod(const TextureResidency::View &view) {
+		// Primitive meshes have a single level
+		if (m_Model && m_Model->IsReady())
+			m_Lod = m_Model->SelectLod(GetOwner()->GetRootComponent()->GetWorldTransform(), view, m_Lod);
+	}
+
+	void StaticMeshComponent::Render(Shader &shader, RenderMode mode, const ClusterCullView *cull) {
 		// Get world transform from owner's root SceneComponent
 		const glm::mat4 modelMatrix = GetOwner()->GetRootComponent()->GetWorldTransform();
 		shader.SetUniformMat4("u_Model", modelMatrix);
 
+		// Meshlets are tested in object space
+		ClusterCullView objectCull;
+		if (cull)
+			objectCull = cull->ToObjectSpace(modelMatrix);
+		const ClusterCullView *meshCull = cull ? &objectCull : nullptr;
+
 		// --- Geometry Draw Call ---
 		if (m_Model) {
+			// Still streaming in: draw nothing
+			if (!m_Model->IsReady())
+				return;
 			// Wireframe mode only needs geometry
 			if (mode == RenderMode::Wireframe) {
-				m_Model->DrawGeometry(shader);
+				m_Model->DrawGeometry(shader, m_Lod, meshCull);
 			} else {
 				// PBR and Unlit modes use materials (Model::Draw handles its internal materials)
-				m_Model->Draw(shader);
+				m_Model->Draw(shader, m_Lod, meshCull);
 			}
 		} else if (m_Mesh) {
 			// --- Material & Texture Uniforms for Primitive Mesh ---
@@ -108,6 +142,14 @@ namespace Engine {
 					shader.SetUniformInt("u_HasAOMap", 0);
 					shader.SetUniformFloat("u_AO", m_Material->ao);
 				}
+				// Packed AO/Roughness/Metallic/Height (overrides the maps above per channel)
+				if (m_Material->hasPackedMap && m_Material->packedMap) {
+					m_Material->packedMap->Bind(11);
+					shader.SetUniformInt("u_PackedMap", 11);
+					shader.SetUniformInt("u_PackedChannels", m_Material->packedChannels);
+				} else {
+					shader.SetUniformInt("u_PackedChannels", 0);
+				}
 
 			} else if (mode == RenderMode::Unlit) {
 				// --- Unlit Uniforms ---
@@ -125,21 +167,47 @@ namespace Engine {
 			}
 
 			// Draw the mesh (common to all modes)
-			m_Mesh->Draw();
+			m_Mesh->Draw(0, meshCull);
 		}
 	}
 
-	void StaticMeshComponent::RenderDepth(Shader &depthShader) {
-		// Set model matrix for depth shader
-		const glm::mat4 modelMatrix = GetOwner()->GetRootComponent()->GetWorldTransform();
-		depthShader.SetUniformMat4("model", modelMatrix);
+	void StaticMeshComponent::RenderDepthInstanced(unsigned int instanceCount, const ClusterCullView *cull, const glm::mat4 *transforms) const {
+		// One object-space view per instance: a meshlet is drawn if any instance sees it
+		s_InstanceCulls.clear();
+		if (cull && transforms) {
+			for (unsigned int i = 0; i < instanceCount; ++i)
+				s_InstanceCulls.push_back(cull->ToObjectSpace(transforms[i]));
+		}
+		const ClusterCullView *meshCull = s_InstanceCulls.empty() ? nullptr : s_InstanceCulls.data();
 
-		// Draw geometry (no material needed)
+		// Draw geometry only (no material needed); transforms are read from the instance buffer
 		if (m_Model) {
-			m_Model->DrawGeometry(depthShader);
+			if (m_Model->IsReady())
+				m_Model->DrawGeometryInstanced(instanceCount, m_Lod, meshCull);
 		} else if (m_Mesh) {
-			m_Mesh->Draw();
+			m_Mesh->DrawInstanced(instanceCount, 0, meshCull);
+		}
+	}
+
+	const void *StaticMeshComponent::GetGeometryKey() const {
+		if (m_Model)
+			return m_Model.get();
+		return m_Mesh;
+	}
+
+	bool StaticMeshComponent::GetLocalBounds(glm::vec3 &center, float &radius) const {
+		if (m_Model) {
+			if (!m_Model->IsReady())
+				return false;
+			center = m_Model->GetBoundsCenter();
+			radius = m_Model->GetBoundsRadius();
+			return true;
 		}
+		if (!m_Mesh)
+			return false;
+		center = m_Mesh->GetBoundsCenter();
+		radius = m_Mesh->GetBoundsRadius();
+		return true;
 	}
 
 	void StaticMeshComponent::RenderGeometry(Shader &shader) {
@@ -161,7 +229,8 @@ namespace Engine {
 		shader.SetUniformInt("u_Material_HasAOMap", 0);
 
 		if (m_Model) {
-			m_Model->DrawGeometry(shader);
+			if (m_Model->IsReady())
+				m_Model->DrawGeometry(shader, m_Lod);
 		} else if (m_Mesh) {
 			m_Mesh->Draw();
 		}
@@ -6,7 +6,7 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/04/26 13:14:42 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/04/28 23:12:33 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2025/05/16 09:42:17 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -14,6 +14,7 @@
 
 #include "Core/Application.h"					// Include Application for RenderMode enum
 #include "Renderer/Materials/DefaultMaterial.h" // Include default material getter
+#include "Renderer/Textures/TextureResidency.h"
 #include "World/ActorComponent.h"
 #include <glm/glm.hpp>
 #include <memory>
@@ -23,6 +24,7 @@ namespace Engine {
 
 	class Actor;
 	class Mesh;
+	struct ClusterCullView;
 	class Model;
 	class Shader;
 	class MaterialPBR;
@@ -30,7 +32,7 @@ namespace Engine {
 	/**
 	 * @brief Component for rendering static meshes or models.
 	 *
-	 * - Can render a primitive Mesh (externally owned) or a loaded Model (owned).
+	 * - Can render a primitive Mesh (externally owned) or a loaded Model (shared through ModelCache).
 	 * - Always has a PBR material (defaults if none provided).
 	 */
 	class StaticMeshComponent : public ActorComponent {
@@ -43,7 +45,7 @@ namespace Engine {
 		StaticMeshComponent(Actor *owner, Mesh *mesh);
 
 		/**
-		 * @brief Construct with a loaded Model from file (ownership is internal).
+		 * @brief Construct with a Model loaded from file, shared with every component using the same file.
 		 * Uses the default material if `material` is nullptr.
 		 * @param owner Owning Actor.
 		 * @param objPath Path to model file (e.g. .obj).
@@ -58,14 +60,31 @@ namespace Engine {
 		 * @brief Render the mesh/model with the given shader and mode.
 		 * @param shader Shader to use for rendering.
 		 * @param mode The current rendering mode.
+		 * @param cull World-space view of the pass; meshes with meshlets skip the clusters it cannot see.
 		 */
-		void Render(Shader &shader, RenderMode mode);
+		void Render(Shader &shader, RenderMode mode, const ClusterCullView *cull = nullptr);
 
 		/**
-		 * @brief Render only depth (for shadow mapping, etc).
-		 * @param depthShader Shader for depth rendering.
+		 * @brief Draw only depth for several instances sharing this component's geometry.
+		 *        Transforms come from the instance buffer bound by World::RenderDepth.
+		 * @param instanceCount Number of instances to draw.
+		 * @param cull World-space view of the pass for meshlet culling (nullptr = no culling).
+		 * @param transforms World transform of each instance (required with `cull`).
 		 */
-		void RenderDepth(Shader &depthShader);
+		void RenderDepthInstanced(unsigned int instanceCount, const ClusterCullView *cull = nullptr, const glm::mat4 *transforms = nullptr) const;
+
+		/**
+		 * @brief Identifies the geometry drawn by this component (Model or Mesh).
+		 *        Components with the same key can be batched into one instanced draw.
+		 * @return Opaque key, or nullptr when there is nothing to draw.
+		 */
+		const void *GetGeometryKey() const;
+
+		/**
+		 * @brief Object-space bounding sphere of the drawn geometry (Model or Mesh).
+		 * @return False when there is nothing to draw yet (model still streaming).
+		 */
+		bool GetLocalBounds(glm::vec3 &center, float &radius) const;
 
 		/**
 		 * @brief Renders the geometry of the mesh/model without material setup.
@@ -74,6 +93,23 @@ namespace Engine {
 		 */
 		void RenderGeometry(Shader &shader);
 
+		/**
+		 * @brief Report the screen-space UV density of the drawn textures to TextureResidency.
+		 * @param view Camera of the frame (culled components report nothing).
+		 */
+		void ReportTextureUsage(const TextureResidency::View &view) const;
+
+		/**
+		 * @brief Choose the model's level of detail for this frame (used by every pass, shadows included).
+		 * @param view Camera of the frame.
+		 */
+		void SelectLod(const TextureResidency::View &view);
+
+		/**
+		 * @brief Level of detail drawn (0 = full detail).
+		 */
+		int GetLod() const { return m_Lod; }
+
 		/**
 		 * @brief Set the PBR material.
 		 * @param material Shared pointer to MaterialPBR.
@@ -82,8 +118,9 @@ namespace Engine {
 
 	private:
 		Mesh *m_Mesh = nullptr;					 ///< Non-owning pointer to primitive mesh.
-		std::unique_ptr<Model> m_Model;			 ///< Owning pointer to loaded model.
+		std::shared_ptr<Model> m_Model;			 ///< Streamed model (shared through ModelCache, empty until ready).
 		std::shared_ptr<MaterialPBR> m_Material; ///< Shared PBR material.
+		int m_Lod = 0;							 ///< Level of detail picked by SelectLod().
 	};
 
 } // namespace Engine
\ No newline at end of file
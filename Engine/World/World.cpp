@@ -6,13 +6,14 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/04/26 13:24:56 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/04/29 10:56:00 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2025/05/14 18:04:55 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "World/World.h"
 #include "Core/Application.h" // Include Application to check render mode (or pass shader pointer type)
 #include "Renderer/Camera.h"
+#include "Renderer/GPUResources/ShaderStorageBuffer.h"
 #include "Renderer/Shaders/Shader.h"
 #include "World/Actor.h"
 #include "World/Components/BillboardComponent.h" // Include BillboardComponent
@@ -22,6 +23,7 @@
 #include "World/Components/SpotLightComponent.h"
 #include "World/Components/StaticMeshComponent.h"
 #include <algorithm>
+#include <functional>
 #include <iostream>
 #include <vector>
 
@@ -61,55 +63,73 @@ namespace Engine {
 	 * @param mode The current rendering mode (Default, Unlit, Wireframe).
 	 */
 	void World::Render(Shader &shader, const glm::mat4 &viewMatrix, RenderMode mode) {
+		SetupLightUniforms(shader, mode);
+		RenderOpaque(shader, mode);
+		RenderBillboards(shader, viewMatrix, mode);
+	}
+
+	void World::SetupLightUniforms(Shader &shader, RenderMode mode) {
 		// --- Light Setup (Only for PBR/Default Mode) ---
-		if (mode == RenderMode::Default) {
-			int pointLightCount		   = 0;
-			int spotLightCount		   = 0;
-			const int MAX_POINT_LIGHTS = 4;
-			const int MAX_SPOT_LIGHTS  = 4;
-
-			for (const auto &actor : m_Actors) {
-				// Directional Light
-				if (auto dirLight = actor->GetComponent<DirectionalLightComponent>()) {
-					dirLight->SetupUniforms(shader, 0);
-				}
-				// Point Lights (excluding SpotLights)
-				if (auto pointLight = actor->GetComponent<PointLightComponent>()) {
-					if (!dynamic_cast<SpotLightComponent *>(pointLight) && pointLightCount < MAX_POINT_LIGHTS) {
-						pointLight->SetupUniforms(shader, pointLightCount++);
-					}
-				}
-				// Spot Lights
-				if (auto spotLight = actor->GetComponent<SpotLightComponent>()) {
-					if (spotLightCount < MAX_SPOT_LIGHTS) {
-						spotLight->SetupUniforms(shader, spotLightCount++);
-					}
-				}
-			}
-			shader.SetUniformInt("u_NumPointLights", pointLightCount);
-			shader.SetUniformInt("u_NumSpotLights", spotLightCount);
-			shader.SetUniformInt("u_HasDirLight", (int)(pointLightCount > 0));
-			shader.SetUniformInt("u_HasPointLight", (int)(pointLightCount > 0));
-			shader.SetUniformInt("u_HasSpotLight", (int)(spotLightCount > 0));
+		if (mode != RenderMode::Default)
+			return;
+
+		WorldLights lights = CollectLights();
+
+		// Directional Light
+		if (lights.directional) {
+			lights.directional->SetupUniforms(shader, 0);
+		}
+		// Point Lights (excluding SpotLights)
+		for (size_t i = 0; i < lights.points.size(); ++i) {
+			lights.points[i]->SetupUniforms(shader, static_cast<int>(i));
 		}
+		// Spot Lights
+		for (size_t i = 0; i < lights.spots.size(); ++i) {
+			lights.spots[i]->SetupUniforms(shader, static_cast<int>(i));
+		}
+		int pointLightCount = static_cast<int>(lights.points.size());
+		int spotLightCount	= static_cast<int>(lights.spots.size());
+		shader.SetUniformInt("u_NumPointLights", pointLightCount);
+		shader.SetUniformInt("u_NumSpotLights", spotLightCount);
+		shader.SetUniformInt("u_HasDirLight", (int)(pointLightCount > 0));
+		shader.SetUniformInt("u_HasPointLight", (int)(pointLightCount > 0));
+		shader.SetUniformInt("u_HasSpotLight", (int)(spotLightCount > 0));
+	}
 
-		// --- Render Static Meshes & Collect Billboards ---
-		std::vector<BillboardComponent *> billboards;
+	void World::RenderOpaque(Shader &shader, RenderMode mode, const ClusterCullView *cull) {
 		for (const auto &actor : m_Actors) {
-			// Render Meshes
 			auto meshComp = actor->GetComponent<StaticMeshComponent>();
 			if (meshComp) {
-				meshComp->Render(shader, mode); // Pass shader and mode
+				meshComp->Render(shader, mode, cull); // Pass shader and mode
 			}
-			// Collect Billboards
-			auto actorBillboards = actor->GetComponentsByClass<BillboardComponent>();
-			billboards.insert(billboards.end(), actorBillboards.begin(), actorBillboards.end());
 		}
+	}
 
-		// --- Render Billboards ---
+	void World::ReportTextureUsage(const glm::mat4 &viewMatrix, const glm::mat4 &projection, int viewportHeight) const {
+		const TextureResidency::View view = TextureResidency::View::FromCamera(viewMatrix, projection, viewportHeight);
+		for (const auto &actor : m_Actors) {
+			auto meshComp = actor->GetComponent<StaticMeshComponent>();
+			if (meshComp)
+				meshComp->ReportTextureUsage(view);
+		}
+	}
+
+	void World::SelectLods(const glm::mat4 &viewMatrix, const glm::mat4 &projection, int viewportHeight) {
+		const TextureResidency::View view = TextureResidency::View::FromCamera(viewMatrix, projection, viewportHeight);
+		for (const auto &actor : m_Actors) {
+			auto meshComp = actor->GetComponent<StaticMeshComponent>();
+			if (meshComp)
+				meshComp->SelectLod(view);
+		}
+	}
+
+	void World::RenderBillboards(Shader &shader, const glm::mat4 &viewMatrix, RenderMode mode) {
 		// Don't render billboards in wireframe mode
-		if (mode != RenderMode::Wireframe) {
-			for (BillboardComponent *billboard : billboards) {
+		if (mode == RenderMode::Wireframe)
+			return;
+
+		for (const auto &actor : m_Actors) {
+			for (BillboardComponent *billboard : actor->GetComponentsByClass<BillboardComponent>()) {
 				if (billboard) {
 					billboard->Render(shader, viewMatrix, mode); // Pass shader, view matrix, and mode
 				}
@@ -117,21 +137,100 @@ namespace Engine {
 		}
 	}
 
+	/**
+	 * @brief Lays down scene depth so the expensive forward shader only runs on visible fragments.
+	 * @param prepassShader The depth prepass shader.
+	 *
+	 * u_Model is set exactly as in StaticMeshComponent::Render so both passes produce the same
+	 * (invariant) depth and the colour pass can use GL_EQUAL with depth writes off.
+	 */
+	void World::RenderDepthPrepass(Shader &prepassShader, const ClusterCullView *cull) {
+		for (const auto &actor : m_Actors) {
+			auto meshComp = actor->GetComponent<StaticMeshComponent>();
+			if (meshComp) {
+				const glm::mat4 transform = actor->GetRootComponent()->GetWorldTransform();
+				prepassShader.SetUniformMat4("u_Model", transform);
+				meshComp->RenderDepthInstanced(1, cull, &transform);
+			}
+		}
+	}
+
 	/**
 	 * @brief Renders depth information for all static meshes (for shadow mapping).
-	 * @param depthShader The shader used for depth rendering.
+	 * @param depthShader The layered depth shader used for depth rendering.
 	 *
-	 * Sets the model matrix uniform for each mesh before rendering.
+	 * Groups casters by geometry and issues one instanced draw per group. Transforms are
+	 * uploaded once per call to the instance buffer and indexed with u_InstanceOffset + gl_InstanceID.
 	 */
-	void World::RenderDepth(Shader &depthShader) {
+	void World::RenderDepth(Shader &depthShader, const ClusterCullView *cull) {
+		// Gather casters and sort them so those sharing geometry are contiguous
+		m_DepthInstances.clear();
 		for (auto &actor : m_Actors) {
 			auto meshComp = actor->GetComponent<StaticMeshComponent>();
-			if (meshComp) {
-				// Set the model matrix for the current actor
-				depthShader.SetUniformMat4("model", actor->GetRootComponent()->GetWorldTransform());
-				meshComp->RenderDepth(depthShader);
+			if (meshComp && meshComp->GetGeometryKey()) {
+				m_DepthInstances.push_back({meshComp->GetGeometryKey(), meshComp->GetLod(), meshComp, actor->GetRootComponent()->GetWorldTransform()});
+			}
+		}
+		if (m_DepthInstances.empty())
+			return;
+
+		std::stable_sort(m_DepthInstances.begin(), m_DepthInstances.end(), [](const DepthInstance &a, const DepthInstance &b) {
+			if (a.geometry != b.geometry)
+				return std::less<const void *>()(a.geometry, b.geometry);
+			return a.lod < b.lod;
+		});
+
+		// Upload transforms in batch order
+		m_DepthTransforms.clear();
+		for (const DepthInstance &instance : m_DepthInstances) {
+			m_DepthTransforms.push_back(instance.transform);
+		}
+		const unsigned int bytes = static_cast<unsigned int>(m_DepthTransforms.size() * sizeof(glm::mat4));
+		if (!m_InstanceBuffer) {
+			m_InstanceBuffer = std::make_unique<ShaderStorageBuffer>(bytes, INSTANCE_BUFFER_BINDING);
+		}
+		m_InstanceBuffer->SetData(bytes, m_DepthTransforms.data());
+
+		// One instanced draw per geometry group
+		size_t first = 0;
+		while (first < m_DepthInstances.size()) {
+			size_t last = first + 1;
+			while (last < m_DepthInstances.size() && m_DepthInstances[last].geometry == m_DepthInstances[first].geometry &&
+				   m_DepthInstances[last].lod == m_DepthInstances[first].lod) {
+				++last;
+			}
+			depthShader.SetUniformInt("u_InstanceOffset", static_cast<int>(first));
+			m_DepthInstances[first].component->RenderDepthInstanced(static_cast<unsigned int>(last - first), cull, m_DepthTransforms.data() + first);
+			first = last;
+		}
+	}
+
+	/**
+	 * @brief Collects the shading lights in actor order.
+	 *
+	 * Point lights exclude spot lights (which derive from PointLightComponent), and both
+	 * lists are capped to the shader array sizes. Shadow passes rely on this order to
+	 * line up per-light shadow data with the light uniform slots.
+	 */
+	WorldLights World::CollectLights() const {
+		WorldLights lights;
+		for (const auto &actor : m_Actors) {
+			if (auto dirLight = actor->GetComponent<DirectionalLightComponent>()) {
+				if (!lights.directional)
+					lights.directional = dirLight;
+			}
+			if (auto pointLight = actor->GetComponent<PointLightComponent>()) {
+				if (!dynamic_cast<SpotLightComponent *>(pointLight) && (int)lights.points.size() < MAX_POINT_LIGHTS) {
+					lights.points.push_back(pointLight);
+				}
+			}
+			if (auto spotLight = actor->GetComponent<SpotLightComponent>()) {
+				if ((int)lights.spots.size() < MAX_SPOT_LIGHTS) {
+					lights.spots.push_back(spotLight);
+				}
 			}
 		}
+		return lights;
 	}
 
 	/**
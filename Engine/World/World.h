@@ -6,7 +6,7 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/04/26 13:15:18 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/04/28 11:27:31 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2025/05/14 18:04:55 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -23,6 +23,21 @@ namespace Engine {
 	class Actor;
 	class Shader;
 	class Camera;
+	class DirectionalLightComponent;
+	class PointLightComponent;
+	class SpotLightComponent;
+	class StaticMeshComponent;
+	class ShaderStorageBuffer;
+	struct ClusterCullView;
+
+	/**
+	 * @brief Lights gathered from the world, in the order their shader array slots are assigned.
+	 */
+	struct WorldLights {
+		DirectionalLightComponent *directional = nullptr; ///< First directional light found (sun).
+		std::vector<PointLightComponent *> points;		  ///< Point lights (spot lights excluded), capped to MAX_POINT_LIGHTS.
+		std::vector<SpotLightComponent *> spots;		  ///< Spot lights, capped to MAX_SPOT_LIGHTS.
+	};
 
 	class World {
 	public:
@@ -43,15 +58,95 @@ namespace Engine {
 		 */
 		void Render(Shader &shader, const glm::mat4 &viewMatrix, RenderMode mode);
 
-		// Render depth for shadow mapping
-		void RenderDepth(Shader &depthShader);
+		/**
+		 * @brief Sets the light uniforms of the forward shader (Default mode only).
+		 * @param shader The forward shading shader.
+		 * @param mode The current rendering mode.
+		 */
+		void SetupLightUniforms(Shader &shader, RenderMode mode);
+
+		/**
+		 * @brief Renders the static meshes (opaque geometry) with their materials.
+		 * @param shader The shader selected based on the render mode.
+		 * @param mode The current rendering mode.
+		 * @param cull Camera view for meshlet culling (nullptr = draw every meshlet).
+		 */
+		void RenderOpaque(Shader &shader, RenderMode mode, const ClusterCullView *cull = nullptr);
+
+		/**
+		 * @brief Renders billboards (skipped in wireframe mode).
+		 * @param shader The shader selected based on the render mode.
+		 * @param viewMatrix The current camera view matrix.
+		 * @param mode The current rendering mode.
+		 */
+		void RenderBillboards(Shader &shader, const glm::mat4 &viewMatrix, RenderMode mode);
+
+		/**
+		 * @brief Reports the texture density of every visible static mesh to TextureResidency.
+		 * @param viewMatrix Camera view matrix.
+		 * @param projection Camera projection matrix.
+		 * @param viewportHeight Height of the render target in pixels.
+		 */
+		void ReportTextureUsage(const glm::mat4 &viewMatrix, const glm::mat4 &projection, int viewportHeight) const;
+
+		/**
+		 * @brief Picks the level of detail of every static mesh for this frame's passes.
+		 * @param viewMatrix Camera view matrix.
+		 * @param projection Camera projection matrix.
+		 * @param viewportHeight Height of the render target in pixels.
+		 */
+		void SelectLods(const glm::mat4 &viewMatrix, const glm::mat4 &projection, int viewportHeight);
+
+		/**
+		 * @brief Depth-only prepass over the static meshes.
+		 * @param prepassShader Minimal shader (depth_prepass.vert + depth.frag) with an
+		 *        invariant gl_Position, so RenderOpaque() can follow with GL_EQUAL.
+		 * @param cull Must match the view given to RenderOpaque() so both passes draw the same meshlets.
+		 */
+		void RenderDepthPrepass(Shader &prepassShader, const ClusterCullView *cull = nullptr);
+
+		/**
+		 * @brief Renders depth for all static meshes (for shadow mapping).
+		 * @param depthShader The layered depth shader (depth.vert/.geom/.frag).
+		 *
+		 * Casters sharing a Mesh/Model and level of detail are grouped into one instanced draw; their transforms
+		 * are read from an instance buffer, so no per-object uniform is set. The caller sets
+		 * "lightSpaceMatrices[i]", "u_ViewCount" and one viewport per view, and every draw
+		 * writes all views at once.
+		 * @param cull View covering every layer written, for meshlet culling (nullptr = draw every meshlet).
+		 */
+		void RenderDepth(Shader &depthShader, const ClusterCullView *cull = nullptr);
+
+		/**
+		 * @brief Collects the lights used for shading, matching the slot order of the light uniform arrays.
+		 * @return Directional, point and spot lights (index i maps to shader slot i).
+		 */
+		WorldLights CollectLights() const;
+
+		static constexpr int MAX_POINT_LIGHTS = 4; ///< Must match MAX_POINT_LIGHTS in lighting.glsl.
+		static constexpr int MAX_SPOT_LIGHTS  = 4; ///< Must match MAX_SPOT_LIGHTS in lighting.glsl.
 
 		// Getters
 		const std::vector<std::unique_ptr<Actor>> &GetActors() const;
 
+		static constexpr unsigned int INSTANCE_BUFFER_BINDING = 1; ///< SSBO binding of per-instance transforms.
+
 	private:
+		/// Shadow caster gathered for instanced depth rendering.
+		struct DepthInstance {
+			const void *geometry;				 ///< Mesh/Model shared by the batch.
+			int lod;							 ///< Level of detail shared by the batch.
+			const StaticMeshComponent *component; ///< Component used to issue the draw.
+			glm::mat4 transform;				 ///< World transform of the caster.
+		};
+
 		std::vector<std::unique_ptr<Actor>> m_Actors;
 		uint32_t m_NextID;
+
+		// Scratch storage reused across depth passes
+		std::vector<DepthInstance> m_DepthInstances;
+		std::vector<glm::mat4> m_DepthTransforms;
+		std::unique_ptr<ShaderStorageBuffer> m_InstanceBuffer;
 	};
 
 } // namespace Engine
\ No newline at end of file
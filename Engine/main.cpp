@@ -6,15 +6,30 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/04/26 11:19:17 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/04/27 12:13:30 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2025/05/13 10:47:22 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "Core/Application.h"
 #include "Core/Reflection/ReflectionRegistry.h"
+#include "Renderer/Geometry/Model.h"
+#include "Renderer/Textures/TextureCooker.h"
+#include <cstring>
 #include <iostream>
 
-int main() {
+int main(int argc, char **argv) {
+	// Asset cooking: compress textures offline, no window needed
+	if (argc > 1 && std::strcmp(argv[1], "--cook") == 0)
+		return Engine::TextureCooker::RunCommandLine(argc - 2, argv + 2);
+
+	// Model cooking: write '.vmesh' files so runtime loads skip Assimp
+	if (argc > 1 && std::strcmp(argv[1], "--cook-models") == 0) {
+		int failed = 0;
+		for (int i = 2; i < argc; ++i)
+			failed += Engine::Model::Cook(argv[i]) ? 0 : 1;
+		return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+	}
+
 	// Initialize Reflection System (Register basic types)
 	Engine::Reflection::RegisterBasicTypes();
 
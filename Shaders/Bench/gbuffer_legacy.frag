@@ -0,0 +1,24 @@
+#version 450 core
+
+// Previous G-buffer layout (3x RGBA16F + RGBA8), kept for Bench/GBufferBench only.
+// The fourth attachment was never written.
+layout (location = 0) out vec4 gPositionMetallic; // World Pos (xyz), Metallic (w)
+layout (location = 1) out vec4 gNormalRoughness;  // World Normal (xyz), Roughness (w)
+layout (location = 2) out vec4 gAlbedoAO;         // Albedo Color (rgb), AO (a)
+
+in VS_OUT {
+	vec3 FragPos;
+	vec3 Normal;
+	vec2 TexCoords;
+} fs_in;
+
+uniform vec3  u_Material_AlbedoColor;
+uniform float u_Material_Metallic;
+uniform float u_Material_Roughness;
+uniform float u_Material_AO;
+
+void main() {
+	gPositionMetallic = vec4(fs_in.FragPos, u_Material_Metallic);
+	gNormalRoughness = vec4(normalize(fs_in.Normal), u_Material_Roughness);
+	gAlbedoAO = vec4(u_Material_AlbedoColor, u_Material_AO);
+}
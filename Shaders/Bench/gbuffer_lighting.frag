@@ -0,0 +1,70 @@
+#version 450 core
+
+// Lighting pass of Bench/GBufferBench: reads either G-buffer layout, then shades every pixel
+// with the same directional Cook-Torrance term, so only the G-buffer reads differ.
+in vec2 TexCoords;
+out vec4 FragColor;
+
+uniform bool u_LegacyLayout;
+
+// Compact layout (Application::CreateGBuffer)
+uniform sampler2D gAlbedoAO;          // Albedo (rgb), AO (a); also attachment 2 of the legacy layout
+uniform sampler2D gNormal;            // Octahedral world normal in [0, 1]
+uniform sampler2D gMetallicRoughness; // Metallic (r), Roughness (g)
+uniform sampler2D gDepth;             // Depth, for position reconstruction
+uniform mat4 u_InvViewProjection;
+
+// Legacy layout
+uniform sampler2D gPositionMetallic; // World Pos (xyz), Metallic (w)
+uniform sampler2D gNormalRoughness;  // World Normal (xyz), Roughness (w)
+
+uniform vec3 u_ViewPos;
+uniform vec3 u_LightDir; // Direction towards the light (world space, normalized)
+
+#include "../Core/Common/packing.glsl"
+
+const float PI = 3.14159265359;
+
+void main() {
+	ivec2 texel = ivec2(gl_FragCoord.xy);
+	vec3 fragPos;
+	vec3 N;
+	float metallic;
+	float roughness;
+	if (u_LegacyLayout) {
+		vec4 positionMetallic = texelFetch(gPositionMetallic, texel, 0);
+		vec4 normalRoughness = texelFetch(gNormalRoughness, texel, 0);
+		fragPos = positionMetallic.xyz;
+		metallic = positionMetallic.w;
+		N = normalize(normalRoughness.xyz);
+		roughness = normalRoughness.w;
+	} else {
+		float depth = texelFetch(gDepth, texel, 0).r;
+		if (depth >= 1.0) {
+			FragColor = vec4(0.0, 0.0, 0.0, 1.0);
+			return;
+		}
+		fragPos = ReconstructWorldPosition(TexCoords, depth, u_InvViewProjection);
+		N = OctDecode(texelFetch(gNormal, texel, 0).rg * 2.0 - 1.0);
+		vec2 metalRough = texelFetch(gMetallicRoughness, texel, 0).rg;
+		metallic = metalRough.r;
+		roughness = metalRough.g;
+	}
+	vec4 albedoAO = texelFetch(gAlbedoAO, texel, 0);
+
+	vec3 V = normalize(u_ViewPos - fragPos);
+	vec3 L = u_LightDir;
+	vec3 H = normalize(V + L);
+	float NdotL = max(dot(N, L), 0.0);
+	float NdotV = max(dot(N, V), 1e-4);
+	float a2 = pow(roughness * roughness, 2.0);
+	float NdotH = max(dot(N, H), 0.0);
+	float D = a2 / max(PI * pow(NdotH * NdotH * (a2 - 1.0) + 1.0, 2.0), 1e-7);
+	float k = pow(roughness + 1.0, 2.0) / 8.0;
+	float G = NdotV / (NdotV * (1.0 - k) + k) * NdotL / (NdotL * (1.0 - k) + k);
+	vec3 F0 = mix(vec3(0.04), albedoAO.rgb, metallic);
+	vec3 F = F0 + (1.0 - F0) * pow(1.0 - max(dot(H, V), 0.0), 5.0);
+	vec3 kD = (1.0 - F) * (1.0 - metallic);
+	vec3 color = (kD * albedoAO.rgb / PI + D * G * F / (4.0 * NdotV * NdotL + 1e-4)) * NdotL;
+	FragColor = vec4(color + 0.03 * albedoAO.rgb * albedoAO.a, 1.0);
+}
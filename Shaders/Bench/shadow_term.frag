@@ -0,0 +1,92 @@
+#version 450 core
+
+// Directional shadow term only (Bench/ShadowFilterBench): the world position is rebuilt from
+// the camera depth and CalculateShadow() is written out, without any lighting around it.
+// u_Reference switches to a dense, noise-free PCSS used as ground truth by the quality metric.
+in vec2 TexCoords;
+out float ShadowTerm;
+
+uniform sampler2D u_SceneDepth;      // Camera depth buffer
+uniform mat4 u_InvViewProjection;    // inverse(projection * view)
+uniform vec3 u_ViewPos;              // Camera position in world space
+uniform vec3 u_LightDir;             // Direction towards the light (world space, normalized)
+uniform bool u_Reference;
+
+uniform sampler2DShadow shadowMap;
+uniform sampler2D u_ShadowDepthMap;
+uniform sampler2D u_ShadowMoments;
+uniform int u_ShadowFilterMode;
+uniform float u_ShadowLightSize;
+uniform mat4 lightSpaceMatrix;
+
+#include "../Core/Common/packing.glsl"
+#include "../Core/Common/shadow.glsl"
+
+// PCSS with every texel of the blocker search region and of the penumbra kernel
+// (same bias and penumbra estimate as ShadowPCSS, no Poisson noise).
+float ShadowReference(vec4 fragPosLightSpace, vec3 normal, vec3 lightDir) {
+	vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w * 0.5 + 0.5;
+	if (projCoords.z > 1.0) {
+		return 1.0;
+	}
+	float bias = max(0.05 * (1.0 - dot(normal, lightDir)), 0.005);
+	float receiver = projCoords.z - bias;
+	vec2 texelSize = 1.0 / vec2(textureSize(shadowMap, 0));
+
+	// 1. Blocker search over the whole light-size disk
+	int searchTexels = int(ceil(u_ShadowLightSize / texelSize.x));
+	float blockerSum = 0.0;
+	float blockerCount = 0.0;
+	for (int y = -searchTexels; y <= searchTexels; ++y) {
+		for (int x = -searchTexels; x <= searchTexels; ++x) {
+			vec2 offset = vec2(x, y) * texelSize;
+			if (length(offset) > u_ShadowLightSize) continue;
+			float depth = texture(u_ShadowDepthMap, projCoords.xy + offset).r;
+			if (depth < receiver) {
+				blockerSum += depth;
+				blockerCount += 1.0;
+			}
+		}
+	}
+	if (blockerCount == 0.0) {
+		return 1.0;
+	}
+	float avgBlocker = blockerSum / blockerCount;
+	float penumbra = u_ShadowLightSize * (projCoords.z - avgBlocker) / max(avgBlocker, 1e-3);
+	penumbra = clamp(penumbra, texelSize.x, u_ShadowLightSize * 4.0);
+
+	// 2. One comparison per texel of the penumbra disk
+	int kernelTexels = int(ceil(penumbra / texelSize.x));
+	float lit = 0.0;
+	float taps = 0.0;
+	for (int y = -kernelTexels; y <= kernelTexels; ++y) {
+		for (int x = -kernelTexels; x <= kernelTexels; ++x) {
+			vec2 offset = vec2(x, y) * texelSize;
+			if (length(offset) > penumbra) continue;
+			lit += texture(shadowMap, vec3(projCoords.xy + offset, receiver));
+			taps += 1.0;
+		}
+	}
+	return lit / taps;
+}
+
+void main() {
+	float depth = texelFetch(u_SceneDepth, ivec2(gl_FragCoord.xy), 0).r;
+	vec3 fragPos = ReconstructWorldPosition(TexCoords, depth, u_InvViewProjection);
+
+	// Geometric normal from screen-space derivatives (taken before any branch), facing the camera
+	vec3 normal = normalize(cross(dFdx(fragPos), dFdy(fragPos)));
+	normal = faceforward(normal, fragPos - u_ViewPos, normal);
+
+	if (depth >= 1.0) {
+		ShadowTerm = 1.0; // Background, excluded from the metric
+		return;
+	}
+	vec4 fragPosLightSpace = lightSpaceMatrix * vec4(fragPos, 1.0);
+	if (u_Reference) {
+		ShadowTerm = ShadowReference(fragPosLightSpace, normal, u_LightDir);
+	} else {
+		ShadowTerm = CalculateShadow(u_ShadowFilterMode, shadowMap, u_ShadowDepthMap, u_ShadowMoments,
+									 fragPosLightSpace, normal, u_LightDir, u_ShadowLightSize);
+	}
+}
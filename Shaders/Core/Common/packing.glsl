@@ -0,0 +1,40 @@
+#ifndef PACKING_GLSL
+#define PACKING_GLSL
+
+// ============================================================================
+// OCTAHEDRAL NORMAL ENCODING
+// ============================================================================
+// Maps a unit vector onto the faces of an octahedron unfolded into [-1, 1]^2.
+// Two 16-bit channels keep the angular error well below what lighting can show.
+
+vec2 OctWrap(vec2 v) {
+	return (1.0 - abs(v.yx)) * vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+}
+
+// Unit vector -> [-1, 1]^2
+vec2 OctEncode(vec3 n) {
+	n /= (abs(n.x) + abs(n.y) + abs(n.z));
+	n.xy = n.z >= 0.0 ? n.xy : OctWrap(n.xy);
+	return n.xy;
+}
+
+// [-1, 1]^2 -> unit vector
+vec3 OctDecode(vec2 f) {
+	vec3 n = vec3(f.x, f.y, 1.0 - abs(f.x) - abs(f.y));
+	float t = clamp(-n.z, 0.0, 1.0);
+	n.x += n.x >= 0.0 ? -t : t;
+	n.y += n.y >= 0.0 ? -t : t;
+	return normalize(n);
+}
+
+// ============================================================================
+// DEPTH -> POSITION
+// ============================================================================
+// Reconstructs the world-space position from a [0, 1] depth buffer value.
+vec3 ReconstructWorldPosition(vec2 uv, float depth, mat4 invViewProjection) {
+	vec4 ndc = vec4(uv * 2.0 - 1.0, depth * 2.0 - 1.0, 1.0);
+	vec4 world = invViewProjection * ndc;
+	return world.xyz / world.w;
+}
+
+#endif // PACKING_GLSL
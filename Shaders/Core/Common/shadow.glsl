@@ -4,65 +4,208 @@
 // ============================================================================
 // REQUIRED UNIFORMS & INPUTS (Must be provided by the including shader)
 // ============================================================================
-// uniform sampler2D shadowMap; // Sampler for the shadow map texture.
-// in vec4 FragPosLightSpace;   // Fragment position transformed by the light's view-projection matrix.
-// in vec3 Normal;              // World-space surface normal.
-// uniform vec3 u_LightDir;    // Direction *towards* the light source (needed for bias).
-// uniform vec3 u_ViewPos;     // Camera position (optional, potentially useful for other bias methods).
+// uniform sampler2DShadow shadowMap;   // Shadow map with GL_COMPARE_REF_TO_TEXTURE (hardware PCF).
+// uniform sampler2D u_ShadowDepthMap;  // Same depth texture read raw (PCSS blocker search).
+// uniform sampler2D u_ShadowMoments;   // Mipmapped EVSM moments (EVSM mode only).
+// uniform int u_ShadowFilterMode;      // One of SHADOW_FILTER_* below.
+// uniform float u_ShadowLightSize;     // PCSS light size, in shadow map UV units.
+// in vec4 FragPosLightSpace;           // Fragment position transformed by the light's view-projection matrix.
 
 // ============================================================================
 // CONSTANTS
 // ============================================================================
-// const float EPSILON = 1e-5; // Small value, potentially useful for bias calculations.
+// Filter modes (must match Engine::ShadowFilterMode)
+#define SHADOW_FILTER_HARDWARE_PCF 0
+#define SHADOW_FILTER_POISSON_PCF 1
+#define SHADOW_FILTER_PCSS 2
+#define SHADOW_FILTER_EVSM 3
+
+// EVSM warp exponents (safe range for RGBA32F moments)
+const float EVSM_POSITIVE_EXPONENT = 40.0;
+const float EVSM_NEGATIVE_EXPONENT = 5.0;
+
+const vec2 POISSON_DISK[16] = vec2[](
+	vec2(-0.94201624, -0.39906216), vec2(0.94558609, -0.76890725),
+	vec2(-0.09418410, -0.92938870), vec2(0.34495938, 0.29387760),
+	vec2(-0.91588581, 0.45771432), vec2(-0.81544232, -0.87912464),
+	vec2(-0.38277543, 0.27676845), vec2(0.97484398, 0.75648379),
+	vec2(0.44323325, -0.97511554), vec2(0.53742981, -0.47373420),
+	vec2(-0.26496911, -0.41893023), vec2(0.79197514, 0.19090188),
+	vec2(-0.24188840, 0.99706507), vec2(-0.81409955, 0.91437590),
+	vec2(0.19984126, 0.78641367), vec2(0.14383161, -0.14100790));
+
+// ============================================================================
+// FILTER KERNELS (Directional Light)
+// ============================================================================
+// All kernels return 1.0 for fully lit fragments, 0.0 for fully shadowed fragments.
+
+// Per-pixel rotation of the Poisson disk (interleaved gradient noise): trades banding for fine noise.
+mat2 ShadowKernelRotation(vec2 fragCoord) {
+	float angle = 6.28318530718 * fract(52.9829189 * fract(dot(fragCoord, vec2(0.06711056, 0.00583715))));
+	float s = sin(angle);
+	float c = cos(angle);
+	return mat2(c, s, -s, c);
+}
+
+// Four bilinear comparison taps at half-texel offsets cover a 3x3 texel tent
+// (16 depth compares for the price of 4 fetches).
+float ShadowHardwarePCF(sampler2DShadow shadowSampler, vec3 projCoords, float bias) {
+	vec2 texelSize = 1.0 / vec2(textureSize(shadowSampler, 0));
+	float ref = projCoords.z - bias;
+	float lit = 0.0;
+	lit += texture(shadowSampler, vec3(projCoords.xy + vec2(-0.5, -0.5) * texelSize, ref));
+	lit += texture(shadowSampler, vec3(projCoords.xy + vec2(0.5, -0.5) * texelSize, ref));
+	lit += texture(shadowSampler, vec3(projCoords.xy + vec2(-0.5, 0.5) * texelSize, ref));
+	lit += texture(shadowSampler, vec3(projCoords.xy + vec2(0.5, 0.5) * texelSize, ref));
+	return lit * 0.25;
+}
+
+// 16 rotated Poisson-disk comparison taps within `radius` (UV units).
+float ShadowPoissonPCF(sampler2DShadow shadowSampler, vec3 projCoords, float bias, float radius, mat2 rotation) {
+	float ref = projCoords.z - bias;
+	float lit = 0.0;
+	for (int i = 0; i < 16; ++i) {
+		vec2 offset = rotation * POISSON_DISK[i] * radius;
+		lit += texture(shadowSampler, vec3(projCoords.xy + offset, ref));
+	}
+	return lit / 16.0;
+}
+
+// Percentage-closer soft shadows: blocker search on raw depth, then a PCF kernel
+// whose width grows with the receiver/blocker distance (contact hardening).
+float ShadowPCSS(sampler2DShadow shadowSampler, sampler2D depthSampler, vec3 projCoords, float bias, float lightSize, mat2 rotation) {
+	// 1. Blocker search
+	float receiver = projCoords.z - bias;
+	float blockerSum = 0.0;
+	float blockerCount = 0.0;
+	for (int i = 0; i < 16; ++i) {
+		float depth = texture(depthSampler, projCoords.xy + rotation * POISSON_DISK[i] * lightSize).r;
+		if (depth < receiver) {
+			blockerSum += depth;
+			blockerCount += 1.0;
+		}
+	}
+	if (blockerCount == 0.0) {
+		return 1.0; // No occluder in the search region
+	}
+	float avgBlocker = blockerSum / blockerCount;
+
+	// 2. Penumbra estimate (similar triangles between light, blocker and receiver)
+	vec2 texelSize = 1.0 / vec2(textureSize(shadowSampler, 0));
+	float penumbra = lightSize * (projCoords.z - avgBlocker) / max(avgBlocker, 1e-3);
+	penumbra = clamp(penumbra, texelSize.x, lightSize * 4.0);
+
+	// 3. Filter
+	return ShadowPoissonPCF(shadowSampler, projCoords, bias, penumbra, rotation);
+}
+
+// One-tailed Chebyshev bound with light-bleeding reduction.
+float ChebyshevUpperBound(vec2 moments, float t, float minVariance) {
+	if (t <= moments.x) {
+		return 1.0;
+	}
+	float variance = max(moments.y - moments.x * moments.x, minVariance);
+	float d = t - moments.x;
+	float pMax = variance / (variance + d * d);
+	return clamp((pMax - 0.2) / 0.8, 0.0, 1.0);
+}
+
+// Exponential variance shadow map: the moments are prefiltered by their mip chain,
+// so a single trilinear fetch replaces the whole PCF kernel.
+float ShadowEVSM(sampler2D momentsSampler, vec3 projCoords) {
+	vec4 moments = texture(momentsSampler, projCoords.xy);
+	float depth = projCoords.z * 2.0 - 1.0;
+	float positive = exp(EVSM_POSITIVE_EXPONENT * depth);
+	float negative = -exp(-EVSM_NEGATIVE_EXPONENT * depth);
+
+	float positiveMinVariance = 1e-4 * EVSM_POSITIVE_EXPONENT * positive * positive;
+	float negativeMinVariance = 1e-4 * EVSM_NEGATIVE_EXPONENT * negative * negative;
+	float litPositive = ChebyshevUpperBound(moments.xy, positive, positiveMinVariance);
+	float litNegative = ChebyshevUpperBound(moments.zw, negative, negativeMinVariance);
+	return min(litPositive, litNegative);
+}
 
 // ============================================================================
-// SHADOW CALCULATION (Directional Light, Basic PCF)
+// SHADOW CALCULATION (Directional Light)
 // ============================================================================
-// Calculates the shadow attenuation factor using simple Percentage-Closer Filtering (PCF).
+// Calculates the shadow attenuation factor with the selected filter mode.
 // Returns 1.0 for fully lit fragments, 0.0 for fully shadowed fragments.
-float CalculateShadow(sampler2D shadowMapSampler, vec4 fragPosLightSpace, vec3 normal, vec3 lightDir) {
-	// Perform perspective divide to get Normalized Device Coordinates (NDC) [-1, 1].
+float CalculateShadow(int filterMode, sampler2DShadow shadowSampler, sampler2D depthSampler, sampler2D momentsSampler,
+					  vec4 fragPosLightSpace, vec3 normal, vec3 lightDir, float lightSize) {
+	// Perspective divide to NDC [-1, 1], then map to texture coordinates [0, 1].
 	vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w;
-
-	// Map NDC to texture coordinates [0, 1] for sampling the shadow map.
 	projCoords = projCoords * 0.5 + 0.5;
 
 	// Fragments outside the light's view frustum (far plane) are considered not shadowed.
-	// Check the depth component (z) before sampling.
 	if (projCoords.z > 1.0) {
-		return 1.0; // Not shadowed.
+		return 1.0;
 	}
 
-	// Calculate shadow bias to prevent "shadow acne" (self-shadowing artifacts).
-	// Slope-scale bias: increases bias for surfaces nearly parallel to the light direction.
-	// Clamps to a minimum bias value.
+	// Slope-scale bias against shadow acne (unused by EVSM, which does not self-shadow).
 	float bias = max(0.05 * (1.0 - dot(normal, lightDir)), 0.005);
-	// Alternative: Fixed bias (simpler but less robust)
-	// float bias = 0.005;
-
-	// --- Percentage-Closer Filtering (PCF) ---
-	// Sample the shadow map multiple times in a small neighborhood and average the results.
-	float shadowFactor = 0.0; // Accumulator for shadow contribution (0 = lit, 1 = shadowed).
-	vec2 texelSize = 1.0 / textureSize(shadowMapSampler, 0); // Calculate the size of a single texel.
-
-	// Sample a 3x3 neighborhood around the projected coordinates.
-	for (int x = -1; x <= 1; ++x) {
-		for (int y = -1; y <= 1; ++y) {
-			// Calculate sample coordinates for the current tap.
-			vec2 sampleCoords = projCoords.xy + vec2(x, y) * texelSize;
-			// Sample the depth stored in the shadow map at the tap location.
-			float pcfDepth = texture(shadowMapSampler, sampleCoords).r;
-			// Compare the current fragment's depth (with bias applied) to the sampled depth.
-			// If the fragment is further from the light than the stored depth, it's shadowed for this tap.
-			shadowFactor += (projCoords.z - bias) > pcfDepth ? 1.0 : 0.0;
-		}
+
+	if (filterMode == SHADOW_FILTER_EVSM) {
+		return ShadowEVSM(momentsSampler, projCoords);
+	}
+	if (filterMode == SHADOW_FILTER_POISSON_PCF) {
+		vec2 texelSize = 1.0 / vec2(textureSize(shadowSampler, 0));
+		return ShadowPoissonPCF(shadowSampler, projCoords, bias, texelSize.x * 2.0, ShadowKernelRotation(gl_FragCoord.xy));
 	}
-	// Average the shadow contribution over the 9 samples.
-	shadowFactor /= 9.0;
+	if (filterMode == SHADOW_FILTER_PCSS) {
+		return ShadowPCSS(shadowSampler, depthSampler, projCoords, bias, lightSize, ShadowKernelRotation(gl_FragCoord.xy));
+	}
+	return ShadowHardwarePCF(shadowSampler, projCoords, bias);
+}
+
+// ============================================================================
+// SHADOW ATLAS (Spot & Point Lights)
+// ============================================================================
+// Spot lights own one atlas tile, point lights own six (one per cube face).
+// tileRect = (offset.xy, scale.zw) of the tile in atlas UV space; a zero scale means
+// the light has no shadow tile this frame and is treated as unshadowed.
+
+// Returns the cube face index (+X, -X, +Y, -Y, +Z, -Z) whose frustum contains `dir`.
+int SelectCubeFace(vec3 dir) {
+	vec3 a = abs(dir);
+	if (a.x >= a.y && a.x >= a.z) return dir.x > 0.0 ? 0 : 1;
+	if (a.y >= a.z) return dir.y > 0.0 ? 2 : 3;
+	return dir.z > 0.0 ? 4 : 5;
+}
+
+// Calculates the lighting factor for a fragment using a tile of the shadow atlas
+// (hardware comparison, 3x3 tent from four bilinear taps).
+// Returns 1.0 for fully lit fragments, 0.0 for fully shadowed fragments.
+float CalculateAtlasShadow(sampler2DShadow atlas, vec4 tileRect, mat4 lightMatrix, vec3 fragPos, vec3 normal, vec3 lightDir) {
+	if (tileRect.z <= 0.0) {
+		return 1.0; // No tile assigned
+	}
+
+	vec4 fragPosLightSpace = lightMatrix * vec4(fragPos, 1.0);
+	vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w;
+	projCoords = projCoords * 0.5 + 0.5;
+
+	// Outside the light frustum: no shadow information.
+	if (projCoords.z > 1.0 || any(lessThan(projCoords.xy, vec2(0.0))) || any(greaterThan(projCoords.xy, vec2(1.0)))) {
+		return 1.0;
+	}
+
+	// Perspective depth is non-linear, so the bias is much smaller than the directional one.
+	float bias = max(0.0025 * (1.0 - dot(normal, lightDir)), 0.0005);
+	float ref = projCoords.z - bias;
+
+	// Keep the bilinear footprint (tap +/- half a texel) inside the tile so PCF never
+	// reads a neighbouring light's depth.
+	vec2 texelSize = 1.0 / vec2(textureSize(atlas, 0));
+	vec2 tileMin = tileRect.xy + texelSize;
+	vec2 tileMax = tileRect.xy + tileRect.zw - texelSize;
+	vec2 atlasCoords = tileRect.xy + projCoords.xy * tileRect.zw;
 
-	// The result `shadowFactor` is the percentage of samples that were determined to be in shadow.
-	// Return the lighting factor (1.0 - shadow percentage).
-	return 1.0 - shadowFactor;
+	float lit = 0.0;
+	lit += texture(atlas, vec3(clamp(atlasCoords + vec2(-0.5, -0.5) * texelSize, tileMin, tileMax), ref));
+	lit += texture(atlas, vec3(clamp(atlasCoords + vec2(0.5, -0.5) * texelSize, tileMin, tileMax), ref));
+	lit += texture(atlas, vec3(clamp(atlasCoords + vec2(-0.5, 0.5) * texelSize, tileMin, tileMax), ref));
+	lit += texture(atlas, vec3(clamp(atlasCoords + vec2(0.5, 0.5) * texelSize, tileMin, tileMax), ref));
+	return lit * 0.25;
 }
 
 #endif // SHADOW_GLSL
\ No newline at end of file
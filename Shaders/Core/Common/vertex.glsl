@@ -0,0 +1,49 @@
+#ifndef VERTEX_GLSL
+#define VERTEX_GLSL
+
+#include "packing.glsl"
+
+// ============================================================================
+// MESH VERTEX ATTRIBUTES
+// ============================================================================
+// Mesh uploads one of two layouts (see Engine::VertexFormat):
+//   Full    : float position (0), normal (1), UV (2), tangent (3), bitangent (4).
+//   Compact : snorm16 position against the mesh bounds (0, w = bitangent sign),
+//             half-float UV (2), octahedral snorm16 normal (9) and tangent (10).
+// Both bind the position decode at 11/12 as per-mesh constants; w of the scale is 1
+// for Compact. Arrays not used by a layout are disabled and read as constants.
+layout(location = 0) in vec4 a_Position;
+layout(location = 1) in vec3 a_Normal;
+layout(location = 2) in vec2 a_TexCoords;
+layout(location = 3) in vec3 a_Tangent;
+layout(location = 4) in vec3 a_Bitangent;
+layout(location = 9) in vec2 a_OctNormal;
+layout(location = 10) in vec2 a_OctTangent;
+layout(location = 11) in vec4 a_PositionScale;
+layout(location = 12) in vec4 a_PositionOffset;
+
+bool IsCompactVertex() {
+	return a_PositionScale.w > 0.5;
+}
+
+// Object-space position (exact for Full: x * 1 + 0)
+vec3 GetVertexPosition() {
+	return a_Position.xyz * a_PositionScale.xyz + a_PositionOffset.xyz;
+}
+
+vec3 GetVertexNormal() {
+	return IsCompactVertex() ? OctDecode(a_OctNormal) : a_Normal;
+}
+
+vec3 GetVertexTangent() {
+	return IsCompactVertex() ? OctDecode(a_OctTangent) : a_Tangent;
+}
+
+// +1 or -1: bitangent = sign * cross(normal, tangent)
+float GetVertexBitangentSign() {
+	if (IsCompactVertex())
+		return a_Position.w < 0.0 ? -1.0 : 1.0;
+	return dot(cross(a_Normal, a_Tangent), a_Bitangent) < 0.0 ? -1.0 : 1.0;
+}
+
+#endif // VERTEX_GLSL
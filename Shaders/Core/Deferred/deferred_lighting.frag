@@ -3,17 +3,27 @@ out vec4 FragColor;
 
 in vec2 TexCoords;
 
-// G-Buffer samplers
-uniform sampler2D gAlbedoAO;         // Albedo Color (rgb), AO (a)
-uniform sampler2D gPositionMetallic; // World Pos (xyz), Metallic (w)
-uniform sampler2D gNormalRoughness;  // World Normal (xyz), Roughness (w)
+// G-Buffer samplers (compact layout, see gbuffer.frag)
+uniform sampler2D gAlbedoAO;          // Albedo Color (rgb), AO (a)
+uniform sampler2D gNormal;            // Octahedral world normal in [0, 1]
+uniform sampler2D gMetallicRoughness; // Metallic (r), Roughness (g)
+uniform sampler2D gDepth;             // Depth buffer, used to reconstruct world position
 // uniform sampler2D gEmissiveSpecular; // Optional
+uniform mat4 u_InvViewProjection;     // inverse(projection * view)
 
 // Other uniforms
-uniform sampler2D shadowMap;
+uniform sampler2DShadow shadowMap;  // Directional shadow (hardware comparison)
+uniform sampler2D u_ShadowDepthMap; // Same depth, raw reads (PCSS)
+uniform sampler2D u_ShadowMoments;  // EVSM moments
+uniform sampler2DShadow u_ShadowAtlas; // Point light shadow tiles (ShadowAtlas)
+uniform int u_ShadowFilterMode;
+uniform float u_ShadowLightSize;
 uniform vec3 u_ViewPos; // Camera position in world space
 uniform mat4 lightSpaceMatrix;
 
+#include "../Common/packing.glsl"
+#include "../Common/shadow.glsl"
+
 // --- PBR Cook-Torrance BRDF functions (same as in pbr.frag) ---
 const float PI = 3.14159265359;
 
@@ -53,39 +63,6 @@ vec3 fresnelSchlick(float cosTheta, vec3 F0) {
 // --- End PBR Functions ---
 
 
-// --- Shadow Calculation ---
-float CalculateShadow(vec4 fragPosLightSpace, vec3 normal, vec3 lightDir) {
-    // Perspective divide
-    vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w;
-    // Transform to [0,1] range
-    projCoords = projCoords * 0.5 + 0.5;
-
-    // Check if outside shadow map bounds
-    if (projCoords.z > 1.0) return 0.0;
-
-    // Get closest depth from shadow map
-    float closestDepth = texture(shadowMap, projCoords.xy).r;
-    // Get current depth
-    float currentDepth = projCoords.z;
-
-    // Calculate bias (slope-based)
-    float bias = max(0.005 * (1.0 - dot(normal, lightDir)), 0.0005);
-
-    // PCF - Percentage-Closer Filtering
-    float shadow = 0.0;
-    vec2 texelSize = 1.0 / textureSize(shadowMap, 0);
-    for (int x = -1; x <= 1; ++x) {
-        for (int y = -1; y <= 1; ++y) {
-            float pcfDepth = texture(shadowMap, projCoords.xy + vec2(x, y) * texelSize).r;
-            shadow += (currentDepth - bias) > pcfDepth ? 1.0 : 0.0;
-        }
-    }
-    shadow /= 9.0;
-
-    return shadow;
-}
-
-
 // --- Light Structs (match C++ side, e.g., UBO layout) ---
 struct PointLight {
     vec3 position;
@@ -109,19 +86,32 @@ struct DirectionalLight {
 uniform PointLight u_PointLights[MAX_POINT_LIGHTS];
 uniform int u_NumPointLights;
 
+// Atlas tiles of the first point lights (slots follow World::CollectLights(), six cube faces each)
+#define MAX_SHADOWED_POINT_LIGHTS 4 // World::MAX_POINT_LIGHTS
+uniform mat4 u_PointShadowMatrices[MAX_SHADOWED_POINT_LIGHTS * 6];
+uniform vec4 u_PointShadowRects[MAX_SHADOWED_POINT_LIGHTS * 6];
+
 #define MAX_DIR_LIGHTS 1
 uniform DirectionalLight u_DirLights[MAX_DIR_LIGHTS];
 uniform int u_NumDirLights;
 
 
 void main() {
-    // --- Sample G-Buffer ---
-    vec3 FragPos   = texture(gPositionMetallic, TexCoords).xyz;
-    float metallic = texture(gPositionMetallic, TexCoords).w;
-    vec3 Normal    = texture(gNormalRoughness, TexCoords).xyz;
-    float roughness= texture(gNormalRoughness, TexCoords).w;
-    vec3 Albedo    = texture(gAlbedoAO, TexCoords).rgb;
-    float ao       = texture(gAlbedoAO, TexCoords).a;
+    // --- Sample G-Buffer (exact texels, no filtering of encoded data) ---
+    ivec2 texel = ivec2(gl_FragCoord.xy);
+    float depth = texelFetch(gDepth, texel, 0).r;
+    if (depth >= 1.0) {
+        FragColor = vec4(0.0, 0.0, 0.0, 1.0); // Background: nothing was written to the G-Buffer
+        return;
+    }
+    vec3 FragPos    = ReconstructWorldPosition(TexCoords, depth, u_InvViewProjection);
+    vec3 Normal     = OctDecode(texelFetch(gNormal, texel, 0).rg * 2.0 - 1.0);
+    vec2 metalRough = texelFetch(gMetallicRoughness, texel, 0).rg;
+    float metallic  = metalRough.r;
+    float roughness = metalRough.g;
+    vec4 albedoAO   = texelFetch(gAlbedoAO, texel, 0);
+    vec3 Albedo     = albedoAO.rgb;
+    float ao        = albedoAO.a;
 
  	// --- DEBUG: Output Albedo directly ---
     // FragColor = vec4(Albedo, 1.0); // Output Albedo directly
@@ -161,10 +151,11 @@ void main() {
 
         // Shadow calculation
         vec4 fragPosLightSpace = lightSpaceMatrix * vec4(FragPos, 1.0);
-        float shadow = CalculateShadow(fragPosLightSpace, N, lightDir);
+        float shadow = CalculateShadow(u_ShadowFilterMode, shadowMap, u_ShadowDepthMap, u_ShadowMoments,
+                                       fragPosLightSpace, N, lightDir, u_ShadowLightSize);
 
         // Add to outgoing radiance (scaled by color, NdotL, and shadow)
-        Lo += (kD * Albedo / PI + specular) * lightColor * NdotL * (1.0 - shadow);
+        Lo += (kD * Albedo / PI + specular) * lightColor * NdotL * shadow;
     }
 
     // --- Point Lights ---
@@ -197,9 +188,15 @@ void main() {
         float denominator = 4.0 * max(dot(N, V), 0.0) * NdotL + 0.0001;
         vec3 specular = numerator / denominator;
 
-        // Add to outgoing radiance (scaled by color, NdotL, and attenuation)
-        // Note: Point light shadows are more complex and not included here
-        Lo += (kD * Albedo / PI + specular) * lightColor * NdotL * attenuation;
+        // Shadow from the cube face tile facing the fragment
+        float shadow = 1.0;
+        if (i < MAX_SHADOWED_POINT_LIGHTS) {
+            int face = SelectCubeFace(FragPos - lightPos);
+            shadow = CalculateAtlasShadow(u_ShadowAtlas, u_PointShadowRects[i * 6 + face], u_PointShadowMatrices[i * 6 + face], FragPos, N, lightDir);
+        }
+
+        // Add to outgoing radiance (scaled by color, NdotL, attenuation and shadow)
+        Lo += (kD * Albedo / PI + specular) * lightColor * NdotL * attenuation * shadow;
     }
 
 
@@ -1,10 +1,10 @@
 #version 450 core
-layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec2 aTexCoords;
 
 out vec2 TexCoords;
 
 void main() {
-    TexCoords = aTexCoords;
-    gl_Position = vec4(aPos, 1.0); // Pass through NDC directly
+    // Fullscreen triangle from gl_VertexID (no vertex buffer), covers NDC [-1, 1]
+    vec2 pos = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    TexCoords = pos;
+    gl_Position = vec4(pos * 2.0 - 1.0, 0.0, 1.0);
 }
\ No newline at end of file
@@ -1,9 +1,13 @@
 #version 450 core
-layout (location = 0) out vec4 gPositionMetallic; // World Pos (xyz), Metallic (w)
-layout (location = 1) out vec4 gNormalRoughness;  // World Normal (xyz), Roughness (w)
-layout (location = 2) out vec4 gAlbedoAO;         // Albedo Color (rgb), AO (a)
+// Compact layout (10 bytes/pixel + depth). World position is not stored:
+// the lighting pass reconstructs it from the depth buffer.
+layout (location = 0) out vec4 gAlbedoAO;          // RGBA8: Albedo Color (rgb), AO (a)
+layout (location = 1) out vec2 gNormal;            // RG16:  Octahedral world normal, remapped to [0, 1]
+layout (location = 2) out vec2 gMetallicRoughness; // RG8:   Metallic (r), Roughness (g)
 // layout (location = 3) out vec4 gEmissiveSpecular; // Optional: Emissive (rgb), Specular (a)
 
+#include "../Common/packing.glsl"
+
 in VS_OUT {
     vec3 FragPos;
     vec3 Normal;
@@ -49,16 +53,12 @@ vec3 getNormalFromMap() {
 */
 
 void main() {
-    // --- Position ---
-    // Store world position in RGB. We might store depth or another value in W if needed.
-    gPositionMetallic.xyz = fs_in.FragPos;
-
     // --- Normal ---
     vec3 normal = normalize(fs_in.Normal);
     // if (u_Material_HasNormalMap) {
     //     normal = getNormalFromMap(); // Requires TBN matrix and tangents
     // }
-    gNormalRoughness.xyz = normal; // Store world normal
+    gNormal = OctEncode(normal) * 0.5 + 0.5; // Store octahedral world normal
 
     // --- Albedo ---
     vec3 albedo = u_Material_AlbedoColor;
@@ -72,14 +72,14 @@ void main() {
     if (u_Material_HasMetallicMap) {
         metallic = texture(u_Material_MetallicMap, fs_in.TexCoords).r; // Assuming metallic is in R channel
     }
-    gPositionMetallic.w = metallic; // Store metallic in Position's W component
+    gMetallicRoughness.r = metallic;
 
     // --- Roughness ---
     float roughness = u_Material_Roughness;
     if (u_Material_HasRoughnessMap) {
         roughness = texture(u_Material_RoughnessMap, fs_in.TexCoords).r; // Assuming roughness is in R channel
     }
-    gNormalRoughness.w = roughness; // Store roughness in Normal's W component
+    gMetallicRoughness.g = roughness;
 
     // --- Ambient Occlusion ---
     float ao = u_Material_AO;
@@ -1,8 +1,5 @@
 #version 450 core
-layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aNormal;
-layout (location = 2) in vec2 aTexCoords;
-// layout (location = 3) in vec3 aTangent; // Add if tangents are available and needed
+#include "../Common/vertex.glsl" // a_Position, a_Normal, a_TexCoords (Full or Compact layout)
 
 // Uniform Buffer Object for matrices
 layout (std140, binding = 0) uniform Matrices {
@@ -21,19 +18,20 @@ out VS_OUT {
 
 void main() {
     mat4 viewModel = view * u_Model;
-    vec4 worldPos = u_Model * vec4(aPos, 1.0);
+    vec3 position = GetVertexPosition();
+    vec4 worldPos = u_Model * vec4(position, 1.0);
 
     vs_out.FragPos = vec3(worldPos);
     // Calculate world normal (inverse transpose for non-uniform scaling)
-    vs_out.Normal = normalize(mat3(transpose(inverse(u_Model))) * aNormal);
-    vs_out.TexCoords = aTexCoords;
+    vs_out.Normal = normalize(mat3(transpose(inverse(u_Model))) * GetVertexNormal());
+    vs_out.TexCoords = a_TexCoords;
 
     // Optional: Calculate TBN matrix if needed for normal mapping in GBuffer pass
-    // vec3 T = normalize(mat3(u_Model) * aTangent);
+    // vec3 T = normalize(mat3(u_Model) * GetVertexTangent());
     // vec3 N = vs_out.Normal;
     // T = normalize(T - dot(T, N) * N); // Gram-Schmidt orthogonalize
-    // vec3 B = cross(N, T);
+    // vec3 B = cross(N, T) * GetVertexBitangentSign();
     // vs_out.TBN = mat3(T, B, N);
 
-    gl_Position = projection * viewModel * vec4(aPos, 1.0);
+    gl_Position = projection * viewModel * vec4(position, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,21 @@
+#version 450 core
+
+// Depth-only prepass for the forward path (paired with depth.frag).
+// gl_Position must be computed exactly as in forward_shading.vert: both declare it
+// invariant so the colour pass can depth-test with GL_EQUAL.
+
+#include "../Common/vertex.glsl"
+
+layout(std140, binding = 0) uniform Matrices {
+    mat4 u_Projection;
+    mat4 u_View;
+};
+
+uniform mat4 u_Model;
+
+invariant gl_Position;
+
+void main() {
+    vec4 worldPos = u_Model * vec4(GetVertexPosition(), 1.0);
+    gl_Position = u_Projection * u_View * worldPos;
+}
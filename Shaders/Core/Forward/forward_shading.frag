@@ -36,7 +36,13 @@ uniform sampler2D u_MetallicMap;   // Unit 2
 uniform sampler2D u_RoughnessMap;  // Unit 3
 uniform sampler2D u_AOMap;         // Unit 4
 uniform sampler2D u_EmissiveMap;   // Unit 5 (Optional)
-uniform sampler2D shadowMap;       // Unit (e.g., 11) for directional shadow
+uniform sampler2D u_PackedMap;     // Unit 11, R = AO, G = Roughness, B = Metallic, A = Height
+uniform sampler2DShadow shadowMap;     // Unit 13, directional shadow (hardware comparison)
+uniform sampler2D u_ShadowDepthMap;    // Unit 14, same depth read raw (PCSS blocker search)
+uniform sampler2D u_ShadowMoments;     // Unit 15, EVSM moments (mipmapped)
+uniform sampler2DShadow u_ShadowAtlas; // Unit 12, spot/point light shadow tiles
+uniform int u_ShadowFilterMode;        // Engine::ShadowFilterMode
+uniform float u_ShadowLightSize;       // PCSS light size (shadow map UV units)
 
 // ============================================================================
 // MATERIAL UNIFORMS (Match MaterialPBR setup)
@@ -53,6 +59,7 @@ uniform int u_HasMetallicMap;
 uniform int u_HasRoughnessMap;
 uniform int u_HasAOMap;
 uniform int u_HasEmissiveMap; // Optional
+uniform int u_PackedChannels; // Channels read from u_PackedMap: 1 = AO, 2 = Roughness, 4 = Metallic (0 = none)
 
 // ============================================================================
 // LIGHT UNIFORMS (Use structs from lighting.glsl)
@@ -67,6 +74,12 @@ uniform int u_NumPointLights; // Number of active point lights
 uniform SpotLight u_SpotLights[MAX_SPOT_LIGHTS];   // Array from lighting.glsl
 uniform int u_NumSpotLights;   // Number of active spot lights
 
+// Shadow atlas tiles (see ShadowAtlas): one per spot light, six (cube faces) per point light
+uniform mat4 u_SpotShadowMatrices[MAX_SPOT_LIGHTS];
+uniform vec4 u_SpotShadowRects[MAX_SPOT_LIGHTS];
+uniform mat4 u_PointShadowMatrices[MAX_POINT_LIGHTS * 6];
+uniform vec4 u_PointShadowRects[MAX_POINT_LIGHTS * 6];
+
 // ============================================================================
 // CAMERA UNIFORM
 // ============================================================================
@@ -78,8 +91,9 @@ uniform vec3 u_ViewPos; // Camera position in world space
 vec3 getShadingNormal() {
     vec3 N = normalize(fs_in.Normal); // Default to interpolated vertex normal
     if (u_HasNormalMap == 1) {
-        // Sample tangent-space normal from map
-        vec3 tangentNormal = texture(u_NormalMap, fs_in.TexCoords).xyz * 2.0 - 1.0;
+        // Sample tangent-space normal from map (Z rebuilt from XY so two-channel BC5 maps work too)
+        vec2 normalXY = texture(u_NormalMap, fs_in.TexCoords).xy * 2.0 - 1.0;
+        vec3 tangentNormal = vec3(normalXY, sqrt(max(1.0 - dot(normalXY, normalXY), 0.0)));
         // Transform to world space using the TBN matrix
         N = normalize(fs_in.TBN * tangentNormal);
     }
@@ -96,18 +110,30 @@ void main() {
         albedo = texture(u_AlbedoMap, fs_in.TexCoords).rgb;
     }
 
+    // One fetch for every channel-packed map; separate maps only for channels not in the pack
+    vec4 packedSample = vec4(1.0);
+    if (u_PackedChannels != 0) {
+        packedSample = texture(u_PackedMap, fs_in.TexCoords);
+    }
+
     float metallic = u_Metallic;
-    if (u_HasMetallicMap == 1) {
+    if ((u_PackedChannels & 4) != 0) {
+        metallic = packedSample.b;
+    } else if (u_HasMetallicMap == 1) {
         metallic = texture(u_MetallicMap, fs_in.TexCoords).r;
     }
 
     float roughness = u_Roughness;
-    if (u_HasRoughnessMap == 1) {
+    if ((u_PackedChannels & 2) != 0) {
+        roughness = packedSample.g;
+    } else if (u_HasRoughnessMap == 1) {
         roughness = texture(u_RoughnessMap, fs_in.TexCoords).r;
     }
 
     float ao = u_AO;
-    if (u_HasAOMap == 1) {
+    if ((u_PackedChannels & 1) != 0) {
+        ao = packedSample.r;
+    } else if (u_HasAOMap == 1) {
         ao = texture(u_AOMap, fs_in.TexCoords).r;
     }
 
@@ -151,7 +177,8 @@ void main() {
         vec3 specular = numerator / denominator;
 
         // Calculate shadow attenuation
-        float shadow = CalculateShadow(shadowMap, fs_in.FragPosLightSpace, N, L);
+        float shadow = CalculateShadow(u_ShadowFilterMode, shadowMap, u_ShadowDepthMap, u_ShadowMoments,
+                                       fs_in.FragPosLightSpace, N, L, u_ShadowLightSize);
 
         // Add contribution to outgoing radiance (scaled by NdotL and shadow)
         Lo += (kD * albedo / PI + specular) * radiance * NdotL * shadow;
@@ -189,8 +216,11 @@ void main() {
         float denominator = 4.0 * max(dot(N, V), 0.0) * NdotL + EPSILON;
         vec3 specular = numerator / denominator;
 
-        // Add contribution (no shadows for point lights in this example)
-        Lo += (kD * albedo / PI + specular) * radiance * NdotL;
+        // Shadow from the cube face tile facing the fragment
+        int face = SelectCubeFace(fs_in.FragPos - lightPos);
+        float shadow = CalculateAtlasShadow(u_ShadowAtlas, u_PointShadowRects[i * 6 + face], u_PointShadowMatrices[i * 6 + face], fs_in.FragPos, N, L);
+
+        Lo += (kD * albedo / PI + specular) * radiance * NdotL * shadow;
     }
 
     // ================== SPOT LIGHTS ==================
@@ -233,8 +263,10 @@ void main() {
         float denominator = 4.0 * max(dot(N, V), 0.0) * NdotL + EPSILON;
         vec3 specular = numerator / denominator;
 
-        // Add contribution (no shadows for spot lights in this example)
-        Lo += (kD * albedo / PI + specular) * radiance * NdotL;
+        // Shadow from the spot light's atlas tile
+        float shadow = CalculateAtlasShadow(u_ShadowAtlas, u_SpotShadowRects[i], u_SpotShadowMatrices[i], fs_in.FragPos, N, L);
+
+        Lo += (kD * albedo / PI + specular) * radiance * NdotL * shadow;
     }
 
 	
@@ -3,11 +3,7 @@
 // ============================================================================
 // INPUT VERTEX ATTRIBUTES
 // ============================================================================
-layout(location = 0) in vec3 a_Position;
-layout(location = 1) in vec3 a_Normal;
-layout(location = 2) in vec2 a_TexCoords;
-layout(location = 3) in vec3 a_Tangent;   // Input tangent (model space)
-layout(location = 4) in vec3 a_Bitangent; // Input bitangent (model space)
+#include "../Common/vertex.glsl" // Full or Compact mesh layout (model space)
 
 // ============================================================================
 // OUTPUTS TO FRAGMENT SHADER
@@ -35,25 +31,27 @@ layout(std140, binding = 0) uniform Matrices {
 uniform mat4 u_Model;          // Model transformation matrix
 uniform mat4 lightSpaceMatrix; // Directional Light's view-projection matrix (for shadows)
 
+// Must match depth_prepass.vert bit for bit (GL_EQUAL depth test after the prepass)
+invariant gl_Position;
+
 // ============================================================================
 // MAIN VERTEX SHADER FUNCTION
 // ============================================================================
 void main() {
     // --- Calculate World Position ---
-    vec4 worldPos = u_Model * vec4(a_Position, 1.0);
+    vec4 worldPos = u_Model * vec4(GetVertexPosition(), 1.0);
     vs_out.FragPos = worldPos.xyz;
 
     // --- Calculate Normal Matrix ---
     mat3 normalMatrix = transpose(inverse(mat3(u_Model)));
 
     // --- Calculate World Space Normal, Tangent, Bitangent ---
-    vec3 N = normalize(normalMatrix * a_Normal);
-    vec3 T = normalize(normalMatrix * a_Tangent);
-    vec3 B = normalize(normalMatrix * a_Bitangent);
+    vec3 N = normalize(normalMatrix * GetVertexNormal());
+    vec3 T = normalize(normalMatrix * GetVertexTangent());
 
     // --- Orthogonalize TBN Basis (Gram-Schmidt) ---
     T = normalize(T - dot(T, N) * N);
-    B = cross(N, T); // Recalculate B for orthogonality
+    vec3 B = cross(N, T) * GetVertexBitangentSign(); // Rebuilt from the handedness (mirrored UVs)
 
     // --- Pass World Space Vectors ---
     vs_out.Normal = N;
@@ -1,15 +1,17 @@
 #version 450 core
 
-// Input vertex attribute: Position in object space
-layout (location = 0) in vec3 aPos;
+// Input vertex attributes (only the position is read)
+#include "Common/vertex.glsl"
 
-// Uniforms for transformations
-uniform mat4 model;            // Model matrix: Object space -> World space
-uniform mat4 lightSpaceMatrix; // Light's combined view-projection matrix: World space -> Light's clip space
+// Per-instance model matrices (uploaded by World::RenderDepth, binding = 1)
+layout (std430, binding = 1) readonly buffer InstanceTransforms {
+	mat4 instanceModels[];
+};
+
+uniform int u_InstanceOffset; // First instance of the current batch in instanceModels
 
 void main() {
-	// Calculate the vertex position in the light's clip space.
-	// This is used for depth testing from the light's perspective (e.g., shadow mapping).
-	// Transformation order: Object -> World -> Light Clip Space
-	gl_Position = lightSpaceMatrix * model * vec4(aPos, 1.0);
+	// Output the world-space position; the geometry shader applies each light view.
+	// Transformation order: Object -> World (-> Light Clip Space in depth.geom)
+	gl_Position = instanceModels[u_InstanceOffset + gl_InstanceID] * vec4(GetVertexPosition(), 1.0);
 }
@@ -0,0 +1,19 @@
+#version 450 core
+
+// Converts the directional shadow depth into exponential variance moments.
+// The result is mipmapped afterwards, which prefilters the shadow map.
+in vec2 TexCoords;
+out vec4 Moments;
+
+uniform sampler2D u_DepthMap; // Raw depth (comparison disabled by the sampler object)
+
+// Must match EVSM_*_EXPONENT in Common/shadow.glsl
+const float EVSM_POSITIVE_EXPONENT = 40.0;
+const float EVSM_NEGATIVE_EXPONENT = 5.0;
+
+void main() {
+	float depth = texture(u_DepthMap, TexCoords).r * 2.0 - 1.0;
+	float positive = exp(EVSM_POSITIVE_EXPONENT * depth);
+	float negative = -exp(-EVSM_NEGATIVE_EXPONENT * depth);
+	Moments = vec4(positive, positive * positive, negative, negative * negative);
+}
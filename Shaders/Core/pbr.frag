@@ -538,7 +538,9 @@ void main() {
     vec3 N_geom = normalize(Normal); // Geometric normal
     surface.N = N_geom;
     if (u_HasNormalMap == 1) {
-        vec3 tangentNormal = texture(u_NormalMap, surface.TexCoords).rgb * 2.0 - 1.0;
+        // Z is rebuilt from XY so two-channel (BC5) normal maps work too
+        vec2 normalXY = texture(u_NormalMap, surface.TexCoords).rg * 2.0 - 1.0;
+        vec3 tangentNormal = vec3(normalXY, sqrt(max(1.0 - dot(normalXY, normalXY), 0.0)));
         // Transform tangent-space normal to world space using transpose of TBN
         // Assumes TBN is World -> Tangent
         surface.N = normalize(TBN_inv * tangentNormal);
@@ -3,11 +3,7 @@
 // ============================================================================
 // INPUT VERTEX ATTRIBUTES
 // ============================================================================
-layout(location = 0) in vec3 a_Position;
-layout(location = 1) in vec3 a_Normal;
-layout(location = 2) in vec2 a_TexCoords;
-layout(location = 3) in vec3 a_Tangent;   // Input tangent (model space)
-layout(location = 4) in vec3 a_Bitangent; // Input bitangent (model space)
+#include "../Common/vertex.glsl" // Full or Compact mesh layout (model space)
 
 // ============================================================================
 // OUTPUTS TO FRAGMENT SHADER
@@ -38,7 +34,7 @@ uniform mat4 lightSpaceMatrix; // Light's view-projection matrix (for shadows)
 // ============================================================================
 void main() {
     // --- Calculate World Position ---
-    vec4 worldPos = u_Model * vec4(a_Position, 1.0);
+    vec4 worldPos = u_Model * vec4(GetVertexPosition(), 1.0);
     FragPos = worldPos.xyz;
 
     // --- Calculate Normal Matrix ---
@@ -48,9 +44,8 @@ void main() {
 
     // --- Calculate World Space Normal, Tangent, Bitangent ---
     // Transform direction vectors from model space to world space
-    vec3 N = normalize(normalMatrix * a_Normal);
-    vec3 T = normalize(normalMatrix * a_Tangent);
-    vec3 B = normalize(normalMatrix * a_Bitangent); // Transform original bitangent
+    vec3 N = normalize(normalMatrix * GetVertexNormal());
+    vec3 T = normalize(normalMatrix * GetVertexTangent());
 
     // --- Orthogonalize TBN Basis (Gram-Schmidt) ---
     // Ensure the basis vectors passed to the fragment shader are orthogonal,
@@ -60,10 +55,8 @@ void main() {
     T = normalize(T - dot(T, N) * N);
     // 3. Recalculate Bitangent (B) to be orthogonal to both N and T.
     //    This also ensures the basis remains right-handed (or left-handed, consistently).
-    B = cross(N, T);
-    // Note: Depending on the original bitangent calculation (tool/importer),
-    // you might need B = cross(T, N) if the original winding order was different.
-    // Check visual results, especially with normal maps.
+    //    The stored handedness flips it for mirrored UVs.
+    vec3 B = cross(N, T) * GetVertexBitangentSign();
 
     // --- Pass World Space Vectors ---
     // Pass the final, orthogonalized world-space vectors.
@@ -1,8 +1,7 @@
 #version 450 core
 
-// Vertex attributes
-layout (location = 0) in vec3 aPos;        // Vertex position (object space)
-layout (location = 2) in vec2 aTexCoords;  // Texture coordinates
+// Vertex attributes (position and texture coordinates are read)
+#include "Common/vertex.glsl"
 
 // Camera matrices (shared via UBO, binding = 0)
 layout (std140, binding = 0) uniform Matrices {
@@ -18,7 +17,7 @@ out vec2 TexCoords;
 
 void main() {
 	// Transform vertex to clip space
-	gl_Position = projection * view * u_Model * vec4(aPos, 1.0);
+	gl_Position = projection * view * u_Model * vec4(GetVertexPosition(), 1.0);
 	// Pass texture coordinates through
-	TexCoords = aTexCoords;
+	TexCoords = a_TexCoords;
 }
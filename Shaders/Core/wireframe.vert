@@ -1,7 +1,7 @@
 #version 450 core
 
-// Input vertex attribute: Position (location = 0)
-layout (location = 0) in vec3 aPos;
+// Input vertex attributes (only the position is read)
+#include "Common/vertex.glsl"
 
 // Uniform Buffer Object (UBO) for common matrices
 // Bound to binding point 0, using std140 layout for memory alignment
@@ -18,5 +18,5 @@ void main() {
 	// Calculate the final vertex position in clip space
 	// Transformation order: Object -> World -> Camera -> Clip
 	// Note: GLM uses column-major matrices, so multiplication order is P * V * M * v
-	gl_Position = projection * view * u_Model * vec4(aPos, 1.0);
+	gl_Position = projection * view * u_Model * vec4(GetVertexPosition(), 1.0);
 }
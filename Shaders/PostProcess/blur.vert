@@ -1,8 +1,8 @@
 #version 450 core
-layout(location=0) in vec2 a_Pos;
-layout(location=1) in vec2 a_UV;
 out vec2 TexCoords;
 void main() {
-    TexCoords = a_UV;
-    gl_Position = vec4(a_Pos,0.0,1.0);
+    // Fullscreen triangle from gl_VertexID (no vertex buffer)
+    vec2 pos = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    TexCoords = pos;
+    gl_Position = vec4(pos * 2.0 - 1.0, 0.0, 1.0);
 }